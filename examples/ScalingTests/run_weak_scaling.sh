@@ -0,0 +1,99 @@
+#!/bin/bash
+
+#=========================================================================================
+# Weak scaling benchmark of the Stokes solver (default vs. pipelined Krylov configurations)
+#
+# Run as follows
+#
+# ./run_weak_scaling.sh "num_proc_list" [cells_per_proc]
+#
+# Example (process counts must be cubes, 32^3 cells per process):
+#
+# ./run_weak_scaling.sh "1 8 64 512 4096" 32
+#
+# The grid is refined with the number of processes to keep the local grid size constant.
+# Every run writes a performance report perf_<config>_<num_proc>.json and a screen log
+# log_<config>_<num_proc>.out. A summary table is printed in the end (requires python3).
+#
+# Environment variables:
+#
+#    MPIEXEC - MPI launcher         (default: mpiexec)
+#    LAMEM   - LaMEM executable     (default: ../../bin/opt/LaMEM)
+#
+# Non-blocking reductions of pipelined solvers only overlap with the preconditioner if
+# the MPI library progresses them asynchronously, e.g.:
+#
+#    MPICH_ASYNC_PROGRESS=1 (MPICH, Cray MPICH)
+#    I_MPI_ASYNC_PROGRESS=1 (Intel MPI)
+#
+#=========================================================================================
+
+NPROCS=${1:-"1 8 64"}
+NLOC=${2:-32}
+MPIEXEC=${MPIEXEC:-mpiexec}
+LAMEM=${LAMEM:-../../bin/opt/LaMEM}
+INPUT=FallingSpheres_WeakScaling.dat
+
+# configuration name, Krylov solver type, multigrid smoother type
+CONFIGS=(
+	"default      fgmres      heavy"
+	"fgmres_cheb  fgmres      intermediate"
+	"pipefgmres   pipefgmres  intermediate"
+	"pipegcr      pipegcr     intermediate"
+)
+
+for np in $NPROCS; do
+
+	# get number of processes per direction
+	p=$(awk -v n=$np 'BEGIN { p = int(n^(1.0/3.0) + 0.5); if(p*p*p != n) p = 0; print p }')
+
+	if [ "$p" -eq 0 ]; then
+		echo "Number of processes is not a cube: $np"
+		exit 1
+	fi
+
+	nel=$((NLOC*p))
+
+	for cfg in "${CONFIGS[@]}"; do
+
+		read -r name ksp smoother <<< "$cfg"
+
+		echo "Running $name on $np processes (grid $nel^3)"
+
+		# set configuration in the solver options block
+		sed -e "s/^\([[:space:]]*krylov_type[[:space:]]*=[[:space:]]*\)[^[:space:]]*/\1$ksp/" \
+		    -e "s/^\([[:space:]]*smoother_type[[:space:]]*=[[:space:]]*\)[^[:space:]]*/\1$smoother/" \
+		    $INPUT > input_$name.dat
+
+		$MPIEXEC -np $np $LAMEM -ParamFile input_$name.dat \
+			-nel_x $nel -nel_y $nel -nel_z $nel \
+			-cpu_x $p -cpu_y $p -cpu_z $p \
+			-perf_file perf_${name}_${np}.json > log_${name}_${np}.out 2>&1
+
+		if [ $? -ne 0 ]; then
+			echo "Run failed, see log_${name}_${np}.out"
+		fi
+	done
+done
+
+# print summary (Stokes solve time of the slowest process summed over all steps)
+python3 - $NPROCS <<'PYEOF'
+import json, sys, os
+
+configs = ["default", "fgmres_cheb", "pipefgmres", "pipegcr"]
+nprocs  = sys.argv[1:]
+base    = {}
+
+print("%-12s %8s %10s %10s %12s %12s %10s" % ("config", "procs", "ksp_its", "solve[s]", "per_it[ms]", "mg_apply[s]", "weak_eff"))
+
+for name in configs:
+	for np in nprocs:
+		fname = "perf_%s_%s.json" % (name, np)
+		if not os.path.exists(fname): continue
+		rep   = json.load(open(fname))
+		its   = sum(s["ksp_its"] for s in rep["steps"])
+		solve = rep["events"]["snes_solve"]["time_max"]
+		mg    = rep["events"]["mg_apply"]["time_max"]
+		base.setdefault(name, solve)
+		print("%-12s %8s %10d %10.3f %12.3f %12.3f %10.3f" % (name, np, its, solve, 1e3*solve/max(its, 1), mg, base[name]/solve))
+PYEOF
@@ -24,10 +24,15 @@
 #include "fdstag.h"
 #include "bc.h"
 #include "tools.h"
+#include "perfLog.h"
 
 //---------------------------------------------------------------------------
 PetscErrorCode AVDCreate(AVD *A)
 {
+	// initialize AVD structure (storage is reused if capacity is sufficient)
+
+	AVDChain   *chain;
+	PetscInt   *claim, *bound, iclaim, ibound;
 	PetscInt    p, npoints;
 	PetscInt    ind;
 	PetscInt    i, j, k;
@@ -51,13 +56,14 @@ PetscErrorCode AVDCreate(AVD *A)
 	s[1] = A->xs[1]-dx[1]*0.5;
 	s[2] = A->xs[2]-dx[2]*0.5;
 
+	npoints = A->npoints;
+
+	// reserve storage for cells plus one layer of boundary cells
+	PetscCall(AVDReserve(A, mx*my*mz, npoints));
+
 	// --------------
 	//   AVD CELLS
 	// --------------
-	// allocate memory for cells plus one layer of boundary cells
-	PetscCall(PetscMalloc((size_t)(mx*my*mz)*sizeof(AVDCell), &A->cell));
-	PetscCall(PetscMemzero(A->cell, (size_t)(mx*my*mz)*sizeof(AVDCell)));
-
 	for (k=0; k<mz; k++)
 	{
 		// compute z - center coordinate
@@ -96,37 +102,94 @@ PetscErrorCode AVDCreate(AVD *A)
 	// --------------
 	//   AVD CHAIN
 	// --------------
-	A->buffer = 1;
-	npoints   = A->npoints;
+	for (p=0; p < npoints; p++)
+	{
+		chain = &A->chain[p];
 
-	// allocate memory for chains
-	PetscCall(PetscMalloc((size_t)(npoints)*sizeof(AVDChain), &A->chain));
-	PetscCall(PetscMemzero(A->chain, (size_t)(npoints)*sizeof(AVDChain)));
+		// clear chain, keep storage of claimed & boundary cells
+		claim  = chain->claim;
+		bound  = chain->bound;
+		iclaim = chain->iclaim;
+		ibound = chain->ibound;
 
-	for (p=0; p < npoints; p++)
+		PetscCall(PetscMemzero(chain, sizeof(AVDChain)));
+
+		chain->claim  = claim;
+		chain->bound  = bound;
+		chain->iclaim = iclaim;
+		chain->ibound = ibound;
+	}
+
+	// --------------
+	//   AVD POINTS
+	// --------------
+	PetscCall(PetscMemzero(A->points, (size_t)(npoints)*sizeof(Marker)));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AVDReserve(AVD *A, PetscInt ncells, PetscInt npoints)
+{
+	// grow storage of AVD structure
+	// NOTE: allocates memory, reserve maximum size before entering threaded regions
+
+	AVDChain *chain;
+	PetscInt  p;
+
+	
+	PetscFunctionBeginUser;
+
+	A->buffer = 1;
+
+	// --------------
+	//   AVD CELLS
+	// --------------
+	if(ncells > A->ccap)
 	{
-		// initialize dominant axis for half-centroid
-		A->chain[p].xh[0] = 0.0;
-		A->chain[p].xh[1] = 0.0;
-		A->chain[p].xh[2] = 0.0;
+		PetscCall(PetscFree(A->cell));
+		PetscCall(PetscMalloc((size_t)(ncells)*sizeof(AVDCell), &A->cell));
 
-		// allocate memory for chains
-		A->chain[p].iclaim  = A->buffer;
-		A->chain[p].ibound = A->buffer;
+		A->ccap = ncells;
+	}
 
-		PetscCall(PetscMalloc(sizeof(PetscInt)*(size_t)(A->chain[p].iclaim + A->buffer), &A->chain[p].claim));
-		PetscCall(PetscMemzero(A->chain[p].claim, sizeof(PetscInt)*(size_t)(A->chain[p].iclaim + A->buffer)));
+	if(npoints <= A->pcap) PetscFunctionReturn(0);
 
-		PetscCall(PetscMalloc(sizeof(PetscInt)*(size_t)(A->chain[p].ibound + A->buffer), &A->chain[p].bound));
-		PetscCall(PetscMemzero(A->chain[p].bound, sizeof(PetscInt)*(size_t)(A->chain[p].ibound + A->buffer)));
+	// --------------
+	//   AVD CHAIN
+	// --------------
+	// allocate memory for chains (existing chains keep their storage)
+	PetscCall(PetscMalloc((size_t)(npoints)*sizeof(AVDChain), &chain));
+	PetscCall(PetscMemzero(chain, (size_t)(npoints)*sizeof(AVDChain)));
+
+	if(A->pcap) { PetscCall(PetscMemcpy(chain, A->chain, (size_t)(A->pcap)*sizeof(AVDChain))); }
+
+	for (p = A->pcap; p < npoints; p++)
+	{
+		// allocate memory for claimed & boundary cells
+		chain[p].iclaim = A->buffer;
+		chain[p].ibound = A->buffer;
+
+		PetscCall(makeIntArray(&chain[p].claim, NULL, chain[p].iclaim + A->buffer));
+		PetscCall(makeIntArray(&chain[p].bound, NULL, chain[p].ibound + A->buffer));
 	}
 
+	PetscCall(PetscFree(A->chain));
+
+	A->chain = chain;
+
 	// --------------
 	//   AVD POINTS
 	// --------------
-	// allocate memory for points
+	PetscCall(PetscFree(A->points));
 	PetscCall(PetscMalloc((size_t)(npoints)*sizeof(Marker), &A->points));
-	PetscCall(PetscMemzero(A->points, (size_t)(npoints)*sizeof(Marker)));
+
+	// sorting buffers
+	PetscCall(PetscFree(A->area));
+	PetscCall(PetscFree(A->sind));
+	PetscCall(makeIntArray(&A->area, NULL, npoints));
+	PetscCall(makeIntArray(&A->sind, NULL, npoints));
+
+	A->pcap = npoints;
 
 	PetscFunctionReturn(0);
 }
@@ -146,7 +209,7 @@ PetscErrorCode AVDDestroy(AVD *A)
 	// --------------
 	//   AVD CHAIN
 	// --------------
-	for (p = 0; p < A->npoints; p++)
+	for (p = 0; p < A->pcap; p++)
 	{
 		if (A->chain[p].claim ) { PetscCall(PetscFree(A->chain[p].claim )); }
 		if (A->chain[p].bound ) { PetscCall(PetscFree(A->chain[p].bound )); }
@@ -157,6 +220,11 @@ PetscErrorCode AVDDestroy(AVD *A)
 	//   AVD POINTS
 	// --------------
 	PetscCall(PetscFree(A->points));
+	PetscCall(PetscFree(A->area));
+	PetscCall(PetscFree(A->sind));
+
+	A->ccap = 0;
+	A->pcap = 0;
 
 	PetscFunctionReturn(0);
 }
@@ -366,36 +434,48 @@ PetscErrorCode AVDUpdateChain(AVD *A, const PetscInt ip)
 //---------------------------------------------------------------------------
 PetscErrorCode AVDReAlloc(AVDChain *chain, PetscInt buffer)
 {
-	PetscInt *temp;
+	// grow storage of claimed & boundary cells (capacity is doubled)
+	// allocation is serialized, since chains can be processed by multiple threads
+
+	PetscInt       *claim, *bound, iclaim, ibound;
+	PetscErrorCode  ierr;
 
 	
 	PetscFunctionBeginUser;
 
-	// 1. allocate memory for claimed cells
-	PetscCall(makeIntArray(&temp, NULL, chain->iclaim + buffer));
+	// get new capacity
+	iclaim = chain->iclaim + PetscMax(buffer, chain->iclaim);
+	ibound = chain->ibound + PetscMax(buffer, chain->ibound);
 
-	// copy current data
-	PetscCall(PetscMemcpy(temp, chain->claim, (size_t)(chain->nclaimed + buffer)*sizeof(PetscInt)));
-
-	// delete previous storage
-	PetscCall(PetscFree(chain->claim));
+	claim = NULL;
+	bound = NULL;
+	ierr  = 0;
 
-	// save new capacity & storage
-	chain->claim      = temp;
-	chain->iclaim    += buffer;
-
-	// 2. allocate memory for boundary cells
-	PetscCall(makeIntArray(&temp, NULL, chain->ibound + buffer));
+	// allocate new storage
+	OMP(critical(AVDAlloc))
+	{
+		ierr = PetscMalloc1((size_t)(iclaim + buffer), &claim);
+		if(!ierr) ierr = PetscMalloc1((size_t)(ibound + buffer), &bound);
+	}
+	PetscCall(ierr);
 
 	// copy current data
-	PetscCall(PetscMemcpy(temp, chain->bound, (size_t)(chain->length + buffer)*sizeof(PetscInt)));
+	PetscCall(PetscMemcpy(claim, chain->claim, (size_t)(chain->nclaimed + buffer)*sizeof(PetscInt)));
+	PetscCall(PetscMemcpy(bound, chain->bound, (size_t)(chain->length   + buffer)*sizeof(PetscInt)));
 
 	// delete previous storage
-	PetscCall(PetscFree(chain->bound));
+	OMP(critical(AVDAlloc))
+	{
+		ierr = PetscFree(chain->claim);
+		if(!ierr) ierr = PetscFree(chain->bound);
+	}
+	PetscCall(ierr);
 
 	// save new capacity & storage
-	chain->bound      = temp;
-	chain->ibound    += buffer;
+	chain->claim  = claim;
+	chain->bound  = bound;
+	chain->iclaim = iclaim;
+	chain->ibound = ibound;
 
 	PetscFunctionReturn(0);
 }
@@ -409,7 +489,7 @@ PetscErrorCode AVDLoadPoints(AdvCtx *actx, AVD *A, PetscInt ind)
 	for (i = 0; i < A->npoints; i++)
 	{
 		// get index
-		ii = actx->markind[actx->markstart[ind] + i];
+		ii = actx->markstart[ind] + i;
 
 		// save marker
 		A->points[i] = actx->markers[ii];
@@ -613,6 +693,9 @@ PetscErrorCode AVDExecuteMarkerInjection(AdvCtx *actx, PetscInt npoints, PetscSc
 	
 	PetscFunctionBeginUser;
 
+	// clear storage
+	PetscCall(PetscMemzero(&A, sizeof(AVD)));
+
 	// initialize some parameters
 	A.nx = actx->avdx;
 	A.ny = actx->avdy;
@@ -675,6 +758,8 @@ PetscErrorCode AVDMarkerControl(AdvCtx *actx)
 	
 	PetscFunctionBeginUser;
 
+	PetscCall(PerfBegin(_PERF_AVD_));
+
 	// AVD routine for every control volume
 	PetscCall(AVDMarkerControlMV(actx, _CELL_)); // CELLS
 
@@ -684,6 +769,8 @@ PetscErrorCode AVDMarkerControl(AdvCtx *actx)
 
 	PetscCall(AVDMarkerControlMV(actx, _YZED_)); // YZ Edge
 
+	PetscCall(PerfEnd(_PERF_AVD_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -718,9 +805,13 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype)
 PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 {
 	// check marker distribution and delete or inject markers if necessary
+	// AVD of every control volume is computed independently (optionally by multiple threads)
+	// injected & deleted markers are stored at precomputed offsets in the order of volumes,
+	// i.e. result does not depend on the number of threads and scheduling
 	PetscScalar    xs[3], xe[3];
-	PetscInt       ind, i, j, k, M, N;
+	PetscInt       ind, i, j, k, M, N, iv, nvol, nt, npmax, ncells;
 	PetscInt       n, ninj, ndel, nmin;
+	PetscInt      *vind, *vinj, *vdel;
 	PetscLogDouble t0,t1;
 	char           lbl[_lbl_sz_];
 
@@ -734,15 +825,23 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	M = mv->M;
 	N = mv->N;
 
+	// allocate list of control volumes & output offsets
+	PetscCall(makeIntArray(&vind, NULL, mv->ncells+1));
+	PetscCall(makeIntArray(&vinj, NULL, mv->ncells+1));
+	PetscCall(makeIntArray(&vdel, NULL, mv->ncells+1));
+
 	// calculate storage
-	ninj = 0;
-	ndel = 0;
+	ninj  = 0;
+	ndel  = 0;
+	nvol  = 0;
+	npmax = 0;
+
 	for(ind = 0; ind < mv->ncells; ind++)
 	{
 		// no of markers in cell
 		n = mv->markstart[ind+1] - mv->markstart[ind];
 
-		if (n < actx->nmin)
+		if ((n < actx->nmin) || (n > actx->nmax))
 		{
 			// expand i, j, k cell indices
 			GET_CELL_IJK(ind, i, j, k, M, N);
@@ -753,17 +852,35 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
 			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
 
-			if (n < nmin)
+			if ((n < nmin) || (n > actx->nmax))
 			{
-				if ((nmin - n) > n) ninj += n;
-				else                ninj += nmin - n;
+				// store volume & output offsets
+				vind[nvol] = ind;
+				vinj[nvol] = ninj;
+				vdel[nvol] = ndel;
+				nvol++;
+
+				if (n < nmin)
+				{
+					if ((nmin - n) > n) ninj += n;
+					else                ninj += nmin - n;
+				}
+				if (n > actx->nmax) ndel += n - actx->nmax;
+
+				if (n > npmax) npmax = n;
 			}
 		}
-		if (n > actx->nmax) ndel += n - actx->nmax;
 	}
 
 	// if no need for injection/deletion
-	if ((!ninj) && (!ndel)) PetscFunctionReturn(0);
+	if ((!ninj) && (!ndel))
+	{
+		PetscCall(PetscFree(vind));
+		PetscCall(PetscFree(vinj));
+		PetscCall(PetscFree(vdel));
+
+		PetscFunctionReturn(0);
+	}
 
 	actx->nrecv = ninj;
 	actx->ndel  = ndel;
@@ -772,39 +889,58 @@ PetscErrorCode AVDCheckCellsMV(AdvCtx *actx, MarkerVolume *mv, PetscInt dir)
 	if(ninj) { PetscCall(PetscMalloc((size_t)actx->nrecv*sizeof(Marker),   &actx->recvbuf)); }
 	if(ndel) { PetscCall(PetscMalloc((size_t)actx->ndel *sizeof(PetscInt), &actx->idel   )); }
 
-	actx->cinj = 0;
-	actx->cdel = 0;
+	// create thread-local AVD storage (reused between calls)
+	nt = actx->avdthreads;
+
+	if(!actx->avd)
+	{
+		PetscCall(PetscMalloc((size_t)nt*sizeof(AVD), &actx->avd));
+		PetscCall(PetscMemzero(actx->avd, (size_t)nt*sizeof(AVD)));
+	}
+
+	// reserve storage for the largest volume (only chains can grow inside threads)
+	ncells = (actx->avdx+2)*(actx->avdy+2)*(actx->avdz+2);
+
+	for(i = 0; i < nt; i++)
+	{
+		PetscCall(AVDReserve(&actx->avd[i], ncells, npmax));
+	}
 
 	// inject/delete
-	for(ind = 0; ind < mv->ncells; ind++)
+	OMP(parallel for num_threads(nt) schedule(dynamic, 1) private(iv, ind, i, j, k, n, nmin, xs, xe))
+	for(iv = 0; iv < nvol; iv++)
 	{
+		ind = vind[iv];
+
 		// no of markers in cell
 		n = mv->markstart[ind+1] - mv->markstart[ind];
 
-		if ((n < actx->nmin) || (n > actx->nmax))
-		{
-			// expand i, j, k cell indices
-			GET_CELL_IJK(ind, i, j, k, M, N);
+		// expand i, j, k cell indices
+		GET_CELL_IJK(ind, i, j, k, M, N);
 
-			// get cell coordinates
-			xs[0] = mv->xcoord[i]; xe[0] = mv->xcoord[i+1];
-			xs[1] = mv->ycoord[j]; xe[1] = mv->ycoord[j+1];
-			xs[2] = mv->zcoord[k]; xe[2] = mv->zcoord[k+1];
+		// get cell coordinates
+		xs[0] = mv->xcoord[i]; xe[0] = mv->xcoord[i+1];
+		xs[1] = mv->ycoord[j]; xe[1] = mv->ycoord[j+1];
+		xs[2] = mv->zcoord[k]; xe[2] = mv->zcoord[k+1];
 
-			// here calculate half volumes minimum
-			nmin = actx->nmin;
-			if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
-			if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
+		// here calculate half volumes minimum
+		nmin = actx->nmin;
+		if ((dir == 0) && ((i == 0) | (i+1 == mv->M))) { nmin = (PetscInt) (actx->nmin/2+1); }
+		if ((dir == 1) && ((j == 0) | (j+1 == mv->N))) { nmin = (PetscInt) (actx->nmin/2+1); }
+		if ((dir == 2) && ((k == 0) | (k+1 == mv->P))) { nmin = (PetscInt) (actx->nmin/2+1); }
 
-			// inject/delete markers
-			if ((n < nmin) || (n > actx->nmax))
-			{
-				PetscCall(AVDAlgorithmMV(actx, mv, n, xs, xe, ind, nmin));
-			}
-		}
+		// inject/delete markers
+		PetscCallAbort(PETSC_COMM_SELF, AVDAlgorithmMV(actx, mv, &actx->avd[getThreadID()], n, xs, xe, ind, nmin, vinj[iv], vdel[iv]));
 	}
 
+	// set total counters
+	actx->cinj = ninj;
+	actx->cdel = ndel;
+
+	PetscCall(PetscFree(vind));
+	PetscCall(PetscFree(vinj));
+	PetscCall(PetscFree(vdel));
+
 	// store new markers
 	PetscCall(ADVCollectGarbage(actx));
 
@@ -1010,7 +1146,7 @@ PetscErrorCode AVDLoadPointsMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
+PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A, PetscInt cinj)
 {
 	FDSTAG     *fs;
 	BCCtx      *bc;
@@ -1031,9 +1167,9 @@ PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
 	npoints = A->npoints;
 	n  = (A->nx+2)*(A->ny+2)*(A->nz+2);
 
-	// allocate memory for sorting
-	PetscCall(makeIntArray(&area, NULL, npoints));
-	PetscCall(makeIntArray(&sind, NULL, npoints));
+	// get sorting buffers
+	area = A->area;
+	sind = A->sind;
 
 	// compute dominant axis
 	for (i = 0; i < npoints; i++)
@@ -1151,37 +1287,31 @@ PetscErrorCode AVDInjectPointsMV(AdvCtx *actx, AVD *A)
 		num_chain = sind[ind];
 
 		// inject same properties as parent marker except for position
-		actx->recvbuf[actx->cinj+i]      = A->points[num_chain];
-		actx->recvbuf[actx->cinj+i].X[0] = A->chain [num_chain].xc[0];
-		actx->recvbuf[actx->cinj+i].X[1] = A->chain [num_chain].xc[1];
-		actx->recvbuf[actx->cinj+i].X[2] = A->chain [num_chain].xc[2];
+		actx->recvbuf[cinj+i]      = A->points[num_chain];
+		actx->recvbuf[cinj+i].X[0] = A->chain [num_chain].xc[0];
+		actx->recvbuf[cinj+i].X[1] = A->chain [num_chain].xc[1];
+		actx->recvbuf[cinj+i].X[2] = A->chain [num_chain].xc[2];
 
 		// --- this is not ideal with multiple control volumes (i.e. use mv for BCOverridePhase) ---
 		// find I, J, K indices by bisection algorithm
-		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, actx->recvbuf[actx->cinj+i].X[0]);
-		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, actx->recvbuf[actx->cinj+i].X[1]);
-		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, actx->recvbuf[actx->cinj+i].X[2]);
+		I = FindPointInCell(fs->dsx.ncoor, 0, fs->dsx.ncels, actx->recvbuf[cinj+i].X[0]);
+		J = FindPointInCell(fs->dsy.ncoor, 0, fs->dsy.ncels, actx->recvbuf[cinj+i].X[1]);
+		K = FindPointInCell(fs->dsz.ncoor, 0, fs->dsz.ncels, actx->recvbuf[cinj+i].X[2]);
 
 		// compute and store consecutive index
 		GET_CELL_ID(cellID, I, J, K, fs->dsx.ncels, fs->dsy.ncels);
 
 		// override marker phase (if necessary) - need to calculate cellID
-		PetscCall(BCOverridePhase(bc, cellID, actx->recvbuf + actx->cinj + i));
+		PetscCall(BCOverridePhase(bc, cellID, actx->recvbuf + cinj + i));
 		// -----------------------------------------------------------------------------------------
 
 		ind--;
 	}
-	// update total counter
-	actx->cinj +=new_nmark;
-
-	// free memory
-	PetscCall(PetscFree(area));
-	PetscCall(PetscFree(sind));
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A)
+PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A, PetscInt cdel)
 {
 	PetscInt    i, ind;
 	PetscInt    num_chain;
@@ -1194,9 +1324,9 @@ PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A)
 	npoints = A->npoints;
 	new_nmark = npoints - A->mmax;
 
-	// allocate memory for sorting
-	PetscCall(makeIntArray(&area, NULL, npoints));
-	PetscCall(makeIntArray(&sind, NULL, npoints));
+	// get sorting buffers
+	area = A->area;
+	sind = A->sind;
 
 	// initialize variables for sorting
 	for (i = 0; i < npoints; i++)
@@ -1212,59 +1342,54 @@ PetscErrorCode AVDDeletePointsMV(AdvCtx *actx, AVD *A)
 		for (i = 0; i < new_nmark; i++)
 		{
 			num_chain = sind[ind];
-			actx->idel[actx->cdel+i] = A->chain[num_chain].gind;
+			actx->idel[cdel+i] = A->chain[num_chain].gind;
 			ind++;
 
 		}
-		// update total counter
-		actx->cdel +=new_nmark;
-
-	// free memory
-	PetscCall(PetscFree(area));
-	PetscCall(PetscFree(sind));
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin)
+PetscErrorCode AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin, PetscInt cinj, PetscInt cdel)
 {
+	// compute AVD of a control volume in reusable storage,
+	// store injected & deleted markers starting from given offsets
 
-	AVD          A;
 	PetscInt     i,claimed;
 
 	
 	PetscFunctionBeginUser;
 
 	// initialize some parameters
-	A.nx = actx->avdx;
-	A.ny = actx->avdy;
-	A.nz = actx->avdz;
+	A->nx = actx->avdx;
+	A->ny = actx->avdy;
+	A->nz = actx->avdz;
 
-	A.mmin = nmin;
-	A.mmax = actx->nmax;
+	A->mmin = nmin;
+	A->mmax = actx->nmax;
 
-	A.npoints = npoints;
+	A->npoints = npoints;
 
-	A.xs[0] = xs[0];
-	A.xs[1] = xs[1];
-	A.xs[2] = xs[2];
+	A->xs[0] = xs[0];
+	A->xs[1] = xs[1];
+	A->xs[2] = xs[2];
 
-	A.xe[0] = xe[0];
-	A.xe[1] = xe[1];
-	A.xe[2] = xe[2];
+	A->xe[0] = xe[0];
+	A->xe[1] = xe[1];
+	A->xe[2] = xe[2];
 
-	A.dx = (xe[0]-xs[0])/(PetscScalar)A.nx;
-	A.dy = (xe[1]-xs[1])/(PetscScalar)A.ny;
-	A.dz = (xe[2]-xs[2])/(PetscScalar)A.nz;
+	A->dx = (xe[0]-xs[0])/(PetscScalar)A->nx;
+	A->dy = (xe[1]-xs[1])/(PetscScalar)A->ny;
+	A->dz = (xe[2]-xs[2])/(PetscScalar)A->nz;
 
-	// create AVD structure
-	PetscCall(AVDCreate(&A));
+	// initialize AVD structure
+	PetscCall(AVDCreate(A));
 
 	// load particles
-	PetscCall(AVDLoadPointsMV(actx,mv,&A,ind));
+	PetscCall(AVDLoadPointsMV(actx,mv,A,ind));
 
 	// initialize AVD cells
-	PetscCall(AVDCellInit(&A));
+	PetscCall(AVDCellInit(A));
 
 	// do AVD algorithm
 	claimed = 1;
@@ -1273,20 +1398,17 @@ PetscErrorCode AVDAlgorithmMV(AdvCtx *actx, MarkerVolume *mv, PetscInt npoints,
 		claimed = 0;
 		for (i = 0; i < npoints; i++)
 		{
-			PetscCall(AVDClaimCells(&A,i));
-			claimed += A.chain[i].nclaimed;
-			PetscCall(AVDUpdateChain(&A,i));
+			PetscCall(AVDClaimCells(A,i));
+			claimed += A->chain[i].nclaimed;
+			PetscCall(AVDUpdateChain(A,i));
 		}
 	}
 
 	// inject markers
-	if (A.npoints < A.mmin) { PetscCall(AVDInjectPointsMV(actx, &A)); }
+	if (A->npoints < A->mmin) { PetscCall(AVDInjectPointsMV(actx, A, cinj)); }
 
 	// delete markers
-	if (A.npoints > A.mmax) { PetscCall(AVDDeletePointsMV(actx, &A)); }
-
-	// destroy AVD structure
-	PetscCall(AVDDestroy(&A));
+	if (A->npoints > A->mmax) { PetscCall(AVDDeletePointsMV(actx, A, cdel)); }
 
 	PetscFunctionReturn(0);
 }
@@ -63,6 +63,8 @@ struct AVD
 	AVDChain    *chain;                    // voronoi chain for every point (size of npoints)
 	Marker      *points;                   // points that we want to compute voronoi diagram (size of npoints)
 	PetscInt    npoints;                   // no. markers
+	PetscInt    ccap, pcap;                // capacity of cell & point storage (storage is reused)
+	PetscInt    *area, *sind;              // sorting buffers (size of pcap)
 
 } ;
 
@@ -90,6 +92,7 @@ enum VolumeCase
 
 // basic AVD routines
 PetscErrorCode AVDCreate     (AVD *A);
+PetscErrorCode AVDReserve    (AVD *A, PetscInt ncells, PetscInt npoints);
 PetscErrorCode AVDDestroy    (AVD *A);
 PetscErrorCode AVDCellInit   (AVD *A);
 PetscErrorCode AVDClaimCells (AVD *A, const PetscInt ip);
@@ -107,10 +110,10 @@ PetscErrorCode AVDMarkerControlMV(AdvCtx *actx, VolumeCase vtype);
 PetscErrorCode AVDCheckCellsMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDMapMarkersMV   (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
 PetscErrorCode AVDCreateMV       (AdvCtx *actx, MarkerVolume *mv, PetscInt dir);
-PetscErrorCode AVDAlgorithmMV    (AdvCtx *actx, MarkerVolume *mv, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin);
+PetscErrorCode AVDAlgorithmMV    (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt npoints, PetscScalar xs[3], PetscScalar xe[3], PetscInt ind, PetscInt nmin, PetscInt cinj, PetscInt cdel);
 PetscErrorCode AVDLoadPointsMV   (AdvCtx *actx, MarkerVolume *mv, AVD *A, PetscInt ind);
-PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, AVD *A);
-PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, AVD *A);
+PetscErrorCode AVDInjectPointsMV (AdvCtx *actx, AVD *A, PetscInt cinj);
+PetscErrorCode AVDDeletePointsMV (AdvCtx *actx, AVD *A, PetscInt cdel);
 PetscErrorCode AVDDestroyMV      (MarkerVolume *mv);
 
 //---------------------------------------------------------------------------
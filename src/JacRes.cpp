@@ -24,6 +24,7 @@
 #include "Tensor.h"
 #include "advect.h"
 #include "dike.h"
+#include "perfLog.h"
 //---------------------------------------------------------------------------
 PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 {
@@ -61,6 +62,7 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	ctrl->mfmax        =  1.0;
 	ctrl->lmaxit       =  25;
 	ctrl->lrtol        =  1e-6;
+	ctrl->nthreads     =  1;
 	ctrl->actTemp	   =  0;			// diffusion is not active by default (otherwise we have to define thermal properties in all cases)
 	ctrl->printNorms   =  0;			// print norms of velocity/pressure/temperature?
 	ctrl->Adiabatic_gr = 0.0;
@@ -106,6 +108,7 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	PetscCall(getScalarParam(fb, _OPTIONAL_, "mfmax",           &ctrl->mfmax,          1, 1.0));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "lmaxit",          &ctrl->lmaxit,         1, 1000));
 	PetscCall(getScalarParam(fb, _OPTIONAL_, "lrtol",           &ctrl->lrtol,          1, 1.0));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "res_num_threads", &ctrl->nthreads,       1, -1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "Phasetrans",      &ctrl->Phasetrans,     1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "Passive_Tracer",  &ctrl->Passive_Tracer, 1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "printNorms", 	 &ctrl->printNorms,     1, 1));
@@ -236,6 +239,17 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Specify reference viscosity for initial guess (init_guess, eta_ref) \n");
 	}
 
+	// limit number of threads to available, phase diagrams share interpolation buffer
+	ctrl->nthreads = getNumThreads(ctrl->nthreads);
+
+	for(i = 0; i < numPhases; i++)
+	{
+		if(jr->dbm->phases[i].pdAct) ctrl->nthreads = 1;
+	}
+
+	// constitutive update threads call PETSc error handling
+	PetscCall(checkThreadSafety("res_num_threads", ctrl->nthreads));
+
 	if(ctrl->rescal)
 	{
 		PetscCall(PetscOptionsGetInt (NULL, NULL, "-gmg_mat_free_levels", &nlmf, NULL));
@@ -283,6 +297,7 @@ PetscErrorCode JacResCreate(JacRes *jr, FB *fb)
 	if(ctrl->mfmax)          PetscPrintf(PETSC_COMM_WORLD, "   Max. melt fraction (viscosity, density) : %g    \n", ctrl->mfmax);
 	if(ctrl->lmaxit)         PetscPrintf(PETSC_COMM_WORLD, "   Rheology iteration number               : %lld  \n", (LLD) ctrl->lmaxit);
 	if(ctrl->lrtol)          PetscPrintf(PETSC_COMM_WORLD, "   Rheology iteration tolerance            : %g    \n", ctrl->lrtol);
+	if(ctrl->nthreads > 1)   PetscPrintf(PETSC_COMM_WORLD, "   Residual evaluation threads per rank    : %lld  \n", (LLD) ctrl->nthreads);
 	if(ctrl->Adiabatic_gr)   PetscPrintf(PETSC_COMM_WORLD, "   Adiabatic gradient                      : %g    \n", ctrl->Adiabatic_gr);
 	if(ctrl->Phasetrans)     PetscPrintf(PETSC_COMM_WORLD, "   Phase transitions are active            @ \n");
 	if(ctrl->Passive_Tracer) PetscPrintf(PETSC_COMM_WORLD, "   Passive Tracers are active              @ \n");
@@ -505,6 +520,66 @@ PetscErrorCode JacResWriteRestart(JacRes *jr, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode JacResViewRestart(JacRes *jr, PetscViewer viewer)
+{
+	// store solution components in natural ordering (independent of partitioning)
+
+	PetscFunctionBeginUser;
+
+	// copy coupled solution to component vectors
+	PetscCall(JacResCopySol(jr, jr->gsol));
+
+	PetscCall(VecView(jr->gvx, viewer));
+	PetscCall(VecView(jr->gvy, viewer));
+	PetscCall(VecView(jr->gvz, viewer));
+	PetscCall(VecView(jr->gp,  viewer));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode JacResLoadRestart(JacRes *jr, PetscViewer viewer)
+{
+	FDSTAG      *fs;
+	PetscScalar *vx, *vy, *vz, *p, *sol, *iter;
+
+	PetscFunctionBeginUser;
+
+	fs = jr->fs;
+
+	PetscCall(VecLoad(jr->gvx, viewer));
+	PetscCall(VecLoad(jr->gvy, viewer));
+	PetscCall(VecLoad(jr->gvz, viewer));
+	PetscCall(VecLoad(jr->gp,  viewer));
+
+	// assemble coupled solution vector
+	PetscCall(VecGetArray(jr->gvx,  &vx));
+	PetscCall(VecGetArray(jr->gvy,  &vy));
+	PetscCall(VecGetArray(jr->gvz,  &vz));
+	PetscCall(VecGetArray(jr->gp,   &p));
+	PetscCall(VecGetArray(jr->gsol, &sol));
+
+	iter = sol;
+
+	PetscCall(PetscMemcpy(iter, vx, (size_t)fs->nXFace*sizeof(PetscScalar)));
+	iter += fs->nXFace;
+
+	PetscCall(PetscMemcpy(iter, vy, (size_t)fs->nYFace*sizeof(PetscScalar)));
+	iter += fs->nYFace;
+
+	PetscCall(PetscMemcpy(iter, vz, (size_t)fs->nZFace*sizeof(PetscScalar)));
+	iter += fs->nZFace;
+
+	PetscCall(PetscMemcpy(iter, p,  (size_t)fs->nCells*sizeof(PetscScalar)));
+
+	PetscCall(VecRestoreArray(jr->gvx,  &vx));
+	PetscCall(VecRestoreArray(jr->gvy,  &vy));
+	PetscCall(VecRestoreArray(jr->gvz,  &vz));
+	PetscCall(VecRestoreArray(jr->gp,   &p));
+	PetscCall(VecRestoreArray(jr->gsol, &sol));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode JacResDestroy(JacRes *jr)
 {
 
@@ -585,6 +660,8 @@ PetscErrorCode JacResFormResidual(JacRes *jr, Vec x, Vec f)
 	
 	PetscFunctionBeginUser;
 
+	PetscCall(PerfBegin(_PERF_RESIDUAL_));
+
 	// copy solution from global to local vectors, enforce boundary constraints
 	PetscCall(JacResCopySol(jr, x));
 
@@ -606,6 +683,8 @@ PetscErrorCode JacResFormResidual(JacRes *jr, Vec x, Vec f)
 	// copy residuals to global vector
 	PetscCall(JacResCopyRes(jr, f));
 
+	PetscCall(PerfEnd(_PERF_RESIDUAL_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1017,8 +1096,8 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	BCCtx      *bc;
 	SolVarCell *svCell;
 	SolVarEdge *svEdge;
-	ConstEqCtx  ctx;
-	PetscInt    iter;
+	ConstEqCtx *ctx, *cctx;
+	PetscInt    iter, color, ncolor, nt, it, ib, ie;
 	PetscInt    periodic;
 	PetscInt    I1, I2, J1, J2, K1, K2;
 	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz, mx, my, mz, mcx, mcy, mcz;
@@ -1028,7 +1107,7 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	PetscScalar XY, XY1, XY2, XY3, XY4;
 	PetscScalar XZ, XZ1, XZ2, XZ3, XZ4;
 	PetscScalar YZ, YZ1, YZ2, YZ3, YZ4;
-	PetscScalar dikeRHS, y_c;
+	PetscScalar dikeRHS, y_c, dRHS[_max_batch_size_];
 	PetscScalar bdx, fdx, bdy, fdy, bdz, fdz, dx, dy, dz, Le;
 	PetscScalar gx, gy, gz, tx, ty, tz, sxx, syy, szz, sxy, sxz, syz, gres;
 	PetscScalar J2Inv, DII, z, rho, Tc, pc, pc_lith, pc_pore, dt, fssa, *grav;
@@ -1059,8 +1138,19 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	// set periodic flag
 	periodic = fs->periodic;
 
-	// setup constitutive equation evaluation context parameters
-	PetscCall(setUpConstEq(&ctx, jr));
+	// get number of threads
+	nt = jr->ctrl.nthreads;
+
+	// set number of plane colors (single thread keeps the plane order of the sequential loop)
+	ncolor = (nt > 1) ? 2 : 1;
+
+	// setup constitutive equation evaluation context parameters (one per thread)
+	PetscCall(PetscMalloc1(nt, &ctx));
+
+	for(it = 0; it < nt; it++)
+	{
+		PetscCall(setUpConstEq(&ctx[it], jr));
+	}
 
 	// clear local residual vectors
 	PetscCall(VecZeroEntries(jr->lfx));
@@ -1088,458 +1178,596 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	PetscCall(DMDAVecGetArray(fs->DA_CEN, jr->lp_pore, &p_pore));
 	PetscCall(DMDAVecGetArray(fs->DA_CEN, bc->bcp,     &bcp));
 
+	// constitutive update & residual assembly
+	PetscCall(PerfBegin(_PERF_CONSTEQ_));
+
 	//-------------------------------
 	// central points
 	//-------------------------------
-	iter = 0;
-
 	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
 
-	START_STD_LOOP
+	// process planes of alternating colors to avoid write conflicts in the residual
+	for(color = 0; color < ncolor; color++)
 	{
-		// access solution variables
-		svCell = &jr->svCell[iter++];
-
-		//=================
-		// SECOND INVARIANT
-		//=================
-		if (jr->ctrl.actDike)
+		OMP(parallel for num_threads(nt) schedule(static) private(i, j, ib, ie, iter, cctx, svCell, y_c, dikeRHS, dRHS, XX, YY, ZZ, XY1, XY2, XY3, XY4, XZ1, XZ2, XZ3, XZ4, YZ1, YZ2, YZ3, YZ4, J2Inv, DII, pc, Tc, pc_lith, pc_pore, z, dx, dy, dz, Le, sxx, syy, szz, gres, rho, gx, gy, gz, tx, ty, tz, bdx, fdx, bdy, fdy, bdz, fdz))
+		START_COLOR_BLOCK_LOOP(color, ncolor)
 		{
-			y_c = COORD_CELL(j,sy,fs->dsy);
-
-			dikeRHS = 0.0;
-
-			// function that computes dikeRHS (additional divergence due to dike) depending on the phase ratio
-			PetscCall(GetDikeContr(&ctx, svCell->phRat, jr->surf->AirPhase, dikeRHS, y_c, j-sy));
-
-			// remove dike contribution to strain rate from deviatoric strain rate (for xx, yy and zz components) prior to computing momentum equation
-			dxx[k][j][i] -=  (2.0/3.0) * dikeRHS;
-			dyy[k][j][i] -= -(1.0/3.0) * dikeRHS;
-			dzz[k][j][i] -= -(1.0/3.0) * dikeRHS;
-		}
-
-		// access strain rates
-		XX = dxx[k][j][i];
-		YY = dyy[k][j][i];
-		ZZ = dzz[k][j][i];
+			cctx = &ctx[getThreadID()];
+
+			// clear evaluation batch
+			ConstEqBatchClear(&cctx->batch);
+
+			// store control volumes of the block in the batch
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svCell = &jr->svCell[iter];
+
+				//=================
+				// SECOND INVARIANT
+				//=================
+				if (jr->ctrl.actDike)
+				{
+					y_c = COORD_CELL(j,sy,fs->dsy);
+
+					dikeRHS = 0.0;
+
+					// function that computes dikeRHS (additional divergence due to dike) depending on the phase ratio
+					PetscCallAbort(PETSC_COMM_SELF, GetDikeContr(cctx, svCell->phRat, jr->surf->AirPhase, dikeRHS, y_c, j-sy));
+
+					// remove dike contribution to strain rate from deviatoric strain rate (for xx, yy and zz components) prior to computing momentum equation
+					dxx[k][j][i] -=  (2.0/3.0) * dikeRHS;
+					dyy[k][j][i] -= -(1.0/3.0) * dikeRHS;
+					dzz[k][j][i] -= -(1.0/3.0) * dikeRHS;
+
+					// store dike contribution
+					dRHS[i-ib] = dikeRHS;
+				}
+
+				// access strain rates
+				XX = dxx[k][j][i];
+				YY = dyy[k][j][i];
+				ZZ = dzz[k][j][i];
 		
-		// x-y plane, i-j indices
-		XY1 = dxy[k][j][i];
-		XY2 = dxy[k][j+1][i];
-		XY3 = dxy[k][j][i+1];
-		XY4 = dxy[k][j+1][i+1];
-
-		// x-z plane, i-k indices
-		XZ1 = dxz[k][j][i];
-		XZ2 = dxz[k+1][j][i];
-		XZ3 = dxz[k][j][i+1];
-		XZ4 = dxz[k+1][j][i+1];
-
-		// y-z plane, j-k indices
-		YZ1 = dyz[k][j][i];
-		YZ2 = dyz[k+1][j][i];
-		YZ3 = dyz[k][j+1][i];
-		YZ4 = dyz[k+1][j+1][i];
-
-		// compute second invariant
-		J2Inv = 0.5*(XX*XX + YY*YY + ZZ*ZZ) +
-		0.25*(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
-		0.25*(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4) +
-		0.25*(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
-
-		DII = sqrt(J2Inv);
-
-		//=======================
-		// CONSTITUTIVE EQUATIONS
-		//=======================
-
-		// access current pressure
-		pc = p[k][j][i];
-
-		// current temperature
-		Tc = T[k][j][i];
-
-		// access current lithostatic pressure
-		pc_lith = p_lith[k][j][i];
-
-		// access current pore pressure (zero if deactivated)
-		pc_pore = p_pore[k][j][i];
-
-		// z-coordinate of control volume
-		z = COORD_CELL(k, sz, fs->dsz);
-
-		// get characteristic element size
-		dx = SIZE_CELL(i, sx, fs->dsx);
-		dy = SIZE_CELL(j, sy, fs->dsy);
-		dz = SIZE_CELL(k, sz, fs->dsz);
-		Le = sqrt(dx*dx + dy*dy + dz*dz);
-
-		// setup control volume parameters
-		PetscCall(setUpCtrlVol(&ctx, svCell->phRat, &svCell->svDev, &svCell->svBulk, pc, pc_lith, pc_pore, Tc, DII, z, Le));
-
-		// evaluate constitutive equations on the cell
-		PetscCall(cellConstEq(&ctx, svCell, XX, YY, ZZ, sxx, syy, szz, gres, rho, dikeRHS));
+				// x-y plane, i-j indices
+				XY1 = dxy[k][j][i];
+				XY2 = dxy[k][j+1][i];
+				XY3 = dxy[k][j][i+1];
+				XY4 = dxy[k][j+1][i+1];
+
+				// x-z plane, i-k indices
+				XZ1 = dxz[k][j][i];
+				XZ2 = dxz[k+1][j][i];
+				XZ3 = dxz[k][j][i+1];
+				XZ4 = dxz[k+1][j][i+1];
+
+				// y-z plane, j-k indices
+				YZ1 = dyz[k][j][i];
+				YZ2 = dyz[k+1][j][i];
+				YZ3 = dyz[k][j+1][i];
+				YZ4 = dyz[k+1][j+1][i];
+
+				// compute second invariant
+				J2Inv = 0.5*(XX*XX + YY*YY + ZZ*ZZ) +
+				0.25*(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
+				0.25*(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4) +
+				0.25*(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
+
+				DII = sqrt(J2Inv);
+
+				//=======================
+				// CONSTITUTIVE EQUATIONS
+				//=======================
+
+				// access current pressure
+				pc = p[k][j][i];
+
+				// current temperature
+				Tc = T[k][j][i];
+
+				// access current lithostatic pressure
+				pc_lith = p_lith[k][j][i];
+
+				// access current pore pressure (zero if deactivated)
+				pc_pore = p_pore[k][j][i];
+
+				// z-coordinate of control volume
+				z = COORD_CELL(k, sz, fs->dsz);
+
+				// get characteristic element size
+				dx = SIZE_CELL(i, sx, fs->dsx);
+				dy = SIZE_CELL(j, sy, fs->dsy);
+				dz = SIZE_CELL(k, sz, fs->dsz);
+				Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+				// setup control volume parameters
+				PetscCallAbort(PETSC_COMM_SELF, setUpCtrlVol(cctx, svCell->phRat, &svCell->svDev, &svCell->svBulk, pc, pc_lith, pc_pore, Tc, DII, z, Le));
+
+				// store control volume and its phases in the batch
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqAdd(cctx));
+			}
+
+			// compute phase viscosities of all control volumes in the block
+			ConstEqBatchSolve(&cctx->batch, jr->ctrl.lrtol, jr->ctrl.lmaxit);
+
+			// evaluate constitutive equations and residuals of the block
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svCell = &jr->svCell[iter];
+
+				// access strain rates
+				XX = dxx[k][j][i];
+				YY = dyy[k][j][i];
+				ZZ = dzz[k][j][i];
+
+				// restore control volume and collect its results
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqGet(cctx, i-ib));
+
+				// evaluate constitutive equations on the cell
+				PetscCallAbort(PETSC_COMM_SELF, cellConstEq(cctx, svCell, XX, YY, ZZ, sxx, syy, szz, gres, rho, dRHS[i-ib]));
 		
-		// compute gravity terms
-		gx = rho*grav[0];
-		gy = rho*grav[1];
-		gz = rho*grav[2];
-
-		// compute stabilization terms (lumped approximation)
-		tx = -fssa*dt*gx;
-		ty = -fssa*dt*gy;
-		tz = -fssa*dt*gz;
-
-		//=========
-		// RESIDUAL
-		//=========
-
-		// get mesh steps for the backward and forward derivatives
-		bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
-		bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
-		bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
-
-		// momentum
-		fx[k][j][i] -= (sxx + (vx[k][j][i])*tx)/bdx + gx/2.0;   fx[k][j][i+1] += (sxx + (vx[k][j][i+1])*tx)/fdx - gx/2.0;
-		fy[k][j][i] -= (syy + (vy[k][j][i])*ty)/bdy + gy/2.0;   fy[k][j+1][i] += (syy + (vy[k][j+1][i])*ty)/fdy - gy/2.0;
-		fz[k][j][i] -= (szz + (vz[k][j][i])*tz)/bdz + gz/2.0;   fz[k+1][j][i] += (szz + (vz[k+1][j][i])*tz)/fdz - gz/2.0;
-
-		// pressure boundary constraints
-		if(i == 0   && bcp[k][j][i-1] != DBL_MAX) fx[k][j][i]   += -p[k][j][i-1]/bdx;
-		if(i == mcx && bcp[k][j][i+1] != DBL_MAX) fx[k][j][i+1] -= -p[k][j][i+1]/fdx;
-		if(j == 0   && bcp[k][j-1][i] != DBL_MAX) fy[k][j][i]   += -p[k][j-1][i]/bdy;
-		if(j == mcy && bcp[k][j+1][i] != DBL_MAX) fy[k][j+1][i] -= -p[k][j+1][i]/fdy;
-		if(k == 0   && bcp[k-1][j][i] != DBL_MAX) fz[k][j][i]   += -p[k-1][j][i]/bdz;
-		if(k == mcz && bcp[k+1][j][i] != DBL_MAX) fz[k+1][j][i] -= -p[k+1][j][i]/fdz;
-
-		// mass (volume)
-		gc[k][j][i] = gres;
-
+				// compute gravity terms
+				gx = rho*grav[0];
+				gy = rho*grav[1];
+				gz = rho*grav[2];
+
+				// compute stabilization terms (lumped approximation)
+				tx = -fssa*dt*gx;
+				ty = -fssa*dt*gy;
+				tz = -fssa*dt*gz;
+
+				//=========
+				// RESIDUAL
+				//=========
+
+				// get mesh steps for the backward and forward derivatives
+				bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+				bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+				bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+				// momentum
+				fx[k][j][i] -= (sxx + (vx[k][j][i])*tx)/bdx + gx/2.0;   fx[k][j][i+1] += (sxx + (vx[k][j][i+1])*tx)/fdx - gx/2.0;
+				fy[k][j][i] -= (syy + (vy[k][j][i])*ty)/bdy + gy/2.0;   fy[k][j+1][i] += (syy + (vy[k][j+1][i])*ty)/fdy - gy/2.0;
+				fz[k][j][i] -= (szz + (vz[k][j][i])*tz)/bdz + gz/2.0;   fz[k+1][j][i] += (szz + (vz[k+1][j][i])*tz)/fdz - gz/2.0;
+
+				// pressure boundary constraints
+				if(i == 0   && bcp[k][j][i-1] != DBL_MAX) fx[k][j][i]   += -p[k][j][i-1]/bdx;
+				if(i == mcx && bcp[k][j][i+1] != DBL_MAX) fx[k][j][i+1] -= -p[k][j][i+1]/fdx;
+				if(j == 0   && bcp[k][j-1][i] != DBL_MAX) fy[k][j][i]   += -p[k][j-1][i]/bdy;
+				if(j == mcy && bcp[k][j+1][i] != DBL_MAX) fy[k][j+1][i] -= -p[k][j+1][i]/fdy;
+				if(k == 0   && bcp[k-1][j][i] != DBL_MAX) fz[k][j][i]   += -p[k-1][j][i]/bdz;
+				if(k == mcz && bcp[k+1][j][i] != DBL_MAX) fz[k+1][j][i] -= -p[k+1][j][i]/fdz;
+
+				// mass (volume)
+				gc[k][j][i] = gres;
+			}
+		}
+		END_COLOR_BLOCK_LOOP
 	}
-	END_STD_LOOP
 
 	//-------------------------------
 	// xy edge points
 	//-------------------------------
-	iter = 0;
-
 	PetscCall(DMDAGetCorners(fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
 
-	START_STD_LOOP
+	// process planes of alternating colors to avoid write conflicts in the residual
+	for(color = 0; color < ncolor; color++)
 	{
-		// access solution variables
-		svEdge = &jr->svXYEdge[iter++];
-
-		//=================
-		// SECOND INVARIANT
-		//=================
-
-		// check index bounds
-		I1 = i;   if(!periodic && I1 == mx) I1--;
-		I2 = i-1; if(!periodic && I2 == -1) I2++;
-		J1 = j;   if(             J1 == my) J1--;
-		J2 = j-1; if(             J2 == -1) J2++;
-
-		// access strain rates
-		XY = dxy[k][j][i];
-
-		// x-y plane, i-j indices (i & j - bounded)
-		XX1 = dxx[k][J1][I1];
-		XX2 = dxx[k][J1][I2];
-		XX3 = dxx[k][J2][I1];
-		XX4 = dxx[k][J2][I2];
-
-		// x-y plane, i-j indices (i & j - bounded)
-		YY1 = dyy[k][J1][I1];
-		YY2 = dyy[k][J1][I2];
-		YY3 = dyy[k][J2][I1];
-		YY4 = dyy[k][J2][I2];
-
-		// x-y plane, i-j indices (i & j - bounded)
-		ZZ1 = dzz[k][J1][I1];
-		ZZ2 = dzz[k][J1][I2];
-		ZZ3 = dzz[k][J2][I1];
-		ZZ4 = dzz[k][J2][I2];
-
-		// y-z plane j-k indices (j - bounded)
-		XZ1 = dxz[k][J1][i];
-		XZ2 = dxz[k+1][J1][i];
-		XZ3 = dxz[k][J2][i];
-		XZ4 = dxz[k+1][J2][i];
-
-		// x-z plane i-k indices (i - bounded)
-		YZ1 = dyz[k][j][I1];
-		YZ2 = dyz[k+1][j][I1];
-		YZ3 = dyz[k][j][I2];
-		YZ4 = dyz[k+1][j][I2];
-
-		// compute second invariant
-		J2Inv = XY*XY +
-		0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
-		0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
-		0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
-		0.25 *(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4) +
-		0.25 *(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
-
-		DII = sqrt(J2Inv);
-
-		//=======================
-		// CONSTITUTIVE EQUATIONS
-		//=======================
-
-		// access current pressure (x-y plane, i-j indices)
-		pc  = 0.25*(p[k][j][i] + p[k][j][i-1] + p[k][j-1][i] + p[k][j-1][i-1]);
-
-		// current temperature (x-y plane, i-j indices)
-		Tc = 0.25*(T[k][j][i] + T[k][j][i-1] + T[k][j-1][i] + T[k][j-1][i-1]);
-
-		// access current lithostatic pressure (x-y plane, i-j indices)
-		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k][j-1][i] + p_lith[k][j-1][i-1]);
-
-		// access current pore pressure (x-y plane, i-j indices)
-		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k][j-1][i] + p_pore[k][j-1][i-1]);
-
-		// get characteristic element size
-		dx = SIZE_NODE(i, sx, fs->dsx);
-		dy = SIZE_NODE(j, sy, fs->dsy);
-		dz = SIZE_CELL(k, sz, fs->dsz);
-		Le = sqrt(dx*dx + dy*dy + dz*dz);
-
-		// setup control volume parameters
-		PetscCall(setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
-
-		// evaluate constitutive equations on the edge
-		PetscCall(edgeConstEq(&ctx, svEdge, XY, sxy));
-
-		//=========
-		// RESIDUAL
-		//=========
-
-		// get mesh steps for the backward and forward derivatives
-		bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
-		bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
-
-		// momentum
-		fx[k][j-1][i] -= sxy/bdy;   fx[k][j][i] += sxy/fdy;
-		fy[k][j][i-1] -= sxy/bdx;   fy[k][j][i] += sxy/fdx;
-
+		OMP(parallel for num_threads(nt) schedule(static) private(i, j, ib, ie, iter, cctx, svEdge, I1, I2, J1, J2, XY, XX1, XX2, XX3, XX4, YY1, YY2, YY3, YY4, ZZ1, ZZ2, ZZ3, ZZ4, XZ1, XZ2, XZ3, XZ4, YZ1, YZ2, YZ3, YZ4, J2Inv, DII, pc, Tc, pc_lith, pc_pore, dx, dy, dz, Le, sxy, bdx, fdx, bdy, fdy))
+		START_COLOR_BLOCK_LOOP(color, ncolor)
+		{
+			cctx = &ctx[getThreadID()];
+
+			// clear evaluation batch
+			ConstEqBatchClear(&cctx->batch);
+
+			// store control volumes of the block in the batch
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svXYEdge[iter];
+
+				//=================
+				// SECOND INVARIANT
+				//=================
+
+				// check index bounds
+				I1 = i;   if(!periodic && I1 == mx) I1--;
+				I2 = i-1; if(!periodic && I2 == -1) I2++;
+				J1 = j;   if(             J1 == my) J1--;
+				J2 = j-1; if(             J2 == -1) J2++;
+
+				// access strain rates
+				XY = dxy[k][j][i];
+
+				// x-y plane, i-j indices (i & j - bounded)
+				XX1 = dxx[k][J1][I1];
+				XX2 = dxx[k][J1][I2];
+				XX3 = dxx[k][J2][I1];
+				XX4 = dxx[k][J2][I2];
+
+				// x-y plane, i-j indices (i & j - bounded)
+				YY1 = dyy[k][J1][I1];
+				YY2 = dyy[k][J1][I2];
+				YY3 = dyy[k][J2][I1];
+				YY4 = dyy[k][J2][I2];
+
+				// x-y plane, i-j indices (i & j - bounded)
+				ZZ1 = dzz[k][J1][I1];
+				ZZ2 = dzz[k][J1][I2];
+				ZZ3 = dzz[k][J2][I1];
+				ZZ4 = dzz[k][J2][I2];
+
+				// y-z plane j-k indices (j - bounded)
+				XZ1 = dxz[k][J1][i];
+				XZ2 = dxz[k+1][J1][i];
+				XZ3 = dxz[k][J2][i];
+				XZ4 = dxz[k+1][J2][i];
+
+				// x-z plane i-k indices (i - bounded)
+				YZ1 = dyz[k][j][I1];
+				YZ2 = dyz[k+1][j][I1];
+				YZ3 = dyz[k][j][I2];
+				YZ4 = dyz[k+1][j][I2];
+
+				// compute second invariant
+				J2Inv = XY*XY +
+				0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
+				0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
+				0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
+				0.25 *(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4) +
+				0.25 *(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
+
+				DII = sqrt(J2Inv);
+
+				//=======================
+				// CONSTITUTIVE EQUATIONS
+				//=======================
+
+				// access current pressure (x-y plane, i-j indices)
+				pc  = 0.25*(p[k][j][i] + p[k][j][i-1] + p[k][j-1][i] + p[k][j-1][i-1]);
+
+				// current temperature (x-y plane, i-j indices)
+				Tc = 0.25*(T[k][j][i] + T[k][j][i-1] + T[k][j-1][i] + T[k][j-1][i-1]);
+
+				// access current lithostatic pressure (x-y plane, i-j indices)
+				pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k][j-1][i] + p_lith[k][j-1][i-1]);
+
+				// access current pore pressure (x-y plane, i-j indices)
+				pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k][j-1][i] + p_pore[k][j-1][i-1]);
+
+				// get characteristic element size
+				dx = SIZE_NODE(i, sx, fs->dsx);
+				dy = SIZE_NODE(j, sy, fs->dsy);
+				dz = SIZE_CELL(k, sz, fs->dsz);
+				Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+				// setup control volume parameters
+				PetscCallAbort(PETSC_COMM_SELF, setUpCtrlVol(cctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
+
+				// store control volume and its phases in the batch
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqAdd(cctx));
+			}
+
+			// compute phase viscosities of all control volumes in the block
+			ConstEqBatchSolve(&cctx->batch, jr->ctrl.lrtol, jr->ctrl.lmaxit);
+
+			// evaluate constitutive equations and residuals of the block
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svXYEdge[iter];
+
+				// access strain rates
+				XY = dxy[k][j][i];
+
+				// restore control volume and collect its results
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqGet(cctx, i-ib));
+
+				// evaluate constitutive equations on the edge
+				PetscCallAbort(PETSC_COMM_SELF, edgeConstEq(cctx, svEdge, XY, sxy));
+
+				//=========
+				// RESIDUAL
+				//=========
+
+				// get mesh steps for the backward and forward derivatives
+				bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+				bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+				// momentum
+				fx[k][j-1][i] -= sxy/bdy;   fx[k][j][i] += sxy/fdy;
+				fy[k][j][i-1] -= sxy/bdx;   fy[k][j][i] += sxy/fdx;
+			}
+		}
+		END_COLOR_BLOCK_LOOP
 	}
-	END_STD_LOOP
 
 	//-------------------------------
 	// xz edge points
 	//-------------------------------
-	iter = 0;
-
 	PetscCall(DMDAGetCorners(fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
 
-	START_STD_LOOP
+	// process planes of alternating colors to avoid write conflicts in the residual
+	for(color = 0; color < ncolor; color++)
 	{
-		// access solution variables
-		svEdge = &jr->svXZEdge[iter++];
-
-		//=================
-		// SECOND INVARIANT
-		//=================
-
-		I1 = i;   if(!periodic && I1 == mx) I1--;
-		I2 = i-1; if(!periodic && I2 == -1) I2++;
-		K1 = k;   if(             K1 == mz) K1--;
-		K2 = k-1; if(             K2 == -1) K2++;
-
-		// access strain rates
-		XZ = dxz[k][j][i];
-
-		// x-z plane, i-k indices (i & k - bounded)
-		XX1 = dxx[K1][j][I1];
-		XX2 = dxx[K1][j][I2];
-		XX3 = dxx[K2][j][I1];
-		XX4 = dxx[K2][j][I2];
-
-		// x-z plane, i-k indices (i & k - bounded)
-		YY1 = dyy[K1][j][I1];
-		YY2 = dyy[K1][j][I2];
-		YY3 = dyy[K2][j][I1];
-		YY4 = dyy[K2][j][I2];
-
-		// x-z plane, i-k indices (i & k - bounded)
-		ZZ1 = dzz[K1][j][I1];
-		ZZ2 = dzz[K1][j][I2];
-		ZZ3 = dzz[K2][j][I1];
-		ZZ4 = dzz[K2][j][I2];
-
-		// y-z plane, j-k indices (k - bounded)
-		XY1 = dxy[K1][j][i];
-		XY2 = dxy[K1][j+1][i];
-		XY3 = dxy[K2][j][i];
-		XY4 = dxy[K2][j+1][i];
-
-		// xy plane, i-j indices (i - bounded)
-		YZ1 = dyz[k][j][I1];
-		YZ2 = dyz[k][j+1][I1];
-		YZ3 = dyz[k][j][I2];
-		YZ4 = dyz[k][j+1][I2];
-
-		// compute second invariant
-		J2Inv = XZ*XZ +
-		0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
-		0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
-		0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
-		0.25 *(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
-		0.25 *(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
-
-		DII = sqrt(J2Inv);
-
-		//=======================
-		// CONSTITUTIVE EQUATIONS
-		//=======================
-
-		// access current pressure (x-z plane, i-k indices)
-		pc = 0.25*(p[k][j][i] + p[k][j][i-1] + p[k-1][j][i] + p[k-1][j][i-1]);
-
-		// current temperature (x-z plane, i-k indices)
-		Tc = 0.25*(T[k][j][i] + T[k][j][i-1] + T[k-1][j][i] + T[k-1][j][i-1]);
-
-		// access current lithostatic pressure (x-z plane, i-k indices)
-		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k-1][j][i] + p_lith[k-1][j][i-1]);
-
-		// access current pore pressure (x-z plane, i-k indices)
-		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k-1][j][i] + p_pore[k-1][j][i-1]);
-
-		// get characteristic element size
-		dx = SIZE_NODE(i, sx, fs->dsx);
-		dy = SIZE_CELL(j, sy, fs->dsy);
-		dz = SIZE_NODE(k, sz, fs->dsz);
-		Le = sqrt(dx*dx + dy*dy + dz*dz);
-
-		// setup control volume parameters
-		PetscCall(setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
-
-		// evaluate constitutive equations on the edge
-		PetscCall(edgeConstEq(&ctx, svEdge, XZ, sxz));
-
-		//=========
-		// RESIDUAL
-		//=========
-
-		// get mesh steps for the backward and forward derivatives
-		bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
-		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
-
-		// momentum
-		fx[k-1][j][i] -= sxz/bdz;   fx[k][j][i] += sxz/fdz;
-		fz[k][j][i-1] -= sxz/bdx;   fz[k][j][i] += sxz/fdx;
-
+		OMP(parallel for num_threads(nt) schedule(static) private(i, j, ib, ie, iter, cctx, svEdge, I1, I2, K1, K2, XZ, XX1, XX2, XX3, XX4, YY1, YY2, YY3, YY4, ZZ1, ZZ2, ZZ3, ZZ4, XY1, XY2, XY3, XY4, YZ1, YZ2, YZ3, YZ4, J2Inv, DII, pc, Tc, pc_lith, pc_pore, dx, dy, dz, Le, sxz, bdx, fdx, bdz, fdz))
+		START_COLOR_BLOCK_LOOP(color, ncolor)
+		{
+			cctx = &ctx[getThreadID()];
+
+			// clear evaluation batch
+			ConstEqBatchClear(&cctx->batch);
+
+			// store control volumes of the block in the batch
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svXZEdge[iter];
+
+				//=================
+				// SECOND INVARIANT
+				//=================
+
+				I1 = i;   if(!periodic && I1 == mx) I1--;
+				I2 = i-1; if(!periodic && I2 == -1) I2++;
+				K1 = k;   if(             K1 == mz) K1--;
+				K2 = k-1; if(             K2 == -1) K2++;
+
+				// access strain rates
+				XZ = dxz[k][j][i];
+
+				// x-z plane, i-k indices (i & k - bounded)
+				XX1 = dxx[K1][j][I1];
+				XX2 = dxx[K1][j][I2];
+				XX3 = dxx[K2][j][I1];
+				XX4 = dxx[K2][j][I2];
+
+				// x-z plane, i-k indices (i & k - bounded)
+				YY1 = dyy[K1][j][I1];
+				YY2 = dyy[K1][j][I2];
+				YY3 = dyy[K2][j][I1];
+				YY4 = dyy[K2][j][I2];
+
+				// x-z plane, i-k indices (i & k - bounded)
+				ZZ1 = dzz[K1][j][I1];
+				ZZ2 = dzz[K1][j][I2];
+				ZZ3 = dzz[K2][j][I1];
+				ZZ4 = dzz[K2][j][I2];
+
+				// y-z plane, j-k indices (k - bounded)
+				XY1 = dxy[K1][j][i];
+				XY2 = dxy[K1][j+1][i];
+				XY3 = dxy[K2][j][i];
+				XY4 = dxy[K2][j+1][i];
+
+				// xy plane, i-j indices (i - bounded)
+				YZ1 = dyz[k][j][I1];
+				YZ2 = dyz[k][j+1][I1];
+				YZ3 = dyz[k][j][I2];
+				YZ4 = dyz[k][j+1][I2];
+
+				// compute second invariant
+				J2Inv = XZ*XZ +
+				0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
+				0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
+				0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
+				0.25 *(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
+				0.25 *(YZ1*YZ1 + YZ2*YZ2 + YZ3*YZ3 + YZ4*YZ4);
+
+				DII = sqrt(J2Inv);
+
+				//=======================
+				// CONSTITUTIVE EQUATIONS
+				//=======================
+
+				// access current pressure (x-z plane, i-k indices)
+				pc = 0.25*(p[k][j][i] + p[k][j][i-1] + p[k-1][j][i] + p[k-1][j][i-1]);
+
+				// current temperature (x-z plane, i-k indices)
+				Tc = 0.25*(T[k][j][i] + T[k][j][i-1] + T[k-1][j][i] + T[k-1][j][i-1]);
+
+				// access current lithostatic pressure (x-z plane, i-k indices)
+				pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j][i-1] + p_lith[k-1][j][i] + p_lith[k-1][j][i-1]);
+
+				// access current pore pressure (x-z plane, i-k indices)
+				pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j][i-1] + p_pore[k-1][j][i] + p_pore[k-1][j][i-1]);
+
+				// get characteristic element size
+				dx = SIZE_NODE(i, sx, fs->dsx);
+				dy = SIZE_CELL(j, sy, fs->dsy);
+				dz = SIZE_NODE(k, sz, fs->dsz);
+				Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+				// setup control volume parameters
+				PetscCallAbort(PETSC_COMM_SELF, setUpCtrlVol(cctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
+
+				// store control volume and its phases in the batch
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqAdd(cctx));
+			}
+
+			// compute phase viscosities of all control volumes in the block
+			ConstEqBatchSolve(&cctx->batch, jr->ctrl.lrtol, jr->ctrl.lmaxit);
+
+			// evaluate constitutive equations and residuals of the block
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svXZEdge[iter];
+
+				// access strain rates
+				XZ = dxz[k][j][i];
+
+				// restore control volume and collect its results
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqGet(cctx, i-ib));
+
+				// evaluate constitutive equations on the edge
+				PetscCallAbort(PETSC_COMM_SELF, edgeConstEq(cctx, svEdge, XZ, sxz));
+
+				//=========
+				// RESIDUAL
+				//=========
+
+				// get mesh steps for the backward and forward derivatives
+				bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+				bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+				// momentum
+				fx[k-1][j][i] -= sxz/bdz;   fx[k][j][i] += sxz/fdz;
+				fz[k][j][i-1] -= sxz/bdx;   fz[k][j][i] += sxz/fdx;
+			}
+		}
+		END_COLOR_BLOCK_LOOP
 	}
-	END_STD_LOOP
 
 	//-------------------------------
 	// yz edge points
 	//-------------------------------
-	iter = 0;
-
 	PetscCall(DMDAGetCorners(fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
 
-	START_STD_LOOP
+	// process planes of alternating colors to avoid write conflicts in the residual
+	for(color = 0; color < ncolor; color++)
 	{
-		// access solution variables
-		svEdge = &jr->svYZEdge[iter++];
-
-		//=================
-		// SECOND INVARIANT
-		//=================
-
-		// check index bounds
-		J1 = j;   if(J1 == my) J1--;
-		J2 = j-1; if(J2 == -1) J2++;
-		K1 = k;   if(K1 == mz) K1--;
-		K2 = k-1; if(K2 == -1) K2++;
-
-		// access strain rates
-		YZ = dyz[k][j][i];
-
-		// y-z plane, j-k indices (j & k - bounded)
-		XX1 = dxx[K1][J1][i];
-		XX2 = dxx[K1][J2][i];
-		XX3 = dxx[K2][J1][i];
-		XX4 = dxx[K2][J2][i];
-
-		// y-z plane, j-k indices (j & k - bounded)
-		YY1 = dyy[K1][J1][i];
-		YY2 = dyy[K1][J2][i];
-		YY3 = dyy[K2][J1][i];
-		YY4 = dyy[K2][J2][i];
-
-		// y-z plane, j-k indices (j & k - bounded)
-		ZZ1 = dzz[K1][J1][i];
-		ZZ2 = dzz[K1][J2][i];
-		ZZ3 = dzz[K2][J1][i];
-		ZZ4 = dzz[K2][J2][i];
-
-		// x-z plane, i-k indices (k -bounded)
-		XY1 = dxy[K1][j][i];
-		XY2 = dxy[K1][j][i+1];
-		XY3 = dxy[K2][j][i];
-		XY4 = dxy[K2][j][i+1];
-
-		// x-y plane, i-j indices (j - bounded)
-		XZ1 = dxz[k][J1][i];
-		XZ2 = dxz[k][J1][i+1];
-		XZ3 = dxz[k][J2][i];
-		XZ4 = dxz[k][J2][i+1];
-
-		// compute second invariant
-		J2Inv = YZ*YZ +
-		0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
-		0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
-		0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
-		0.25 *(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
-		0.25 *(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4);
-
-		DII = sqrt(J2Inv);
-
-		//=======================
-		// CONSTITUTIVE EQUATIONS
-		//=======================
-
-		// access current pressure (y-z plane, j-k indices)
-		pc = 0.25*(p[k][j][i] + p[k][j-1][i] + p[k-1][j][i] + p[k-1][j-1][i]);
-
-		// current temperature (y-z plane, j-k indices)
-		Tc = 0.25*(T[k][j][i] + T[k][j-1][i] + T[k-1][j][i] + T[k-1][j-1][i]);
-
-		// access current lithostatic pressure (y-z plane, j-k indices)
-		pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j-1][i] + p_lith[k-1][j][i] + p_lith[k-1][j-1][i]);
-
-		// access current pore pressure (y-z plane, j-k indices)
-		pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j-1][i] + p_pore[k-1][j][i] + p_pore[k-1][j-1][i]);
-
-		// get characteristic element size
-		dx = SIZE_CELL(i, sx, fs->dsx);
-		dy = SIZE_NODE(j, sy, fs->dsy);
-		dz = SIZE_NODE(k, sz, fs->dsz);
-		Le = sqrt(dx*dx + dy*dy + dz*dz);
-
-		// setup control volume parameters
-		PetscCall(setUpCtrlVol(&ctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
-
-		// evaluate constitutive equations on the edge
-		PetscCall(edgeConstEq(&ctx, svEdge, YZ, syz));
-
-		//=========
-		// RESIDUAL
-		//=========
-
-		// get mesh steps for the backward and forward derivatives
-		bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
-		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
-
-		// update momentum residuals
-		fy[k-1][j][i] -= syz/bdz;   fy[k][j][i] += syz/fdz;
-		fz[k][j-1][i] -= syz/bdy;   fz[k][j][i] += syz/fdy;
-
+		OMP(parallel for num_threads(nt) schedule(static) private(i, j, ib, ie, iter, cctx, svEdge, J1, J2, K1, K2, YZ, XX1, XX2, XX3, XX4, YY1, YY2, YY3, YY4, ZZ1, ZZ2, ZZ3, ZZ4, XY1, XY2, XY3, XY4, XZ1, XZ2, XZ3, XZ4, J2Inv, DII, pc, Tc, pc_lith, pc_pore, dx, dy, dz, Le, syz, bdy, fdy, bdz, fdz))
+		START_COLOR_BLOCK_LOOP(color, ncolor)
+		{
+			cctx = &ctx[getThreadID()];
+
+			// clear evaluation batch
+			ConstEqBatchClear(&cctx->batch);
+
+			// store control volumes of the block in the batch
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svYZEdge[iter];
+
+				//=================
+				// SECOND INVARIANT
+				//=================
+
+				// check index bounds
+				J1 = j;   if(J1 == my) J1--;
+				J2 = j-1; if(J2 == -1) J2++;
+				K1 = k;   if(K1 == mz) K1--;
+				K2 = k-1; if(K2 == -1) K2++;
+
+				// access strain rates
+				YZ = dyz[k][j][i];
+
+				// y-z plane, j-k indices (j & k - bounded)
+				XX1 = dxx[K1][J1][i];
+				XX2 = dxx[K1][J2][i];
+				XX3 = dxx[K2][J1][i];
+				XX4 = dxx[K2][J2][i];
+
+				// y-z plane, j-k indices (j & k - bounded)
+				YY1 = dyy[K1][J1][i];
+				YY2 = dyy[K1][J2][i];
+				YY3 = dyy[K2][J1][i];
+				YY4 = dyy[K2][J2][i];
+
+				// y-z plane, j-k indices (j & k - bounded)
+				ZZ1 = dzz[K1][J1][i];
+				ZZ2 = dzz[K1][J2][i];
+				ZZ3 = dzz[K2][J1][i];
+				ZZ4 = dzz[K2][J2][i];
+
+				// x-z plane, i-k indices (k -bounded)
+				XY1 = dxy[K1][j][i];
+				XY2 = dxy[K1][j][i+1];
+				XY3 = dxy[K2][j][i];
+				XY4 = dxy[K2][j][i+1];
+
+				// x-y plane, i-j indices (j - bounded)
+				XZ1 = dxz[k][J1][i];
+				XZ2 = dxz[k][J1][i+1];
+				XZ3 = dxz[k][J2][i];
+				XZ4 = dxz[k][J2][i+1];
+
+				// compute second invariant
+				J2Inv = YZ*YZ +
+				0.125*(XX1*XX1 + XX2*XX2 + XX3*XX3 + XX4*XX4) +
+				0.125*(YY1*YY1 + YY2*YY2 + YY3*YY3 + YY4*YY4) +
+				0.125*(ZZ1*ZZ1 + ZZ2*ZZ2 + ZZ3*ZZ3 + ZZ4*ZZ4) +
+				0.25 *(XY1*XY1 + XY2*XY2 + XY3*XY3 + XY4*XY4) +
+				0.25 *(XZ1*XZ1 + XZ2*XZ2 + XZ3*XZ3 + XZ4*XZ4);
+
+				DII = sqrt(J2Inv);
+
+				//=======================
+				// CONSTITUTIVE EQUATIONS
+				//=======================
+
+				// access current pressure (y-z plane, j-k indices)
+				pc = 0.25*(p[k][j][i] + p[k][j-1][i] + p[k-1][j][i] + p[k-1][j-1][i]);
+
+				// current temperature (y-z plane, j-k indices)
+				Tc = 0.25*(T[k][j][i] + T[k][j-1][i] + T[k-1][j][i] + T[k-1][j-1][i]);
+
+				// access current lithostatic pressure (y-z plane, j-k indices)
+				pc_lith = 0.25*(p_lith[k][j][i] + p_lith[k][j-1][i] + p_lith[k-1][j][i] + p_lith[k-1][j-1][i]);
+
+				// access current pore pressure (y-z plane, j-k indices)
+				pc_pore = 0.25*(p_pore[k][j][i] + p_pore[k][j-1][i] + p_pore[k-1][j][i] + p_pore[k-1][j-1][i]);
+
+				// get characteristic element size
+				dx = SIZE_CELL(i, sx, fs->dsx);
+				dy = SIZE_NODE(j, sy, fs->dsy);
+				dz = SIZE_NODE(k, sz, fs->dsz);
+				Le = sqrt(dx*dx + dy*dy + dz*dz);
+
+				// setup control volume parameters
+				PetscCallAbort(PETSC_COMM_SELF, setUpCtrlVol(cctx, svEdge->phRat, &svEdge->svDev, NULL, pc, pc_lith, pc_pore, Tc, DII, DBL_MAX, Le));
+
+				// store control volume and its phases in the batch
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqAdd(cctx));
+			}
+
+			// compute phase viscosities of all control volumes in the block
+			ConstEqBatchSolve(&cctx->batch, jr->ctrl.lrtol, jr->ctrl.lmaxit);
+
+			// evaluate constitutive equations and residuals of the block
+			for(i = ib; i < ie; i++)
+			{
+				// access solution variables
+				iter   = (i-sx) + (j-sy)*nx + (k-sz)*nx*ny;
+				svEdge = &jr->svYZEdge[iter];
+
+				// access strain rates
+				YZ = dyz[k][j][i];
+
+				// restore control volume and collect its results
+				PetscCallAbort(PETSC_COMM_SELF, devConstEqGet(cctx, i-ib));
+
+				// evaluate constitutive equations on the edge
+				PetscCallAbort(PETSC_COMM_SELF, edgeConstEq(cctx, svEdge, YZ, syz));
+
+				//=========
+				// RESIDUAL
+				//=========
+
+				// get mesh steps for the backward and forward derivatives
+				bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+				bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+				// update momentum residuals
+				fy[k-1][j][i] -= syz/bdz;   fy[k][j][i] += syz/fdz;
+				fz[k][j-1][i] -= syz/bdy;   fz[k][j][i] += syz/fdy;
+			}
+		}
+		END_COLOR_BLOCK_LOOP
 	}
-	END_STD_LOOP
+
+	PetscCall(PerfEnd(_PERF_CONSTEQ_));
 
 	// restore vectors
 	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, jr->gc,      &gc));
@@ -1566,8 +1794,18 @@ PetscErrorCode JacResGetResidual(JacRes *jr)
 	LOCAL_TO_GLOBAL(fs->DA_Y, jr->lfy, jr->gfy)
 	LOCAL_TO_GLOBAL(fs->DA_Z, jr->lfz, jr->gfz)
 
+	// collect iteration statistics from all threads
+	for(it = 1; it < nt; it++)
+	{
+		ctx[0].stats[0] += ctx[it].stats[0];
+		ctx[0].stats[1] += ctx[it].stats[1];
+		ctx[0].stats[2] += ctx[it].stats[2];
+	}
+
 	// check convergence of constitutive equations
-	PetscCall(checkConvConstEq(&ctx));
+	PetscCall(checkConvConstEq(&ctx[0]));
+
+	PetscCall(PetscFree(ctx));
 
 	PetscFunctionReturn(0);
 }
@@ -2173,28 +2411,51 @@ PetscErrorCode JacResViewRes(JacRes *jr)
 	PetscCall(JacResCopyMomentumRes  (jr, jr->gres));
 	PetscCall(JacResCopyContinuityRes(jr, jr->gres));
 
-	// compute norms
-	PetscCall(VecNorm(jr->gc,  NORM_INFINITY, &dinf));
-	PetscCall(VecNorm(jr->gc,  NORM_2,        &d2));
+	if(jr->ctrl.actTemp)
+	{
+		PetscCall(JacResGetTempRes(jr,jr->ts->dt));
+	}
 
-	PetscCall(VecNorm(jr->gfx, NORM_2, &fx));
-	PetscCall(VecNorm(jr->gfy, NORM_2, &fy));
-	PetscCall(VecNorm(jr->gfz, NORM_2, &fz));
+	// compute norms (split-phase, all norms are combined in one reduction)
+	PetscCall(VecNormBegin(jr->gc,  NORM_INFINITY, &dinf));
+	PetscCall(VecNormBegin(jr->gc,  NORM_2,        &d2));
 
-	PetscCall(VecNorm(jr->gvx, NORM_2, &vx2));
-	PetscCall(VecNorm(jr->gvy, NORM_2, &vy2));
-	PetscCall(VecNorm(jr->gvz, NORM_2, &vz2));
-	PetscCall(VecNorm(jr->gp,  NORM_2, &p2));		// pressure
+	PetscCall(VecNormBegin(jr->gfx, NORM_2, &fx));
+	PetscCall(VecNormBegin(jr->gfy, NORM_2, &fy));
+	PetscCall(VecNormBegin(jr->gfz, NORM_2, &fz));
 
-	f2 = sqrt(fx*fx + fy*fy + fz*fz);
+	PetscCall(VecNormBegin(jr->gvx, NORM_2, &vx2));
+	PetscCall(VecNormBegin(jr->gvy, NORM_2, &vy2));
+	PetscCall(VecNormBegin(jr->gvz, NORM_2, &vz2));
+	PetscCall(VecNormBegin(jr->gp,  NORM_2, &p2));		// pressure
 
 	if(jr->ctrl.actTemp)
 	{
-		PetscCall(JacResGetTempRes(jr,jr->ts->dt));
-		PetscCall(VecNorm(jr->ge, NORM_2, &e2));
+		PetscCall(VecNormBegin(jr->ge, NORM_2, &e2));
+	}
+
+	PetscCall(VecNormEnd(jr->gc,  NORM_INFINITY, &dinf));
+	PetscCall(VecNormEnd(jr->gc,  NORM_2,        &d2));
+
+	PetscCall(VecNormEnd(jr->gfx, NORM_2, &fx));
+	PetscCall(VecNormEnd(jr->gfy, NORM_2, &fy));
+	PetscCall(VecNormEnd(jr->gfz, NORM_2, &fz));
+
+	PetscCall(VecNormEnd(jr->gvx, NORM_2, &vx2));
+	PetscCall(VecNormEnd(jr->gvy, NORM_2, &vy2));
+	PetscCall(VecNormEnd(jr->gvz, NORM_2, &vz2));
+	PetscCall(VecNormEnd(jr->gp,  NORM_2, &p2));
+
+	if(jr->ctrl.actTemp)
+	{
+		PetscCall(VecNormEnd(jr->ge, NORM_2, &e2));
+
+		// local vector (not part of the global reduction)
 		PetscCall(VecNorm(jr->lT, NORM_2, &T2));
 	}
 
+	f2 = sqrt(fx*fx + fy*fy + fz*fz);
+
 	// print
 	PetscPrintf(PETSC_COMM_WORLD, "Residual summary: \n");
 	PetscPrintf(PETSC_COMM_WORLD, "   Continuity: \n");
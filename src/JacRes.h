@@ -35,6 +35,7 @@ struct SolVarDev
 {
 	PetscScalar  eta;    // total effective viscosity
 	PetscScalar  eta_st; // stabilization viscosity
+	PetscScalar  deta;   // viscosity derivative w.r.t. J2 = DII^2 (Newton tangent)
 	PetscScalar  I2Gdt;  // inverse elastic parameter (1/2G/dt)
 	PetscScalar  Hr;     // shear heating term contribution
 	PetscScalar  APS;    // accumulated plastic strain
@@ -159,6 +160,7 @@ struct Controls
 
 	PetscInt    lmaxit;         // maximum number of local rheology iterations
 	PetscScalar lrtol;          // local rheology iterations relative tolerance
+	PetscInt    nthreads;       // number of threads for residual evaluation
 	PetscInt    Phasetrans;     // Flag to activate phase transition routines
 	PetscInt    Passive_Tracer; // Flag to activate passive tracer routine
 	PetscScalar Adiabatic_gr;   // Adiabatic gradient
@@ -250,6 +252,15 @@ struct JacRes
 	Vec dT;   // temperature increment (global)
 	Vec ge;   // energy residual (global)
 	KSP tksp; // temperature diffusion solver
+	KSP itksp; // steady-state (initial) temperature solver (only during initialization)
+
+	// temperature solver reuse (shared by both temperature solvers)
+	KSP         tpc_ksp;  // solver with current preconditioner
+	Vec         Tdiag;    // matrix diagonal at last preconditioner setup
+	Vec         dTprev;   // first temperature increment of the previous step
+	PetscScalar dTdt;     // time step of stored increment (0 - not available)
+	PetscScalar tpc_rtol; // diagonal drift tolerance for preconditioner reuse (0 - always rebuild)
+	PetscInt    tguess;   // warm start flag
 
 	// reference energy residual norm for automatic tolerance setting
 	PetscScalar ts_ksp_ref_norm;
@@ -271,6 +282,10 @@ PetscErrorCode JacResReadRestart(JacRes *jr, FILE *fp);
 
 PetscErrorCode JacResWriteRestart(JacRes *jr, FILE *fp);
 
+PetscErrorCode JacResViewRestart(JacRes *jr, PetscViewer viewer);
+
+PetscErrorCode JacResLoadRestart(JacRes *jr, PetscViewer viewer);
+
 // destroy residual & Jacobian evaluation context
 PetscErrorCode JacResDestroy(JacRes *jr);
 
@@ -376,6 +391,10 @@ PetscErrorCode JacResGetTempRes(JacRes *jr, PetscScalar dt);
 // assemble temperature preconditioner matrix
 PetscErrorCode JacResGetTempMat(JacRes *jr, PetscScalar dt);
 
+// solve for temperature increment (first - first solve of the step)
+// preconditioner is reused until matrix diagonal drifts beyond tolerance
+PetscErrorCode JacResSolveTemp(JacRes *jr, KSP ksp, PetscScalar dt, PetscInt first);
+
 //---------------------------------------------------------------------------
 //......................   INTEGRATION FUNCTIONS   ..........................
 //---------------------------------------------------------------------------
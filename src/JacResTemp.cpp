@@ -174,6 +174,7 @@ PetscErrorCode JacResCreateTempParam(JacRes *jr)
 	DMBoundaryType BC_TYPE_X;
 	PetscInt       periodic;
 	const PetscInt *lx, *ly, *lz;
+	PetscBool      flg;
 
 	PetscFunctionBeginUser;
 
@@ -221,6 +222,16 @@ PetscErrorCode JacResCreateTempParam(JacRes *jr)
 	// energy residual
 	PetscCall(DMCreateGlobalVector(jr->DA_T, &jr->ge));
 
+	// solver reuse vectors
+	PetscCall(DMCreateGlobalVector(jr->DA_T, &jr->Tdiag));
+	PetscCall(DMCreateGlobalVector(jr->DA_T, &jr->dTprev));
+
+	// read solver reuse options
+	PetscCall(PetscOptionsGetScalar(NULL, NULL, "-ts_pc_reuse_rtol",  &jr->tpc_rtol, NULL));
+	PetscCall(PetscOptionsHasName  (NULL, NULL, "-ts_ksp_warm_start", &flg));
+
+	if(flg == PETSC_TRUE) jr->tguess = 1;
+
 	// create temperature diffusion solver
 	PetscCall(KSPCreate(PETSC_COMM_WORLD, &jr->tksp));
 
@@ -258,6 +269,10 @@ PetscErrorCode JacResDestroyTempParam(JacRes *jr)
 
 	PetscCall(VecDestroy(&jr->ge));
 
+	PetscCall(VecDestroy(&jr->Tdiag));
+
+	PetscCall(VecDestroy(&jr->dTprev));
+
 	PetscCall(ViewSolver(jr->tksp));
 
 	PetscCall(KSPDestroy(&jr->tksp));
@@ -709,6 +724,70 @@ PetscErrorCode JacResGetTempMat(JacRes *jr, PetscScalar dt)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode JacResSolveTemp(JacRes *jr, KSP ksp, PetscScalar dt, PetscInt first)
+{
+	// solve for temperature increment
+	// sparsity pattern is fixed, coefficients are updated in place by JacResGetTempMat,
+	// preconditioner (including multigrid hierarchy) is only rebuilt if the relative
+	// change of the matrix diagonal exceeds the tolerance, or the solver is switched
+
+	PetscScalar drift;
+	PetscInt    reuse;
+
+	PetscFunctionBeginUser;
+
+	reuse = 0;
+
+	// check matrix drift since last preconditioner setup
+	if(jr->tpc_rtol && jr->tpc_ksp == ksp)
+	{
+		PetscCall(MatGetDiagonal(jr->Att, jr->dT));
+
+		PetscCall(VecPointwiseDivide(jr->dT, jr->dT, jr->Tdiag));
+		PetscCall(VecShift(jr->dT, -1.0));
+		PetscCall(VecNorm(jr->dT, NORM_INFINITY, &drift));
+
+		if(drift < jr->tpc_rtol) reuse = 1;
+	}
+
+	// store reference diagonal
+	if(jr->tpc_rtol && !reuse)
+	{
+		PetscCall(MatGetDiagonal(jr->Att, jr->Tdiag));
+	}
+
+	jr->tpc_ksp = ksp;
+
+	PetscCall(KSPSetReusePreconditioner(ksp, reuse ? PETSC_TRUE : PETSC_FALSE));
+
+	// set initial guess (first increment of the previous step, scaled with time step)
+	if(jr->tguess && first && dt && jr->dTdt)
+	{
+		PetscCall(VecAXPBY(jr->dT, dt/jr->dTdt, 0.0, jr->dTprev));
+
+		PetscCall(KSPSetInitialGuessNonzero(ksp, PETSC_TRUE));
+	}
+	else
+	{
+		PetscCall(KSPSetInitialGuessNonzero(ksp, PETSC_FALSE));
+	}
+
+	// solve linear system
+	PetscCall(KSPSetOperators(ksp, jr->Att, jr->Att));
+	PetscCall(KSPSetUp(ksp));
+	PetscCall(KSPSolve(ksp, jr->ge, jr->dT));
+
+	// store increment for the next step
+	if(jr->tguess && first)
+	{
+		PetscCall(VecCopy(jr->dT, jr->dTprev));
+
+		jr->dTdt = dt;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 /*
 Diffusion term expansion
 
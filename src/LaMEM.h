@@ -80,9 +80,6 @@
 // FDSTAG near null space size
 #define _max_nullsp_sz_ 4
 
-// maximum number of geometry primitives
-#define _max_geom_ 100
-
 // maximum number of polygons on the same level
 #define _max_polygons_ 10
 
@@ -101,6 +98,12 @@
 // maximum number of phases
 #define _max_num_phases_ 32
 
+// maximum number of control volumes evaluated in one constitutive equation batch
+#define _max_batch_size_ 16
+
+// maximum number of constitutive equation batch lanes (phases of all control volumes)
+#define _max_batch_lanes_ (_max_num_phases_*_max_batch_size_)
+
 // maximum number of softening laws
 #define _max_num_soft_ 10
 
@@ -183,6 +186,9 @@
 #ifdef _WIN32
 #include "asprintf.h"       // required for some windows compilers
 #endif 
+#ifdef _OPENMP
+#include <omp.h>            // optional thread parallelism (make omp=1)
+#endif
 
 using namespace std;
 
@@ -199,6 +205,21 @@ typedef pair <PetscInt,    PetscInt> ipair;
 
 #define UNUSED(x) (void)(x)
 
+//-----------------------------------------------------------------------------
+// OPENMP DIRECTIVES MACRO (expands to nothing in non-threaded builds)
+//-----------------------------------------------------------------------------
+
+#define LAMEM_PRAGMA(x) _Pragma(#x)
+
+#ifdef _OPENMP
+#define OMP(x) LAMEM_PRAGMA(omp x)
+#else
+#define OMP(x)
+#endif
+
+// vectorization hint with clauses (always enabled, see -fopenmp-simd compiler flag)
+#define OMP_SIMD(x) LAMEM_PRAGMA(omp simd x)
+
 //-----------------------------------------------------------------------------
 // PROTOTYPES
 //-----------------------------------------------------------------------------
@@ -40,6 +40,9 @@
 #include "paraViewOutPassiveTracers.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
+#include "asyncWriter.h"
+#include "checkpoint.h"
+#include "perfLog.h"
 #include "LaMEMLib.h"
 
 //---------------------------------------------------------------------------
@@ -48,7 +51,6 @@ PetscErrorCode LaMEMLibMain(void *param, FB *fb)
 	LaMEMLib       lm;
 	RunMode        mode;
 	PetscBool      found;
-	PetscInt       exists;
 	char           str[_str_len_];
 	PetscLogDouble cputime_start, cputime_end;
 
@@ -80,17 +82,6 @@ PetscErrorCode LaMEMLibMain(void *param, FB *fb)
 		else SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect run mode type: %s", str);
 	}
 
-	// cancel restart if no database is available
-	if(mode == _RESTART_)
-	{
-		PetscCall(DirCheck("./restart", &exists));
-
-		if(!exists)
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No restart database available (check -mode option)");
-		}
-	}
-
 	//===========
 	// INITIALIZE
 	//===========
@@ -108,6 +99,9 @@ PetscErrorCode LaMEMLibMain(void *param, FB *fb)
 
 		PetscFunctionReturn(0);
 	}
+	// register performance events, read report parameters
+	PetscCall(PerfLogCreate(fb));
+
 	if(mode == _NORMAL_ || mode == _DRY_RUN_)
 	{
 		// create library objects
@@ -119,6 +113,9 @@ PetscErrorCode LaMEMLibMain(void *param, FB *fb)
 		PetscCall(LaMEMLibLoadRestart(&lm, fb));
 	}
 
+	// start background output writer
+	PetscCall(AsyncWriterCreate(fb));
+
 	//======
 	// SOLVE
 	//======
@@ -134,6 +131,12 @@ PetscErrorCode LaMEMLibMain(void *param, FB *fb)
 		PetscCall(LaMEMLibSolve(&lm, param));
 	}
 
+	// complete pending output
+	PetscCall(AsyncWriterDestroy());
+
+	// write performance report
+	PetscCall(PerfLogDestroy());
+
 	// destroy library objects
 	PetscCall(LaMEMLibDestroy(&lm));
 
@@ -230,18 +233,43 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm, FB *fb)
 	FILE            *fp;
 	PetscLogDouble  t;
 	PetscMPIInt     rank;
-	char            *fileName;
+	PetscBool       portable;
+	PetscInt        found;
+	char            *fileName, dirName[_str_len_];
 
 	
 	PetscFunctionBeginUser;
 
+	// find latest valid restart database
+	PetscCall(CheckpointFind(dirName, &found));
+
+	if(!found)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "No restart database available (check -mode option)");
+	}
+
+	PetscPrintf(PETSC_COMM_WORLD, "Restart database directory : %s \n", dirName);
+
+	// check for portable restart database
+	asprintf(&fileName, "%s/prdb.dat", dirName);
+	PetscCall(PetscTestFile(fileName, 'r', &portable));
+	PetscCallMPI(MPI_Bcast(&portable, 1, MPIU_BOOL, 0, PETSC_COMM_WORLD));
+	free(fileName);
+
+	if(portable)
+	{
+		PetscCall(LaMEMLibLoadRestartPortable(lm, fb, dirName));
+
+		PetscFunctionReturn(0);
+	}
+
 	PrintStart(&t, "Loading restart database", NULL);
 
 	// get MPI processor rank
 	PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
 
 	// compile restart file name
-	asprintf(&fileName, "./restart/rdb.%1.8lld.dat", (LLD)rank);
+	asprintf(&fileName, "%s/rdb.%1.8lld.dat", dirName, (LLD)rank);
 
 	// open restart file for reading in binary mode
 	fp = fopen(fileName, "rb");
@@ -303,7 +331,7 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm, FB *fb)
 //---------------------------------------------------------------------------
 PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 {
-	// save new restart database, then delete the original
+	// save new restart database, then shift database generations
 
 	FILE           *fp;
 	PetscMPIInt    rank;
@@ -315,6 +343,16 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 
 	if(!TSSolIsRestart(&lm->ts)) PetscFunctionReturn(0);
 
+	if(lm->ts.rdb_portable)
+	{
+		// portable database is written synchronously
+		PetscCall(AsyncWriterWait());
+
+		PetscCall(LaMEMLibSaveRestartPortable(lm));
+
+		PetscFunctionReturn(0);
+	}
+
 	PrintStart(&t, "Saving restart database", NULL);
 
 	// get MPI processor rank
@@ -324,10 +362,10 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	asprintf(&fileNameTmp, "./restart-tmp/rdb.%1.8lld.dat", (LLD)rank);
 
 	// create temporary restart directory
-	PetscCall(DirMake("./restart-tmp"));
+	PetscCall(CheckpointStart());
 
-	// open temporary restart file for writing in binary mode
-	fp = fopen(fileNameTmp, "wb");
+	// open temporary restart file for writing in binary mode (checksums computed on write)
+	PetscCall(CheckpointOpen(fileNameTmp, &fp));
 
 	if(fp == NULL)
 	{
@@ -362,13 +400,10 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	PetscCall(DynamicDike_WriteRestart(&lm->jr, fp));
 
 	// close temporary restart file
-	fclose(fp);
-
-	// delete existing restart database
-	PetscCall(LaMEMLibDeleteRestart());
+	PetscCall(AsyncWriterClose(fp));
 
-	// push temporary database to actual
-	PetscCall(DirRename("./restart-tmp", "./restart"));
+	// replace existing database once temporary files are written
+	PetscCall(AsyncWriterDefer(LaMEMLibCommitRestart, lm));
 
 	// free space
 	free(fileNameTmp);
@@ -378,41 +413,178 @@ PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode LaMEMLibDeleteRestart()
+PetscErrorCode LaMEMLibLoadRestartPortable(LaMEMLib *lm, FB *fb, const char *dirName)
 {
-	// delete existing restart database
-	PetscMPIInt  rank;
-	int          status;
-	PetscInt     exists;
-	char        *fileName;
+	// Portable restart database can be loaded on any number of processors.
+	// Library objects are created from the input file, then the run-time
+	// state is overwritten from the database. Grid resolution, phases and
+	// active model features must be the same as in the original run.
+
+	PetscViewer     viewer;
+	PetscLogDouble  t_beg, t_end;
+	char            *fileName;
 
-	
 	PetscFunctionBeginUser;
 
-	// get MPI processor rank
-	PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+	PetscTime(&t_beg);
+
+	PetscPrintf(PETSC_COMM_WORLD, "Loading portable restart database \n");
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
 
-	asprintf(&fileName, "./restart/rdb.%1.8lld.dat", (LLD)rank);
+	asprintf(&fileName, "%s/prdb.dat", dirName);
+	PetscCall(PetscViewerBinaryOpen(PETSC_COMM_WORLD, fileName, FILE_MODE_READ, &viewer));
+	free(fileName);
 
-	// check for existing restart database
-	PetscCall(DirCheck("./restart", &exists));
+	// skip initialization of the data stored in the database
+	lm->actx.markLoad  = 1;
+	lm->bc.fixCellLoad = 1;
 
-	if(exists)
-	{
-		// delete existing database
-		status = remove(fileName);
+	// scaling & time stepping
+	PetscCall(ScalingCreate(&lm->scal, fb, PETSC_TRUE));
 
-		if(status && errno != ENOENT)
-		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Failed to delete file %s", fileName);
-		}
+	PetscCall(TSSolCreate(&lm->ts, fb));
 
-		PetscCall(DirRemove("./restart"));
-	}
+	PetscCall(TSSolLoadRestart(&lm->ts, viewer));
 
-	// free space
+	// staggered grid (restore deformed coordinates on new partitioning)
+	PetscCall(FDSTAGCreate(&lm->fs, fb));
+
+	PetscCall(FDSTAGLoadRestart(&lm->fs, viewer));
+
+	// material database
+	PetscCall(DBMatCreate(&lm->dbm, fb, PETSC_TRUE));
+
+	// free surface
+	PetscCall(FreeSurfCreate(&lm->surf, fb));
+
+	PetscCall(FreeSurfLoadRestart(&lm->surf, viewer));
+
+	// boundary conditions context
+	PetscCall(BCCreate(&lm->bc, fb));
+
+	PetscCall(BCLoadRestart(&lm->bc, viewer));
+
+	// solution variables
+	PetscCall(JacResCreate(&lm->jr, fb));
+
+	PetscCall(JacResLoadRestart(&lm->jr, viewer));
+
+	// dynamic dike
+	PetscCall(DBDikeCreate(&lm->dbdike, &lm->dbm, fb, &lm->jr, PETSC_TRUE));
+
+	PetscCall(DynamicDike_LoadRestart(&lm->jr, viewer));
+
+	// dynamic phase transition
+	PetscCall(DynamicPhTr_Init(&lm->jr));
+
+	PetscCall(DynamicPhTr_LoadRestart(&lm->jr, viewer));
+
+	// markers (redistributed to the host processors)
+	PetscCall(ADVCreate(&lm->actx, fb));
+
+	asprintf(&fileName, "%s/mdb.dat", dirName);
+	PetscCall(ADVLoadRestart(&lm->actx, fileName));
 	free(fileName);
 
+	// passive tracers
+	PetscCall(ADVPtrPassive_Tracer_create(&lm->actx, fb));
+
+	PetscCall(Passive_Tracer_LoadRestart(&lm->actx, viewer));
+
+	PetscCall(PetscViewerDestroy(&viewer));
+
+	// output drivers
+	PetscCall(PVOutCreate(&lm->pvout, fb));
+
+	PetscCall(PVSurfCreate(&lm->pvsurf, fb));
+
+	PetscCall(PVMarkCreate(&lm->pvmark, fb));
+
+	PetscCall(PVPtrCreate(&lm->pvptr, fb));
+
+	PetscCall(PVAVDCreate(&lm->pvavd, fb));
+
+	PetscTime(&t_end);
+
+	PetscPrintf(PETSC_COMM_WORLD, "Portable restart database loaded (%g sec)\n", t_end - t_beg);
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibSaveRestartPortable(LaMEMLib *lm)
+{
+	// save portable restart database, then shift database generations
+	// (single PETSc binary file + shared marker database file)
+
+	PetscViewer    viewer;
+	PetscLogDouble t;
+
+	PetscFunctionBeginUser;
+
+	PrintStart(&t, "Saving portable restart database", NULL);
+
+	// create temporary restart directory
+	PetscCall(CheckpointStart());
+
+	// open binary viewer (no .info file)
+	PetscCall(PetscViewerCreate(PETSC_COMM_WORLD, &viewer));
+	PetscCall(PetscViewerSetType(viewer, PETSCVIEWERBINARY));
+	PetscCall(PetscViewerFileSetMode(viewer, FILE_MODE_WRITE));
+	PetscCall(PetscViewerBinarySetSkipInfo(viewer, PETSC_TRUE));
+	PetscCall(PetscViewerFileSetName(viewer, "./restart-tmp/prdb.dat"));
+
+	// time stepping
+	PetscCall(TSSolViewRestart(&lm->ts, viewer));
+
+	// staggered grid
+	PetscCall(FDSTAGViewRestart(&lm->fs, viewer));
+
+	// free surface
+	PetscCall(FreeSurfViewRestart(&lm->surf, viewer));
+
+	// boundary conditions context
+	PetscCall(BCViewRestart(&lm->bc, viewer));
+
+	// solution variables
+	PetscCall(JacResViewRestart(&lm->jr, viewer));
+
+	// dynamic dike
+	PetscCall(DynamicDike_ViewRestart(&lm->jr, viewer));
+
+	// dynamic phase transition
+	PetscCall(DynamicPhTr_ViewRestart(&lm->jr, viewer));
+
+	// passive tracers
+	PetscCall(Passive_Tracer_ViewRestart(&lm->actx, viewer));
+
+	PetscCall(PetscViewerDestroy(&viewer));
+
+	// markers
+	PetscCall(ADVViewRestart(&lm->actx, "./restart-tmp/mdb.dat"));
+
+	// validate temporary database & shift generations
+	PetscCall(LaMEMLibCommitRestart(lm));
+
+	PrintDone(t);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode LaMEMLibCommitRestart(void *ctx)
+{
+	// validate temporary restart database, replace oldest generation
+
+	LaMEMLib *lm;
+	TSSol    *ts;
+
+	PetscFunctionBeginUser;
+
+	lm = (LaMEMLib*)ctx;
+	ts = &lm->ts;
+
+	PetscCall(CheckpointCommit(ts->rdb_portable, lm->actx.advect != ADV_NONE, ts->rdb_keep));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -527,6 +699,10 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	scal = &lm->scal;
 	ts   = &lm->ts;
 
+	// complete output & restart database of previous step
+	// (staged files are written while current step is solved)
+	PetscCall(AsyncWriterWait());
+
 	if(!TSSolIsOutput(ts)) PetscFunctionReturn(0);
 
 	PrintStart(&t, "Saving output", NULL);
@@ -542,26 +718,37 @@ PetscErrorCode LaMEMLibSaveOutput(LaMEMLib *lm)
 	PetscCall(DirMake(dirName));
 
 	// AVD phase output
+	PetscCall(PerfBegin(_PERF_OUT_AVD_));
 	PetscCall(PVAVDWriteTimeStep(&lm->pvavd, dirName, time));
+	PetscCall(PerfEnd(_PERF_OUT_AVD_));
 
 	// grid ParaView output
+	PetscCall(PerfBegin(_PERF_OUT_GRID_));
 	PetscCall(PVOutWriteTimeStep(&lm->pvout, dirName, time));
+	PetscCall(PerfEnd(_PERF_OUT_GRID_));
 
 	// free surface ParaView output
+	PetscCall(PerfBegin(_PERF_OUT_SURF_));
 	PetscCall(PVSurfWriteTimeStep(&lm->pvsurf, dirName, time));
+	PetscCall(PerfEnd(_PERF_OUT_SURF_));
 
 	// marker ParaView output
+	PetscCall(PerfBegin(_PERF_OUT_MARK_));
 	PetscCall(PVMarkWriteTimeStep(&lm->pvmark, dirName, time));
+	PetscCall(PerfEnd(_PERF_OUT_MARK_));
 
 	// compute and output effective permeability
 	PetscCall(JacResGetPermea(&lm->jr, bgPhase, step, lm->pvout.outfile));
 
 	// passive tracers paraview output
+	// (timed on all ranks to keep event counts consistent in imbalance report)
+	PetscCall(PerfBegin(_PERF_OUT_PTR_));
 	if(ISRankZero(PETSC_COMM_WORLD))
 	{
 		// save .dat files// binary of passive tracers
 		PetscCall(PVPtrWriteTimeStep(&lm->pvptr, dirName, time));
 	}
+	PetscCall(PerfEnd(_PERF_OUT_PTR_));
 	// clean up
 	free(dirName);
 
@@ -642,8 +829,12 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param)
 
 		if(track_stages) { PetscCall(PetscLogStagePush(stages[1])); }
 
+		PetscCall(PerfBegin(_PERF_SNES_));
+
 		PetscCall(SNESSolve(snes, NULL, lm->jr.gsol));
 
+		PetscCall(PerfEnd(_PERF_SNES_));
+
 		if(track_stages) { PetscCall(PetscLogStagePop()); }
 
 		// print analyze convergence/divergence reason & iteration count
@@ -729,7 +920,12 @@ PetscErrorCode LaMEMLibSolve(LaMEMLib *lm, void *param)
 		if(track_stages) { PetscCall(PetscLogStagePop()); }
 
 		// restart database
+		PetscCall(PerfBegin(_PERF_RESTART_));
 		PetscCall(LaMEMLibSaveRestart(lm));
+		PetscCall(PerfEnd(_PERF_RESTART_));
+
+		// record step timings & iteration counts
+		PetscCall(PerfStepEnd(snes, lm->ts.istep, lm->ts.time*lm->scal.time, lm->ts.dt*lm->scal.time, lm->scal.lbl_time));
 
 	}
 
@@ -933,6 +1129,18 @@ PetscErrorCode LaMEMLibDiffuseTemp(LaMEMLib *lm)
 		PrintDone(t);		
 	}
 
+	// destroy initial temperature solver
+	if(jr->itksp)
+	{
+		PetscCall(ViewSolver(jr->itksp));
+
+		PetscCall(KSPDestroy(&jr->itksp));
+
+		// reset solver reuse data
+		jr->tpc_ksp = NULL;
+		jr->dTdt    = 0.0;
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -941,7 +1149,6 @@ PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
 	JacRes         *jr;
 	AdvCtx         *actx;
 	Controls       *ctrl;
-	KSP            tksp;
 	PetscScalar    norm;
 	PetscBool      set;
 	PetscInt       ts_ksp_atol_auto;
@@ -960,21 +1167,24 @@ PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
 	if(set && ctrl->actTemp) { ts_ksp_atol_auto = 1; }
 	else                     { ts_ksp_atol_auto = 0; }
 
-	// create temperature diffusion solver
-	PetscCall(KSPCreate(PETSC_COMM_WORLD, &tksp));
+	// create temperature diffusion solver (kept during initialization)
+	if(!jr->itksp)
+	{
+		PetscCall(KSPCreate(PETSC_COMM_WORLD, &jr->itksp));
 
-	// enable geometric multigrid
-	PetscCall(KSPSetDM(tksp, jr->DA_T));
+		// enable geometric multigrid
+		PetscCall(KSPSetDM(jr->itksp, jr->DA_T));
 
 #if PETSC_VERSION_LT(3, 25, 0)
-	PetscCall(KSPSetDMActive(tksp,                   PETSC_FALSE));
+		PetscCall(KSPSetDMActive(jr->itksp,                   PETSC_FALSE));
 #else
-	PetscCall(KSPSetDMActive(tksp, KSP_DMACTIVE_ALL, PETSC_FALSE));
+		PetscCall(KSPSetDMActive(jr->itksp, KSP_DMACTIVE_ALL, PETSC_FALSE));
 #endif
 
-	// set options
-	PetscCall(KSPSetOptionsPrefix(tksp,"its_"));
-	PetscCall(KSPSetFromOptions(tksp));
+		// set options
+		PetscCall(KSPSetOptionsPrefix(jr->itksp,"its_"));
+		PetscCall(KSPSetFromOptions(jr->itksp));
+	}
 
 	// compute matrix and rhs
 	// STEADY STATE solution is activated by setting time step to zero
@@ -990,18 +1200,7 @@ PetscErrorCode LaMEMLibSolveTemp(LaMEMLib *lm, PetscScalar dt)
 	}
 
 	// solve linear system
-	PetscCall(KSPSetOperators(tksp, jr->Att, jr->Att));
-	PetscCall(KSPSetUp(tksp));
-	PetscCall(KSPSolve(tksp, jr->ge, jr->dT));
-
-	// view solver
-	if(!dt)
-	{
-		PetscCall(ViewSolver(tksp));
-	}
-
-	// destroy initial temperature solver
-	PetscCall(KSPDestroy(&tksp));
+	PetscCall(JacResSolveTemp(jr, jr->itksp, dt, 1));
 
 	// store computed temperature, enforce boundary constraints
 	PetscCall(JacResUpdateTemp(jr));
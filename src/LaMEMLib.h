@@ -64,7 +64,11 @@ PetscErrorCode LaMEMLibLoadRestart(LaMEMLib *lm, FB *fb);
 
 PetscErrorCode LaMEMLibSaveRestart(LaMEMLib *lm);
 
-PetscErrorCode LaMEMLibDeleteRestart();
+PetscErrorCode LaMEMLibLoadRestartPortable(LaMEMLib *lm, FB *fb, const char *dirName);
+
+PetscErrorCode LaMEMLibSaveRestartPortable(LaMEMLib *lm);
+
+PetscErrorCode LaMEMLibCommitRestart(void *ctx);
 
 PetscErrorCode LaMEMLibDestroy(LaMEMLib *lm);
 
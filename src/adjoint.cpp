@@ -4473,6 +4473,7 @@ PetscErrorCode setUpPhaseFD(ConstEqCtx *ctx, PetscInt ID, AdjGrad *aop, ModParam
 	ctx->N_dis = 1.0; // dislocation exponent
 	ctx->A_prl = 0.0; // Peierls constant
 	ctx->N_prl = 1.0; // Peierls exponent
+	ctx->A_fk  = 0.0; // Frank-Kamenetzky constant
 	ctx->taupl = 0.0; // plastic yield stress
 
 	// MELT FRACTION
@@ -4654,6 +4655,9 @@ PetscErrorCode setUpPhaseFD(ConstEqCtx *ctx, PetscInt ID, AdjGrad *aop, ModParam
 	if(dP < 0.0) ctx->taupl =         ch; // Von-Mises model for extension
 	else         ctx->taupl = dP*fr + ch; // Drucker-Prager model for compression
 
+	// store regularization viscosity
+	ctx->eta_vp = mat->eta_vp;
+
 	// correct for ultimate yield stress (if defined)
 	if(ctrl->tauUlt) { if(ctx->taupl > ctrl->tauUlt) ctx->taupl = ctrl->tauUlt; }
 
@@ -4664,11 +4668,12 @@ PetscErrorCode devConstEqFD(ConstEqCtx *ctx, AdjGrad *aop, ModParam *IOparam, Pe
 {
 	// evaluate deviatoric constitutive equations in control volume
 
-	Controls    *ctrl;
-	PetscScalar *phRat;
-	SolVarDev   *svDev;
-	Material_t  *phases;
-	PetscInt     i, numPhases;
+	Controls     *ctrl;
+	PetscScalar  *phRat;
+	SolVarDev    *svDev;
+	Material_t   *phases;
+	ConstEqBatch *bt;
+	PetscInt      i, numPhases;
 
 	
 	PetscFunctionBeginUser;
@@ -4682,10 +4687,12 @@ PetscErrorCode devConstEqFD(ConstEqCtx *ctx, AdjGrad *aop, ModParam *IOparam, Pe
 
 	// zero out results
 	ctx->eta    = 0.0; // effective viscosity
+	ctx->deta   = 0.0; // viscosity derivative
 	ctx->eta_cr = 0.0; // creep viscosity
 	ctx->DIIdif = 0.0; // diffusion creep strain rate
 	ctx->DIIdis = 0.0; // dislocation creep strain rate
 	ctx->DIIprl = 0.0; // Peierls creep strain rate
+	ctx->DIIfk  = 0.0; // Frank-Kamenetzky strain rate
 	ctx->DIIpl  = 0.0; // plastic strain rate
 	ctx->yield  = 0.0; // yield stress
 
@@ -4702,6 +4709,11 @@ PetscErrorCode devConstEqFD(ConstEqCtx *ctx, AdjGrad *aop, ModParam *IOparam, Pe
 		PetscFunctionReturn(0);
 	}
 
+	// clear phase evaluation batch
+	bt = &ctx->batch;
+
+	ConstEqBatchClear(bt);
+
 	// scan all phases
 	for(i = 0; i < numPhases; i++)
 	{
@@ -4711,20 +4723,27 @@ PetscErrorCode devConstEqFD(ConstEqCtx *ctx, AdjGrad *aop, ModParam *IOparam, Pe
 			// setup phase parameters
 			PetscCall(setUpPhaseFD(ctx, i, aop, IOparam,  ii,  jj,  k,  ik,  jk,  kk));
 
-			// compute phase viscosities and strain rate partitioning
-			PetscCall(getPhaseVisc(ctx, i));
+			// store phase parameters in the batch
+			PetscCall(ConstEqBatchAddPhase(bt, ctx, i));
 
 			// update stabilization viscosity
 			svDev->eta_st += phRat[i]*phases->eta_st;
 		}
 	}
 
+	// compute phase viscosities and strain rate partitioning
+	ConstEqBatchSolve(bt, ctrl->lrtol, ctrl->lmaxit);
+
+	// update results
+	ConstEqBatchCollect(bt, ctx, 0, bt->n);
+
 	// normalize strain rates
 	if(ctx->DII)
 	{
 		ctx->DIIdif /= ctx->DII;
 		ctx->DIIdis /= ctx->DII;
 		ctx->DIIprl /= ctx->DII;
+		ctx->DIIfk  /= ctx->DII;
 		ctx->DIIpl  /= ctx->DII;
 	}
 
@@ -29,6 +29,7 @@
 #include "interpolate.h"
 #include "phase_transition.h"
 #include "passive_tracer.h"
+#include "perfLog.h"
 /*
 #START_DOC#
 \lamemfunction{\verb- ADVCreate -}
@@ -98,6 +99,8 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	actx->bgPhase  = -1;
 	actx->A        =  2.0/3.0;
 	actx->npmax    =  1;
+	actx->nthreads =  1;
+	actx->avdthreads = 1;
 	maxPhaseID     = actx->dbm->numPhases-1;
 
 	// READ
@@ -110,7 +113,7 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "rand_noise",     &actx->randNoise,1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "rand_noiseGP",   &actx->randNoiseGP,1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "bg_phase",       &actx->bgPhase,  1, maxPhaseID));
-	PetscCall(getIntParam   (fb, _OPTIONAL_, "save_mark",      &actx->saveMark, 1, 1));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "save_mark",      &actx->saveMark, 1, 2));
 	PetscCall(getStringParam(fb, _OPTIONAL_, "mark_save_file",  actx->saveFile, "./markers/mdb"));
 	PetscCall(getStringParam(fb, _OPTIONAL_, "interp",          interp,         "stag"));
 	PetscCall(getScalarParam(fb, _OPTIONAL_, "stagp_a",        &actx->A,        1, 1.0));
@@ -118,6 +121,8 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nmark_lim",       nmark_lim,      2, 0));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nmark_avd",       nmark_avd,      3, 0));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nmark_sub",      &actx->npmax,    1, 27));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "proj_num_threads",&actx->nthreads, 1, -1));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "avd_num_threads", &actx->avdthreads, 1, -1));
 
 	// CHECK
 
@@ -169,6 +174,13 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Interpolation constant must be between 0 and 1 (stagp_a)");
 	}
 
+	// limit number of projection & marker control threads
+	actx->nthreads   = getNumThreads(actx->nthreads);
+	actx->avdthreads = getNumThreads(actx->avdthreads);
+
+	// AVD threads call PETSc error handling (projection threads do not)
+	PetscCall(checkThreadSafety("avd_num_threads", actx->avdthreads));
+
 	if(actx->interp != STAG_P)  actx->A       = 0.0;
 	if(actx->msetup != _GEOM_)  actx->bgPhase = -1;
 
@@ -223,12 +235,18 @@ PetscErrorCode ADVCreate(AdvCtx *actx, FB *fb)
 	if(actx->saveMark)      PetscPrintf(PETSC_COMM_WORLD,"   Marker storage file           : %s \n", actx->saveFile);
 	if(actx->bgPhase != -1) PetscPrintf(PETSC_COMM_WORLD,"   Background phase ID           : %lld \n", (LLD)actx->bgPhase);
 	if(actx->A)             PetscPrintf(PETSC_COMM_WORLD,"   Interpolation constant        : %g \n", actx->A);
+	if(actx->nthreads > 1)  PetscPrintf(PETSC_COMM_WORLD,"   Projection threads per rank   : %lld \n", (LLD)actx->nthreads);
+	if(actx->mctrl == CTRL_AVD
+	&& actx->avdthreads > 1) PetscPrintf(PETSC_COMM_WORLD,"   AVD control threads per rank  : %lld \n", (LLD)actx->avdthreads);
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
 	// create communicator and separator
 	PetscCall(ADVCreateData(actx));
 
+	// markers are loaded from portable restart database
+	if(actx->markLoad) PetscFunctionReturn(0);
+
 	// initialize markers
 	PetscCall(ADVMarkInit(actx, fb));
 
@@ -336,12 +354,12 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp)
 	PetscCall(PetscMalloc((size_t)actx->markcap*sizeof(Marker), &actx->markers));
 	PetscCall(PetscMemzero(actx->markers, (size_t)actx->markcap*sizeof(Marker)));
 
+	// allocate scratch memory for reordering markers
+	PetscCall(PetscMalloc((size_t)actx->markcap*sizeof(Marker), &actx->markbuf));
+
 	// allocate memory for host cell numbers
 	PetscCall(makeIntArray(&actx->cellnum, NULL, actx->markcap));
 
-	// allocate memory for indices of all markers in each cell
-	PetscCall(makeIntArray(&actx->markind, NULL, actx->markcap));
-
 	// read markers from disk
 	fread(actx->markers, (size_t)actx->nummark*sizeof(Marker), 1, fp);
 
@@ -370,6 +388,38 @@ PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode ADVViewRestart(AdvCtx *actx, const char *filename)
+{
+	PetscFunctionBeginUser;
+
+	// check activation
+ 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
+
+	// store all markers to single shared file
+	PetscCall(ADVMarkWriteDB(actx, filename));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVLoadRestart(AdvCtx *actx, const char *filename)
+{
+	PetscFunctionBeginUser;
+
+	// check activation
+ 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
+
+	// read markers & send them to host processors
+	PetscCall(ADVMarkReadDB(actx, filename));
+
+	// compute host cells for all the markers
+	PetscCall(ADVMapMarkToCells(actx));
+
+	// project history from markers to grid (initialize solution variables)
+	PetscCall(ADVProjHistMarkToGrid(actx));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVCreateData(AdvCtx *actx)
 {
 	// create communicator and separator
@@ -410,13 +460,24 @@ PetscErrorCode ADVDestroy(AdvCtx *actx)
 
 	PetscCallMPI(MPI_Comm_free(&actx->icomm));
 	PetscCall(PetscFree(actx->markers));
+	PetscCall(PetscFree(actx->markbuf));
 	PetscCall(PetscFree(actx->cellnum));
-	PetscCall(PetscFree(actx->markind));
 	PetscCall(PetscFree(actx->markstart));
 	PetscCall(PetscFree(actx->sendbuf));
 	PetscCall(PetscFree(actx->recvbuf));
 	PetscCall(PetscFree(actx->idel));
 
+	// thread-local AVD storage
+	if(actx->avd)
+	{
+		for(PetscInt i = 0; i < actx->avdthreads; i++)
+		{
+			PetscCall(AVDDestroy(&actx->avd[i]));
+		}
+
+		PetscCall(PetscFree(actx->avd));
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -460,7 +521,8 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 	// or fixed maximum number markers per cell + deleting excessive markers.
 	// The latter has an advantage of maintaining memory locality).
 
-	Marker *markers;
+	Marker   *markers;
+	PetscInt *cellnum;
 
 	
 	PetscFunctionBeginUser;
@@ -471,12 +533,16 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 		// update capacity
 		actx->markcap = (PetscInt)(_cap_overhead_*(PetscScalar)nummark);
 
-		// reallocate memory for host cell and marker-in-cell indices
-		PetscCall(PetscFree(actx->cellnum));
-		PetscCall(PetscFree(actx->markind));
+		// reallocate memory for host cell indices (keep tracked host cells)
+		PetscCall(makeIntArray(&cellnum, NULL, actx->markcap));
 
-		PetscCall(makeIntArray(&actx->cellnum, NULL, actx->markcap));
-		PetscCall(makeIntArray(&actx->markind, NULL, actx->markcap));
+		if(actx->nummark)
+		{
+			PetscCall(PetscMemcpy(cellnum, actx->cellnum, (size_t)actx->nummark*sizeof(PetscInt)));
+		}
+
+		PetscCall(PetscFree(actx->cellnum));
+		actx->cellnum = cellnum;
 
 		// reallocate memory for markers
 		PetscCall(PetscMalloc((size_t)actx->markcap*sizeof(Marker), &markers));
@@ -491,6 +557,10 @@ PetscErrorCode ADVReAllocStorage(AdvCtx *actx, PetscInt nummark)
 		// update marker storage
 		PetscCall(PetscFree(actx->markers));
 		actx->markers = markers;
+
+		// reallocate scratch memory for reordering markers (no data to keep)
+		PetscCall(PetscFree(actx->markbuf));
+		PetscCall(PetscMalloc((size_t)actx->markcap*sizeof(Marker), &actx->markbuf));
 	}
 
 	PetscFunctionReturn(0);
@@ -560,6 +630,9 @@ PetscErrorCode ADVRemap(AdvCtx *actx)
 	}
 	else if(actx->mctrl == CTRL_AVD)
 	{
+		// marker control modifies storage, recompute all host cells
+		actx->cellmap = 0;
+
 		// check markers and inject/delete if necessary in all control volumes
 		PetscCall(AVDMarkerControl(actx));
 
@@ -605,6 +678,8 @@ PetscErrorCode ADVExchange(AdvCtx *actx)
 
 	if(actx->advect == ADV_NONE) PetscFunctionReturn(0);
 
+	PetscCall(PerfBegin(_PERF_MARK_EXCH_));
+
 	// count number of markers to be sent to each neighbor domain
 	PetscCall(ADVMapMarkToDomains(actx));
 
@@ -623,6 +698,8 @@ PetscErrorCode ADVExchange(AdvCtx *actx)
 	// free communication buffer
 	PetscCall(ADVDestroyMPIBuff(actx));
 
+	PetscCall(PerfEnd(_PERF_MARK_EXCH_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -833,20 +910,38 @@ PetscErrorCode ADVInterpFieldToMark(AdvCtx *actx, InterpCase icase)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+static inline PetscInt getTrackedCell(PetscScalar *ncoor, PetscInt n, PetscInt I, PetscScalar x)
+{
+	// find host cell by walking from the old host cell (-1 = outside local domain)
+	// point on the node belongs to the cell on the right (same as Discret1DFindPoint)
+
+	while(I >= 0 && x <  ncoor[I])   I--;
+
+	if(I < 0) return -1;
+
+	while(I <  n && x >= ncoor[I+1]) I++;
+
+	if(I == n) return -1;
+
+	return I;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVAdvectMark(AdvCtx *actx)
 {
 	// update marker positions from current velocities & time step
+	// track host cells & flag markers leaving local domain in the same pass
 
 	FDSTAG      *fs;
 	JacRes      *jr;
 	Marker      *P;
 	SolVarCell  *svCell;
-	PetscInt    sx, sy, sz, nx, ny;
-	PetscInt    jj, ID, I, J, K, II, JJ, KK, AirPhase;
+	PetscInt    sx, sy, sz, nx, ny, nz;
+	PetscInt    jj, ID, I, J, K, II, JJ, KK, AirPhase, track;
 	PetscScalar *ncx, *ncy, *ncz;
 	PetscScalar *ccx, *ccy, *ccz;
 	PetscScalar ***lvx, ***lvy, ***lvz, ***lp, ***lT;
 	PetscScalar vx, vy, vz, xc, yc, zc, xp, yp, zp, dt, Ttop;
+	PetscScalar Exx, Eyy, Ezz;
 
 	
 	PetscFunctionBeginUser;
@@ -870,7 +965,12 @@ PetscErrorCode ADVAdvectMark(AdvCtx *actx)
 	// starting indices & number of cells
 	sx = fs->dsx.pstart; nx = fs->dsx.ncels;
 	sy = fs->dsy.pstart; ny = fs->dsy.ncels;
-	sz = fs->dsz.pstart;
+	sz = fs->dsz.pstart; nz = fs->dsz.ncels;
+
+	// host cells can only be tracked if grid is not stretched after advection
+	PetscCall(BCGetBGStrainRates(jr->bc, &Exx, &Eyy, &Ezz, NULL, NULL, NULL, NULL));
+
+	track = !Exx && !Eyy && !Ezz;
 
 	// node & cell coordinates
 	ncx = fs->dsx.ncoor; ccx = fs->dsx.ccoor;
@@ -940,8 +1040,22 @@ PetscErrorCode ADVAdvectMark(AdvCtx *actx)
 		P->U[0] += vx*dt;
 		P->U[1] += vy*dt;
 		P->U[2] += vz*dt;
+
+		// find new host cell (neighbor search from the old host cell)
+		if(track)
+		{
+			I = getTrackedCell(ncx, nx, I, P->X[0]);
+			J = getTrackedCell(ncy, ny, J, P->X[1]);
+			K = getTrackedCell(ncz, nz, K, P->X[2]);
+
+			if(I == -1 || J == -1 || K == -1) actx->cellnum[jj] = -1;
+			else                              GET_CELL_ID(actx->cellnum[jj], I, J, K, nx, ny);
+		}
 	}
 
+	// set host cell tracking flag
+	actx->cellmap = track;
+
 	// restore access
 	PetscCall(DMDAVecRestoreArray(fs->DA_X,   jr->lvx, &lvx));
 	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   jr->lvy, &lvy));
@@ -971,6 +1085,9 @@ PetscErrorCode ADVMapMarkToDomains(AdvCtx *actx)
 	// scan markers
 	for(i = 0, cnt = 0; i < actx->nummark; i++)
 	{
+		// skip markers that stay in local domain (tracked during advection)
+		if(actx->cellmap && actx->cellnum[i] != -1) continue;
+
 		// get marker coordinates
 		X = actx->markers[i].X;
 
@@ -1081,6 +1198,9 @@ PetscErrorCode ADVCreateMPIBuff(AdvCtx *actx)
 	// copy markers to send buffer, store their indices
 	for(i = 0, cnt = 0; i < actx->nummark; i++)
 	{
+		// skip markers that stay in local domain (tracked during advection)
+		if(actx->cellmap && actx->cellnum[i] != -1) continue;
+
 		// get marker coordinates
 		X = actx->markers[i].X;
 
@@ -1181,9 +1301,10 @@ PetscErrorCode ADVDestroyMPIBuff(AdvCtx *actx)
 PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 {
 	// store received markers, collect garbage
+	// host cells are moved with markers (received markers are not mapped)
 
 	Marker   *markers, *recvbuf;
-	PetscInt *idel, nummark, nrecv, ndel;
+	PetscInt *idel, *cellnum, nummark, nrecv, ndel;
 
 	
 	PetscFunctionBeginUser;
@@ -1198,10 +1319,13 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 	ndel    = actx->ndel;
 	idel    = actx->idel;
 
+	cellnum = actx->cellnum;
+
 	// close holes in marker storage
 	while(nrecv && ndel)
 	{
 		markers[idel[ndel-1]] = recvbuf[nrecv-1];
+		cellnum[idel[ndel-1]] = -1;
 		nrecv--;
 		ndel--;
 	}
@@ -1213,10 +1337,12 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 
 		// make sure we have a correct storage pointer
 		markers = actx->markers;
+		cellnum = actx->cellnum;
 
 		// put the rest in the end of marker storage
 		while(nrecv)
 		{
+			cellnum[nummark]   = -1;
 			markers[nummark++] = recvbuf[nrecv-1];
 			nrecv--;
 		}
@@ -1230,6 +1356,7 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 			if(idel[ndel-1] != nummark-1)
 			{
 				markers[idel[ndel-1]] = markers[nummark-1];
+				cellnum[idel[ndel-1]] = cellnum[nummark-1];
 			}
 			nummark--;
 			ndel--;
@@ -1244,11 +1371,17 @@ PetscErrorCode ADVCollectGarbage(AdvCtx *actx)
 //-----------------------------------------------------------------------------
 PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 {
-	// store host cell ID for every marker & list of marker IDs in every cell
+	// store host cell ID for every marker & cluster markers cell-wise
 	// NOTE: this routine MUST be called for the local markers only
+	// NOTE: if host cells are tracked during advection, only markers
+	// received from neighbors (cellnum = -1) are searched
+	// NOTE: markers are physically reordered by host cells (counting sort),
+	// such that markers of cell ID are stored in [markstart[ID], markstart[ID+1])
 
 	FDSTAG      *fs;
+	Marker      *markers;
 	PetscScalar *X;
+	PetscBool    sorted;
 	PetscInt     i, ID, I, J, K, M, N, nummark;
 
 	
@@ -1262,6 +1395,9 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 	// loop over all local particles
 	for(i = 0; i < actx->nummark; i++)
 	{
+		// host cell is known (tracked during advection)
+		if(actx->cellmap && actx->cellnum[i] != -1) continue;
+
 		// get marker coordinates
 		X = actx->markers[i].X;
 
@@ -1281,6 +1417,9 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 		actx->cellnum[i] = ID;
 	}
 
+	// host cells must be recomputed after next position change
+	actx->cellmap = 0;
+
 	// count number of markers per cell
 	PetscCall(clearIntArray(actx->markstart, fs->nCells+1));
 
@@ -1297,11 +1436,27 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Wrong marker-to-cell-mapping (marker counts)");
 	}
 
-	// store marker indices cell-wise
+	// set end-of-array index
+	actx->markstart[fs->nCells] = nummark;
+
+	// check whether markers are already clustered cell-wise
+	sorted = PETSC_TRUE;
+
+	for(i = 1; i < actx->nummark; i++)
+	{
+		if(actx->cellnum[i] < actx->cellnum[i-1]) { sorted = PETSC_FALSE; break; }
+	}
+
+	if(sorted) PetscFunctionReturn(0);
+
+	// access scratch storage for reordered markers
+	markers = actx->markbuf;
+
+	// copy markers cell-wise
 	for(i = 0; i < actx->nummark; i++)
 	{
-		// index
-		actx->markind[actx->markstart[actx->cellnum[i]]] = i;
+		// copy
+		markers[actx->markstart[actx->cellnum[i]]] = actx->markers[i];
 
 		// iterator
 		actx->markstart[actx->cellnum[i]]++;
@@ -1310,8 +1465,15 @@ PetscErrorCode ADVMapMarkToCells(AdvCtx *actx)
 	// rewind iterators
 	rewindPtr(fs->nCells, actx->markstart);
 
-	// set end-of-array index
-	actx->markstart[fs->nCells] = nummark;
+	// update marker storage (swap with scratch storage)
+	actx->markbuf = actx->markers;
+	actx->markers = markers;
+
+	// update host cell IDs
+	for(ID = 0; ID < fs->nCells; ID++)
+	{
+		for(i = actx->markstart[ID]; i < actx->markstart[ID+1]; i++) actx->cellnum[i] = ID;
+	}
 
 	PetscFunctionReturn(0);
 }
@@ -1367,7 +1529,7 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 
 		for(ii = 0; ii < n; ii++)
 		{
-			P = &actx->markers[actx->markind[p+ii]];
+			P = &actx->markers[p+ii];
 
 			// get marker coordinates
 			xp[0] = P->X[0];
@@ -1504,7 +1666,7 @@ PetscErrorCode ADVCheckCorners(AdvCtx *actx)
 						for (ii = 0; ii < nummark[ineigh]; ii++)
 						{
 							// get index
-							ind = actx->markind[actx->markstart[indcell[ineigh]] + ii];
+							ind = actx->markstart[indcell[ineigh]] + ii;
 
 							// save marker
 							markers[jj] = actx->markers[ind];
@@ -1606,6 +1768,8 @@ PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx)
 	jr        = actx->jr;
 	numPhases = actx->dbm->numPhases;
 
+	PetscCall(PerfBegin(_PERF_MARK_PROJ_));
+
 	// check marker phases
 	PetscCall(ADVCheckMarkPhases(actx));
 
@@ -1648,12 +1812,15 @@ PetscErrorCode ADVProjHistMarkToGrid(AdvCtx *actx)
 	// update phase ratios taking into account actual free surface position
 	PetscCall(FreeSurfGetAirPhaseRatio(actx->surf));
 
+	PetscCall(PerfEnd(_PERF_MARK_PROJ_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx)
 {
 	// marker-to-grid projection (cell nodes)
+	// markers are stored cell-wise, each cell is processed by a single thread
 
 	FDSTAG      *fs;
 	JacRes      *jr;
@@ -1675,11 +1842,12 @@ PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx)
 	ny     = fs->dsy.ncels;
 	nCells = fs->nCells;
 
-	// clear history variables
-	for(jj = 0; jj < nCells; jj++)
+	// scan ALL cells
+	OMP(parallel for num_threads(actx->nthreads) schedule(static) private(ii, jj, I, J, K, P, svCell, xp, yp, zp, wxc, wyc, wzc, w))
+	for(ID = 0; ID < nCells; ID++)
 	{
 		// access solution variable
-		svCell = &jr->svCell[jj];
+		svCell = &jr->svCell[ID];
 
 		// clear phase ratios
 		for(ii = 0; ii < numPhases; ii++) svCell->phRat[ii] = 0.0;
@@ -1695,51 +1863,44 @@ PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx)
 		svCell->U[0]       = 0.0;
 		svCell->U[1]       = 0.0;
 		svCell->U[2]       = 0.0;
-	}
-
-	// scan ALL markers
-	for(jj = 0; jj < actx->nummark; jj++)
-	{
-		// access next marker
-		P = &actx->markers[jj];
-
-		// get consecutive index of the host cell
-		ID = actx->cellnum[jj];
 
 		// expand I, J, K cell indices
 		GET_CELL_IJK(ID, I, J, K, nx, ny)
 
-		// get marker coordinates
-		xp = P->X[0];
-		yp = P->X[1];
-		zp = P->X[2];
-
-		// get interpolation weights in cell control volumes
-		wxc = WEIGHT_POINT_CELL(I, xp, fs->dsx);
-		wyc = WEIGHT_POINT_CELL(J, yp, fs->dsy);
-		wzc = WEIGHT_POINT_CELL(K, zp, fs->dsz);
-
-		// get total interpolation weight
-		w = wxc*wyc*wzc;
-
-		// access solution variable of the host cell
-		svCell = &jr->svCell[ID];
-
-		// update phase ratios
-		svCell->phRat[P->phase] += w;
-
-		// update history variables
-		svCell->svBulk.pn += w*P->p;
-		svCell->svBulk.Tn += w*P->T;
-		svCell->svDev.APS += w*P->APS;
-		svCell->ATS       += w*P->ATS;
-		svCell->hxx       += w*P->S.xx;
-		svCell->hyy       += w*P->S.yy;
-		svCell->hzz       += w*P->S.zz;
-		svCell->U[0]      += w*P->U[0];
-		svCell->U[1]      += w*P->U[1];
-		svCell->U[2]      += w*P->U[2];
+		// scan markers of the cell
+		for(jj = actx->markstart[ID]; jj < actx->markstart[ID+1]; jj++)
+		{
+			// access next marker
+			P = &actx->markers[jj];
 
+			// get marker coordinates
+			xp = P->X[0];
+			yp = P->X[1];
+			zp = P->X[2];
+
+			// get interpolation weights in cell control volumes
+			wxc = WEIGHT_POINT_CELL(I, xp, fs->dsx);
+			wyc = WEIGHT_POINT_CELL(J, yp, fs->dsy);
+			wzc = WEIGHT_POINT_CELL(K, zp, fs->dsz);
+
+			// get total interpolation weight
+			w = wxc*wyc*wzc;
+
+			// update phase ratios
+			svCell->phRat[P->phase] += w;
+
+			// update history variables
+			svCell->svBulk.pn += w*P->p;
+			svCell->svBulk.Tn += w*P->T;
+			svCell->svDev.APS += w*P->APS;
+			svCell->ATS       += w*P->ATS;
+			svCell->hxx       += w*P->S.xx;
+			svCell->hyy       += w*P->S.yy;
+			svCell->hzz       += w*P->S.zz;
+			svCell->U[0]      += w*P->U[0];
+			svCell->U[1]      += w*P->U[1];
+			svCell->U[2]      += w*P->U[2];
+		}
 	}
 
 	// normalize interpolated values
@@ -1770,13 +1931,15 @@ PetscErrorCode ADVInterpMarkToCell(AdvCtx *actx)
 PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx, PetscInt iphase, InterpCase icase)
 {
 	// marker-to-grid projection (edge nodes)
+	// cell z-planes are processed in two colors, planes of the same color never
+	// update the same edge node, summation order does not depend on thread count
 
 	FDSTAG      *fs;
 	JacRes      *jr;
 	Marker      *P;
 	PetscScalar  UPXY, UPXZ, UPYZ;
-	PetscInt     nx, ny, sx, sy, sz;
-	PetscInt     jj, ID, I, J, K, II, JJ, KK;
+	PetscInt     nx, ny, nz, sx, sy, sz;
+	PetscInt     jj, ID, I, J, K, II, JJ, KK, L, color;
 	PetscScalar *gxy, *gxz, *gyz, ***lxy, ***lxz, ***lyz;
 	PetscScalar  xc, yc, zc, xp, yp, zp, wxc, wyc, wzc, wxn, wyn, wzn;
 
@@ -1789,7 +1952,7 @@ PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx, PetscInt iphase, InterpCase ica
 	// starting indices & number of cells
 	sx = fs->dsx.pstart; nx = fs->dsx.ncels;
 	sy = fs->dsy.pstart; ny = fs->dsy.ncels;
-	sz = fs->dsz.pstart;
+	sz = fs->dsz.pstart; nz = fs->dsz.ncels;
 
 	// clear local vectors
 	PetscCall(VecZeroEntries(jr->ldxy));
@@ -1804,53 +1967,61 @@ PetscErrorCode ADVInterpMarkToEdge(AdvCtx *actx, PetscInt iphase, InterpCase ica
 	// set interpolated fields to defaults
 	UPXY = 1.0; UPXZ = 1.0; UPYZ = 1.0;
 
-	// scan ALL markers
-	for(jj = 0; jj < actx->nummark; jj++)
+	// scan ALL markers (plane-wise)
+	for(color = 0; color < 2; color++)
 	{
-		// access next marker
-		P = &actx->markers[jj];
-
-		// perform phase ID test
-		if(icase == _PHASE_ && P->phase != iphase) continue;
-
-		// get consecutive index of the host cell
-		ID = actx->cellnum[jj];
-
-		// expand I, J, K cell indices
-		GET_CELL_IJK(ID, I, J, K, nx, ny)
-
-		// get marker coordinates
-		xp = P->X[0];
-		yp = P->X[1];
-		zp = P->X[2];
-
-		// get coordinates of cell center
-		xc = fs->dsx.ccoor[I];
-		yc = fs->dsy.ccoor[J];
-		zc = fs->dsz.ccoor[K];
+		OMP(parallel for num_threads(actx->nthreads) schedule(dynamic, 1) firstprivate(UPXY, UPXZ, UPYZ) private(jj, P, ID, I, J, K, II, JJ, KK, xc, yc, zc, xp, yp, zp, wxc, wyc, wzc, wxn, wyn, wzn))
+		for(L = color; L < nz; L += 2)
+		{
+			// scan markers of the plane
+			for(jj = actx->markstart[L*nx*ny]; jj < actx->markstart[(L+1)*nx*ny]; jj++)
+			{
+				// access next marker
+				P = &actx->markers[jj];
 
-		// map marker on the control volumes of edge nodes
-		if(xp > xc) { II = I+1; } else { II = I; }
-		if(yp > yc) { JJ = J+1; } else { JJ = J; }
-		if(zp > zc) { KK = K+1; } else { KK = K; }
+				// perform phase ID test
+				if(icase == _PHASE_ && P->phase != iphase) continue;
 
-		// get interpolation weights in cell control volumes
-		wxc = WEIGHT_POINT_CELL(I, xp, fs->dsx);
-		wyc = WEIGHT_POINT_CELL(J, yp, fs->dsy);
-		wzc = WEIGHT_POINT_CELL(K, zp, fs->dsz);
+				// get consecutive index of the host cell
+				ID = actx->cellnum[jj];
 
-		// get interpolation weights in node control volumes
-		wxn = WEIGHT_POINT_NODE(II, xp, fs->dsx);
-		wyn = WEIGHT_POINT_NODE(JJ, yp, fs->dsy);
-		wzn = WEIGHT_POINT_NODE(KK, zp, fs->dsz);
+				// expand I, J, K cell indices
+				GET_CELL_IJK(ID, I, J, K, nx, ny)
 
-		if      (icase == _STRESS_) { UPXY = P->S.xy; UPXZ = P->S.xz; UPYZ = P->S.yz; }
-		else if (icase == _APS_)    { UPXY = P->APS;  UPXZ = P->APS;  UPYZ = P->APS;  }
+				// get marker coordinates
+				xp = P->X[0];
+				yp = P->X[1];
+				zp = P->X[2];
 
-		// update required fields from marker to edge nodes
-		lxy[sz+K ][sy+JJ][sx+II] += wxn*wyn*wzc*UPXY;
-		lxz[sz+KK][sy+J ][sx+II] += wxn*wyc*wzn*UPXZ;
-		lyz[sz+KK][sy+JJ][sx+I ] += wxc*wyn*wzn*UPYZ;
+				// get coordinates of cell center
+				xc = fs->dsx.ccoor[I];
+				yc = fs->dsy.ccoor[J];
+				zc = fs->dsz.ccoor[K];
+
+				// map marker on the control volumes of edge nodes
+				if(xp > xc) { II = I+1; } else { II = I; }
+				if(yp > yc) { JJ = J+1; } else { JJ = J; }
+				if(zp > zc) { KK = K+1; } else { KK = K; }
+
+				// get interpolation weights in cell control volumes
+				wxc = WEIGHT_POINT_CELL(I, xp, fs->dsx);
+				wyc = WEIGHT_POINT_CELL(J, yp, fs->dsy);
+				wzc = WEIGHT_POINT_CELL(K, zp, fs->dsz);
+
+				// get interpolation weights in node control volumes
+				wxn = WEIGHT_POINT_NODE(II, xp, fs->dsx);
+				wyn = WEIGHT_POINT_NODE(JJ, yp, fs->dsy);
+				wzn = WEIGHT_POINT_NODE(KK, zp, fs->dsz);
+
+				if      (icase == _STRESS_) { UPXY = P->S.xy; UPXZ = P->S.xz; UPYZ = P->S.yz; }
+				else if (icase == _APS_)    { UPXY = P->APS;  UPXZ = P->APS;  UPYZ = P->APS;  }
+
+				// update required fields from marker to edge nodes
+				lxy[sz+K ][sy+JJ][sx+II] += wxn*wyn*wzc*UPXY;
+				lxz[sz+KK][sy+J ][sx+II] += wxn*wyc*wzn*UPXZ;
+				lyz[sz+KK][sy+JJ][sx+I ] += wxc*wyn*wzn*UPYZ;
+			}
+		}
 	}
 
 	// restore access
@@ -2059,6 +2230,7 @@ PetscErrorCode ADVMarkerAdiabatic(AdvCtx *actx)
 		// access marker
 		P->T+=dT;
 	}
+
 	PetscFunctionReturn(0);
 
 }
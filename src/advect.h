@@ -20,6 +20,7 @@ struct JacRes;
 struct FreeSurf;
 struct DBMat;
 struct P_Tr;
+struct AVD;
 
 //---------------------------------------------------------------------------
 //............   Material marker (history variables advection)   ............
@@ -136,7 +137,8 @@ struct AdvCtx
 	PetscInt      bgPhase;             // background phase ID
 	PetscInt      periodic;            // periodic advection flag
 
-	PetscInt      saveMark;            // flag for saving markers
+	PetscInt      markLoad;            // flag for loading markers from portable restart database
+	PetscInt      saveMark;            // flag for saving markers (1 - file per processor, 2 - single shared file)
 	char          saveFile[_str_len_]; // marker output file name
 
 	AdvectionType advect;              // advection scheme
@@ -144,6 +146,8 @@ struct AdvCtx
 	PetscScalar   A;                   // FDSTAG velocity interpolation parameter
 
 	MarkCtrlType  mctrl;               // marker control type
+	PetscInt      nthreads;            // number of threads for marker-to-grid projection
+	PetscInt      avdthreads;          // number of threads for AVD marker control
 
 	//====================
 	// RUN TIME PARAMETERS
@@ -152,6 +156,7 @@ struct AdvCtx
 	PetscInt    nmin, nmax;       // minimum and maximum number of markers per cell
 	PetscInt    avdx, avdy, avdz; // AVD cells refinement factors
 	PetscInt    npmax;            // maximum number of same phase markers per subcell
+	AVD        *avd;              // thread-local AVD storage (reused between control volumes & steps)
 
 	//=============
 	// COMMUNICATOR
@@ -166,14 +171,15 @@ struct AdvCtx
 	PetscInt  nummark;    // local number of markers
 	PetscInt  markcap;    // capacity of marker storage
 	Marker   *markers;    // storage for local markers
+	Marker   *markbuf;    // scratch storage for reordering markers (same capacity)
 	P_Tr     *Ptr    ;    // storage for Passive tracers
 
 	//========================
 	// MARKER-CELL INTERACTION
 	//========================
 	PetscInt *cellnum;    // host cells local number for each marker
-	PetscInt *markind;    // id (position) of markers clustered for every cell
-	PetscInt *markstart;  // start id in markind for every cell
+	PetscInt *markstart;  // start id of markers in every cell (markers are stored cell-wise)
+	PetscInt  cellmap;    // host cells are tracked during advection (cellnum = -1 for markers leaving local domain)
 
 	//=========
 	// EXCHANGE
@@ -205,6 +211,12 @@ PetscErrorCode ADVReadRestart(AdvCtx *actx, FILE *fp);
 // read advection object from restart database
 PetscErrorCode ADVWriteRestart(AdvCtx *actx, FILE *fp);
 
+// write markers to portable restart database
+PetscErrorCode ADVViewRestart(AdvCtx *actx, const char *filename);
+
+// read markers from portable restart database (any number of processors)
+PetscErrorCode ADVLoadRestart(AdvCtx *actx, const char *filename);
+
 // create communicator and separator
 PetscErrorCode ADVCreateData(AdvCtx *actx);
 
@@ -0,0 +1,388 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ....................... ASYNCHRONOUS FILE WRITER .........................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "asyncWriter.h"
+#include "parsing.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+//---------------------------------------------------------------------------
+// staged file (memory buffers are allocated by the C library, freed by the writer)
+struct AsyncFile
+{
+	char        *name;   // file name
+	char        *data;   // file contents
+	size_t       size;   // number of bytes
+	AsyncFilter  filter; // contents filter (optional)
+	void        *fctx;   // filter context
+};
+//---------------------------------------------------------------------------
+// writer state (one background thread per process)
+struct AsyncWriterCtx
+{
+	PetscInt                  active;  // activation flag
+	PetscInt                  stop;    // termination flag
+	PetscInt                  busy;    // file is being written
+	PetscInt                  failed;  // write error flag
+	char                      errfile[_str_len_]; // name of the failed file
+	PetscErrorCode          (*action)(void*); // deferred collective action
+	void                     *ctx;     // deferred action context
+	map <FILE*, AsyncFile*>   open;    // open memory streams
+	deque <AsyncFile*>        queue;   // staged files
+	thread                    worker;  // background thread
+	mutex                     lock;    // queue protection
+	condition_variable        cvpush;  // file is staged
+	condition_variable        cvdone;  // file is written
+};
+
+static AsyncWriterCtx aw;
+//---------------------------------------------------------------------------
+static int AsyncFileFlush(AsyncFile *af)
+{
+	// apply filter & write file, return nonzero on failure
+
+	FILE   *fp;
+	char   *data;
+	size_t  size, nw;
+
+	if(af->filter)
+	{
+		data = NULL;
+		size = 0;
+
+		if(af->filter(af->fctx, af->data, af->size, &data, &size))
+		{
+			free(data);
+
+			return 1;
+		}
+
+		// replace staged contents
+		if(data)
+		{
+			free(af->data);
+
+			af->data = data;
+			af->size = size;
+		}
+	}
+
+	nw = 0;
+	fp = fopen(af->name, "wb");
+
+	if(fp)
+	{
+		nw = fwrite(af->data, 1, af->size, fp);
+
+		if(fclose(fp)) nw = 0;
+	}
+
+	return (!fp || nw != af->size);
+}
+//---------------------------------------------------------------------------
+static void AsyncFileFree(AsyncFile *af)
+{
+	free(af->name);
+	free(af->data);
+	free(af);
+}
+//---------------------------------------------------------------------------
+static void AsyncWriterLoop()
+{
+	// background thread: write staged files in order of arrival
+
+	AsyncFile *af;
+	int        fail;
+
+	unique_lock <mutex> lk(aw.lock);
+
+	for(;;)
+	{
+		aw.cvpush.wait(lk, []{ return aw.stop || !aw.queue.empty(); });
+
+		// terminate after queue is drained
+		if(aw.queue.empty()) break;
+
+		af = aw.queue.front();
+		aw.queue.pop_front();
+		aw.busy = 1;
+
+		lk.unlock();
+
+		// filter & write file
+		fail = AsyncFileFlush(af);
+
+		lk.lock();
+
+		if(fail && !aw.failed)
+		{
+			aw.failed = 1;
+			strncpy(aw.errfile, af->name, _str_len_-1);
+		}
+
+		AsyncFileFree(af);
+
+		aw.busy = 0;
+
+		aw.cvdone.notify_all();
+	}
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterCreate(FB *fb)
+{
+	PetscInt active;
+
+	PetscFunctionBeginUser;
+
+	active = 0;
+
+	PetscCall(getIntParam(fb, _OPTIONAL_, "out_async", &active, 1, 1));
+
+#ifdef _WIN32
+	// memory streams are not available
+	active = 0;
+#endif
+
+	if(!active || aw.active) PetscFunctionReturn(0);
+
+	aw.active = 1;
+	aw.stop   = 0;
+	aw.busy   = 0;
+	aw.failed = 0;
+	aw.action = NULL;
+	aw.ctx    = NULL;
+
+	aw.worker = thread(AsyncWriterLoop);
+
+	PetscPrintf(PETSC_COMM_WORLD, "Asynchronous output writer is active\n");
+	PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterDestroy()
+{
+	PetscFunctionBeginUser;
+
+	// write pending files & execute deferred action
+	PetscCall(AsyncWriterWait());
+
+	if(!aw.active) PetscFunctionReturn(0);
+
+	{
+		lock_guard <mutex> lk(aw.lock);
+
+		aw.stop = 1;
+	}
+
+	aw.cvpush.notify_all();
+
+	aw.worker.join();
+
+	aw.active = 0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscInt AsyncWriterActive()
+{
+	return aw.active;
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode AsyncWriterStage(const char *name, AsyncFilter filter, void *fctx, FILE **fp)
+{
+	// open memory stream for staged file
+
+	AsyncFile *af;
+
+	PetscFunctionBeginUser;
+
+	(*fp) = NULL;
+
+#ifndef _WIN32
+	af = (AsyncFile*)calloc(1, sizeof(AsyncFile));
+
+	if(!af) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_MEM, "Cannot allocate staging buffer for file %s", name);
+
+	af->name   = strdup(name);
+	af->filter = filter;
+	af->fctx   = fctx;
+
+	(*fp) = open_memstream(&af->data, &af->size);
+
+	if(!(*fp))
+	{
+		free(af->name);
+		free(af);
+
+		PetscFunctionReturn(0);
+	}
+
+	aw.open[*fp] = af;
+#else
+	UNUSED(name);
+	UNUSED(filter);
+	UNUSED(fctx);
+#endif
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterOpen(const char *name, FILE **fp)
+{
+	// WARNING! file pointer is NULL on failure (check as for fopen)
+
+	PetscFunctionBeginUser;
+
+	if(!aw.active)
+	{
+		(*fp) = fopen(name, "wb");
+
+		PetscFunctionReturn(0);
+	}
+
+	PetscCall(AsyncWriterStage(name, NULL, NULL, fp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterOpenFilter(const char *name, AsyncFilter filter, void *fctx, FILE **fp)
+{
+	// WARNING! file pointer is NULL on failure (check as for fopen)
+	// NOTE: file is staged in memory in synchronous mode as well
+
+	PetscFunctionBeginUser;
+
+	PetscCall(AsyncWriterStage(name, filter, fctx, fp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterClose(FILE *fp)
+{
+	AsyncFile *af;
+	char       errfile[_str_len_];
+	int        fail;
+
+	PetscFunctionBeginUser;
+
+	auto it = aw.open.find(fp);
+
+	// regular file
+	if(it == aw.open.end())
+	{
+		fclose(fp);
+
+		PetscFunctionReturn(0);
+	}
+
+	af = it->second;
+
+	aw.open.erase(it);
+
+	// finalize memory stream (sets data & size)
+	fclose(fp);
+
+	// synchronous mode (filtered files only)
+	if(!aw.active)
+	{
+		fail = AsyncFileFlush(af);
+
+		PetscCall(PetscStrncpy(errfile, af->name, _str_len_));
+
+		AsyncFileFree(af);
+
+		if(fail) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Failed to write file %s", errfile);
+
+		PetscFunctionReturn(0);
+	}
+
+	// pass staged file to background thread
+	{
+		lock_guard <mutex> lk(aw.lock);
+
+		aw.queue.push_back(af);
+	}
+
+	aw.cvpush.notify_one();
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterDefer(PetscErrorCode (*action)(void*), void *ctx)
+{
+	PetscFunctionBeginUser;
+
+	// synchronous mode
+	if(!aw.active)
+	{
+		PetscCall(action(ctx));
+
+		PetscFunctionReturn(0);
+	}
+
+	// only one action can be pending
+	if(aw.action) PetscCall(AsyncWriterWait());
+
+	aw.action = action;
+	aw.ctx    = ctx;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode AsyncWriterWait()
+{
+	PetscErrorCode (*action)(void*);
+	PetscInt       failed, gfailed;
+
+	PetscFunctionBeginUser;
+
+	if(!aw.active) PetscFunctionReturn(0);
+
+	// drain local queue
+	{
+		unique_lock <mutex> lk(aw.lock);
+
+		aw.cvdone.wait(lk, []{ return aw.queue.empty() && !aw.busy; });
+
+		failed = aw.failed;
+	}
+
+	// all processes must agree on failure before collective operations
+	PetscCallMPI(MPI_Allreduce(&failed, &gfailed, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD));
+
+	if(gfailed)
+	{
+		// discard deferred action
+		aw.action = NULL;
+
+		if(failed) PetscPrintf(PETSC_COMM_SELF, "Asynchronous writer failed to write file %s\n", aw.errfile);
+
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_WRITE, "Asynchronous writer failed to write output files");
+	}
+
+	// execute deferred action (collective)
+	if(aw.action)
+	{
+		action    = aw.action;
+		aw.action = NULL;
+
+		PetscCallMPI(MPI_Barrier(PETSC_COMM_WORLD));
+
+		PetscCall(action(aw.ctx));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
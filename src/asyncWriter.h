@@ -0,0 +1,64 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ....................... ASYNCHRONOUS FILE WRITER .........................
+//---------------------------------------------------------------------------
+#ifndef __asyncWriter_h__
+#define __asyncWriter_h__
+//---------------------------------------------------------------------------
+
+struct FB;
+
+// filter of staged file contents (output buffer is malloc'ed, nonzero return on failure)
+// contents are written unchanged if filter leaves output buffer NULL (e.g. checksums)
+// WARNING! filter is called from background thread, no PETSc or MPI calls are allowed
+typedef int (*AsyncFilter)(void *ctx, const char *src, size_t n, char **dst, size_t *dn);
+
+//---------------------------------------------------------------------------
+// Output files are staged in memory streams and written to disk by
+// a background thread (one per process), while the next time step proceeds.
+// Only plain file operations are done by the thread (no PETSc or MPI calls).
+// Optionally, staged contents are passed through a filter (e.g. compression)
+// by the background thread before writing.
+//
+// AsyncWriterWait is collective. It blocks until all staged files are
+// written on all processes, and then executes the deferred action
+// (e.g. commit of the temporary restart directory).
+//
+// Without activation (out_async = 0) files are written synchronously.
+//---------------------------------------------------------------------------
+
+// read activation flag and start background thread
+PetscErrorCode AsyncWriterCreate(FB *fb);
+
+// flush all staged files and stop background thread
+PetscErrorCode AsyncWriterDestroy();
+
+// check whether asynchronous writer is active
+PetscInt AsyncWriterActive();
+
+// open output file for writing (memory stream if writer is active)
+PetscErrorCode AsyncWriterOpen(const char *name, FILE **fp);
+
+// open output file staged in memory, filter contents before writing
+// (filter context must stay valid until AsyncWriterWait)
+PetscErrorCode AsyncWriterOpenFilter(const char *name, AsyncFilter filter, void *fctx, FILE **fp);
+
+// close output file (queue staged contents for writing)
+PetscErrorCode AsyncWriterClose(FILE *fp);
+
+// set collective action to execute after all staged files are written
+PetscErrorCode AsyncWriterDefer(PetscErrorCode (*action)(void*), void *ctx);
+
+// wait until all staged files are written, execute deferred action (collective)
+PetscErrorCode AsyncWriterWait();
+
+//---------------------------------------------------------------------------
+#endif
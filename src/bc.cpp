@@ -1026,6 +1026,62 @@ PetscErrorCode BCWriteRestart(BCCtx *bc, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode BCViewRestart(BCCtx *bc, PetscViewer viewer)
+{
+	// store fixed cell flags as cell-centered vector (natural ordering)
+
+	Vec          gflag;
+	PetscScalar *flag;
+	PetscInt     i, nCells;
+
+	PetscFunctionBeginUser;
+
+	if(!bc->fixCell) PetscFunctionReturn(0);
+
+	nCells = bc->fs->nCells;
+
+	PetscCall(DMGetGlobalVector(bc->fs->DA_CEN, &gflag));
+
+	PetscCall(VecGetArray(gflag, &flag));
+
+	for(i = 0; i < nCells; i++) flag[i] = (PetscScalar)bc->fixCellFlag[i];
+
+	PetscCall(VecRestoreArray(gflag, &flag));
+
+	PetscCall(VecView(gflag, viewer));
+
+	PetscCall(DMRestoreGlobalVector(bc->fs->DA_CEN, &gflag));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode BCLoadRestart(BCCtx *bc, PetscViewer viewer)
+{
+	Vec          gflag;
+	PetscScalar *flag;
+	PetscInt     i, nCells;
+
+	PetscFunctionBeginUser;
+
+	if(!bc->fixCell) PetscFunctionReturn(0);
+
+	nCells = bc->fs->nCells;
+
+	PetscCall(DMGetGlobalVector(bc->fs->DA_CEN, &gflag));
+
+	PetscCall(VecLoad(gflag, viewer));
+
+	PetscCall(VecGetArray(gflag, &flag));
+
+	for(i = 0; i < nCells; i++) bc->fixCellFlag[i] = (unsigned char)flag[i];
+
+	PetscCall(VecRestoreArray(gflag, &flag));
+
+	PetscCall(DMRestoreGlobalVector(bc->fs->DA_CEN, &gflag));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode BCCreateData(BCCtx *bc)
 {
 	FDSTAG   *fs;
@@ -1097,8 +1153,8 @@ PetscErrorCode BCReadFixCell(BCCtx *bc, FB *fb)
 	
 	PetscFunctionBeginUser;
 
-	// check activation
-	if(!bc->fixCell) PetscFunctionReturn(0);
+	// check activation (portable restart database provides flags for any partitioning)
+	if(!bc->fixCell || bc->fixCellLoad) PetscFunctionReturn(0);
 
 	// get file name
 	PetscCall(getStringParam(fb, _OPTIONAL_, "fix_cell_file", file, "./bc/cdb"));
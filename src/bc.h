@@ -251,6 +251,7 @@ struct BCCtx
 	// fixed cells (no-flow condition)
 	PetscInt         fixCell;
 	unsigned char   *fixCellFlag;
+	PetscInt         fixCellLoad; // fixed cell flags are loaded from portable restart database
 
 	//========================
 	// TEMPERATURE CONSTRAINTS
@@ -285,6 +286,12 @@ PetscErrorCode BCReadRestart(BCCtx *bc, FILE *fp);
 // write boundary condition context to restart database
 PetscErrorCode BCWriteRestart(BCCtx *bc, FILE *fp);
 
+// write boundary condition context to portable restart database
+PetscErrorCode BCViewRestart(BCCtx *bc, PetscViewer viewer);
+
+// read boundary condition context from portable restart database
+PetscErrorCode BCLoadRestart(BCCtx *bc, PetscViewer viewer);
+
 // allocate internal vectors and arrays
 PetscErrorCode BCCreateData(BCCtx *bc);
 
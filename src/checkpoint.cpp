@@ -0,0 +1,692 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ...................... RESTART DATABASE GENERATIONS ......................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "checkpoint.h"
+#include "asyncWriter.h"
+#include "tools.h"
+//---------------------------------------------------------------------------
+#ifdef _WIN32
+#define fseeko _fseeki64
+#define off_t  __int64
+#endif
+//---------------------------------------------------------------------------
+// manifest status
+enum ManifestStatus
+{
+	_MANIFEST_BAD_  = -1, // corrupted or inconsistent database
+	_MANIFEST_NONE_ =  0, // no manifest (database of older version)
+	_MANIFEST_OK_   =  1  // database matches manifest
+};
+// checksums of the per-processor restart file (computed by the writer)
+struct CheckpointHash
+{
+	long long          size; // number of bytes written (-1 - not available)
+	vector <uint64_t>  sums; // block checksums
+};
+
+static CheckpointHash chash = { -1, vector <uint64_t>() };
+//---------------------------------------------------------------------------
+static PetscInt CheckpointNumBlocks(long long size)
+{
+	if(size <= 0) return 1;
+
+	return (PetscInt)((size + _chk_block_ - 1)/_chk_block_);
+}
+//---------------------------------------------------------------------------
+static uint64_t CheckpointHashBytes(uint64_t h, const char *buff, size_t n)
+{
+	// FNV-1a hash update
+
+	size_t k;
+
+	for(k = 0; k < n; k++)
+	{
+		h ^= (uint64_t)(unsigned char)buff[k];
+		h *= 1099511628211ULL;
+	}
+
+	return h;
+}
+//---------------------------------------------------------------------------
+static int CheckpointHashFilter(void *ctx, const char *src, size_t n, char **dst, size_t *dn)
+{
+	// compute block checksums of staged file, leave contents unchanged
+	// WARNING! called from background thread, no PETSc or MPI calls are allowed
+
+	CheckpointHash *hc;
+	size_t          b, nb, offset;
+
+	hc = (CheckpointHash*)ctx;
+
+	nb = (size_t)CheckpointNumBlocks((long long)n);
+
+	hc->sums.resize(nb);
+
+	for(b = 0; b < nb; b++)
+	{
+		offset = b*(size_t)_chk_block_;
+
+		hc->sums[b] = CheckpointHashBytes(14695981039346656037ULL, src + offset, min(n - offset, (size_t)_chk_block_));
+	}
+
+	hc->size = (long long)n;
+
+	(*dst) = NULL;
+	(*dn)  = 0;
+
+	return 0;
+}
+//---------------------------------------------------------------------------
+static void CheckpointFileList(PetscInt portable, PetscInt markers, PetscMPIInt nproc, vector <char> &names, PetscInt &nfile)
+{
+	// list files of restart database
+	// (portable marker database is only written if markers are advected)
+
+	PetscInt i;
+
+	if(portable) nfile = markers ? 2 : 1;
+	else         nfile = (PetscInt)nproc;
+
+	names.assign((size_t)(nfile*_str_len_), '\0');
+
+	if(portable)
+	{
+		strcpy(names.data(), "prdb.dat");
+
+		if(markers) strcpy(names.data() + _str_len_, "mdb.dat");
+	}
+	else
+	{
+		for(i = 0; i < nfile; i++)
+		{
+			snprintf(names.data() + i*_str_len_, _str_len_, "rdb.%1.8lld.dat", (LLD)i);
+		}
+	}
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode CheckpointChecksum(
+		const char      *dirName,
+		PetscInt         nfile,
+		const char      *names,
+		const long long *sizes,
+		uint64_t        *sums,
+		PetscInt        *fail)
+{
+	// read back files & compute FNV-1a checksums of fixed-size blocks
+	// (blocks are distributed cyclically over processors)
+
+	FILE          *fp;
+	char          *path, *buff;
+	uint64_t       h;
+	long long      offset, left;
+	size_t         nr;
+	PetscMPIInt    rank, nproc;
+	PetscInt       i, b, nb, ib, nblock, lfail;
+
+	PetscFunctionBeginUser;
+
+	PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+	PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &nproc));
+
+	// total number of blocks
+	nblock = 0;
+
+	for(i = 0; i < nfile; i++) nblock += CheckpointNumBlocks(sizes[i]);
+
+	memset(sums, 0, sizeof(uint64_t)*(size_t)nblock);
+
+	buff  = (char*)malloc(1048576);
+	lfail = 0;
+	ib    = 0;
+
+	for(i = 0; i < nfile; i++)
+	{
+		nb = CheckpointNumBlocks(sizes[i]);
+		fp = NULL;
+
+		asprintf(&path, "%s/%s", dirName, names + i*_str_len_);
+
+		for(b = 0; b < nb; b++, ib++)
+		{
+			if(ib % nproc != rank) continue;
+
+			// open file once for all local blocks
+			if(!fp) fp = fopen(path, "rb");
+
+			if(!fp) { lfail = 1; break; }
+
+			offset = (long long)b*_chk_block_;
+			left   = min(sizes[i] - offset, (long long)_chk_block_);
+			h      = 14695981039346656037ULL;
+
+			if(fseeko(fp, (off_t)offset, SEEK_SET)) lfail = 1;
+
+			while(!lfail && left > 0)
+			{
+				nr = fread(buff, 1, (size_t)min(left, 1048576LL), fp);
+
+				if(!nr) { lfail = 1; break; }
+
+				h = CheckpointHashBytes(h, buff, nr);
+
+				left -= (long long)nr;
+			}
+
+			sums[ib] = h;
+		}
+
+		if(fp) fclose(fp);
+
+		free(path);
+	}
+
+	free(buff);
+
+	// each block is computed by one processor
+	PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, sums, (PetscMPIInt)nblock, MPI_UINT64_T, MPI_BXOR, PETSC_COMM_WORLD));
+
+	PetscCallMPI(MPI_Allreduce(&lfail, fail, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode CheckpointFileSizes(
+		const char      *dirName,
+		PetscInt         nfile,
+		const char      *names,
+		long long       *sizes)
+{
+	// get file sizes on rank zero & distribute (-1 - missing file)
+
+	struct stat s;
+	char        *path;
+	PetscInt    i;
+
+	PetscFunctionBeginUser;
+
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		for(i = 0; i < nfile; i++)
+		{
+			asprintf(&path, "%s/%s", dirName, names + i*_str_len_);
+
+			if(stat(path, &s)) sizes[i] = -1;
+			else               sizes[i] = (long long)s.st_size;
+
+			free(path);
+		}
+	}
+
+	PetscCallMPI(MPI_Bcast(sizes, (PetscMPIInt)nfile, MPI_LONG_LONG, 0, PETSC_COMM_WORLD));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode CheckpointReadManifest(
+		const char          *dirName,
+		PetscInt            *status,
+		vector <char>       &names,
+		vector <long long>  &sizes,
+		vector <uint64_t>   &sums)
+{
+	// read manifest on rank zero & distribute
+
+	FILE               *fp;
+	char               *path;
+	unsigned long long  h;
+	long long           size, nb, nf;
+	PetscInt            i, j, nfile, nblock, st;
+
+	PetscFunctionBeginUser;
+
+	st     = _MANIFEST_NONE_;
+	nfile  = 0;
+	nblock = 0;
+
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		asprintf(&path, "%s/%s", dirName, _chk_manifest_);
+
+		fp = fopen(path, "r");
+
+		free(path);
+
+		if(fp)
+		{
+			st = _MANIFEST_BAD_;
+
+			if(fscanf(fp, " LaMEM restart manifest nfile %lld", &nf) == 1 && nf > 0)
+			{
+				nfile = (PetscInt)nf;
+
+				names.assign((size_t)(nfile*_str_len_), '\0');
+				sizes.resize((size_t)nfile);
+
+				for(i = 0; i < nfile; i++)
+				{
+					if(fscanf(fp, " %259s %lld %lld", names.data() + i*_str_len_, &size, &nb) != 3
+					|| nb != CheckpointNumBlocks(size)) break;
+
+					sizes[(size_t)i] = size;
+
+					for(j = 0; j < nb; j++)
+					{
+						if(fscanf(fp, " %llx", &h) != 1) break;
+
+						sums.push_back((uint64_t)h);
+					}
+
+					if(j != nb) break;
+				}
+
+				if(i == nfile)
+				{
+					st     = _MANIFEST_OK_;
+					nblock = (PetscInt)sums.size();
+				}
+			}
+
+			fclose(fp);
+		}
+	}
+
+	PetscCallMPI(MPI_Bcast(&st, 1, MPIU_INT, 0, PETSC_COMM_WORLD));
+
+	if(st != _MANIFEST_OK_)
+	{
+		(*status) = st;
+
+		PetscFunctionReturn(0);
+	}
+
+	PetscCallMPI(MPI_Bcast(&nfile,  1, MPIU_INT, 0, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Bcast(&nblock, 1, MPIU_INT, 0, PETSC_COMM_WORLD));
+
+	names.resize((size_t)(nfile*_str_len_));
+	sizes.resize((size_t)nfile);
+	sums .resize((size_t)nblock);
+
+	PetscCallMPI(MPI_Bcast(names.data(), (PetscMPIInt)(nfile*_str_len_), MPI_CHAR,      0, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Bcast(sizes.data(), (PetscMPIInt)nfile,             MPI_LONG_LONG, 0, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Bcast(sums .data(), (PetscMPIInt)nblock,            MPI_UINT64_T,  0, PETSC_COMM_WORLD));
+
+	(*status) = st;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode CheckpointVerify(const char *dirName, PetscInt *status)
+{
+	vector <char>      names;
+	vector <long long> sizes, check;
+	vector <uint64_t>  sums, comp;
+	PetscInt           i, nfile, fail;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(CheckpointReadManifest(dirName, status, names, sizes, sums));
+
+	if((*status) != _MANIFEST_OK_) PetscFunctionReturn(0);
+
+	nfile = (PetscInt)sizes.size();
+
+	// check file sizes
+	check.resize((size_t)nfile);
+
+	PetscCall(CheckpointFileSizes(dirName, nfile, names.data(), check.data()));
+
+	for(i = 0; i < nfile; i++)
+	{
+		if(check[(size_t)i] != sizes[(size_t)i])
+		{
+			(*status) = _MANIFEST_BAD_;
+
+			PetscFunctionReturn(0);
+		}
+	}
+
+	// check file contents
+	comp.resize(sums.size());
+
+	PetscCall(CheckpointChecksum(dirName, nfile, names.data(), sizes.data(), comp.data(), &fail));
+
+	if(fail || comp != sums) (*status) = _MANIFEST_BAD_;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+void CheckpointGenName(PetscInt gen, char *dirName)
+{
+	if(!gen) snprintf(dirName, _str_len_, "./restart");
+	else     snprintf(dirName, _str_len_, "./restart.%lld", (LLD)gen);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointStart()
+{
+	int status;
+
+	PetscFunctionBeginUser;
+
+	// create temporary restart directory
+	PetscCall(DirMake("./restart-tmp"));
+
+	// temporary database is incomplete until manifest is written
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		status = remove("./restart-tmp/" _chk_manifest_);
+
+		if(status && errno != ENOENT)
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to delete file ./restart-tmp/%s", _chk_manifest_);
+		}
+	}
+
+	PetscCallMPI(MPI_Barrier(PETSC_COMM_WORLD));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointOpen(const char *name, FILE **fp)
+{
+	// WARNING! file pointer is NULL on failure (check as for fopen)
+	// NOTE: file is staged in memory in synchronous mode as well
+	// NOTE: checksums are updated by the writer (valid after AsyncWriterWait)
+
+	PetscFunctionBeginUser;
+
+	PetscCall(AsyncWriterOpenFilter(name, CheckpointHashFilter, &chash, fp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointCommit(PetscInt portable, PetscInt markers, PetscInt keep)
+{
+	FILE               *fp;
+	vector <char>      names;
+	vector <long long> sizes;
+	vector <uint64_t>  sums;
+	PetscMPIInt        rank, nproc;
+	PetscInt           i, j, ib, nb, nfile, nblock, fail;
+
+	PetscFunctionBeginUser;
+
+	PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+	PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &nproc));
+
+	// list & check database files
+	CheckpointFileList(portable, markers, nproc, names, nfile);
+
+	sizes.resize((size_t)nfile);
+
+	PetscCall(CheckpointFileSizes("./restart-tmp", nfile, names.data(), sizes.data()));
+
+	nblock = 0;
+
+	for(i = 0; i < nfile; i++)
+	{
+		if(sizes[(size_t)i] < 0)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_OPEN, "Missing restart file ./restart-tmp/%s", names.data() + i*_str_len_);
+		}
+
+		nblock += CheckpointNumBlocks(sizes[(size_t)i]);
+	}
+
+	sums.resize((size_t)nblock);
+
+	if(portable)
+	{
+		// portable database is written by PETSc viewers (read back files)
+		PetscCall(CheckpointChecksum("./restart-tmp", nfile, names.data(), sizes.data(), sums.data(), &fail));
+
+		if(fail)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_READ, "Failed to read back restart database ./restart-tmp");
+		}
+	}
+	else
+	{
+		// collect checksums computed while writing (one file per processor)
+		memset(sums.data(), 0, sizeof(uint64_t)*(size_t)nblock);
+
+		fail = (chash.size != sizes[(size_t)rank]);
+
+		if(!fail)
+		{
+			for(i = 0, ib = 0; i < rank; i++) ib += CheckpointNumBlocks(sizes[(size_t)i]);
+
+			for(j = 0; j < (PetscInt)chash.sums.size(); j++) sums[(size_t)(ib + j)] = chash.sums[(size_t)j];
+		}
+
+		PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, &fail, 1, MPIU_INT, MPI_MAX, PETSC_COMM_WORLD));
+
+		if(fail)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_WRITE, "Checksums do not match restart database ./restart-tmp");
+		}
+
+		PetscCallMPI(MPI_Reduce(ISRankZero(PETSC_COMM_WORLD) ? MPI_IN_PLACE : sums.data(), sums.data(), (PetscMPIInt)nblock, MPI_UINT64_T, MPI_BXOR, 0, PETSC_COMM_WORLD));
+	}
+
+	// write manifest
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		fp = fopen("./restart-tmp/" _chk_manifest_, "w");
+
+		if(!fp) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_OPEN, "Cannot open file ./restart-tmp/%s", _chk_manifest_);
+
+		fprintf(fp, "LaMEM restart manifest\n");
+		fprintf(fp, "nfile %lld\n", (LLD)nfile);
+
+		for(i = 0, ib = 0; i < nfile; i++)
+		{
+			nb = CheckpointNumBlocks(sizes[(size_t)i]);
+
+			fprintf(fp, "%s %lld %lld\n", names.data() + i*_str_len_, sizes[(size_t)i], (LLD)nb);
+
+			for(j = 0; j < nb; j++, ib++)
+			{
+				fprintf(fp, "%016llx\n", (unsigned long long)sums[(size_t)ib]);
+			}
+		}
+
+		if(fclose(fp)) SETERRQ(PETSC_COMM_SELF, PETSC_ERR_FILE_WRITE, "Failed to write file ./restart-tmp/%s", _chk_manifest_);
+	}
+
+	// shift generations
+	PetscCall(CheckpointRotate(keep));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointRotate(PetscInt keep)
+{
+	// shift generations & promote temporary database (keep <= 0 - keep all)
+	// WARNING! a complete database exists at every stage
+
+	char     dirName[_str_len_], newName[_str_len_];
+	PetscInt k, ngen, exists;
+
+	PetscFunctionBeginUser;
+
+	// count generations (latest may be missing after interrupted update)
+	ngen = 0;
+
+	for(k = 0; ; k++)
+	{
+		CheckpointGenName(k, dirName);
+
+		PetscCall(DirCheck(dirName, &exists));
+
+		if(exists) ngen = k+1;
+		else if(k) break;
+	}
+
+	// delete expired generations
+	if(keep > 0)
+	{
+		for(k = keep-1; k < ngen; k++)
+		{
+			CheckpointGenName(k, dirName);
+
+			PetscCall(DirCheck(dirName, &exists));
+
+			if(exists) PetscCall(CheckpointDelete(dirName));
+		}
+
+		ngen = min(ngen, keep-1);
+	}
+
+	// shift remaining generations
+	for(k = ngen-1; k >= 0; k--)
+	{
+		CheckpointGenName(k,   dirName);
+		CheckpointGenName(k+1, newName);
+
+		PetscCall(DirCheck(dirName, &exists));
+
+		if(exists) PetscCall(DirRename(dirName, newName));
+	}
+
+	// push temporary database to actual
+	PetscCall(DirRename("./restart-tmp", "./restart"));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointFind(char *dirName, PetscInt *found)
+{
+	PetscInt k, exists, status;
+
+	PetscFunctionBeginUser;
+
+	(*found) = 0;
+
+	// complete temporary database takes precedence (interrupted update)
+	PetscCall(DirCheck("./restart-tmp", &exists));
+
+	if(exists)
+	{
+		PetscCall(CheckpointVerify("./restart-tmp", &status));
+
+		if(status == _MANIFEST_OK_)
+		{
+			PetscPrintf(PETSC_COMM_WORLD, "Completing interrupted update of restart database\n");
+
+			PetscCall(CheckpointRotate(0));
+
+			CheckpointGenName(0, dirName);
+
+			(*found) = 1;
+
+			PetscFunctionReturn(0);
+		}
+	}
+
+	// latest valid generation
+	for(k = 0; ; k++)
+	{
+		CheckpointGenName(k, dirName);
+
+		PetscCall(DirCheck(dirName, &exists));
+
+		if(!exists)
+		{
+			if(k) break;
+			else  continue;
+		}
+
+		PetscCall(CheckpointVerify(dirName, &status));
+
+		if(status != _MANIFEST_BAD_)
+		{
+			(*found) = 1;
+
+			PetscFunctionReturn(0);
+		}
+
+		PetscPrintf(PETSC_COMM_WORLD, "Restart database %s is corrupted, trying previous generation\n", dirName);
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode CheckpointDelete(const char *dirName)
+{
+	// delete database directory with all files
+
+	vector <char>      names;
+	vector <long long> sizes;
+	vector <uint64_t>  sums;
+	PetscMPIInt        rank;
+	PetscInt           i, status;
+	char               *fileName;
+
+	PetscFunctionBeginUser;
+
+	PetscCallMPI(MPI_Comm_rank(PETSC_COMM_WORLD, &rank));
+
+	PetscCall(CheckpointReadManifest(dirName, &status, names, sizes, sums));
+
+	// WARNING! missing files are ignored
+
+	// files listed in manifest
+	if(ISRankZero(PETSC_COMM_WORLD) && status == _MANIFEST_OK_)
+	{
+		for(i = 0; i < (PetscInt)sizes.size(); i++)
+		{
+			asprintf(&fileName, "%s/%s", dirName, names.data() + i*_str_len_);
+
+			if(remove(fileName) && errno != ENOENT)
+			{
+				SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to delete file %s", fileName);
+			}
+
+			free(fileName);
+		}
+	}
+
+	PetscCallMPI(MPI_Barrier(PETSC_COMM_WORLD));
+
+	// database without manifest (or stale files)
+	asprintf(&fileName, "%s/rdb.%1.8lld.dat", dirName, (LLD)rank);
+
+	if(remove(fileName) && errno != ENOENT)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to delete file %s", fileName);
+	}
+
+	free(fileName);
+
+	if(ISRankZero(PETSC_COMM_WORLD))
+	{
+		const char *extra[] = { "prdb.dat", "mdb.dat", _chk_manifest_ };
+
+		for(i = 0; i < 3; i++)
+		{
+			asprintf(&fileName, "%s/%s", dirName, extra[i]);
+
+			if(remove(fileName) && errno != ENOENT)
+			{
+				SETERRQ(PETSC_COMM_SELF, PETSC_ERR_USER, "Failed to delete file %s", fileName);
+			}
+
+			free(fileName);
+		}
+	}
+
+	PetscCall(DirRemove(dirName));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,62 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ...................... RESTART DATABASE GENERATIONS ......................
+//---------------------------------------------------------------------------
+#ifndef __checkpoint_h__
+#define __checkpoint_h__
+//---------------------------------------------------------------------------
+
+// Restart databases are saved in generation directories:
+//
+//    ./restart-tmp - database that is currently written
+//    ./restart     - latest database (generation 0)
+//    ./restart.1   - previous database (generation 1)
+//    ./restart.N   - ...
+//
+// Once all files of a new database are written, a manifest with file sizes
+// and checksums is added, and generations are shifted by renaming. Checksums
+// of the per-processor files are computed from the staged contents while they
+// are written, files are only read back to validate a database on load. A database
+// that fails validation on load is skipped in favor of the previous one.
+// A complete temporary database (valid manifest) is used if renaming was
+// interrupted.
+
+#define _chk_manifest_ "manifest.dat"
+
+// checksum block size (blocks are distributed over processors)
+#define _chk_block_ 16777216
+
+//---------------------------------------------------------------------------
+
+// compose directory name of database generation
+void CheckpointGenName(PetscInt gen, char *dirName);
+
+// create temporary database directory, remove stale manifest
+PetscErrorCode CheckpointStart();
+
+// open per-processor restart file (staged in memory, checksums computed on write)
+PetscErrorCode CheckpointOpen(const char *name, FILE **fp);
+
+// write manifest of temporary database & shift generations
+// (markers - portable database contains marker file)
+PetscErrorCode CheckpointCommit(PetscInt portable, PetscInt markers, PetscInt keep);
+
+// shift generations & promote temporary database (keep <= 0 - keep all)
+PetscErrorCode CheckpointRotate(PetscInt keep);
+
+// find latest valid database (databases without manifest are accepted)
+PetscErrorCode CheckpointFind(char *dirName, PetscInt *found);
+
+// delete database directory with all files
+PetscErrorCode CheckpointDelete(const char *dirName);
+
+//---------------------------------------------------------------------------
+#endif
@@ -317,15 +317,18 @@ PetscErrorCode setUpPhase(ConstEqCtx *ctx, PetscInt ID)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode devConstEq(ConstEqCtx *ctx)
+PetscErrorCode devConstEqAdd(ConstEqCtx *ctx)
 {
-	// evaluate deviatoric constitutive equations in control volume
+	// store control volume in the evaluation batch and append its present phases
+	// (phase viscosities are computed for the entire batch by ConstEqBatchSolve)
 
-	Controls    *ctrl;
-	PetscScalar *phRat;
-	SolVarDev   *svDev;
-	Material_t  *mat;
-	PetscInt     i, numPhases;
+	Controls     *ctrl;
+	PetscScalar  *phRat;
+	SolVarDev    *svDev;
+	Material_t   *mat;
+	ConstEqBatch *bt;
+	CtrlVol      *cv;
+	PetscInt      i, numPhases;
 
 	PetscFunctionBeginUser;
 
@@ -334,9 +337,83 @@ PetscErrorCode devConstEq(ConstEqCtx *ctx)
 	numPhases = ctx->numPhases;
 	phRat     = ctx->phRat;
 	svDev     = ctx->svDev;
+	bt        = &ctx->batch;
+
+	if(bt->nv == _max_batch_size_)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Too many control volumes in constitutive equation batch");
+	}
+
+	// store control volume parameters
+	cv         = &bt->cv[bt->nv++];
+	cv->phRat  = ctx->phRat;
+	cv->svDev  = ctx->svDev;
+	cv->svBulk = ctx->svBulk;
+	cv->p      = ctx->p;
+	cv->p_lith = ctx->p_lith;
+	cv->p_pore = ctx->p_pore;
+	cv->T      = ctx->T;
+	cv->DII    = ctx->DII;
+	cv->Le     = ctx->Le;
+	cv->depth  = ctx->depth;
+	cv->ls     = bt->n;
+
+	// zero out stabilization and viscoplastic viscosity
+	svDev->eta_st = 0.0;
+
+	// scan all phases (no lanes for viscous initial guess)
+	for(i = 0; i < numPhases && !ctrl->initGuess; i++)
+	{
+		// update present phases only
+		if(phRat[i])
+		{
+			// setup phase parameters
+			PetscCall(setUpPhase(ctx, i));
+
+			// store phase parameters in the batch
+			PetscCall(ConstEqBatchAddPhase(bt, ctx, i));
+
+			// update stabilization and viscoplastic viscosity
+			mat            = ctx->phases + i;
+			svDev->eta_st += phRat[i]*mat->eta_st;
+		}
+	}
+
+	cv->le = bt->n;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode devConstEqGet(ConstEqCtx *ctx, PetscInt iv)
+{
+	// restore control volume from the evaluation batch and collect its results
+
+	Controls     *ctrl;
+	ConstEqBatch *bt;
+	CtrlVol      *cv;
+
+	PetscFunctionBeginUser;
+
+	// access context
+	ctrl = ctx->ctrl;
+	bt   = &ctx->batch;
+	cv   = &bt->cv[iv];
+
+	// restore control volume parameters
+	ctx->phRat  = cv->phRat;
+	ctx->svDev  = cv->svDev;
+	ctx->svBulk = cv->svBulk;
+	ctx->p      = cv->p;
+	ctx->p_lith = cv->p_lith;
+	ctx->p_pore = cv->p_pore;
+	ctx->T      = cv->T;
+	ctx->DII    = cv->DII;
+	ctx->Le     = cv->Le;
+	ctx->depth  = cv->depth;
 
 	// zero out results
 	ctx->eta    = 0.0; // effective viscosity
+	ctx->deta   = 0.0; // viscosity derivative
 	ctx->eta_cr = 0.0; // creep viscosity
 	ctx->DIIdif = 0.0; // diffusion creep strain rate
 	ctx->DIIdis = 0.0; // dislocation creep strain rate
@@ -345,9 +422,6 @@ PetscErrorCode devConstEq(ConstEqCtx *ctx)
 	ctx->DIIpl  = 0.0; // plastic strain rate
 	ctx->yield  = 0.0; // yield stress
 
-	// zero out stabilization and viscoplastic viscosity
-	svDev->eta_st = 0.0;
-
 	// viscous initial guess
 	if(ctrl->initGuess)
 	{
@@ -358,23 +432,8 @@ PetscErrorCode devConstEq(ConstEqCtx *ctx)
 		PetscFunctionReturn(0);
 	}
 
-	// scan all phases
-	for(i = 0; i < numPhases; i++)
-	{
-		// update present phases only
-		if(phRat[i])
-		{
-			// setup phase parameters
-			PetscCall(setUpPhase(ctx, i));
-
-			// compute phase viscosities and strain rate partitioning
-			PetscCall(getPhaseVisc(ctx, i));
-
-			// update stabilization and viscoplastic viscosity
-			mat            = ctx->phases + i;
-			svDev->eta_st += phRat[i]*mat->eta_st;
-		}
-	}
+	// update results
+	ConstEqBatchCollect(bt, ctx, cv->ls, cv->le);
 
 	// normalize strain rates
 	if(ctx->DII)
@@ -389,175 +448,255 @@ PetscErrorCode devConstEq(ConstEqCtx *ctx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
-PetscErrorCode getPhaseVisc(ConstEqCtx *ctx, PetscInt ID)
+void ConstEqBatchClear(ConstEqBatch *bt)
 {
-	// compute phase viscosities and strain rate partitioning
+	// clear evaluation batch
 
-	Controls    *ctrl;
-	PetscInt    it, conv;
-	PetscScalar eta_min, eta_mean, eta, eta_cr, tauII, taupl, DII;
-	PetscScalar DIIdif, DIImax, DIIdis, DIIprl, DIIpl, DIIplc, DIIfk, DIIvs, phRat;
-	PetscScalar inv_eta_els, inv_eta_dif, inv_eta_max, inv_eta_dis, inv_eta_prl, inv_eta_fk, inv_eta_min;
+	bt->n  = 0;
+	bt->nv = 0;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ConstEqBatchAddPhase(ConstEqBatch *bt, ConstEqCtx *ctx, PetscInt ID)
+{
+	// append current phase parameters to evaluation batch
+
+	PetscInt l;
 
 	PetscFunctionBeginUser;
 
-	// access context
-	ctrl   = ctx->ctrl;      // global controls
-	phRat  = ctx->phRat[ID]; // phase ratio
-	taupl  = ctx->taupl;     // plastic yield stress
-	DII    = ctx->DII;       // effective strain rate
+	l = bt->n++;
+
+	bt->phRat [l] = ctx->phRat[ID];
+	bt->DII   [l] = ctx->DII;
+	bt->A_lin [l] = ctx->A_els + ctx->A_dif + ctx->A_max + ctx->A_fk;
+	bt->A_dif [l] = ctx->A_dif;
+	bt->A_max [l] = ctx->A_max;
+	bt->A_dis [l] = ctx->A_dis;
+	bt->N_dis [l] = ctx->N_dis;
+	bt->A_prl [l] = ctx->A_prl;
+	bt->N_prl [l] = ctx->N_prl;
+	bt->A_fk  [l] = ctx->A_fk;
+	bt->taupl [l] = ctx->taupl;
+	bt->eta_vp[l] = ctx->taupl ? ctx->eta_vp : 0.0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static inline PetscScalar getBatchRes(ConstEqBatch *bt, PetscInt l, PetscScalar tauII)
+{
+	// compute residual of the visco-elastic constitutive equation in a lane
+	// r < 0 if stress > solution (negative on overshoot)
+	// r > 0 if stress < solution (positive on undershoot)
 
-	// initialize
-	it     = 1;
-	conv   = 1;
-	DIIpl  = 0.0;
-	eta_cr = 0.0;
+	return bt->DII[l] - (bt->A_lin[l]*tauII
+	+ bt->A_dis[l]*pow(tauII, bt->N_dis[l])
+	+ bt->A_prl[l]*pow(tauII, bt->N_prl[l]));
+}
+//---------------------------------------------------------------------------
+void ConstEqBatchSolve(ConstEqBatch *bt, PetscScalar lrtol, PetscInt lmaxit)
+{
+	// compute phase viscosities for all lanes of the batch
+	//
+	// Visco-elastic equation is solved by Newton iteration for the logarithm
+	// of stress (x = ln(tauII)), for which the residual f(x) = ln(S(x)/DII),
+	// S = A_lin*tauII + A_dis*tauII^N_dis + A_prl*tauII^N_prl, is convex and
+	// monotonically increasing. Starting from the minimum of the isolated
+	// mechanism stresses (upper bound, f >= 0) the iterates decrease monotonically
+	// and converge without bracketing. All lanes follow the same fixed schedule
+	// (masked updates) so that the iteration loop vectorizes.
+
+	PetscInt    l, n, it, nact, upd, conv, *act, *lit, *lconv;
+	PetscScalar x, tau, lin, pdis, pprl, S, dS, DII, DIIpl, DIIplc, tauII;
+	PetscScalar *lnt;
+
+	n     = bt->n;
+	lnt   = bt->lnt;
+	act   = bt->act;
+	lit   = bt->it;
+	lconv = bt->conv;
 
 	//===========
 	// PLASTICITY
 	//===========
 
-	if(taupl && DII)
+	for(l = 0; l < n; l++)
 	{
-		// get initial yield stress and viscosity
-		tauII = taupl;
-		eta   = tauII/(2.0*DII);
+		DII   = bt->DII[l];
+		DIIpl = 0.0;
+		it    = 1;
+		conv  = 1;
+		tauII = 0.0;
 
-		// compute initial plastic strain rate
-		DIIpl = getConsEqRes(eta, ctx);
-
-		// reset if plasticity is not active
-		if(DIIpl < 0.0)
-		{
-			DIIpl = 0.0;
-		}
-		else if(ctx->eta_vp)
+		if(bt->taupl[l] && DII)
 		{
-			//================================================================
-			// solve regularized visco-plastic strain by fixed-point iteration
-			//================================================================
-			do
+			// get initial yield stress, compute initial plastic strain rate
+			tauII = bt->taupl[l];
+			DIIpl = getBatchRes(bt, l, tauII);
+
+			// reset if plasticity is not active
+			if(DIIpl < 0.0)
 			{
-				// get regularized yield stress and viscosity
-				tauII = taupl + 2.0*ctx->eta_vp*DIIpl;
-				eta   = tauII/(2.0*DII);
+				DIIpl = 0.0;
+			}
+			else if(bt->eta_vp[l])
+			{
+				// solve regularized visco-plastic strain by fixed-point iteration
+				do
+				{
+					tauII  = bt->taupl[l] + 2.0*bt->eta_vp[l]*DIIpl;
+					DIIplc = DIIpl;
+					DIIpl  = getBatchRes(bt, l, tauII);
+					conv   = (PetscAbsScalar((DIIpl - DIIplc)/DII) <= lrtol);
 
-			    // store current strain strain rate
-			    DIIplc = DIIpl;
+				} while(!conv && ++it < lmaxit);
+			}
+		}
+
+		bt->DIIpl[l] = DIIpl;
+		bt->tauII[l] = tauII;
+		lit      [l] = it;
+		lconv    [l] = conv;
+		act      [l] = 0;
 
-				// compute updated plastic strain rate
-				DIIpl = getConsEqRes(eta, ctx);
+		if(DIIpl) continue;
 
-				// set convergence flag
-				conv = (PetscAbsScalar((DIIpl - DIIplc)/DII) <= ctrl->lrtol);
+		//=================
+		// VISCO-ELASTICITY
+		//=================
 
-			} while(!conv && ++it < ctrl->lmaxit);
+		if(!DII)
+		{
+			// zero strain rate, only linear mechanisms contribute
+			bt->tauII[l] = 0.0;
+			continue;
 		}
-	}
 
-	//=================
-	// VISCO-ELASTICITY
-	//=================
-	if(!DIIpl)
-	{
-		// get isolated viscosities
-		inv_eta_els = 0.0;
-		inv_eta_dif = 0.0;
-		inv_eta_max = 0.0;
-		inv_eta_dis = 0.0;
-		inv_eta_prl = 0.0;
-		inv_eta_fk  = 0.0;
-
-		// elasticity
-		if(ctx->A_els) inv_eta_els = 2.0*ctx->A_els;
-		// diffusion
-		if(ctx->A_dif) inv_eta_dif = 2.0*ctx->A_dif;
-		// upper bound
-		if(ctx->A_max) inv_eta_max = 2.0*ctx->A_max;
-		// dislocation
-		if(ctx->A_dis) inv_eta_dis = 2.0*pow(ctx->A_dis, 1.0/ctx->N_dis)*pow(DII, 1.0 - 1.0/ctx->N_dis);
-		// Peierls
-		if(ctx->A_prl) inv_eta_prl = 2.0*pow(ctx->A_prl, 1.0/ctx->N_prl)*pow(DII, 1.0 - 1.0/ctx->N_prl);
-		// Frank-Kamenetzky
-		if(ctx->A_fk)  inv_eta_fk  = 2.0*ctx->A_fk;
-
-		// get minimum viscosity (upper bound)
-		inv_eta_min                               = inv_eta_els;
-		if(inv_eta_dif > inv_eta_min) inv_eta_min = inv_eta_dif;
-		if(inv_eta_max > inv_eta_min) inv_eta_min = inv_eta_max;
-		if(inv_eta_dis > inv_eta_min) inv_eta_min = inv_eta_dis;
-		if(inv_eta_prl > inv_eta_min) inv_eta_min = inv_eta_prl;
-		if(inv_eta_fk  > inv_eta_min) inv_eta_min = inv_eta_fk;
-		eta_min = 1.0/inv_eta_min;
-
-		// get quasi-harmonic mean (lower bound)
-		eta_mean = 1.0/(inv_eta_els + inv_eta_dif + inv_eta_max + inv_eta_dis + inv_eta_prl + inv_eta_fk);
-
-		// NOTE: if closed-form solution exists, it is equal to lower bound
-		// If only one mechanism is active, then both bounds are coincident
-		// Bisection will return immediately if closed-form solution exists
-
-		// apply bisection algorithm to nonlinear scalar equation
-		conv = solveBisect(eta_mean, eta_min, ctrl->lrtol*DII, ctrl->lmaxit, eta, it, getConsEqRes, ctx);
-
-		// compute stress
-		tauII = 2.0*eta*DII;
+		// get initial guess (minimum of isolated mechanism stresses)
+		x = DBL_MAX;
+
+		if(bt->A_lin[l])                                 x = log(DII/bt->A_lin[l]);
+		if(bt->A_dis[l]) { tau = log(DII/bt->A_dis[l])/bt->N_dis[l]; if(tau < x) x = tau; }
+		if(bt->A_prl[l]) { tau = log(DII/bt->A_prl[l])/bt->N_prl[l]; if(tau < x) x = tau; }
+
+		lnt[l] = x;
+		act[l] = (x != DBL_MAX);
+		lit[l] = 0;
 	}
 
-	// update iteration statistics
-	ctx->stats[0] += 1.0;               // start counter
-	ctx->stats[1] += (PetscScalar)conv; // convergence counter
-	ctx->stats[2] += (PetscScalar)it;   // iteration counter
+	// count unconverged lanes
+	nact = 0;
 
-	// compute strain rates
-	DIIdif = ctx->A_dif*tauII;                  // diffusion
-	DIImax = ctx->A_max*tauII;                  // upper bound
-	DIIdis = ctx->A_dis*pow(tauII, ctx->N_dis); // dislocation
-	DIIprl = ctx->A_prl*pow(tauII, ctx->N_prl); // Peierls
-	DIIfk  = ctx->A_fk*tauII;                   // Frank-Kamenetzky
-	DIIvs  = DIIdif + DIImax + DIIdis + DIIprl + DIIfk; // viscous (total)
+	for(l = 0; l < n; l++) nact += act[l];
 
-	// compute creep viscosity
-	if(DIIvs) eta_cr = tauII/DIIvs/2.0;
+	// Newton iterations with fixed schedule
+	for(it = 0; it < lmaxit && nact; it++)
+	{
+		nact = 0;
 
-	// update results
-	ctx->eta    += phRat*eta;    // effective viscosity
-	ctx->eta_cr += phRat*eta_cr; // creep viscosity
-	ctx->DIIdif += phRat*DIIdif; // diffusion creep strain rate
-	ctx->DIIdis += phRat*DIIdis; // dislocation creep strain rate
-	ctx->DIIprl += phRat*DIIprl; // Peierls creep strain rate
-	ctx->DIIfk  += phRat*DIIfk;  // Frank-Kamenetzky
-	ctx->DIIpl  += phRat*DIIpl;  // plastic strain rate
-	ctx->yield  += phRat*taupl;  // plastic yield stress
+		OMP_SIMD(private(x, tau, lin, pdis, pprl, S, dS, upd) reduction(+:nact))
+		for(l = 0; l < n; l++)
+		{
+			x    = lnt[l];
+			tau  = exp(x);
+			lin  = bt->A_lin[l]*tau;
+			pdis = bt->A_dis[l]*exp(bt->N_dis[l]*x);
+			pprl = bt->A_prl[l]*exp(bt->N_prl[l]*x);
+			S    = lin + pdis + pprl;
+			dS   = lin + bt->N_dis[l]*pdis + bt->N_prl[l]*pprl;
+
+			// update unconverged lanes only
+			upd    = act[l] && (PetscAbsScalar(bt->DII[l] - S) > lrtol*bt->DII[l]);
+			lnt[l] = upd ? x - log(S/bt->DII[l])*S/dS : x;
+			lit[l] = lit[l] + upd;
+			act[l] = upd;
+			nact  += upd;
+		}
+	}
 
-	PetscFunctionReturn(0);
+	// store results
+	for(l = 0; l < n; l++)
+	{
+		if(bt->DIIpl[l])
+		{
+			bt->eta[l] = bt->tauII[l]/(2.0*bt->DII[l]);
+		}
+		else if(!bt->DII[l])
+		{
+			bt->eta[l] = 1.0/(2.0*bt->A_lin[l]);
+		}
+		else
+		{
+			bt->tauII[l] = exp(lnt[l]);
+			bt->eta  [l] = bt->tauII[l]/(2.0*bt->DII[l]);
+			lconv    [l] = !act[l];
+			lit      [l] = lit[l] + 1;
+		}
+	}
 }
 //---------------------------------------------------------------------------
-PetscScalar getConsEqRes(PetscScalar eta, void *pctx)
+void ConstEqBatchCollect(ConstEqBatch *bt, ConstEqCtx *ctx, PetscInt ls, PetscInt le)
 {
-	// compute residual of the nonlinear visco-elastic constitutive equation
+	// accumulate batch results of lanes [ls, le) and iteration statistics in context
 
-	PetscScalar tauII, DIIels, DIIdif, DIImax, DIIdis, DIIprl, DIIfk;
+	PetscInt    l;
+	PetscScalar phRat, tauII, eta_cr, DIIdif, DIImax, DIIdis, DIIprl, DIIfk, DIIvs;
+	PetscScalar DII, dS, dtau, deta;
 
-	// access context
-	ConstEqCtx *ctx = (ConstEqCtx*)pctx;
+	for(l = ls; l < le; l++)
+	{
+		phRat  = bt->phRat[l];
+		tauII  = bt->tauII[l];
+		DII    = bt->DII[l];
+		eta_cr = 0.0;
+		deta   = 0.0;
+
+		// update iteration statistics
+		ctx->stats[0] += 1.0;                      // start counter
+		ctx->stats[1] += (PetscScalar)bt->conv[l]; // convergence counter
+		ctx->stats[2] += (PetscScalar)bt->it[l];   // iteration counter
+
+		// compute strain rates
+		DIIdif = bt->A_dif[l]*tauII;                       // diffusion
+		DIImax = bt->A_max[l]*tauII;                       // upper bound
+		DIIdis = bt->A_dis[l]*pow(tauII, bt->N_dis[l]);    // dislocation
+		DIIprl = bt->A_prl[l]*pow(tauII, bt->N_prl[l]);    // Peierls
+		DIIfk  = bt->A_fk [l]*tauII;                       // Frank-Kamenetzky
+		DIIvs  = DIIdif + DIImax + DIIdis + DIIprl + DIIfk; // viscous (total)
+
+		// compute creep viscosity
+		if(DIIvs) eta_cr = tauII/DIIvs/2.0;
+
+		// compute viscosity derivative from implicit differentiation of
+		// the constitutive equation, eta = tauII/(2*DII):
+		// visco-elastic: dtau/dDII = 1/(dS/dtau)
+		// plastic:       dtau/dDII = 2*eta_vp/(1 + 2*eta_vp*dS/dtau)
+		// (pressure dependence of the yield stress is not linearized)
+		if(DII && tauII)
+		{
+			dS = bt->A_lin[l];
 
-	// compute stress
-	tauII = 2.0*eta*ctx->DII;
+			if(bt->A_dis[l]) dS += bt->N_dis[l]*bt->A_dis[l]*pow(tauII, bt->N_dis[l] - 1.0);
+			if(bt->A_prl[l]) dS += bt->N_prl[l]*bt->A_prl[l]*pow(tauII, bt->N_prl[l] - 1.0);
 
-	// creep strain rates
-	DIIels = ctx->A_els*tauII;                  // elasticity
-	DIIdif = ctx->A_dif*tauII;                  // diffusion
-	DIImax = ctx->A_max*tauII;                  // upper bound
-	DIIdis = ctx->A_dis*pow(tauII, ctx->N_dis); // dislocation
-	DIIprl = ctx->A_prl*pow(tauII, ctx->N_prl); // Peierls
-	DIIfk  = ctx->A_fk*tauII;                   // Frank-Kamenetzky
+			dtau = 0.0;
 
-	// residual function (r)
-	// r < 0 if eta > solution (negative on overshoot)
-	// r > 0 if eta < solution (positive on undershoot)
+			if(bt->DIIpl[l])  dtau = 2.0*bt->eta_vp[l]/(1.0 + 2.0*bt->eta_vp[l]*dS);
+			else if(dS)       dtau = 1.0/dS;
 
-	return ctx->DII - (DIIels + DIIdif + DIImax + DIIdis + DIIprl + DIIfk);
+			deta = (dtau - 2.0*bt->eta[l])/(2.0*DII);
+		}
+
+		// update results
+		ctx->eta    += phRat*bt->eta[l];   // effective viscosity
+		ctx->deta   += phRat*deta;         // viscosity derivative
+		ctx->eta_cr += phRat*eta_cr;       // creep viscosity
+		ctx->DIIdif += phRat*DIIdif;       // diffusion creep strain rate
+		ctx->DIIdis += phRat*DIIdis;       // dislocation creep strain rate
+		ctx->DIIprl += phRat*DIIprl;       // Peierls creep strain rate
+		ctx->DIIfk  += phRat*DIIfk;        // Frank-Kamenetzky
+		ctx->DIIpl  += phRat*bt->DIIpl[l]; // plastic strain rate
+		ctx->yield  += phRat*bt->taupl[l]; // plastic yield stress
+	}
 }
 //---------------------------------------------------------------------------
 PetscScalar applyStrainSoft(
@@ -784,9 +923,6 @@ PetscErrorCode cellConstEq(
 	svBulk = ctx->svBulk;
 	ctrl   = ctx->ctrl;
 
-	// evaluate deviatoric constitutive equation
-	PetscCall(devConstEq(ctx));
-
 	// evaluate volumetric constitutive equation
 	PetscCall(volConstEq(ctx));
 
@@ -825,6 +961,9 @@ PetscErrorCode cellConstEq(
 	// compute total viscosity
 	svDev->eta = ctx->eta + eta_st;
 
+	// store viscosity derivative w.r.t. J2 (d eta / d DII / 2*DII)
+	svDev->deta = ctx->DII ? ctx->deta/(2.0*ctx->DII) : 0.0;
+
 	// get total pressure (effective pressure + pore pressure)
 	ptotal = ctx->p + ctrl->biot*ctx->p_pore;
 
@@ -882,9 +1021,6 @@ PetscErrorCode edgeConstEq(
 	// access context
 	svDev = &svEdge->svDev;
 
-	// evaluate deviatoric constitutive equation
-	PetscCall(devConstEq(ctx));
-
 	// get stabilization viscosity
 	if(ctx->ctrl->initGuess) eta_st = 0.0;
 	else                     eta_st = svDev->eta_st;
@@ -910,6 +1046,9 @@ PetscErrorCode edgeConstEq(
 	// compute total viscosity
 	svDev->eta = ctx->eta + eta_st;
 
+	// store viscosity derivative w.r.t. J2 (d eta / d DII / 2*DII)
+	svDev->deta = ctx->DII ? ctx->deta/(2.0*ctx->DII) : 0.0;
+
 	// compute total stress
 	s += svEdge->s;
 
@@ -32,6 +32,60 @@ struct Dike;
 struct DBPropDike;
 //---------------------------------------------------------------------------
 
+// control volume parameters stored in the evaluation batch
+struct CtrlVol
+{
+	PetscScalar *phRat;  // phase ratios in the control volume
+	SolVarDev   *svDev;  // deviatoric variables
+	SolVarBulk  *svBulk; // volumetric variables
+	PetscScalar  p;      // pressure
+	PetscScalar  p_lith; // lithostatic pressure
+	PetscScalar  p_pore; // pore pressure
+	PetscScalar  T;      // temperature
+	PetscScalar  DII;    // effective strain rate
+	PetscScalar  Le;     // characteristic element size
+	PetscScalar  depth;  // depth for depth-dependent density model
+	PetscInt     ls;     // first lane
+	PetscInt     le;     // last lane + 1
+};
+
+//---------------------------------------------------------------------------
+
+// batch of deviatoric constitutive equations in structure-of-arrays layout
+// (every lane is one phase in a control volume, a batch holds all phases
+// of up to _max_batch_size_ control volumes, i.e. a block of cells or edges)
+struct ConstEqBatch
+{
+	PetscInt     n;                         // number of active lanes
+	PetscInt     nv;                        // number of control volumes
+	CtrlVol      cv    [_max_batch_size_];  // control volume parameters
+
+	// lane parameters
+	PetscScalar  phRat [_max_batch_lanes_]; // phase ratio
+	PetscScalar  DII   [_max_batch_lanes_]; // effective strain rate
+	PetscScalar  A_lin [_max_batch_lanes_]; // sum of linear constants (elasticity, diffusion, upper bound, Frank-Kamenetzky)
+	PetscScalar  A_dif [_max_batch_lanes_]; // diffusion constant
+	PetscScalar  A_max [_max_batch_lanes_]; // upper bound constant
+	PetscScalar  A_dis [_max_batch_lanes_]; // dislocation constant
+	PetscScalar  N_dis [_max_batch_lanes_]; // dislocation exponent
+	PetscScalar  A_prl [_max_batch_lanes_]; // Peierls constant
+	PetscScalar  N_prl [_max_batch_lanes_]; // Peierls exponent
+	PetscScalar  A_fk  [_max_batch_lanes_]; // Frank-Kamenetzky constant
+	PetscScalar  taupl [_max_batch_lanes_]; // plastic yield stress
+	PetscScalar  eta_vp[_max_batch_lanes_]; // regularization viscosity
+
+	// lane results
+	PetscScalar  lnt   [_max_batch_lanes_]; // logarithm of stress (Newton iterate)
+	PetscScalar  tauII [_max_batch_lanes_]; // stress
+	PetscScalar  eta   [_max_batch_lanes_]; // viscosity
+	PetscScalar  DIIpl [_max_batch_lanes_]; // plastic strain rate
+	PetscInt     act   [_max_batch_lanes_]; // active (unconverged) lane flag
+	PetscInt     it    [_max_batch_lanes_]; // iteration count
+	PetscInt     conv  [_max_batch_lanes_]; // convergence flag
+};
+
+//---------------------------------------------------------------------------
+
 // constitutive equations evaluation context
 struct ConstEqCtx
 {
@@ -80,6 +134,7 @@ struct ConstEqCtx
 
 	// control volume results
 	PetscScalar  eta;    // effective viscosity
+	PetscScalar  deta;   // viscosity derivative (d eta / d DII)
 	PetscScalar  eta_cr; // creep viscosity
 	PetscScalar  DIIdif; // diffusion creep strain rate
 	PetscScalar  DIIdis; // dislocation creep strain rate
@@ -87,6 +142,9 @@ struct ConstEqCtx
 	PetscScalar  DIIfk;  // Frank-Kamenetzky strain rate
 	PetscScalar  DIIpl;  // plastic strain rate
 	PetscScalar  yield;  // yield stress
+
+	// phase evaluation batch
+	ConstEqBatch batch;
 };
 
 //---------------------------------------------------------------------------
@@ -110,14 +168,23 @@ PetscErrorCode setUpCtrlVol(
 // setup phase parameters for deviatoric constitutive equation
 PetscErrorCode setUpPhase(ConstEqCtx *ctx, PetscInt ID);
 
-// evaluate deviatoric constitutive equations in control volume
-PetscErrorCode devConstEq(ConstEqCtx *ctx);
+// store control volume in the evaluation batch and append its present phases
+PetscErrorCode devConstEqAdd(ConstEqCtx *ctx);
+
+// restore control volume from the evaluation batch and collect its results
+PetscErrorCode devConstEqGet(ConstEqCtx *ctx, PetscInt iv);
+
+// clear evaluation batch
+void ConstEqBatchClear(ConstEqBatch *bt);
+
+// append current phase parameters to evaluation batch
+PetscErrorCode ConstEqBatchAddPhase(ConstEqBatch *bt, ConstEqCtx *ctx, PetscInt ID);
 
-// compute phase viscosities and strain rate partitioning
-PetscErrorCode getPhaseVisc(ConstEqCtx *ctx, PetscInt ID);
+// compute phase viscosities for all lanes of the batch
+void ConstEqBatchSolve(ConstEqBatch *bt, PetscScalar lrtol, PetscInt lmaxit);
 
-// compute residual of the visco-elastic constitutive equation
-PetscScalar getConsEqRes(PetscScalar eta, void *pctx);
+// accumulate batch results of lanes [ls, le) and iteration statistics in context
+void ConstEqBatchCollect(ConstEqBatch *bt, ConstEqCtx *ctx, PetscInt ls, PetscInt le);
 
 // apply strain softening to a parameter (friction, cohesion)
 PetscScalar applyStrainSoft(
@@ -138,6 +205,7 @@ PetscScalar getI2Gdt(
 PetscErrorCode volConstEq(ConstEqCtx *ctx);
 
 // evaluate constitutive equations on the cell
+// (deviatoric results must be available in the context, see devConstEqGet)
 PetscErrorCode cellConstEq(
 		ConstEqCtx  *ctx,    // evaluation context
 		SolVarCell  *svCell, // solution variables
@@ -152,6 +220,7 @@ PetscErrorCode cellConstEq(
 		PetscScalar &dikeRHS);   // additional term due to dike divergence when computing RHS
 
 // evaluate constitutive equations on the edge
+// (deviatoric results must be available in the context, see devConstEqGet)
 PetscErrorCode edgeConstEq(
 		ConstEqCtx  *ctx,    // evaluation context
 		SolVarEdge  *svEdge, // solution variables
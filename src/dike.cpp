@@ -1635,6 +1635,83 @@ PetscErrorCode DynamicDike_WriteRestart(JacRes *jr, FILE *fp)
 
   PetscFunctionReturn(0);
 }
+//---------------------------------------------------------------------------
+PetscErrorCode DynamicDike_ViewRestart(JacRes *jr, PetscViewer viewer)
+{
+	// store mean stress history (replicated over processor layers in z-direction)
+
+	Dike        *dike;
+	DM           da;
+	Vec          ghist;
+	PetscScalar  count;
+	PetscInt     nD, numDike;
+
+	PetscFunctionBeginUser;
+
+	if(!jr->ctrl.actDike) PetscFunctionReturn(0);
+
+	numDike = jr->dbdike->numDike;
+	da      = jr->dbdike->DA_CELL_2D_tave;
+
+	for(nD = 0; nD < numDike; nD++)
+	{
+		dike = jr->dbdike->matDike+nD;
+
+		if(!dike->dyndike_start) continue;
+
+		count = (PetscScalar)dike->istep_count;
+
+		PetscCall(PetscViewerBinaryWrite(viewer, &count, 1, PETSC_SCALAR));
+
+		PetscCall(DMGetGlobalVector(da, &ghist));
+
+		PetscCall(DMLocalToGlobalBegin(da, dike->sxx_eff_ave_hist, INSERT_VALUES, ghist));
+		PetscCall(DMLocalToGlobalEnd  (da, dike->sxx_eff_ave_hist, INSERT_VALUES, ghist));
+
+		PetscCall(DMDAViewRedundant(da, ghist, dike->istep_nave, viewer));
+
+		PetscCall(DMRestoreGlobalVector(da, &ghist));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DynamicDike_LoadRestart(JacRes *jr, PetscViewer viewer)
+{
+	Dike        *dike;
+	DM           da;
+	Vec          ghist;
+	PetscScalar  count;
+	PetscInt     nD, numDike;
+
+	PetscFunctionBeginUser;
+
+	if(!jr->ctrl.actDike) PetscFunctionReturn(0);
+
+	numDike = jr->dbdike->numDike;
+	da      = jr->dbdike->DA_CELL_2D_tave;
+
+	for(nD = 0; nD < numDike; nD++)
+	{
+		dike = jr->dbdike->matDike+nD;
+
+		if(!dike->dyndike_start) continue;
+
+		PetscCall(PetscViewerBinaryRead(viewer, &count, 1, NULL, PETSC_SCALAR));
+
+		dike->istep_count = (PetscInt)count;
+
+		PetscCall(DMGetGlobalVector(da, &ghist));
+
+		PetscCall(DMDALoadRedundant(da, ghist, dike->istep_nave, viewer));
+
+		GLOBAL_TO_LOCAL(da, ghist, dike->sxx_eff_ave_hist);
+
+		PetscCall(DMRestoreGlobalVector(da, &ghist));
+	}
+
+	PetscFunctionReturn(0);
+}
   
 //---------------------------------------------------------------------------
 
@@ -96,6 +96,8 @@ PetscErrorCode Set_dike_zones(JacRes *jr, PetscInt nD, PetscInt nPtr, PetscInt
 PetscErrorCode Locate_Dike_Zones(AdvCtx *actx);
 PetscErrorCode DynamicDike_ReadRestart(DBPropDike *dbdike, DBMat *dbm, JacRes *jr, TSSol *ts, FILE *fp, FB *fb);
 PetscErrorCode DynamicDike_WriteRestart(JacRes *jr, FILE *fp);
+PetscErrorCode DynamicDike_ViewRestart(JacRes *jr, PetscViewer viewer);
+PetscErrorCode DynamicDike_LoadRestart(JacRes *jr, PetscViewer viewer);
 PetscErrorCode DynamicDike_Destroy(JacRes *jr);
 
 //---------------------------------------------------------------------------
@@ -260,6 +260,9 @@ PetscErrorCode Discret1DCreate(
 	// column communicator
 	ds->comm = MPI_COMM_NULL;
 
+	// communicator of processor grid
+	ds->pcomm = PETSC_COMM_WORLD;
+
 	// geometric tolerance
 	ds->gtol = gtol;
 
@@ -278,6 +281,7 @@ PetscErrorCode Discret1DDestroy(Discret1D *ds)
 	PetscCall(PetscFree(ds->nbuff));
 	PetscCall(PetscFree(ds->cbuff));
 	PetscCall(PetscFree(ds->starts));
+	PetscCall(PetscFree(ds->bkt));
 	PetscCall(Discret1DFreeColumnComm(ds));
 
 	PetscFunctionReturn(0);
@@ -299,6 +303,12 @@ PetscErrorCode Discret1DReadRestart(Discret1D *ds, FILE *fp)
 	ds->ncoor = ds->nbuff + 1;
 	ds->ccoor = ds->cbuff + 1;
 
+	// rebuild point location table
+	ds->nbkt = 0;
+	ds->bkt  = NULL;
+
+	PetscCall(Discret1DSetupFindPoint(ds));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -413,6 +423,9 @@ PetscErrorCode Discret1DCoarsenCoord(Discret1D *coarse, Discret1D *fine)
 		// copy cell coordinate buffer
 		for(i = 0, nn = fine->ncels+2; i < nn; i++)
 			coarse->cbuff[i] = fine->cbuff[i];
+
+		// setup point location table
+		PetscCall(Discret1DSetupFindPoint(coarse));
 	}
 	else
 	{
@@ -430,16 +443,16 @@ PetscErrorCode Discret1DCoarsenCoord(Discret1D *coarse, Discret1D *fine)
 		{
 			sprev = fine->ncoor[2];
 
-			PetscCallMPI(MPI_Isend(&sprev, 1, MPIU_SCALAR, fine->grprev, 700, PETSC_COMM_WORLD, &request[cnt++]));
-			PetscCallMPI(MPI_Irecv(&rprev, 1, MPIU_SCALAR, fine->grprev, 700, PETSC_COMM_WORLD, &request[cnt++]));
+			PetscCallMPI(MPI_Isend(&sprev, 1, MPIU_SCALAR, fine->grprev, 700, fine->pcomm, &request[cnt++]));
+			PetscCallMPI(MPI_Irecv(&rprev, 1, MPIU_SCALAR, fine->grprev, 700, fine->pcomm, &request[cnt++]));
 		}
 
 		if(fine->grnext != -1)
 		{
 			snext = fine->ncoor[fine->ncels-2];
 
-			PetscCallMPI(MPI_Isend(&snext, 1, MPIU_SCALAR, fine->grnext, 700, PETSC_COMM_WORLD, &request[cnt++]));
-			PetscCallMPI(MPI_Irecv(&rnext, 1, MPIU_SCALAR, fine->grnext, 700, PETSC_COMM_WORLD, &request[cnt++]));
+			PetscCallMPI(MPI_Isend(&snext, 1, MPIU_SCALAR, fine->grnext, 700, fine->pcomm, &request[cnt++]));
+			PetscCallMPI(MPI_Irecv(&rnext, 1, MPIU_SCALAR, fine->grnext, 700, fine->pcomm, &request[cnt++]));
 		}
 
 		// wait until all communication processes have been terminated
@@ -533,6 +546,68 @@ PetscErrorCode Discret1DCompleteCoord(Discret1D *ds)
 	for(i = -1; i < ds->ncels+1; i++)
 		ds->ccoor[i] = (ds->ncoor[i] + ds->ncoor[i+1])/2.0;
 
+	// setup point location table
+	PetscCall(Discret1DSetupFindPoint(ds));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Discret1DSetupFindPoint(Discret1D *ds)
+{
+	// setup point location table for non-uniform grids
+	// local domain is divided into uniform buckets, every bucket stores host cell
+	// of its left bound, i.e. candidate cells of a bucket are [bkt[b], bkt[b+1]]
+	// NOTE: table is defined in relative coordinates, i.e. it remains valid
+	// after grid stretching (Discret1DStretch)
+
+	PetscScalar *px, L, h, hmin, x;
+	PetscInt     i, b, n, nbkt;
+
+	PetscFunctionBeginUser;
+
+	// clear previous table
+	PetscCall(PetscFree(ds->bkt));
+
+	ds->nbkt = 0;
+
+	if(ds->uniform) PetscFunctionReturn(0);
+
+	n  = ds->ncels;
+	px = ds->ncoor;
+	L  = px[n] - px[0];
+
+	// get minimum cell size
+	hmin = L;
+
+	for(i = 0; i < n; i++)
+	{
+		h = px[i+1] - px[i];
+
+		if(h < hmin) hmin = h;
+	}
+
+	if(hmin <= 0.0) PetscFunctionReturn(0);
+
+	// number of buckets (bucket size is not larger than the smallest cell if possible)
+	nbkt = (PetscInt)PetscCeilReal(L/hmin);
+
+	if(nbkt < n)                      nbkt = n;
+	if(nbkt > _max_bkt_per_cell_*n)   nbkt = _max_bkt_per_cell_*n;
+
+	PetscCall(makeIntArray(&ds->bkt, NULL, nbkt+1));
+
+	// store host cells of bucket bounds (single pass over cells)
+	for(b = 0, i = 0; b <= nbkt; b++)
+	{
+		x = px[0] + L*(PetscScalar)b/(PetscScalar)nbkt;
+
+		while(i < n-1 && px[i+1] <= x) i++;
+
+		ds->bkt[b] = i;
+	}
+
+	ds->nbkt = nbkt;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -569,7 +644,7 @@ PetscErrorCode Discret1DGetColumnComm(Discret1D *ds)
 
 	if(ds->nproc != 1 && ds->comm == MPI_COMM_NULL)
 	{
-		PetscCallMPI(MPI_Comm_split(PETSC_COMM_WORLD, ds->color, ds->rank, &ds->comm));
+		PetscCallMPI(MPI_Comm_split(ds->pcomm, ds->color, ds->rank, &ds->comm));
 	}
 
 	PetscFunctionReturn(0);
@@ -665,6 +740,183 @@ PetscErrorCode Discret1DGatherCoord(Discret1D *ds, PetscScalar **coord)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode Discret1DSetCoord(Discret1D *ds, PetscScalar *coord)
+{
+	// set local node coordinates from global coordinate array (tnods entries)
+
+	PetscInt     i, n, pstart;
+	PetscScalar *crd;
+
+	PetscFunctionBeginUser;
+
+	// set global grid coordinate bounds
+	ds->gcrdbeg = coord[0];
+	ds->gcrdend = coord[ds->tnods-1];
+
+	// use the same layout as in Discret1DGenCoord
+	pstart = ds->pstart;
+	crd    = ds->ncoor;
+	n      = ds->nnods;
+
+	if(ds->grprev != -1) { pstart--; crd--; n++; }
+	if(ds->grnext != -1) { n += 2; }
+
+	for(i = 0; i < n; i++) crd[i] = coord[pstart + i];
+
+	// generate ghost points and cell center coordinates
+	PetscCall(Discret1DCompleteCoord(ds));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Discret1DGatherCellArray(Discret1D *ds, PetscScalar *lbuff, PetscScalar **garray)
+{
+	// gather cell array with ghost points on rank zero of PETSC_COMM_WORLD
+	// both arrays are shifted by one entry (first entry is the left ghost point)
+	// WARNING! the array only exists on rank zero of PETSC_COMM_WORLD
+	// WARNING! the array must be destroyed after use!
+
+	PetscInt     i;
+	PetscScalar *parray;
+	PetscMPIInt *recvcnts;
+	PetscMPIInt *recvdisp;
+	PetscMPIInt  sendcnt;
+	PetscScalar *sendbuf;
+
+	PetscFunctionBeginUser;
+
+	parray   = NULL;
+	recvcnts = NULL;
+	recvdisp = NULL;
+
+	// create column communicator
+	PetscCall(Discret1DGetColumnComm(ds));
+
+	// check for sequential case
+	if(ds->nproc == 1)
+	{
+		// copy array on rank zero of PETSC_COMM_WORLD
+		if(ISRankZero(PETSC_COMM_WORLD))
+		{
+			PetscCall(makeScalArray(&parray, lbuff, ds->tcels+2));
+		}
+	}
+	else
+	{
+		// first processor sends left ghost point, last processor sends right ghost point
+		sendbuf = lbuff + 1;
+		sendcnt = (PetscMPIInt)ds->ncels;
+
+		if(ds->grprev == -1) { sendbuf--; sendcnt++; }
+		if(ds->grnext == -1) {            sendcnt++; }
+
+		// gather array on ranks zero of column communicator
+		if(ISRankZero(ds->comm))
+		{
+			PetscCall(makeScalArray(&parray, NULL, ds->tcels+2));
+
+			PetscCall(makeMPIIntArray(&recvcnts, NULL, ds->nproc));
+
+			PetscCall(makeMPIIntArray(&recvdisp, NULL, ds->nproc));
+
+			// compute receive counts & displacements (ds->starts[ds->nproc] stores total number of cells)
+			for(i = 0; i < ds->nproc; i++)
+			{
+				recvcnts[i] = (PetscMPIInt)(ds->starts[i+1] - ds->starts[i]);
+				recvdisp[i] = (PetscMPIInt)(ds->starts[i] + 1);
+			}
+
+			recvcnts[0]++;
+			recvdisp[0]--;
+			recvcnts[ds->nproc-1]++;
+		}
+
+		PetscCallMPI(MPI_Gatherv(sendbuf, sendcnt, MPIU_SCALAR,
+			parray, recvcnts, recvdisp, MPIU_SCALAR, 0, ds->comm));
+
+		// free memory
+		if(!ISRankZero(PETSC_COMM_WORLD))
+		{	PetscCall(PetscFree(parray)); }
+			PetscCall(PetscFree(recvcnts));
+			PetscCall(PetscFree(recvdisp));
+	}
+
+	// return array
+	(*garray) = parray;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Discret1DSetCellArray(Discret1D *ds, PetscScalar *garray, PetscScalar *lbuff)
+{
+	// set local cell array with ghost points from global array (tcels+2 entries)
+
+	PetscFunctionBeginUser;
+
+	PetscCall(PetscMemcpy(lbuff, garray + ds->pstart, (size_t)(ds->ncels+2)*sizeof(PetscScalar)));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Discret1DGetProcBounds(Discret1D *ds, PetscScalar **bounds)
+{
+	// get coordinate bounds of all processors in the column (nproc+1 entries)
+	// WARNING! the array must be destroyed after use!
+
+	PetscScalar *pbnd, beg;
+
+	
+	PetscFunctionBeginUser;
+
+	// allocate bounds
+	PetscCall(makeScalArray(&pbnd, NULL, ds->nproc+1));
+
+	// get first local node coordinate
+	beg = ds->ncoor[0];
+
+	if(ds->nproc == 1)
+	{
+		pbnd[0] = beg;
+	}
+	else
+	{
+		// create column communicator
+		PetscCall(Discret1DGetColumnComm(ds));
+
+		// gather starting coordinates of all processors in the column
+		PetscCallMPI(MPI_Allgather(&beg, 1, MPIU_SCALAR, pbnd, 1, MPIU_SCALAR, ds->comm));
+	}
+
+	// set global end coordinate
+	pbnd[ds->nproc] = ds->gcrdend;
+
+	// return bounds
+	(*bounds) = pbnd;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscInt Discret1DFindProc(PetscInt nproc, PetscScalar *bounds, PetscScalar x)
+{
+	// get rank of processor in the column containing a point (clamped to valid range)
+	// bisection over processor bounds, points on the bound belong to the next processor
+
+	PetscInt L, R, M;
+
+	L = 0;
+	R = nproc;
+
+	while(R - L > 1)
+	{
+		M = (L + R)/2;
+
+		if(x >= bounds[M]) L = M;
+		else               R = M;
+	}
+
+	return L;
+}
+//---------------------------------------------------------------------------
 PetscErrorCode Discret1DCheckMG(Discret1D *ds, const char *dir, PetscInt *_ncors)
 {
 	PetscInt sz, ncors;
@@ -782,9 +1034,10 @@ PetscErrorCode Discret1DgetMaxInvStep(Discret1D *ds, DM da, Vec gv, PetscInt dir
 PetscErrorCode Discret1DFindPoint(Discret1D *ds, PetscScalar x, PetscInt &ID)
 {
 	// find index of a cell containing point (local points only)
+	// non-uniform grids use point location table to bound the binary search
 
 	PetscScalar  *px, dx, tol;
-	PetscInt      n, M, L, R;
+	PetscInt      n, M, L, R, B, b;
 
 	PetscFunctionBeginUser;
 
@@ -814,6 +1067,21 @@ PetscErrorCode Discret1DFindPoint(Discret1D *ds, PetscScalar x, PetscInt &ID)
 		L = 0;
 		R = n;
 
+		// restrict search to candidate cells of the bucket
+		if(ds->nbkt)
+		{
+			b = (PetscInt)PetscFloorReal((x - px[0])/(px[n] - px[0])*(PetscScalar)ds->nbkt);
+
+			if(b < 0)            b = 0;
+			if(b > ds->nbkt-1)   b = ds->nbkt-1;
+
+			M = ds->bkt[b];
+			B = ds->bkt[b+1] + 1;
+
+			// keep full range if point is not bracketed (round-off at bucket bounds)
+			if(px[M] <= x && x <= px[B]) { L = M; R = B; }
+		}
+
 		while((R - L) > 1)
 		{
 			M = (L + R)/2;
@@ -854,6 +1122,7 @@ PetscErrorCode DOFIndexCreate(DOFIndex *dof, DM DA_CEN, DM DA_X, DM DA_Y, DM DA_
 	// compute number of local dof and starting indices
 
 	PetscInt nx, ny, nz, NUM[2], SUM[3];
+	MPI_Comm comm;
 
 	
 	PetscFunctionBeginUser;
@@ -870,7 +1139,9 @@ PetscErrorCode DOFIndexCreate(DOFIndex *dof, DM DA_CEN, DM DA_X, DM DA_Y, DM DA_
 	NUM[1] = dof->lnp;
 
 	// compute prefix sums
-	PetscCallMPI(MPI_Scan(NUM, SUM, 2, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD));
+	PetscCall(PetscObjectGetComm((PetscObject)DA_CEN, &comm));
+
+	PetscCallMPI(MPI_Scan(NUM, SUM, 2, MPIU_INT, MPI_SUM, comm));
 
 	// set starting indices
 	dof->stv = SUM[0] - dof->lnv;
@@ -1075,6 +1346,10 @@ PetscErrorCode FDSTAGReadRestart(FDSTAG *fs, FILE *fp)
 	fs->dsy.comm = MPI_COMM_NULL;
 	fs->dsz.comm = MPI_COMM_NULL;
 
+	fs->dsx.pcomm = PETSC_COMM_WORLD;
+	fs->dsy.pcomm = PETSC_COMM_WORLD;
+	fs->dsz.pcomm = PETSC_COMM_WORLD;
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1090,6 +1365,72 @@ PetscErrorCode FDSTAGWriteRestart(FDSTAG *fs, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FDSTAGViewRestart(FDSTAG *fs, PetscViewer viewer)
+{
+	// write global node coordinates to portable restart database
+
+	Discret1D   *ds[3];
+	PetscScalar *coord;
+	PetscInt     i;
+
+	PetscFunctionBeginUser;
+
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	for(i = 0; i < 3; i++)
+	{
+		coord = NULL;
+
+		PetscCall(Discret1DGatherCoord(ds[i], &coord));
+
+		PetscCall(PetscViewerBinaryWrite(viewer, &ds[i]->tnods, 1, PETSC_INT));
+
+		PetscCall(PetscViewerBinaryWrite(viewer, coord, ds[i]->tnods, PETSC_SCALAR));
+
+		PetscCall(PetscFree(coord));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FDSTAGLoadRestart(FDSTAG *fs, PetscViewer viewer)
+{
+	// read global node coordinates from portable restart database
+	// (grid may be stretched or deformed compared to the input file)
+
+	Discret1D   *ds[3];
+	PetscScalar *coord;
+	PetscInt     i, tnods;
+
+	PetscFunctionBeginUser;
+
+	ds[0] = &fs->dsx;
+	ds[1] = &fs->dsy;
+	ds[2] = &fs->dsz;
+
+	for(i = 0; i < 3; i++)
+	{
+		PetscCall(PetscViewerBinaryRead(viewer, &tnods, 1, NULL, PETSC_INT));
+
+		if(tnods != ds[i]->tnods)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Grid size in restart database (%lld) does not match input file (%lld)", (LLD)tnods, (LLD)ds[i]->tnods);
+		}
+
+		PetscCall(makeScalArray(&coord, NULL, tnods));
+
+		PetscCall(PetscViewerBinaryRead(viewer, coord, tnods, NULL, PETSC_SCALAR));
+
+		PetscCall(Discret1DSetCoord(ds[i], coord));
+
+		PetscCall(PetscFree(coord));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FDSTAGCoarsen(FDSTAG *coarse, FDSTAG *fine)
 {
 	PetscInt         i;
@@ -1099,6 +1440,7 @@ PetscErrorCode FDSTAGCoarsen(FDSTAG *coarse, FDSTAG *fine)
 	PetscInt        *lx,   *ly,   *lz;
 	Discret1D       *fdsx, *fdsy, *fdsz;
 	DMBoundaryType   BC_TYPE_X;
+	MPI_Comm         comm;
 
 	
 	PetscFunctionBeginUser;
@@ -1131,8 +1473,11 @@ PetscErrorCode FDSTAGCoarsen(FDSTAG *coarse, FDSTAG *fine)
 	if(coarse->periodic) { BC_TYPE_X = DM_BOUNDARY_PERIODIC; }
 	else                 { BC_TYPE_X = DM_BOUNDARY_GHOSTED;  }
 
+	// coarse grid uses communicator of fine grid
+	PetscCall(PetscObjectGetComm((PetscObject)fine->DA_CEN, &comm));
+
 	// central points (DA_CEN) with boundary ghost points (1-layer stencil box)
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_TYPE_X, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
 		Nx, Ny, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &coarse->DA_CEN));
 
@@ -1162,6 +1507,10 @@ PetscErrorCode FDSTAGCoarsen(FDSTAG *coarse, FDSTAG *fine)
 	PetscCall(Discret1DCreate(&coarse->dsz, Pz, fdsz->rank, lz, fdsz->color,
 			fdsz->grprev, fdsz->grnext, coarse->gtol, "z"));
 
+	coarse->dsx.pcomm = fdsx->pcomm;
+	coarse->dsy.pcomm = fdsy->pcomm;
+	coarse->dsz.pcomm = fdsz->pcomm;
+
 	// clear temporary storage
 	PetscCall(PetscFree(lx));
 	PetscCall(PetscFree(ly));
@@ -1186,6 +1535,159 @@ PetscErrorCode FDSTAGCoarsenCoord(FDSTAG *coarse, FDSTAG *fine)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FDSTAGAgglomerate(FDSTAG *agg, FDSTAG *fine, MPI_Comm comm, PetscInt f[])
+{
+	// Create grid with the same global size on the processor grid reduced by
+	// factors f in every direction. Every agglomerated processor owns f[0]*f[1]*f[2]
+	// subdomains of the fine grid. Called only by processors of the sub-communicator.
+
+	PetscMPIInt      rank;
+	PetscInt         i, j;
+	PetscInt         rx,    ry,    rz;
+	PetscInt         cx,    cy,    cz;
+	PetscInt         Nx,    Ny,    Nz;
+	PetscInt         Px,    Py,    Pz;
+	const PetscInt  *plx,  *ply,  *plz;
+	PetscInt        *lx,   *ly,   *lz;
+	DMBoundaryType   BC_TYPE_X;
+
+	PetscFunctionBeginUser;
+
+	// clear memory
+	PetscCall(PetscMemzero(agg, sizeof(FDSTAG)));
+
+	// copy data
+	agg->scal     = fine->scal;
+	agg->gtol     = fine->gtol;
+	agg->periodic = fine->periodic;
+
+	// neighbor ranks are not used on agglomerated grid
+	for(i = 0; i < _num_neighb_; i++) { agg->neighb[i] = -1; }
+
+	// get number of cells & processors in the fine grid
+	PetscCall(DMDAGetInfo(fine->DA_CEN, 0, &Nx, &Ny, &Nz, &Px, &Py, &Pz, 0, 0, 0, 0, 0, 0));
+
+	// get number of cells per processor in fine grid
+	PetscCall(DMDAGetOwnershipRanges(fine->DA_CEN, &plx, &ply, &plz));
+
+	// get agglomerated processor grid
+	Px /= f[0];
+	Py /= f[1];
+	Pz /= f[2];
+
+	PetscCall(makeIntArray(&lx, NULL, Px));
+	PetscCall(makeIntArray(&ly, NULL, Py));
+	PetscCall(makeIntArray(&lz, NULL, Pz));
+
+	// merge cells of agglomerated processors
+	for(i = 0; i < Px; i++) { lx[i] = 0; for(j = 0; j < f[0]; j++) { lx[i] += plx[i*f[0] + j]; } }
+	for(i = 0; i < Py; i++) { ly[i] = 0; for(j = 0; j < f[1]; j++) { ly[i] += ply[i*f[1] + j]; } }
+	for(i = 0; i < Pz; i++) { lz[i] = 0; for(j = 0; j < f[2]; j++) { lz[i] += plz[i*f[2] + j]; } }
+
+	// set boundary type in x direction
+	if(agg->periodic) { BC_TYPE_X = DM_BOUNDARY_PERIODIC; }
+	else              { BC_TYPE_X = DM_BOUNDARY_GHOSTED;  }
+
+	// central points (DA_CEN) with boundary ghost points (1-layer stencil box)
+	PetscCall(DMDACreate3DSetUp(comm,
+		BC_TYPE_X, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
+		Nx, Ny, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &agg->DA_CEN));
+
+	// get total number of nodes
+	Nx++; Ny++; Nz++;
+
+	// get number of nodes per processor (only different on the last processor)
+	lx[Px-1]++; ly[Py-1]++; lz[Pz-1]++;
+
+	// create corner, face and edge DMDA objects
+	PetscCall(FDSTAGCreateDMDA(agg, Nx, Ny, Nz, Px, Py, Pz, lx, ly, lz));
+
+	// create index arrays
+	PetscCall(DOFIndexCreate(&agg->dof, agg->DA_CEN, agg->DA_X, agg->DA_Y, agg->DA_Z));
+
+	// get processor rank in sub-communicator
+	PetscCallMPI(MPI_Comm_rank(comm, &rank));
+
+	// determine i-j-k ranks of processor
+	getLocalRank(&rx, &ry, &rz, rank, Px, Py);
+
+	// compute column colors
+	cx = ry + rz*Py; // global index in YZ-plane
+	cy = rx + rz*Px; // global index in XZ-plane
+	cz = rx + ry*Px; // global index in XY-plane
+
+	// set discretization / domain decomposition data (ranks refer to sub-communicator)
+	PetscCall(Discret1DCreate(&agg->dsx, Px, rx, lx, cx,
+			getGlobalRank(rx-1, ry, rz, Px, Py, Pz),
+			getGlobalRank(rx+1, ry, rz, Px, Py, Pz),
+			agg->gtol, "x", agg->periodic));
+
+	PetscCall(Discret1DCreate(&agg->dsy, Py, ry, ly, cy,
+			getGlobalRank(rx, ry-1, rz, Px, Py, Pz),
+			getGlobalRank(rx, ry+1, rz, Px, Py, Pz),
+			agg->gtol, "y"));
+
+	PetscCall(Discret1DCreate(&agg->dsz, Pz, rz, lz, cz,
+			getGlobalRank(rx, ry, rz-1, Px, Py, Pz),
+			getGlobalRank(rx, ry, rz+1, Px, Py, Pz),
+			agg->gtol, "z"));
+
+	agg->dsx.pcomm = comm;
+	agg->dsy.pcomm = comm;
+	agg->dsz.pcomm = comm;
+
+	// clear temporary storage
+	PetscCall(PetscFree(lx));
+	PetscCall(PetscFree(ly));
+	PetscCall(PetscFree(lz));
+
+	// set number of local grid points
+	PetscCall(FDSTAGSetNum(agg));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FDSTAGAgglomerateCoord(FDSTAG *agg, FDSTAG *fine)
+{
+	// gather global coordinates of parent grid, broadcast them
+	// and set local coordinates of agglomerated grid
+
+	Discret1D   *ds[3];
+	PetscScalar *coord;
+	PetscInt     i;
+
+	PetscFunctionBeginUser;
+
+	ds[0] = &fine->dsx;
+	ds[1] = &fine->dsy;
+	ds[2] = &fine->dsz;
+
+	for(i = 0; i < 3; i++)
+	{
+		coord = NULL;
+
+		PetscCall(Discret1DGatherCoord(ds[i], &coord));
+
+		if(!ISRankZero(PETSC_COMM_WORLD))
+		{
+			PetscCall(makeScalArray(&coord, NULL, ds[i]->tnods));
+		}
+
+		PetscCallMPI(MPI_Bcast(coord, (PetscMPIInt)ds[i]->tnods, MPIU_SCALAR, 0, PETSC_COMM_WORLD));
+
+		if(agg)
+		{
+			if     (i == 0) { agg->dsx.uniform = ds[i]->uniform; PetscCall(Discret1DSetCoord(&agg->dsx, coord)); }
+			else if(i == 1) { agg->dsy.uniform = ds[i]->uniform; PetscCall(Discret1DSetCoord(&agg->dsy, coord)); }
+			else if(i == 2) { agg->dsz.uniform = ds[i]->uniform; PetscCall(Discret1DSetCoord(&agg->dsz, coord)); }
+		}
+
+		PetscCall(PetscFree(coord));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FDSTAGDestroy(FDSTAG * fs)
 {
 	
@@ -1216,10 +1718,14 @@ PetscErrorCode FDSTAGCreateDMDA(FDSTAG   *fs,
 {
 	PetscInt       bc_node;
 	DMBoundaryType BC_NONE, BC_GHOSTED;
+	MPI_Comm       comm;
 
 	
 	PetscFunctionBeginUser;
 
+	// use communicator of central points
+	PetscCall(PetscObjectGetComm((PetscObject)fs->DA_CEN, &comm));
+
 	// PERIODIC CASE: JUST USE ONE POINT LESS IN X-DIRECTION FOR DA_COR, DA_XY, DA_XZ, AND DA_X
 
 	if(fs->periodic) { BC_NONE = DM_BOUNDARY_PERIODIC; BC_GHOSTED = DM_BOUNDARY_PERIODIC; bc_node = 1; }
@@ -1227,49 +1733,49 @@ PetscErrorCode FDSTAGCreateDMDA(FDSTAG   *fs,
 
 	// corners (DA_COR) no boundary ghost points (1-layer stencil box)
 	lx[Px-1] -= bc_node;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
 		Nx-bc_node, Ny, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_COR));
 	lx[Px-1] += bc_node;
 
 	// XY edges (DA_XY) no boundary ghost points (1-layer stencil box)
 	lz[Pz-1]--; lx[Px-1] -= bc_node;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
 		Nx-bc_node, Ny, Nz-1, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_XY));
 	lz[Pz-1]++; lx[Px-1] += bc_node;
 
 	// XZ edges (DA_XZ) no boundary ghost points (1-layer stencil box)
 	ly[Py-1]--; lx[Px-1] -= bc_node;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
 		Nx-bc_node, Ny-1, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_XZ));
 	ly[Py-1]++; lx[Px-1] += bc_node;
 
 	// YZ edges (DA_YZ) no boundary ghost points (1-layer stencil box)
 	lx[Px-1]--;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_NONE, DM_BOUNDARY_NONE, DM_BOUNDARY_NONE, DMDA_STENCIL_BOX,
 		Nx-1, Ny, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_YZ));
 	lx[Px-1]++;
 
 	// X face (DA_X) with boundary ghost points (1-layer stencil box)
 	ly[Py-1]--; lz[Pz-1]--; lx[Px-1] -= bc_node;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_GHOSTED, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
 		Nx-bc_node, Ny-1, Nz-1, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_X));
 	ly[Py-1]++; lz[Pz-1]++; lx[Px-1] += bc_node;
 
 	// Y face (DA_Y) with boundary ghost points (1-layer stencil box)
 	lx[Px-1]--; lz[Pz-1]--;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_GHOSTED, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
 		Nx-1, Ny, Nz-1, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_Y));
 	lx[Px-1]++; lz[Pz-1]++;
 
 	// Z face (DA_Z) with boundary ghost points (1-layer stencil box)
 	lx[Px-1]--; ly[Py-1]--;
-	PetscCall(DMDACreate3DSetUp(PETSC_COMM_WORLD,
+	PetscCall(DMDACreate3DSetUp(comm,
 		BC_GHOSTED, DM_BOUNDARY_GHOSTED, DM_BOUNDARY_GHOSTED, DMDA_STENCIL_BOX,
 		Nx-1, Ny-1, Nz, Px, Py, Pz, 1, 1, lx, ly, lz, &fs->DA_Z));
 	lx[Px-1]++; ly[Py-1]++;
@@ -1357,6 +1863,20 @@ PetscErrorCode FDSTAGGetPointRanks(FDSTAG *fs, PetscScalar *X, PetscInt *lrank,
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscMPIInt FDSTAGGetPointGlobalRank(FDSTAG *fs, PetscScalar *bnd[], PetscScalar *X)
+{
+	// get global rank of a domain containing a point (all processors are checked)
+	// bnd - processor bounds in all directions (see Discret1DGetProcBounds)
+
+	PetscInt rx, ry, rz;
+
+	rx = Discret1DFindProc(fs->dsx.nproc, bnd[0], X[0]);
+	ry = Discret1DFindProc(fs->dsy.nproc, bnd[1], X[1]);
+	rz = Discret1DFindProc(fs->dsz.nproc, bnd[2], X[2]);
+
+	return getGlobalRank(rx, ry, rz, fs->dsx.nproc, fs->dsy.nproc, fs->dsz.nproc);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FDSTAGGetAspectRatio(FDSTAG *fs, PetscScalar *maxAspRat)
 {
 	// compute maximum aspect ratio in the grid
@@ -1634,6 +2154,76 @@ PetscErrorCode FDSTAGGetCoarseGridSize(
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FDSTAGGetAggGrid(
+		FDSTAG   *fs,
+		PetscInt nlevels,
+		PetscInt ncells,
+		PetscInt f[],
+		PetscInt &ncors)
+{
+	// compute processor reduction factors that agglomerate coarse grid to at least
+	// ncells local cells per processor (factors are powers of two, the direction
+	// with the smallest agglomerated local size is doubled first)
+
+	PetscInt i, d, k, sz, MG2D, n[3], N[3], P[3];
+
+	PetscFunctionBeginUser;
+
+	// get local size of coarse grid
+	PetscCall(FDSTAGGetCoarseGridSize(fs, nlevels, n[0], n[1], n[2], N[0], N[1], N[2]));
+
+	// set 2D coarsening flag
+	PetscCall(FDSTAGCheckMG2D(fs, MG2D));
+
+	P[0] = fs->dsx.nproc;
+	P[1] = fs->dsy.nproc;
+	P[2] = fs->dsz.nproc;
+
+	f[0] = f[1] = f[2] = 1;
+
+	while(n[0]*f[0]*n[1]*f[1]*n[2]*f[2] < ncells)
+	{
+		// select direction with the smallest local size that can be agglomerated
+		for(i = 0, d = -1; i < 3; i++)
+		{
+			if(MG2D && i == 1)   continue;
+			if(P[i] % (2*f[i]))  continue;
+			if(d == -1 || n[i]*f[i] < n[d]*f[d]) d = i;
+		}
+
+		if(d == -1) break;
+
+		f[d] *= 2;
+	}
+
+	// get maximum number of coarsening steps on agglomerated grid
+	// (enforce at least two coarse grid cells per processor)
+	ncors = -1;
+
+	for(i = 0; i < 3; i++)
+	{
+		if(MG2D && i == 1) continue;
+
+		sz = n[i]*f[i];
+		k  = 0;
+
+		if(sz % 2) { ncors = 0; break; }
+
+		while(!(sz % 2) && sz > 2) { sz /= 2; k++; }
+
+		if(ncors == -1 || k < ncors) ncors = k;
+	}
+
+	// deactivate agglomeration if no further coarsening is possible
+	if(f[0]*f[1]*f[2] == 1 || !ncors)
+	{
+		f[0] = f[1] = f[2] = 1;
+		ncors = 0;
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FDSTAGGetLevelsLocalGridSize(
 		FDSTAG   *fs,
 		PetscInt nlevels,
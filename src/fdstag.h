@@ -76,6 +76,7 @@ struct Discret1D
 
 	PetscMPIInt   color;     // color of processor column in base direction
 	MPI_Comm      comm;      // column communicator
+	MPI_Comm      pcomm;     // communicator of processor grid (grprev, grnext & color refer to it)
 
 	PetscInt      uniform;   // uniform grid flag
 
@@ -84,8 +85,14 @@ struct Discret1D
 
 	PetscScalar   gtol;     // geometric tolerance
 	PetscInt      periodic; // periodic topology flag
+
+	PetscInt      nbkt;     // number of point location buckets (0 - not available)
+	PetscInt     *bkt;      // host cell of left bound of every bucket (nbkt+1 entries)
 };
 
+// maximum number of point location buckets per cell
+#define _max_bkt_per_cell_ 8
+
 //---------------------------------------------------------------------------
 // Discret1D functions
 //---------------------------------------------------------------------------
@@ -120,6 +127,9 @@ PetscErrorCode Discret1DCoarsenCoord(Discret1D *coarse, Discret1D *fine);
 // generate ghost points and cell center coordinates
 PetscErrorCode Discret1DCompleteCoord(Discret1D *ds);
 
+// setup point location table (constant-time Discret1DFindPoint on non-uniform grids)
+PetscErrorCode Discret1DSetupFindPoint(Discret1D *ds);
+
 // stretch grid with constant stretch factor about reference point
 PetscErrorCode Discret1DStretch(Discret1D *ds,  PetscScalar eps, PetscScalar ref);
 
@@ -134,6 +144,24 @@ PetscErrorCode Discret1DFreeColumnComm(Discret1D *ds);
 // WARNING! the array must be destroyed after use!
 PetscErrorCode Discret1DGatherCoord(Discret1D *ds, PetscScalar **coord);
 
+// set local node coordinates from global coordinate array (available on all ranks)
+PetscErrorCode Discret1DSetCoord(Discret1D *ds, PetscScalar *coord);
+
+// gather cell array with ghost points (ncels+2) on rank zero of PETSC_COMM_WORLD (tcels+2)
+// WARNING! the array only exists on rank zero of PETSC_COMM_WORLD
+// WARNING! the array must be destroyed after use!
+PetscErrorCode Discret1DGatherCellArray(Discret1D *ds, PetscScalar *lbuff, PetscScalar **garray);
+
+// set local cell array with ghost points from global array (available on all ranks)
+PetscErrorCode Discret1DSetCellArray(Discret1D *ds, PetscScalar *garray, PetscScalar *lbuff);
+
+// get coordinate bounds of all processors in the column (nproc+1 entries)
+// WARNING! the array must be destroyed after use!
+PetscErrorCode Discret1DGetProcBounds(Discret1D *ds, PetscScalar **bounds);
+
+// get rank of processor in the column containing a point (clamped to valid range)
+PetscInt Discret1DFindProc(PetscInt nproc, PetscScalar *bounds, PetscScalar x);
+
 // check multigrid restrictions, get maximum number of coarsening steps
 PetscErrorCode Discret1DCheckMG(Discret1D *ds, const char *dir, PetscInt *_ncors);
 
@@ -204,10 +232,22 @@ PetscErrorCode FDSTAGReadRestart(FDSTAG *fs, FILE *fp);
 
 PetscErrorCode FDSTAGWriteRestart(FDSTAG *fs, FILE *fp);
 
+PetscErrorCode FDSTAGViewRestart(FDSTAG *fs, PetscViewer viewer);
+
+PetscErrorCode FDSTAGLoadRestart(FDSTAG *fs, PetscViewer viewer);
+
 PetscErrorCode FDSTAGCoarsen(FDSTAG *coarse, FDSTAG *fine);
 
 PetscErrorCode FDSTAGCoarsenCoord(FDSTAG *coarse, FDSTAG *fine);
 
+// create grid with the same global size on agglomerated processor grid
+// (processors with zero indices modulo reduction factors f, collective on comm)
+PetscErrorCode FDSTAGAgglomerate(FDSTAG *agg, FDSTAG *fine, MPI_Comm comm, PetscInt f[]);
+
+// copy coordinates from parent grid to agglomerated grid
+// (collective on parent communicator, agg is NULL on idle processors)
+PetscErrorCode FDSTAGAgglomerateCoord(FDSTAG *agg, FDSTAG *fine);
+
 PetscErrorCode FDSTAGCreateDMDA(FDSTAG   *fs,
 	PetscInt  Nx, PetscInt  Ny, PetscInt  Nz,
 	PetscInt  Px, PetscInt  Py, PetscInt  Pz,
@@ -222,6 +262,10 @@ PetscErrorCode FDSTAGGetNeighbProc(FDSTAG *fs);
 // get local & global ranks of a domain containing a point (only neighbors are checked)
 PetscErrorCode FDSTAGGetPointRanks(FDSTAG *fs, PetscScalar *X, PetscInt *lrank, PetscMPIInt *grank);
 
+// get global rank of a domain containing a point (all processors are checked)
+// bnd - processor bounds in all directions (see Discret1DGetProcBounds)
+PetscMPIInt FDSTAGGetPointGlobalRank(FDSTAG *fs, PetscScalar *bnd[], PetscScalar *X);
+
 // compute maximum aspect ratio in the grid
 PetscErrorCode FDSTAGGetAspectRatio(FDSTAG *fs, PetscScalar *maxAspRat);
 
@@ -252,6 +296,16 @@ PetscErrorCode FDSTAGGetCoarseGridSize(
 		PetscInt &nx, PetscInt &ny, PetscInt &nz,
 		PetscInt &Nx, PetscInt &Ny, PetscInt &Nz);
 
+// compute processor reduction factors that agglomerate coarse grid to at least
+// ncells local cells per processor, and maximum number of coarsening steps on
+// agglomerated grid (all factors are set to one if agglomeration is impossible)
+PetscErrorCode FDSTAGGetAggGrid(
+		FDSTAG   *fs,
+		PetscInt nlevels,
+		PetscInt ncells,
+		PetscInt f[],
+		PetscInt &ncors);
+
 // compute local grid size on all levels
 PetscErrorCode FDSTAGGetLevelsLocalGridSize(
 		FDSTAG   *fs,
@@ -327,6 +381,22 @@ PetscErrorCode FDSTAGGetLevelsLocalGridSize(
 
 //---------------------------------------------------------------------------
 
+// initialize colored block access loop (every ncolor-th z-plane, starting from color,
+// every x-row is split in blocks of at most _max_batch_size_ points [ib, ie))
+// With two colors, planes of the same color never update the same face residual,
+// and can be processed concurrently by threads. A single color (ncolor = 1)
+// reproduces the plane order of the standard access loop
+#define START_COLOR_BLOCK_LOOP(color, ncolor) \
+	for(k = sz+(color); k < sz+nz; k += (ncolor)) \
+	{	for(j = sy; j < sy+ny; j++) \
+		{	for(ib = sx; ib < sx+nx; ib += _max_batch_size_) \
+			{	ie = PetscMin(ib+_max_batch_size_, sx+nx);
+
+// finalize colored block access loop
+#define END_COLOR_BLOCK_LOOP END_STD_LOOP
+
+//---------------------------------------------------------------------------
+
 // initialize plane access loop
 #define START_PLANE_LOOP \
 	for(j = sy; j < sy+ny; j++) \
@@ -20,10 +20,11 @@
 #include "JacRes.h"
 #include "tools.h"
 #include "parsing.h"
+#include "perfLog.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PCParamSetFromOptions(PCParam *p)
 {
-	PetscBool mat_free;
+	PetscBool mat_free, sprec;
 	char      pc_type   [_str_len_], bf_type[_str_len_];
 	char      vs_type   [_str_len_], sp_type[_str_len_];
 	char      vs_pc_type[_str_len_];
@@ -38,15 +39,18 @@ PetscErrorCode PCParamSetFromOptions(PCParam *p)
 	sprintf(vs_pc_type, "general");
 	sprintf(sp_type,    "inv_eta");
 	p->pgamma = 1.0;
+	p->ptan   = 0;
 
 	// read options
 	PetscCall(PetscOptionsHasName  (NULL, NULL, "-js_mat_free",   &mat_free));
+	PetscCall(PetscOptionsHasName  (NULL, NULL, "-jp_single",     &sprec));
 	PetscCall(PetscOptionsGetString(NULL, NULL, "-jp_type",       pc_type,    _str_len_, NULL));
 	PetscCall(PetscOptionsGetString(NULL, NULL, "-bf_type",       bf_type,    _str_len_, NULL));
 	PetscCall(PetscOptionsGetString(NULL, NULL, "-bf_vs_type",    vs_type,    _str_len_, NULL));
 	PetscCall(PetscOptionsGetString(NULL, NULL, "-vs_pc_type",    vs_pc_type, _str_len_, NULL));
 	PetscCall(PetscOptionsGetString(NULL, NULL, "-bf_schur_type", sp_type,    _str_len_, NULL));
 	PetscCall(PetscOptionsGetScalar(NULL, NULL, "-jp_pgamma",     &p->pgamma,            NULL));
+	PetscCall(PetscOptionsGetInt   (NULL, NULL, "-jp_partial_tangent_levels", &p->ptan,   NULL));
 
 	if     (!strcmp(pc_type, "mg"))   p->pc_type = _STOKES_MG_;
 	else if(!strcmp(pc_type, "bf"))   p->pc_type = _STOKES_BF_;
@@ -72,9 +76,14 @@ PetscErrorCode PCParamSetFromOptions(PCParam *p)
 	if(mat_free) p->ps_type =_PICARD_MAT_FREE_;
 	else         p->ps_type =_PICARD_ASSEMBLED_;
 
+	// set single precision flag
+	p->sprec = (sprec == PETSC_TRUE);
+
 	// check errors
 	if(p->pgamma < 1.0) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Penalty parameter is less than unit (jp_pgamma)");
 
+	if(p->ptan < 0) SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Number of partial tangent levels is negative (jp_partial_tangent_levels)");
+
 	if(p->pc_type == _STOKES_MG_ && p->pgamma != 1.0)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Coupled geometric multigrid is incompatible with matrix penalty (jp_type, jp_pgamma)");
@@ -90,6 +99,11 @@ PetscErrorCode PCParamSetFromOptions(PCParam *p)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "wBFBT preconditioner is incompatible with matrix penalty (bf_schur_type, jp_pgamma)");
 	}
 
+	if(p->sprec && p->pc_type == _STOKES_USER_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Single precision operators are not supported by user-defined preconditioner (jp_single, jp_type)");
+	}
+
 	// print parameters
 	PetscPrintf(PETSC_COMM_WORLD, "Preconditioner parameters: \n");
 	if     (p->ps_type == _PICARD_ASSEMBLED_) PetscPrintf(PETSC_COMM_WORLD, "   Picard operator type          : assembled\n");
@@ -107,6 +121,8 @@ PetscErrorCode PCParamSetFromOptions(PCParam *p)
 		else if(p->sp_type == _SCHUR_WBFBT_)      PetscPrintf(PETSC_COMM_WORLD, "   Schur preconditioner          : wBFBT\n");
 	}
 	if     (p->pgamma > 1.0)                  PetscPrintf(PETSC_COMM_WORLD, "   Penalty parameter (pgamma)    : %e\n", p->pgamma);
+	if     (p->ptan)                          PetscPrintf(PETSC_COMM_WORLD, "   Partial tangent levels        : %lld\n", (LLD)p->ptan);
+	if     (p->sprec)                         PetscPrintf(PETSC_COMM_WORLD, "   Preconditioner operators      : single precision\n");
 
 	PetscFunctionReturn(0);
 }
@@ -216,6 +232,25 @@ PetscErrorCode PCDataSetup(PCData *pc, JacRes *jr)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode PCDataSetTangent(PCData *pc, PetscInt flag)
+{
+	// activate partial Newton tangent in preconditioner (ignored if not requested)
+
+	MatData *md = NULL;
+
+	PetscFunctionBeginUser;
+
+	PCParam *param = &pc->param;
+
+	if     (param->pc_type == _STOKES_MG_)   md = &((PCDataMG*)  pc->data)->md;
+	else if(param->pc_type == _STOKES_BF_)   md = &((PCDataBF*)  pc->data)->md;
+	else if(param->pc_type == _STOKES_USER_) md = &((PCDataUser*)pc->data)->md;
+
+	if(md && md->newton) md->tangent = flag;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 //....................... COUPLED GALERKIN MULTIGRID ........................
 //---------------------------------------------------------------------------
 PetscErrorCode PCDataMGCreate(PCDataMG *pc, PCParam *param, JacRes *jr, Mat J, Mat P)
@@ -229,6 +264,14 @@ PetscErrorCode PCDataMGCreate(PCDataMG *pc, PCParam *param, JacRes *jr, Mat J, M
 	// create matrix evaluation context
 	PetscCall(MatDataCreate(&pc->md, jr, _IDX_COUPLED_));
 
+	// create partial Newton tangent storage (activated by nonlinear solver)
+	if(param->ptan)
+	{
+		PetscCall(MatDataCreateNewton(&pc->md, jr));
+
+		pc->md.tangent = 0;
+	}
+
 	// create matrix
 	PMatMono *pm = &pc->pm;
 
@@ -238,7 +281,7 @@ PetscErrorCode PCDataMGCreate(PCDataMG *pc, PCParam *param, JacRes *jr, Mat J, M
 	}
 
 	// create multigrid context
-	PetscCall(MGCreate(&pc->mg, &pc->md, pm->A));
+	PetscCall(MGCreate(&pc->mg, &pc->md, pm->A, param->ptan, param->sprec));
 
 	// set Picard operator
 	if(param->ps_type == _PICARD_MAT_FREE_)
@@ -304,8 +347,12 @@ PetscErrorCode PCDataMGApply(Mat P, Vec r, Vec x)
 
 	MG *mg = &pc->mg;
 
+	PetscCall(PerfBegin(_PERF_MG_APPLY_));
+
 	PetscCall(PCApply(mg->pc, r, x));
 
+	PetscCall(PerfEnd(_PERF_MG_APPLY_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -325,6 +372,14 @@ PetscErrorCode PCDataBFCreate(PCDataBF *pc, PCParam *param, JacRes *jr, Mat J, M
 	// create matrix evaluation context
 	PetscCall(MatDataCreate(&pc->md, jr, _IDX_BLOCK_));
 
+	// create partial Newton tangent storage (activated by nonlinear solver)
+	if(param->ptan)
+	{
+		PetscCall(MatDataCreateNewton(&pc->md, jr));
+
+		pc->md.tangent = 0;
+	}
+
 	// set assembly flags
 	if(param->sp_type == _SCHUR_WBFBT_) buildwBFBT = 1;
 	else                                buildwBFBT = 0;
@@ -351,7 +406,7 @@ PetscErrorCode PCDataBFCreate(PCDataBF *pc, PCParam *param, JacRes *jr, Mat J, M
 	// create & set velocity multigrid preconditioner
 	if(param->vs_type == _VEL_MG_)
 	{
-		PetscCall(MGCreate(&pc->vmg, &pc->md, pm->Avv));
+		PetscCall(MGCreate(&pc->vmg, &pc->md, pm->Avv, param->ptan, param->sprec));
 		PetscCall(KSPGetPC(pc->vksp, &vpc));
 		PetscCall(PCSetType(vpc, PCSHELL));
 		PetscCall(PCShellSetContext(vpc, &pc->vmg));
@@ -372,6 +427,22 @@ PetscErrorCode PCDataBFCreate(PCDataBF *pc, PCParam *param, JacRes *jr, Mat J, M
 		PetscCall(KSPSetOptionsPrefix(pc->pksp,"ks_"));
 		PetscCall(KSPSetFromOptions(pc->pksp));
 	}
+
+	// create single precision copies of preconditioner blocks
+	if(param->sprec)
+	{
+		PetscCall(MatSingleCreate(pm->Avp, &pc->sAvp));
+		PetscCall(MatSingleCreate(pm->Apv, &pc->sApv));
+
+		if(param->vs_type != _VEL_MG_)
+		{
+			PetscCall(MatSingleCreate(pm->Avv, &pc->sAvv));
+		}
+		if(param->sp_type == _SCHUR_WBFBT_)
+		{
+			PetscCall(MatSingleCreate(pm->wbfbt->K, &pc->sK));
+		}
+	}
 	// set Picard operator
 	if(param->ps_type == _PICARD_MAT_FREE_)
 	{
@@ -398,6 +469,16 @@ PetscErrorCode PCDataBFDestroy(PCDataBF *pc)
 
 	PetscCall(MatDataDestroy(&pc->md));
 
+	// velocity block copy is owned by velocity multigrid (if any)
+	if(pc->param->vs_type != _VEL_MG_)
+	{
+		PetscCall(MatSingleDestroy(&pc->sAvv));
+	}
+
+	PetscCall(MatSingleDestroy(&pc->sAvp));
+	PetscCall(MatSingleDestroy(&pc->sApv));
+	PetscCall(MatSingleDestroy(&pc->sK));
+
 	PetscCall(PMatBlockDestroy(&pc->pm));
 
 	PetscCall(ViewSolver(pc->vksp));
@@ -430,18 +511,37 @@ PetscErrorCode PCDataBFSetup(PCDataBF *pc, JacRes *jr)
 
 	PetscCall(PMatBlockAssemble(pm));
 
-	PetscCall(KSPSetOperators(pc->vksp, pm->Avv, pm->Avv));
-
 	if(pc->param->vs_type == _VEL_MG_)
 	{
 		PetscCall(MGSetup(&pc->vmg));
 	}
 
+	// update single precision copies of preconditioner blocks
+	if(pc->param->sprec)
+	{
+		if(pc->param->vs_type == _VEL_MG_) { pc->sAvv = pc->vmg.lvls[0].S;         }
+		else                               { PetscCall(MatSingleUpdate(pc->sAvv)); }
+
+		PetscCall(MatSingleUpdate(pc->sAvp));
+		PetscCall(MatSingleUpdate(pc->sApv));
+
+		if(pc->sK)
+		{
+			PetscCall(MatSingleUpdate(pc->sK));
+		}
+	}
+
+	// single precision operators are only applied by Krylov solvers, double precision matrices define preconditioners
+	if(pc->sAvv) { PetscCall(KSPSetOperators(pc->vksp, pc->sAvv, pm->Avv)); }
+	else         { PetscCall(KSPSetOperators(pc->vksp, pm->Avv,  pm->Avv)); }
+
 	PetscCall(KSPSetUp(pc->vksp));
 
 	if(pc->param->sp_type == _SCHUR_WBFBT_)
 	{
-		PetscCall(KSPSetOperators(pc->pksp, pm->wbfbt->K, pm->wbfbt->K));
+		if(pc->sK) { PetscCall(KSPSetOperators(pc->pksp, pc->sK,      pm->wbfbt->K)); }
+		else       { PetscCall(KSPSetOperators(pc->pksp, pm->wbfbt->K, pm->wbfbt->K)); }
+
 		PetscCall(KSPSetUp(pc->pksp));
 	}
 
@@ -456,6 +556,7 @@ PetscErrorCode PCDataBFApply(Mat P, Vec r, Vec x)
 	//======================================================================
 
 	PCDataBF *pc;
+	Mat       Avp, Apv;
 
 	
 	PetscFunctionBeginUser;
@@ -464,6 +565,10 @@ PetscErrorCode PCDataBFApply(Mat P, Vec r, Vec x)
 
 	PMatBlock *pm = &pc->pm;
 
+	// access off-diagonal blocks (single precision copies if available)
+	Avp = pc->sAvp ? pc->sAvp : pm->Avp;
+	Apv = pc->sApv ? pc->sApv : pm->Apv;
+
 	// extract residual blocks
 	PetscCall(VecScatterBlockToMonolithic(pm->rv, pm->rp, r, SCATTER_REVERSE));
 
@@ -483,7 +588,7 @@ PetscErrorCode PCDataBFApply(Mat P, Vec r, Vec x)
 			PetscCall(MatMult(pm->iS, pm->rp, pm->xp)); // xp = (S^-1)*rp
 		}
 
-		PetscCall(MatMult(pm->Avp, pm->xp, pm->wv)); // wv = Avp*xp
+		PetscCall(MatMult(Avp, pm->xp, pm->wv)); // wv = Avp*xp
 
 		PetscCall(VecAXPY(pm->rv, -1.0, pm->wv)); // rv = rv - wv
 
@@ -498,7 +603,7 @@ PetscErrorCode PCDataBFApply(Mat P, Vec r, Vec x)
 
 		PetscCall(KSPSolve(pc->vksp, pm->rv, pm->xv)); // xv = (Avv^-1)*rv
 
-		PetscCall(MatMult(pm->Apv, pm->xv, pm->wp)); // wp = Apv*xv
+		PetscCall(MatMult(Apv, pm->xv, pm->wp)); // wp = Apv*xv
 
 		PetscCall(VecAXPY(pm->rp, -1.0, pm->wp)); // rp = rp - wp
 
@@ -525,27 +630,34 @@ PetscErrorCode PCDataBFBTApply(PCDataBF *pc, Vec x, Vec y)
 	// wBFBT preconditioner action
 	//============================
 
+	Mat Avv, Avp, Apv;
+
 	
 	PetscFunctionBeginUser;
 
 	PMatBlock *pm = &pc->pm;
 	wBFBTData *sp = pm->wbfbt;
 
+	// access blocks (single precision copies if available)
+	Avv = pc->sAvv ? pc->sAvv : pm->Avv;
+	Avp = pc->sAvp ? pc->sAvp : pm->Avp;
+	Apv = pc->sApv ? pc->sApv : pm->Apv;
+
 	// y   = -(S^⁻1)*x
 	// S⁻1 =  (K^⁻1)*B*C*A*C*B^T*(K^⁻1)
 	// K   =  B*C*B^T
 
 	PetscCall(KSPSolve(pc->pksp, x, pm->wp)); // wp = (K^⁻1)*x
 
-	PetscCall(MatMult(pm->Avp, pm->wp, pm->wv)); // wv = Avp*wp
+	PetscCall(MatMult(Avp, pm->wp, pm->wv)); // wv = Avp*wp
 
 	PetscCall(MatMult(sp->C, pm->wv, sp->w)); // w = C*wv
 
-	PetscCall(MatMult(pm->Avv, sp->w, pm->wv)); // wv = Avv * w
+	PetscCall(MatMult(Avv, sp->w, pm->wv)); // wv = Avv * w
 
 	PetscCall(MatMult(sp->C, pm->wv, sp->w)); // w = C*wv
 
-	PetscCall(MatMult(pm->Apv, sp->w, pm->wp)); // wp = Apv*w
+	PetscCall(MatMult(Apv, sp->w, pm->wp)); // wp = Apv*w
 
 	PetscCall(KSPSolve(pc->pksp, pm->wp, y)); // y = (K^⁻1)*wp
 
@@ -576,6 +688,14 @@ PetscErrorCode PCDataUserCreate(PCDataUser *pc, PCParam *param, JacRes *jr, Mat
 	// create matrix evaluation context
 	PetscCall(MatDataCreate(&pc->md, jr, _IDX_COUPLED_));
 
+	// create partial Newton tangent storage (activated by nonlinear solver)
+	if(param->ptan)
+	{
+		PetscCall(MatDataCreateNewton(&pc->md, jr));
+
+		pc->md.tangent = 0;
+	}
+
 	// access context
 	md  = &pc->md;
 	dof = &md->fs->dof;
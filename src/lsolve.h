@@ -65,6 +65,8 @@ struct PCParam
 	PCVelUserType vu_type; // user velocity solver type
 	PCSchurType   sp_type; // Schur preconditioner type
 	PetscScalar   pgamma;  // penalty parameter
+	PetscInt      ptan;    // number of operator levels with partial Newton tangent (0 - Picard)
+	PetscInt      sprec;   // single precision copies of assembled preconditioner operators
 };
 
 //--------------------------------------------------------------------------
@@ -87,6 +89,8 @@ PetscErrorCode PCDataDestroy(PCData *pc);
 
 PetscErrorCode PCDataSetup(PCData *pc, JacRes *jr);
 
+PetscErrorCode PCDataSetTangent(PCData *pc, PetscInt flag);
+
 //---------------------------------------------------------------------------
 //....................... COUPLED GALERKIN MULTIGRID ........................
 //---------------------------------------------------------------------------
@@ -119,6 +123,10 @@ struct PCDataBF
 	MG         vmg;   // velocity multigrid context
 	KSP        vksp;  // velocity solver
 	KSP        pksp;  // pressure solver
+	Mat        sAvv;  // single precision copies of preconditioner blocks
+	Mat        sAvp;  // (velocity block copy is shared with velocity multigrid)
+	Mat        sApv;
+	Mat        sK;
 };
 
 PetscErrorCode PCDataBFCreate(PCDataBF *pc, PCParam *param, JacRes *jr, Mat J, Mat P);
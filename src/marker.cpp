@@ -300,6 +300,20 @@ PetscErrorCode ADVMarkSave(AdvCtx *actx)
 	// create directory
 	PetscCall(DirMake(path));
 
+	if(actx->saveMark == 2)
+	{
+		// write single shared file
+		asprintf(&filename, "%s.dat", actx->saveFile);
+
+		PetscCall(ADVMarkWriteDB(actx, filename));
+
+		free(filename);
+
+		PrintDone(t);
+
+		PetscFunctionReturn(0);
+	}
+
 	// compile file name
 	asprintf(&filename, "%s.%1.8lld.dat", actx->saveFile, (LLD)actx->iproc);
 
@@ -342,6 +356,370 @@ PetscErrorCode ADVMarkSave(AdvCtx *actx)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+// single-file marker database
+//---------------------------------------------------------------------------
+
+#define _mdb_num_fields_ 17
+
+static const char *mdbFieldNames[_mdb_num_fields_] =
+{
+	"X", "Y", "Z", "phase", "T", "p", "APS", "ATS",
+	"Sxx", "Sxy", "Sxz", "Syy", "Syz", "Szz",
+	"Ux", "Uy", "Uz"
+};
+//---------------------------------------------------------------------------
+static void MarkDBSetHeader(AdvCtx *actx, MarkDBHeader *hdr, PetscInt64 nummark)
+{
+	Scaling  *scal;
+	PetscInt  i;
+
+	scal = actx->jr->scal;
+
+	memset(hdr, 0, sizeof(MarkDBHeader));
+
+	memcpy(hdr->magic, _mdb_magic_, sizeof(hdr->magic));
+
+	hdr->version = _mdb_version_;
+	hdr->hsize   = (PetscInt64)sizeof(MarkDBHeader);
+	hdr->nfields = _mdb_num_fields_;
+	hdr->nummark = nummark;
+	hdr->nproc   = actx->nproc;
+
+	for(i = 0; i < _mdb_num_fields_; i++)
+	{
+		strncpy(hdr->name[i], mdbFieldNames[i], _mdb_name_len_);
+
+		hdr->scale[i] = 1.0;
+		hdr->shift[i] = 0.0;
+	}
+
+	// coordinates & displacements
+	hdr->scale[0]  = scal->length;
+	hdr->scale[1]  = scal->length;
+	hdr->scale[2]  = scal->length;
+	hdr->scale[14] = scal->length;
+	hdr->scale[15] = scal->length;
+	hdr->scale[16] = scal->length;
+
+	// temperature
+	hdr->scale[4]  = scal->temperature;
+	hdr->shift[4]  = -scal->Tshift;
+
+	// pressure & stress
+	for(i = 5; i < 6;  i++) hdr->scale[i] = scal->stress;
+	for(i = 8; i < 14; i++) hdr->scale[i] = scal->stress;
+}
+//---------------------------------------------------------------------------
+static void MarkDBPack(Marker *P, PetscScalar *v)
+{
+	v[0]  =              P->X[0];
+	v[1]  =              P->X[1];
+	v[2]  =              P->X[2];
+	v[3]  = (PetscScalar)P->phase;
+	v[4]  =              P->T;
+	v[5]  =              P->p;
+	v[6]  =              P->APS;
+	v[7]  =              P->ATS;
+	v[8]  =              P->S.xx;
+	v[9]  =              P->S.xy;
+	v[10] =              P->S.xz;
+	v[11] =              P->S.yy;
+	v[12] =              P->S.yz;
+	v[13] =              P->S.zz;
+	v[14] =              P->U[0];
+	v[15] =              P->U[1];
+	v[16] =              P->U[2];
+}
+//---------------------------------------------------------------------------
+static void MarkDBUnpack(Marker *P, PetscScalar *rec, PetscInt *map, PetscScalar *a, PetscScalar *b)
+{
+	// map  - record position of every known field (-1 if missing)
+	// a, b - conversion from writer to current nondimensional units (v = a*rec + b)
+
+	PetscScalar v[_mdb_num_fields_];
+	PetscInt    i;
+
+	for(i = 0; i < _mdb_num_fields_; i++)
+	{
+		v[i] = (map[i] < 0) ? 0.0 : a[i]*rec[map[i]] + b[i];
+	}
+
+	P->X[0]  =           v[0];
+	P->X[1]  =           v[1];
+	P->X[2]  =           v[2];
+	P->phase = (PetscInt)v[3];
+	P->T     =           v[4];
+	P->p     =           v[5];
+	P->APS   =           v[6];
+	P->ATS   =           v[7];
+	P->S.xx  =           v[8];
+	P->S.xy  =           v[9];
+	P->S.xz  =           v[10];
+	P->S.yy  =           v[11];
+	P->S.yz  =           v[12];
+	P->S.zz  =           v[13];
+	P->U[0]  =           v[14];
+	P->U[1]  =           v[15];
+	P->U[2]  =           v[16];
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkWriteDB(AdvCtx *actx, const char *filename)
+{
+	// write all markers to a single shared file (collective)
+
+	MPI_File      fh;
+	MPI_Offset    offset;
+	MarkDBHeader  hdr;
+	PetscInt64    nloc, nbeg, ntot;
+	PetscScalar  *buf;
+	PetscInt      imark;
+
+	
+	PetscFunctionBeginUser;
+
+	nloc = (PetscInt64)actx->nummark;
+	nbeg = 0;
+
+	// get global number of markers & offset of local markers
+	PetscCallMPI(MPI_Exscan   (&nloc, &nbeg, 1, MPIU_INT64, MPI_SUM, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Allreduce(&nloc, &ntot, 1, MPIU_INT64, MPI_SUM, PETSC_COMM_WORLD));
+
+	if(!actx->iproc) nbeg = 0;
+
+	if(nloc*_mdb_num_fields_ > PETSC_MPI_INT_MAX)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Too many local markers for marker database output");
+	}
+
+	// set header
+	MarkDBSetHeader(actx, &hdr, ntot);
+
+	// pack marker records
+	PetscCall(PetscMalloc1((size_t)(nloc*_mdb_num_fields_), &buf));
+
+	for(imark = 0; imark < actx->nummark; imark++)
+	{
+		MarkDBPack(&actx->markers[imark], buf + imark*_mdb_num_fields_);
+	}
+
+	// open & truncate file
+	PetscCallMPI(MPI_File_open(PETSC_COMM_WORLD, filename, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &fh));
+	PetscCallMPI(MPI_File_set_size(fh, 0));
+
+	// write header
+	if(!actx->iproc)
+	{
+		PetscCallMPI(MPI_File_write_at(fh, 0, &hdr, (PetscMPIInt)sizeof(MarkDBHeader), MPI_BYTE, MPI_STATUS_IGNORE));
+	}
+
+	// write marker records
+	offset = (MPI_Offset)(hdr.hsize + nbeg*_mdb_num_fields_*(PetscInt64)sizeof(PetscScalar));
+
+	PetscCallMPI(MPI_File_write_at_all(fh, offset, buf, (PetscMPIInt)(nloc*_mdb_num_fields_), MPIU_SCALAR, MPI_STATUS_IGNORE));
+
+	PetscCallMPI(MPI_File_close(&fh));
+
+	PetscCall(PetscFree(buf));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkReadDB(AdvCtx *actx, const char *filename)
+{
+	// read markers from a single shared file, distribute to host processors (collective)
+
+	MPI_File      fh;
+	MPI_Offset    offset;
+	MarkDBHeader  hdr, cur;
+	Marker       *markers;
+	PetscScalar  *buf, a[_mdb_num_fields_], b[_mdb_num_fields_];
+	PetscInt64    nloc, nbeg, nrem, nfields;
+	PetscInt      i, j, imark, map[_mdb_num_fields_];
+
+	
+	PetscFunctionBeginUser;
+
+	PetscCallMPI(MPI_File_open(PETSC_COMM_WORLD, filename, MPI_MODE_RDONLY, MPI_INFO_NULL, &fh));
+
+	// read & check header
+	PetscCallMPI(MPI_File_read_at_all(fh, 0, &hdr, (PetscMPIInt)sizeof(MarkDBHeader), MPI_BYTE, MPI_STATUS_IGNORE));
+
+	if(memcmp(hdr.magic, _mdb_magic_, sizeof(hdr.magic)))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_UNEXPECTED, "Invalid marker database file: %s", filename);
+	}
+
+	if(hdr.version > _mdb_version_ || hdr.nfields < 1 || hdr.nfields > _mdb_max_fields_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_UNEXPECTED, "Unsupported marker database version or schema: %s", filename);
+	}
+
+	nfields = hdr.nfields;
+
+	// map known fields on record positions
+	for(i = 0; i < _mdb_num_fields_; i++)
+	{
+		map[i] = -1;
+
+		for(j = 0; j < nfields; j++)
+		{
+			if(!strncmp(hdr.name[j], mdbFieldNames[i], _mdb_name_len_)) { map[i] = j; break; }
+		}
+	}
+
+	// coordinates & phase are mandatory
+	for(i = 0; i < 4; i++)
+	{
+		if(map[i] == -1)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_UNEXPECTED, "Marker database misses mandatory field %s: %s", mdbFieldNames[i], filename);
+		}
+	}
+
+	// get scaling of current run
+	MarkDBSetHeader(actx, &cur, 0);
+
+	// convert stored values to physical units (scale*v + shift),
+	// then to nondimensional units of current run
+	for(i = 0; i < _mdb_num_fields_; i++)
+	{
+		a[i] = 1.0;
+		b[i] = 0.0;
+
+		if(map[i] < 0) continue;
+
+		if(hdr.scale[map[i]] == 0.0)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_FILE_UNEXPECTED, "Marker database has zero scaling of field %s: %s", mdbFieldNames[i], filename);
+		}
+
+		a[i] =  hdr.scale[map[i]]/cur.scale[i];
+		b[i] = (hdr.shift[map[i]] - cur.shift[i])/cur.scale[i];
+	}
+
+	// get contiguous block of markers to read (independent of the writer partitioning)
+	nloc = hdr.nummark/actx->nproc;
+	nrem = hdr.nummark%actx->nproc;
+	nbeg = nloc*actx->iproc + PetscMin(actx->iproc, nrem);
+
+	if(actx->iproc < nrem) nloc++;
+
+	if(nloc*nfields > PETSC_MPI_INT_MAX)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Too many markers per processor for marker database input");
+	}
+
+	// read marker records
+	PetscCall(PetscMalloc1((size_t)(nloc*nfields), &buf));
+
+	offset = (MPI_Offset)(hdr.hsize + nbeg*nfields*(PetscInt64)sizeof(PetscScalar));
+
+	PetscCallMPI(MPI_File_read_at_all(fh, offset, buf, (PetscMPIInt)(nloc*nfields), MPIU_SCALAR, MPI_STATUS_IGNORE));
+
+	PetscCallMPI(MPI_File_close(&fh));
+
+	// unpack markers
+	PetscCall(PetscMalloc1((size_t)nloc, &markers));
+	PetscCall(PetscMemzero(markers, (size_t)nloc*sizeof(Marker)));
+
+	for(imark = 0; imark < nloc; imark++)
+	{
+		MarkDBUnpack(&markers[imark], buf + imark*nfields, map, a, b);
+	}
+
+	PetscCall(PetscFree(buf));
+
+	// send markers to host processors
+	PetscCall(ADVMarkRedistribute(actx, markers, (PetscInt)nloc));
+
+	PetscCall(PetscFree(markers));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode ADVMarkRedistribute(AdvCtx *actx, Marker *markers, PetscInt nummark)
+{
+	// send markers to host processors, replace local marker storage (collective)
+	// NOTE: unlike regular exchange, markers can be sent to any processor
+
+	FDSTAG       *fs;
+	Marker       *sendbuf;
+	MPI_Datatype  mtype;
+	PetscScalar  *bnd[3];
+	PetscMPIInt  *dest, *scnt, *sdsp, *rcnt, *rdsp;
+	PetscInt      i, nproc, nrecv;
+
+	
+	PetscFunctionBeginUser;
+
+	fs    = actx->fs;
+	nproc = actx->nproc;
+
+	// get processor bounds in all directions
+	PetscCall(Discret1DGetProcBounds(&fs->dsx, &bnd[0]));
+	PetscCall(Discret1DGetProcBounds(&fs->dsy, &bnd[1]));
+	PetscCall(Discret1DGetProcBounds(&fs->dsz, &bnd[2]));
+
+	PetscCall(makeMPIIntArray(&dest, NULL, nummark));
+	PetscCall(makeMPIIntArray(&scnt, NULL, nproc));
+	PetscCall(makeMPIIntArray(&sdsp, NULL, nproc));
+	PetscCall(makeMPIIntArray(&rcnt, NULL, nproc));
+	PetscCall(makeMPIIntArray(&rdsp, NULL, nproc));
+
+	// get destination processors, count markers
+	for(i = 0; i < nummark; i++)
+	{
+		dest[i] = FDSTAGGetPointGlobalRank(fs, bnd, markers[i].X);
+
+		scnt[dest[i]]++;
+	}
+
+	// sort markers by destination
+	for(i = 1; i < nproc; i++) sdsp[i] = sdsp[i-1] + scnt[i-1];
+
+	PetscCall(PetscMalloc1((size_t)nummark, &sendbuf));
+
+	for(i = 0; i < nummark; i++) sendbuf[sdsp[dest[i]]++] = markers[i];
+
+	for(i = 0; i < nproc; i++) sdsp[i] -= scnt[i];
+
+	// exchange counts
+	PetscCallMPI(MPI_Alltoall(scnt, 1, MPI_INT, rcnt, 1, MPI_INT, PETSC_COMM_WORLD));
+
+	for(i = 1; i < nproc; i++) rdsp[i] = rdsp[i-1] + rcnt[i-1];
+
+	nrecv = (PetscInt)rdsp[nproc-1] + (PetscInt)rcnt[nproc-1];
+
+	// replace local marker storage
+	actx->nummark = 0;
+
+	PetscCall(ADVReAllocStorage(actx, nrecv));
+
+	actx->nummark = nrecv;
+
+	// exchange markers
+	PetscCallMPI(MPI_Type_contiguous((PetscMPIInt)sizeof(Marker), MPI_BYTE, &mtype));
+	PetscCallMPI(MPI_Type_commit(&mtype));
+
+	PetscCallMPI(MPI_Alltoallv(sendbuf, scnt, sdsp, mtype, actx->markers, rcnt, rdsp, mtype, PETSC_COMM_WORLD));
+
+	PetscCallMPI(MPI_Type_free(&mtype));
+
+	// clear
+	PetscCall(PetscFree(sendbuf));
+	PetscCall(PetscFree(dest));
+	PetscCall(PetscFree(scnt));
+	PetscCall(PetscFree(sdsp));
+	PetscCall(PetscFree(rcnt));
+	PetscCall(PetscFree(rdsp));
+	PetscCall(PetscFree(bnd[0]));
+	PetscCall(PetscFree(bnd[1]));
+	PetscCall(PetscFree(bnd[2]));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVMarkCheckMarkers(AdvCtx *actx)
 {
 	// check initial marker distribution
@@ -751,6 +1129,7 @@ PetscErrorCode ADVMarkInitFiles(AdvCtx *actx, FB *fb)
 	char           *filename, file[_str_len_];
 	PetscScalar    *markbuf, *markptr, header, chTemp, chLen, Tshift, s_nummark;
 	PetscInt       imark, nummark, nfields;
+	PetscBool      shared;
 
 	
 	PetscFunctionBeginUser;
@@ -760,6 +1139,26 @@ PetscErrorCode ADVMarkInitFiles(AdvCtx *actx, FB *fb)
 
 	PrintStart(&t, "Loading markers in parallel from", file);
 
+	// check for single shared file
+	asprintf(&filename, "%s.dat", file);
+
+	PetscCall(PetscTestFile(filename, 'r', &shared));
+	PetscCallMPI(MPI_Bcast(&shared, 1, MPIU_BOOL, 0, PETSC_COMM_WORLD));
+
+	if(shared)
+	{
+		// read & distribute markers (any number of processors)
+		PetscCall(ADVMarkReadDB(actx, filename));
+
+		free(filename);
+
+		PrintDone(t);
+
+		PetscFunctionReturn(0);
+	}
+
+	free(filename);
+
 	// compile input file name with extension
 	asprintf(&filename, "%s.%1.8lld.dat", file, (LLD)actx->iproc);
 
@@ -827,12 +1226,26 @@ PetscErrorCode ADVMarkInitFiles(AdvCtx *actx, FB *fb)
 //---------------------------------------------------------------------------
 PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 {
+	FDSTAG         *fs;
 	Marker         *P;
 	PetscLogDouble  t;
 	PetscScalar     chLen, chTime;
 	char            TemperatureStructure[_str_len_];
-	PetscInt        jj, ngeom, imark, maxPhaseID;
-	GeomPrim        geom[_max_geom_], *pgeom[_max_geom_], *sphere, *ellipsoid, *box, *ridge, *hex, *layer, *cylinder;
+	PetscInt        jj, d, ngeom, ngeom_max, imark, maxPhaseID, noise;
+	PetscInt        I, J, K, ID, nx, ny, nc, *cptr, *cidx, *gidx, *idx;
+	GeomPrim       *geom, **pgeom, *sphere, *ellipsoid, *box, *ridge, *hex, *layer, *cylinder;
+
+	// block keys of all primitive types
+	const char *keys[] =
+	{
+		"<LayerStart>",     "<LayerEnd>",
+		"<SphereStart>",    "<SphereEnd>",
+		"<EllipsoidStart>", "<EllipsoidEnd>",
+		"<BoxStart>",       "<BoxEnd>",
+		"<RidgeSegStart>",  "<RidgeSegEnd>",
+		"<HexStart>",       "<HexEnd>",
+		"<CylinderStart>",  "<CylinderEnd>"
+	};
 
 	// map container to sort primitives in the order of appearance
 	map<PetscInt, GeomPrim*> cgeom;
@@ -841,17 +1254,31 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	
 	PetscFunctionBeginUser;
 
+	fs         = actx->fs;
 	ngeom      = 0;
+	ngeom_max  = 0;
 	maxPhaseID = actx->dbm->numPhases - 1;
 	chLen      = actx->jr->scal->length;
 	chTime     = actx->jr->scal->time;
 
-	// clear storage
-	PetscCall(PetscMemzero(geom,  sizeof(GeomPrim) *(size_t)_max_geom_));
-	PetscCall(PetscMemzero(pgeom, sizeof(GeomPrim*)*(size_t)_max_geom_));
-
 	PrintStart(&t, "Reading geometric primitives", NULL);
 
+	// count primitives
+	for(jj = 0; jj < 7; jj++)
+	{
+		PetscCall(FBFindBlocks(fb, _OPTIONAL_, keys[2*jj], keys[2*jj+1]));
+
+		ngeom_max += fb->nblocks;
+
+		PetscCall(FBFreeBlocks(fb));
+	}
+
+	// allocate & clear storage
+	PetscCall(PetscMalloc1((size_t)ngeom_max, &geom));
+	PetscCall(PetscMalloc1((size_t)ngeom_max, &pgeom));
+	PetscCall(PetscMemzero(geom,  sizeof(GeomPrim) *(size_t)ngeom_max));
+	PetscCall(PetscMemzero(pgeom, sizeof(GeomPrim*)*(size_t)ngeom_max));
+
 	//=======
 	// LAYERS
 	//=======
@@ -861,7 +1288,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
 		fb->ID  = jj;								// allows command-line parsing
-		GET_GEOM(layer, geom, ngeom, _max_geom_);
+		GET_GEOM(layer, geom, ngeom, ngeom_max);
 
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",  &layer->phase,  1, maxPhaseID));
 		PetscCall(getScalarParam(fb, _REQUIRED_, "top",    &layer->top,    1, chLen));
@@ -907,6 +1334,12 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 			layer->kappa    = 1e-6/( (actx->jr->scal->length_si)*(actx->jr->scal->length_si)/(actx->jr->scal->time_si)); // thermal diffusivity in m2/s	
 		}
 
+		// bounding box
+		layer->aabb[0] = layer->aabb[2] = -DBL_MAX;
+		layer->aabb[1] = layer->aabb[3] =  DBL_MAX;
+		layer->aabb[4] = layer->bot - PetscAbsScalar(layer->amplitude);
+		layer->aabb[5] = layer->top + PetscAbsScalar(layer->amplitude);
+
 		layer->setPhase = setPhaseLayer;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], layer));
@@ -914,6 +1347,22 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 
 	PetscCall(FBFreeBlocks(fb));
 
+	// every layer test draws a random number, if any layer has random noise
+	// all layers are tested everywhere to keep the random sequence unchanged
+	for(jj = 0, noise = 0; jj < ngeom; jj++)
+	{
+		if(geom[jj].rand_amplitude) noise = 1;
+	}
+
+	if(noise)
+	{
+		for(jj = 0; jj < ngeom; jj++)
+		{
+			geom[jj].aabb[4] = -DBL_MAX;
+			geom[jj].aabb[5] =  DBL_MAX;
+		}
+	}
+
 	//========
 	// SPHERES
 	//========
@@ -924,7 +1373,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	{
 		fb->ID  = jj;								// allows command-line parsing
 		
-		GET_GEOM(sphere, geom, ngeom, _max_geom_);
+		GET_GEOM(sphere, geom, ngeom, ngeom_max);
 		
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",  &sphere->phase,  1, maxPhaseID));
 		PetscCall(getScalarParam(fb, _REQUIRED_, "radius", &sphere->radius, 1, chLen));
@@ -943,6 +1392,13 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 			sphere->cstTemp = (sphere->cstTemp +  actx->jr->scal->Tshift)/actx->jr->scal->temperature; 		
 		}
 		
+		// bounding box
+		for(d = 0; d < 3; d++)
+		{
+			sphere->aabb[2*d]   = sphere->center[d] - sphere->radius;
+			sphere->aabb[2*d+1] = sphere->center[d] + sphere->radius;
+		}
+
 		sphere->setPhase = setPhaseSphere;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], sphere));
@@ -958,7 +1414,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
-		GET_GEOM(ellipsoid, geom, ngeom, _max_geom_);
+		GET_GEOM(ellipsoid, geom, ngeom, ngeom_max);
 
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",  &ellipsoid->phase,  1, maxPhaseID));
 		PetscCall(getScalarParam(fb, _REQUIRED_, "axes",    ellipsoid->axes,   3, chLen));
@@ -977,6 +1433,13 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 			ellipsoid->cstTemp = (ellipsoid->cstTemp +  actx->jr->scal->Tshift)/actx->jr->scal->temperature; 		
 		}
 
+		// bounding box
+		for(d = 0; d < 3; d++)
+		{
+			ellipsoid->aabb[2*d]   = ellipsoid->center[d] - PetscAbsScalar(ellipsoid->axes[d]);
+			ellipsoid->aabb[2*d+1] = ellipsoid->center[d] + PetscAbsScalar(ellipsoid->axes[d]);
+		}
+
 		ellipsoid->setPhase = setPhaseEllipsoid;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], ellipsoid));	
@@ -993,7 +1456,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
 		fb->ID  = jj;								// allows command-line parsing
-		GET_GEOM(box, geom, ngeom, _max_geom_);
+		GET_GEOM(box, geom, ngeom, ngeom_max);
 
 		box->setTemp = 0;	//default is no	
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",  	&box->phase,   1, maxPhaseID));
@@ -1031,6 +1494,9 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 			box->kappa      = 1e-6/( (actx->jr->scal->length_si)*(actx->jr->scal->length_si)/(actx->jr->scal->time_si)); // thermal diffusivity in m2/s	
 		}
 		
+		// bounding box
+		for(d = 0; d < 6; d++) box->aabb[d] = box->bounds[d];
+
 		box->setPhase = setPhaseBox;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], box));
@@ -1049,7 +1515,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	  {
 		PetscScalar v_spread, maxAge;  
 	    fb->ID  = jj;                                                               // allows command-line parsing
-	    GET_GEOM(ridge, geom, ngeom, _max_geom_);
+	    GET_GEOM(ridge, geom, ngeom, ngeom_max);
 	    
 	    ridge->setTemp 	= 0;       	//	default is no
 		v_spread   	   	= 0.0;
@@ -1089,6 +1555,9 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	      
 	    }
 	    
+	    // bounding box
+	    for(d = 0; d < 6; d++) ridge->aabb[d] = ridge->bounds[d];
+
 	    ridge->setPhase = setPhaseRidge;
 	    
 	    cgeom.insert(make_pair(fb->blBeg[fb->blockID++], ridge));
@@ -1107,7 +1576,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
 		fb->ID  = jj;								// allows command-line parsing
-		GET_GEOM(hex, geom, ngeom, _max_geom_);
+		GET_GEOM(hex, geom, ngeom, ngeom_max);
 
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",  &hex->phase, 1,  maxPhaseID));
 		PetscCall(getScalarParam(fb, _REQUIRED_, "coord",   hex->coord, 24, chLen));
@@ -1115,6 +1584,8 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 		// compute bounding box
 		HexGetBoundingBox(hex->coord, hex->bounds);
 
+		for(d = 0; d < 6; d++) hex->aabb[d] = hex->bounds[d];
+
 		hex->setPhase = setPhaseHex;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], hex));
@@ -1131,7 +1602,7 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	for(jj = 0; jj < fb->nblocks; jj++)
 	{
 		fb->ID  = jj;								// allows command-line parsing
-		GET_GEOM(cylinder, geom, ngeom, _max_geom_);
+		GET_GEOM(cylinder, geom, ngeom, ngeom_max);
 
 		PetscCall(getIntParam   (fb, _REQUIRED_, "phase",   &cylinder->phase,  1, maxPhaseID));
 		PetscCall(getScalarParam(fb, _REQUIRED_, "radius",  &cylinder->radius, 1, chLen));
@@ -1151,6 +1622,13 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 			cylinder->cstTemp = (cylinder->cstTemp +  actx->jr->scal->Tshift)/actx->jr->scal->temperature; 		
 		}
 
+		// bounding box
+		for(d = 0; d < 3; d++)
+		{
+			cylinder->aabb[2*d]   = min(cylinder->base[d], cylinder->cap[d]) - cylinder->radius;
+			cylinder->aabb[2*d+1] = max(cylinder->base[d], cylinder->cap[d]) + cylinder->radius;
+		}
+
 		cylinder->setPhase = setPhaseCylinder;
 
 		cgeom.insert(make_pair(fb->blBeg[fb->blockID++], cylinder));
@@ -1168,6 +1646,17 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 	// ASSIGN PHASES
 	//==============
 
+	nx = fs->dsx.ncels;
+	ny = fs->dsy.ncels;
+
+	// get lists of primitives overlapping local cells
+	PetscCall(GeomPrimGetCellCand(fs, ngeom, pgeom, &cptr, &cidx));
+
+	// get full list of primitives (non-local markers)
+	PetscCall(makeIntArray(&gidx, NULL, ngeom));
+
+	for(jj = 0; jj < ngeom; jj++) gidx[jj] = jj;
+
 	// loop over local markers
 	for(imark = 0; imark < actx->nummark; imark++)
 	{
@@ -1176,35 +1665,83 @@ PetscErrorCode ADVMarkInitGeom(AdvCtx *actx, FB *fb)
 		//set default
 		P->phase = actx->bgPhase;
 
-		// override from geometric primitives
-		for(jj = 0; jj < ngeom; jj++)
+		// get candidate primitives from host cell
+		if(P->X[0] >= fs->dsx.ncoor[0] && P->X[0] <= fs->dsx.ncoor[fs->dsx.ncels]
+		&& P->X[1] >= fs->dsy.ncoor[0] && P->X[1] <= fs->dsy.ncoor[fs->dsy.ncels]
+		&& P->X[2] >= fs->dsz.ncoor[0] && P->X[2] <= fs->dsz.ncoor[fs->dsz.ncels])
+		{
+			PetscCall(Discret1DFindPoint(&fs->dsx, P->X[0], I));
+			PetscCall(Discret1DFindPoint(&fs->dsy, P->X[1], J));
+			PetscCall(Discret1DFindPoint(&fs->dsz, P->X[2], K));
+
+			GET_CELL_ID(ID, I, J, K, nx, ny);
+
+			nc  = cptr[ID+1] - cptr[ID];
+			idx = cidx + cptr[ID];
+		}
+		else
+		{
+			nc  = ngeom;
+			idx = gidx;
+		}
+
+		// override from geometric primitives (in the order of appearance)
+		for(jj = 0; jj < nc; jj++)
 		{
-			pgeom[jj]->setPhase(pgeom[jj], P);
+			pgeom[idx[jj]]->setPhase(pgeom[idx[jj]], P);
 		}
 	}
 
+	// clear storage
+	PetscCall(PetscFree(geom));
+	PetscCall(PetscFree(pgeom));
+	PetscCall(PetscFree(cptr));
+	PetscCall(PetscFree(cidx));
+	PetscCall(PetscFree(gidx));
+
 	PrintDone(t);
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+static PetscErrorCode PolyFileRead(int fd, PetscScalar *buf, PetscInt n, PetscInt &skip)
+{
+	// read data from polygon file (move over skipped data first)
+
+	off_t off;
+
+	PetscFunctionBeginUser;
+
+	if(skip)
+	{
+		PetscCall(PetscBinarySeek(fd, (off_t)skip*(off_t)sizeof(PetscScalar), PETSC_BINARY_SEEK_CUR, &off));
+
+		skip = 0;
+	}
+
+	PetscCall(PetscBinaryRead(fd, buf, n, NULL, PETSC_SCALAR));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 {
-	// REDUNDANTLY loads a file with 2D-polygons that coincide with the marker planes
-	// each processor uses the full polygonal shapes to find assign phase ids to local markers
+	// loads a file with 2D-polygons that coincide with the marker planes
+	// every processor streams volume headers, but reads only coordinates
+	// of the polygons located on the local marker planes (others are skipped)
 
 	FDSTAG        *fs;
 	int            fd;
 	PetscViewer    view_in;
 	char           filename[_str_len_];
-	PetscScalar    header[2];
+	PetscScalar    header[2], fhead[3], vhead[4];
 	PetscInt       tstart[3], tend[3], nmark[3], nidx[3], nidxmax;
-	PetscInt       k, n, kvol, Fcount, Fsize, VolN, Nmax, Lmax, kpoly, lpoly, numLev;
+	PetscInt       k, kvol, skip, VolN, Nmax, Lmax, kpoly, lpoly, numLev;
 	Volume3D       Vol;
 	Polygon2D      Polys[_max_polygons_];
 	PetscInt      *polyin, *polyin_sum;
-	PetscInt      *idx;
-	PetscScalar   *X, *PolyLen, *PolyIdx, *PolyX, *PolyFile;
+	PetscInt      *idx, *sptr, *sidx, nslab, sz;
+	PetscScalar   *X, *PolyLen, *PolyIdx, *PolyX;
 	PetscInt       imark, imarkx, imarky, imarkz, icellx, icelly, icellz;
 	PetscScalar    dx, dy, dz, x, y, z;
 	PetscScalar    chLen;
@@ -1223,7 +1760,7 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	// get file name
 	PetscCall(getStringParam(fb, _OPTIONAL_, "poly_file", filename, "./input/poly.dat"));
 
-	PrintStart(&t, "Loading polygons redundantly from", filename);
+	PrintStart(&t, "Loading polygons from", filename);
 
 	// initialize
 	fs = actx->fs;
@@ -1343,25 +1880,27 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 
 	// read (and ignore) the silent undocumented file header & size of file
 	PetscCall(PetscBinaryRead(fd, &header, 2, NULL, PETSC_SCALAR));
-	Fsize = (PetscInt)(header[1]);
-
-	// allocate space for entire file & initialize counter
-	PetscCall(PetscMalloc((size_t)Fsize  *sizeof(PetscScalar),&PolyFile));
-	Fcount = 0;
 
-	// read entire file 
-	PetscCall(PetscBinaryRead(fd, PolyFile, Fsize, NULL, PETSC_SCALAR));
+	// initialize number of skipped entries
+	skip = 0;
 
 	// read number of volumes
-	VolN = (PetscInt)(PolyFile[Fcount]); Fcount++;
-	Nmax = (PetscInt)(PolyFile[Fcount]); Fcount++;
-	Lmax = (PetscInt)(PolyFile[Fcount]); Fcount++;
+	PetscCall(PolyFileRead(fd, fhead, 3, skip));
+
+	VolN = (PetscInt)(fhead[0]);
+	Nmax = (PetscInt)(fhead[1]);
+	Lmax = (PetscInt)(fhead[2]);
 
     // allocate space for index array & the coordinates of the largest polygon
 	PetscCall(PetscMalloc((size_t)Nmax  *sizeof(PetscScalar),&PolyLen));
 	PetscCall(PetscMalloc((size_t)Nmax  *sizeof(PetscScalar),&PolyIdx));
 	PetscCall(PetscMalloc((size_t)Lmax*2*sizeof(PetscScalar),&PolyX));
 
+	// allocate edge table of the largest polygon
+	PetscCall(makeIntArray(&sptr, NULL, Lmax+1));
+	sidx = NULL;
+	sz   = 0;
+
 	// allocate temporary arrays
 	PetscCall(PetscMalloc((size_t)nidxmax*sizeof(PetscInt),&idx));
 	PetscCall(PetscMalloc((size_t)nidxmax*sizeof(PetscInt),&polyin));
@@ -1376,10 +1915,12 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	for(kvol = 0; kvol < VolN; kvol++)
 	{
 		// read volume header
-		Vol.dir   = (PetscInt)(PolyFile[Fcount]); Fcount++; // normal vector of polygon plane
-		Vol.phase = (PetscInt)(PolyFile[Fcount]); Fcount++; // phase that polygon defines
-		Vol.type  = (PetscInt)(PolyFile[Fcount]); Fcount++; // type of assigning the phases
-		Vol.num   = (PetscInt)(PolyFile[Fcount]); Fcount++; // number of polygon slices defining the volume
+		PetscCall(PolyFileRead(fd, vhead, 4, skip));
+
+		Vol.dir   = (PetscInt)(vhead[0]); // normal vector of polygon plane
+		Vol.phase = (PetscInt)(vhead[1]); // phase that polygon defines
+		Vol.type  = (PetscInt)(vhead[2]); // type of assigning the phases
+		Vol.num   = (PetscInt)(vhead[3]); // number of polygon slices defining the volume
 		
 		// define axes the span the polygon plane
 		if (Vol.dir==0)
@@ -1400,16 +1941,10 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 		}
 
 		// get position of polygons (PetscScalar !)
-		for(kpoly = 0; kpoly < Vol.num; kpoly++)
-		{
-			PolyIdx[kpoly] = PolyFile[Fcount]; Fcount++;
-		}
+		PetscCall(PolyFileRead(fd, PolyIdx, Vol.num, skip));
 
 		// get lengths of polygons (PetscScalar !)
-		for (kpoly=0; kpoly<Vol.num;kpoly++)
-		{
-			PolyLen[kpoly] = PolyFile[Fcount]; Fcount++;
-		}
+		PetscCall(PolyFileRead(fd, PolyLen, Vol.num, skip));
 
 		// interpolate stretch parameters
 		PetscScalar SyAll[Vol.num];
@@ -1478,10 +2013,7 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 				if(Polys[lpoly].gidx >= tstart[Vol.dir] && Polys[lpoly].gidx <= tend[Vol.dir])
 				{
 					// read polygon
-					for (n=0; n<Polys[lpoly].len*2;n++)
-					{
-						PolyX[n] = PolyFile[Fcount]; Fcount++;
-					}
+					PetscCall(PolyFileRead(fd, PolyX, Polys[lpoly].len*2, skip));
 
 					// vary Polygon geometry
 					if (kvol == VolID)
@@ -1503,8 +2035,11 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 
 					polygon_box(&nPoly, PolyX, 1e-12, &atol, box);
 
+					// get edge table of a polygon
+					PetscCall(polygon_slabs(nPoly, PolyX, box, &nslab, sptr, &sidx, &sz));
+
 					// check which markers are in the polygon
-					in_polygon(nidx[Vol.dir], X, nPoly, PolyX, box, atol, polyin);
+					in_polygon(nidx[Vol.dir], X, nPoly, PolyX, box, atol, polyin, nslab, sptr, sidx);
 
 					// sum up number of polygons that a marker is in
 					for(k = 0; k < nidx[Vol.dir]; k++)
@@ -1515,8 +2050,8 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 				}
 				else
 				{
-					// increase counter of the buffer
-					Fcount += Polys[lpoly].len*2;
+					// skip polygon
+					skip += Polys[lpoly].len*2;
 				}
 			}
 
@@ -1554,7 +2089,8 @@ PetscErrorCode ADVMarkInitPolygons(AdvCtx *actx, FB *fb)
 	PetscCall(PetscFree(PolyIdx));
 	PetscCall(PetscFree(PolyLen));
 	PetscCall(PetscFree(PolyX));
-	PetscCall(PetscFree(PolyFile));
+	PetscCall(PetscFree(sptr));
+	PetscCall(PetscFree(sidx));
 	
 	if(actx->randNoise)
 	{
@@ -2137,6 +2673,107 @@ void HexGetBoundingBox(
 	}
 }
 //---------------------------------------------------------------------------
+static void GeomPrimGetCellRange(Discret1D *ds, PetscScalar a, PetscScalar b, PetscInt &s, PetscInt &e)
+{
+	// get range [s, e) of local cells overlapping interval [a, b]
+
+	PetscScalar *px, tol;
+	PetscInt     n;
+
+	n   = ds->ncels;
+	px  = ds->ncoor;
+	tol = ds->gtol*(px[n] - px[0])/(PetscScalar)n;
+
+	// expand interval by geometric tolerance
+	a -= tol;
+	b += tol;
+
+	s = 0;
+	e = 0;
+
+	if(b < px[0] || a > px[n]) return;
+
+	while(s < n-1 && px[s+1] < a) s++;
+
+	e = n;
+
+	while(e > s+1 && px[e-1] > b) e--;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode GeomPrimGetCellCand(
+		FDSTAG    *fs,     // staggered grid
+		PetscInt   ngeom,  // number of primitives
+		GeomPrim **pgeom,  // primitives in the order of appearance
+		PetscInt **cptr,   // list pointers (nCells+1)
+		PetscInt **cidx)   // primitive indices
+{
+	// build compressed lists of primitives which bounding boxes overlap local cells
+	// primitives are stored in the order of appearance, i.e. the last-wins
+	// rule is preserved when a marker is tested against the list of its host cell
+
+	GeomPrim    *geom;
+	PetscInt    *ptr, *ind, *rng;
+	PetscInt     i, j, k, g, nx, ny, ID, ncells;
+
+	PetscFunctionBeginUser;
+
+	nx     = fs->dsx.ncels;
+	ny     = fs->dsy.ncels;
+	ncells = fs->nCells;
+
+	PetscCall(makeIntArray(&ptr, NULL, ncells+1));
+	PetscCall(makeIntArray(&rng, NULL, 6*ngeom+1));
+
+	// get cell ranges & count entries
+	for(g = 0; g < ngeom; g++)
+	{
+		geom = pgeom[g];
+
+		GeomPrimGetCellRange(&fs->dsx, geom->aabb[0], geom->aabb[1], rng[6*g],   rng[6*g+1]);
+		GeomPrimGetCellRange(&fs->dsy, geom->aabb[2], geom->aabb[3], rng[6*g+2], rng[6*g+3]);
+		GeomPrimGetCellRange(&fs->dsz, geom->aabb[4], geom->aabb[5], rng[6*g+4], rng[6*g+5]);
+
+		for(k = rng[6*g+4]; k < rng[6*g+5]; k++)
+		for(j = rng[6*g+2]; j < rng[6*g+3]; j++)
+		for(i = rng[6*g  ]; i < rng[6*g+1]; i++)
+		{
+			GET_CELL_ID(ID, i, j, k, nx, ny);
+
+			ptr[ID+1]++;
+		}
+	}
+
+	// get list pointers
+	for(ID = 0; ID < ncells; ID++) ptr[ID+1] += ptr[ID];
+
+	PetscCall(makeIntArray(&ind, NULL, ptr[ncells]+1));
+
+	// store primitive indices (pointers are shifted to the list ends)
+	for(g = 0; g < ngeom; g++)
+	{
+		for(k = rng[6*g+4]; k < rng[6*g+5]; k++)
+		for(j = rng[6*g+2]; j < rng[6*g+3]; j++)
+		for(i = rng[6*g  ]; i < rng[6*g+1]; i++)
+		{
+			GET_CELL_ID(ID, i, j, k, nx, ny);
+
+			ind[ptr[ID]++] = g;
+		}
+	}
+
+	// restore list pointers
+	for(ID = ncells; ID > 0; ID--) ptr[ID] = ptr[ID-1];
+
+	ptr[0] = 0;
+
+	PetscCall(PetscFree(rng));
+
+	(*cptr) = ptr;
+	(*cidx) = ind;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscInt TetPointTest(
 		PetscScalar *coord, // tetrahedron coordinates
 		PetscInt    *ii,    // corner indices
@@ -16,6 +16,7 @@
 //---------------------------------------------------------------------------
 
 struct FB;
+struct FDSTAG;
 struct AdvCtx;
 struct Marker;
 struct Material_t;
@@ -86,6 +87,8 @@ struct GeomPrim
 	PetscScalar topTemp, botTemp;
 	PetscScalar thermalAge;	
     PetscScalar kappa;
+	// axis-aligned bounding box (candidate search)
+	PetscScalar aabb[6];
 
 	void (*setPhase)(GeomPrim*, Marker*);
 };
@@ -108,6 +111,14 @@ void HexGetBoundingBox(
 		PetscScalar *coord,   // hex coordinates
 		PetscScalar *bounds); // bounding box
 
+// build per-cell lists of primitives overlapping local cells (in the order of appearance)
+PetscErrorCode GeomPrimGetCellCand(
+		FDSTAG    *fs,     // staggered grid
+		PetscInt   ngeom,  // number of primitives
+		GeomPrim **pgeom,  // primitives in the order of appearance
+		PetscInt **cptr,   // list pointers (nCells+1)
+		PetscInt **cidx);  // primitive indices
+
 PetscInt TetPointTest(
 		PetscScalar *coord, // tetrahedron coordinates
 		PetscInt    *ii,    // corner indices
@@ -130,6 +141,42 @@ PetscErrorCode ADVMarkPerturb(AdvCtx *actx);
 // save all local markers to disk (parallel output)
 PetscErrorCode ADVMarkSave(AdvCtx *actx);
 
+//---------------------------------------------------------------------------
+// single-file marker database (collective MPI-IO)
+//---------------------------------------------------------------------------
+
+// File layout: fixed-size header followed by nummark records of nfields
+// scalars each (native byte order, model units), ordered by writer rank.
+// Physical value of field i is: value*scale[i] + shift[i].
+// Fields are identified by name, readers skip unknown and zero missing fields.
+
+#define _mdb_magic_      "LaMEMmdb"
+#define _mdb_version_    1
+#define _mdb_max_fields_ 32
+#define _mdb_name_len_   8
+
+struct MarkDBHeader
+{
+	char        magic[8];                               // file signature
+	PetscInt64  version;                                // format version
+	PetscInt64  hsize;                                  // header size (offset of marker records)
+	PetscInt64  nfields;                                // number of fields per marker
+	PetscInt64  nummark;                                // total number of markers
+	PetscInt64  nproc;                                  // number of writer processes (informational)
+	char        name [_mdb_max_fields_][_mdb_name_len_]; // field names
+	PetscScalar scale[_mdb_max_fields_];                // characteristic values
+	PetscScalar shift[_mdb_max_fields_];                // shifts
+};
+
+// write all markers to a single shared file (collective)
+PetscErrorCode ADVMarkWriteDB(AdvCtx *actx, const char *filename);
+
+// read markers from a single shared file, distribute to host processors (collective)
+PetscErrorCode ADVMarkReadDB(AdvCtx *actx, const char *filename);
+
+// send markers to host processors, replace local marker storage (collective)
+PetscErrorCode ADVMarkRedistribute(AdvCtx *actx, Marker *markers, PetscInt nummark);
+
 // check phase IDs of all the markers
 PetscErrorCode ADVMarkCheckMarkers(AdvCtx *actx);
 
@@ -21,13 +21,13 @@ PetscErrorCode MatAIJCreate(
 	PetscInt m, PetscInt n,
 	PetscInt d_nz, const PetscInt d_nnz[],
 	PetscInt o_nz, const PetscInt o_nnz[],
-	Mat *P)
+	Mat *P, MPI_Comm comm)
 {
 	
 	PetscFunctionBeginUser;
 
 	// create matrix
-	PetscCall(MatCreate(PETSC_COMM_WORLD, P));
+	PetscCall(MatCreate(comm, P));
 	PetscCall(MatSetType((*P), MATAIJ));
 	PetscCall(MatSetSizes((*P), m, n, PETSC_DETERMINE, PETSC_DETERMINE));
 
@@ -99,6 +99,7 @@ PetscErrorCode MatAIJSetNullSpace(Mat P, MatData *md)
 	Vec          nullsp_vecs[_max_nullsp_sz_]; // near null space vectors
 	PetscScalar *v;
 	PetscInt     i, j, sz, ln, iter, nullsp_sz, lbsz[_max_nullsp_sz_];
+	MPI_Comm     comm;
 
 	
 	PetscFunctionBeginUser;
@@ -106,6 +107,9 @@ PetscErrorCode MatAIJSetNullSpace(Mat P, MatData *md)
 	// access context
 	dof = &md->fs->dof;
 
+	// get matrix communicator
+	PetscCall(PetscObjectGetComm((PetscObject)P, &comm));
+
 	// get number of vectors
 	nullsp_sz = 0;
 	ln        = 0;
@@ -123,7 +127,7 @@ PetscErrorCode MatAIJSetNullSpace(Mat P, MatData *md)
 	for(i = 0; i < nullsp_sz; i++)
 	{
 		// create
-		PetscCall(VecCreateMPI(PETSC_COMM_WORLD, ln, PETSC_DETERMINE, &nullsp_vecs[i]));
+		PetscCall(VecCreateMPI(comm, ln, PETSC_DETERMINE, &nullsp_vecs[i]));
 		PetscCall(VecSetFromOptions(nullsp_vecs[i]));
 		PetscCall(VecZeroEntries   (nullsp_vecs[i]));
 
@@ -140,7 +144,7 @@ PetscErrorCode MatAIJSetNullSpace(Mat P, MatData *md)
 	}
 
 	// create near null space
-	PetscCall(MatNullSpaceCreate(PETSC_COMM_WORLD, PETSC_FALSE, nullsp_sz, (const Vec*)nullsp_vecs, &nullsp));
+	PetscCall(MatNullSpaceCreate(comm, PETSC_FALSE, nullsp_sz, (const Vec*)nullsp_vecs, &nullsp));
 
 	// attach near null space to the matrix
 	PetscCall(MatSetNearNullSpace(P, nullsp));
@@ -195,6 +199,79 @@ void addDensGradStabil(
 	v[40] += cf*(rho*grav[2])/fdz;
 }
 //---------------------------------------------------------------------------
+void addViscPartialTangent(
+	PetscScalar eta, PetscScalar deta, PetscScalar *d, PetscScalar *v,
+	PetscScalar dx,  PetscScalar dy,   PetscScalar dz,
+	PetscScalar fdx, PetscScalar fdy,  PetscScalar fdz,
+	PetscScalar bdx, PetscScalar bdy,  PetscScalar bdz)
+{
+	// add partial tangent term of the normal stresses
+	//
+	// ds_ii = 2*(d eta / d J2)*d_ii*(d_jj*dd_jj)
+	//
+	// This is only the normal-stress block of the full rank-one tangent
+	// 2*(d eta / d J2)*(d x d). Couplings between normal and shear components
+	// (shear contribution to J2) are omitted to preserve the stencil. Softening
+	// is limited to keep the tangent viscosity positive along d.
+
+	PetscScalar a[3], h[3], rf[6], cf[6], tr, aa, c;
+	PetscInt    r, q;
+
+	if(!deta) return;
+
+	// deviatoric effective strain rates
+	tr   = (d[0] + d[1] + d[2])/3.0;
+	a[0] =  d[0] - tr;
+	a[1] =  d[1] - tr;
+	a[2] =  d[2] - tr;
+	aa   =  a[0]*a[0] + a[1]*a[1] + a[2]*a[2];
+
+	if(!aa) return;
+
+	// limit softening
+	c = deta;
+
+	if(eta + c*aa < _tangent_min_*eta) c = (_tangent_min_ - 1.0)*eta/aa;
+
+	// momentum (row) & strain rate (column) factors
+	h[0] = dx; h[1] = dy; h[2] = dz;
+
+	rf[0] = -1.0/bdx;  rf[1] = 1.0/fdx;
+	rf[2] = -1.0/bdy;  rf[3] = 1.0/fdy;
+	rf[4] = -1.0/bdz;  rf[5] = 1.0/fdz;
+
+	for(q = 0; q < 6; q++)
+	{
+		cf[q] = (q % 2 ? 1.0 : -1.0)*a[q/2]/h[q/2];
+	}
+
+	// update velocity block
+	for(r = 0; r < 6; r++)
+	{
+		for(q = 0; q < 6; q++)
+		{
+			v[r*7 + q] += 2.0*c*rf[r]*a[r/2]*cf[q];
+		}
+	}
+}
+//---------------------------------------------------------------------------
+PetscScalar getViscPartialTangent(PetscScalar eta, PetscScalar deta, PetscScalar d)
+{
+	// partial tangent viscosity of shear stress component
+	//
+	// ds_ij = 2*(eta + 2*(d eta / d J2)*d_ij*d_ij)*dd_ij
+	//
+	// Only the diagonal entry of the full rank-one tangent is retained.
+
+	PetscScalar eta_t;
+
+	eta_t = eta + 2.0*deta*d*d;
+
+	if(eta_t < _tangent_min_*eta) eta_t = _tangent_min_*eta;
+
+	return eta_t;
+}
+//---------------------------------------------------------------------------
 void getVelSchur(PetscScalar v[], PetscScalar d[], PetscScalar g[])
 {
 	PetscScalar k;
@@ -384,3 +461,289 @@ PetscErrorCode VecScatterBlockToMonolithic(Vec f, Vec g, Vec b, ScatterMode mode
 //---------------------------------------------------------------------------
 
 
+// SINGLE PRECISION MATRIX COPY
+//---------------------------------------------------------------------------
+static PetscErrorCode MatSingleCopyBlock(
+	Mat        B,
+	PetscInt   m,
+	PetscInt  *nnz,
+	PetscInt **bi,
+	PetscInt **bj,
+	float    **bv)
+{
+	// copy CSR structure & coefficients of sequential AIJ block
+
+	const PetscInt    *ia, *ja;
+	const PetscScalar *va;
+	PetscInt           i, n, cnt;
+	PetscBool          done;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(MatGetRowIJ(B, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+
+	if(!done || n != m)
+	{
+		SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Cannot access compressed row storage of the matrix");
+	}
+
+	cnt = ia[m];
+
+	// reallocate storage if number of nonzeros has changed
+	if(!(*bi) || cnt != (*nnz))
+	{
+		PetscCall(PetscFree(*bi));
+		PetscCall(PetscFree(*bj));
+		PetscCall(PetscFree(*bv));
+
+		PetscCall(PetscMalloc((size_t)(m+1)*sizeof(PetscInt), bi));
+		PetscCall(PetscMalloc((size_t)cnt  *sizeof(PetscInt), bj));
+		PetscCall(PetscMalloc((size_t)cnt  *sizeof(float),    bv));
+
+		(*nnz) = cnt;
+	}
+
+	PetscCall(PetscMemcpy((*bi), ia, (size_t)(m+1)*sizeof(PetscInt)));
+	PetscCall(PetscMemcpy((*bj), ja, (size_t)cnt  *sizeof(PetscInt)));
+
+	PetscCall(MatRestoreRowIJ(B, 0, PETSC_FALSE, PETSC_FALSE, &n, &ia, &ja, &done));
+
+	// convert coefficients
+	PetscCall(MatSeqAIJGetArrayRead(B, &va));
+
+	for(i = 0; i < cnt; i++) (*bv)[i] = (float)va[i];
+
+	PetscCall(MatSeqAIJRestoreArrayRead(B, &va));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatSingleCreate(Mat A, Mat *S)
+{
+	MatSingle *ms;
+	PetscInt   m, n;
+
+	PetscFunctionBeginUser;
+
+	// allocate context
+	PetscCall(PetscMalloc(sizeof(MatSingle), &ms));
+	PetscCall(PetscMemzero(ms, sizeof(MatSingle)));
+
+	ms->A = A;
+
+	// create shell matrix with the layout of the source matrix
+	PetscCall(MatGetLocalSize(A, &m, &n));
+
+	PetscCall(MatCreateShell(PETSC_COMM_WORLD, m, n, PETSC_DETERMINE, PETSC_DETERMINE, NULL, S));
+	PetscCall(MatSetUp((*S)));
+
+	PetscCall(MatShellSetOperation((*S), MATOP_MULT,         (void(*)(void))MatSingleMult));
+	PetscCall(MatShellSetOperation((*S), MATOP_GET_DIAGONAL, (void(*)(void))MatSingleGetDiagonal));
+
+	PetscCall(MatShellSetContext((*S), (void*)ms));
+
+	PetscCall(MatAssemblyBegin((*S), MAT_FINAL_ASSEMBLY));
+	PetscCall(MatAssemblyEnd  ((*S), MAT_FINAL_ASSEMBLY));
+
+	ms->m = m;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatSingleDestroy(Mat *S)
+{
+	MatSingle *ms;
+
+	PetscFunctionBeginUser;
+
+	if(!(*S)) PetscFunctionReturn(0);
+
+	PetscCall(MatShellGetContext((*S), (void**)&ms));
+
+	PetscCall(PetscFree(ms->di));
+	PetscCall(PetscFree(ms->dj));
+	PetscCall(PetscFree(ms->dv));
+	PetscCall(PetscFree(ms->oi));
+	PetscCall(PetscFree(ms->oj));
+	PetscCall(PetscFree(ms->ov));
+	PetscCall(PetscFree(ms->gidx));
+	PetscCall(VecDestroy(&ms->g));
+	PetscCall(VecScatterDestroy(&ms->sct));
+	PetscCall(PetscFree(ms));
+
+	PetscCall(MatDestroy(S));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatSingleUpdate(Mat S)
+{
+	MatSingle      *ms;
+	Mat             Ad, Ao;
+	MatNullSpace    nullsp;
+	IS              is;
+	Vec             x;
+	const PetscInt *colmap;
+	PetscInt        ng, rebuild;
+	PetscBool       flg;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(MatShellGetContext(S, (void**)&ms));
+
+	// access diagonal & off-diagonal blocks
+	PetscCall(PetscObjectTypeCompare((PetscObject)ms->A, MATMPIAIJ, &flg));
+
+	if(flg == PETSC_TRUE)
+	{
+		PetscCall(MatMPIAIJGetSeqAIJ(ms->A, &Ad, &Ao, &colmap));
+		PetscCall(MatGetLocalSize(Ao, NULL, &ng));
+	}
+	else
+	{
+		PetscCall(PetscObjectTypeCompare((PetscObject)ms->A, MATSEQAIJ, &flg));
+
+		if(flg != PETSC_TRUE)
+		{
+			SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "Single precision copy requires AIJ matrix");
+		}
+
+		Ad     = ms->A;
+		Ao     = NULL;
+		colmap = NULL;
+		ng     = 0;
+	}
+
+	// copy coefficients
+	PetscCall(MatSingleCopyBlock(Ad, ms->m, &ms->nd, &ms->di, &ms->dj, &ms->dv));
+
+	if(Ao)
+	{
+		PetscCall(MatSingleCopyBlock(Ao, ms->m, &ms->no, &ms->oi, &ms->oj, &ms->ov));
+	}
+
+	// check whether ghost columns have changed
+	rebuild = (ng != ms->ng);
+
+	if(!rebuild && ng)
+	{
+		PetscCall(PetscMemcmp(colmap, ms->gidx, (size_t)ng*sizeof(PetscInt), &flg));
+
+		rebuild = (flg != PETSC_TRUE);
+	}
+
+	if(rebuild)
+	{
+		PetscCall(PetscFree(ms->gidx));
+		PetscCall(VecDestroy(&ms->g));
+		PetscCall(VecScatterDestroy(&ms->sct));
+
+		ms->ng = ng;
+
+		if(ng)
+		{
+			PetscCall(PetscMalloc((size_t)ng*sizeof(PetscInt), &ms->gidx));
+			PetscCall(PetscMemcpy(ms->gidx, colmap, (size_t)ng*sizeof(PetscInt)));
+
+			// create ghost scatter from the input vector layout
+			PetscCall(MatCreateVecs(ms->A, &x, NULL));
+			PetscCall(VecCreateSeq(PETSC_COMM_SELF, ng, &ms->g));
+			PetscCall(ISCreateGeneral(PETSC_COMM_SELF, ng, ms->gidx, PETSC_COPY_VALUES, &is));
+			PetscCall(VecScatterCreate(x, is, ms->g, NULL, &ms->sct));
+			PetscCall(ISDestroy(&is));
+			PetscCall(VecDestroy(&x));
+		}
+	}
+
+	// pass null space of the source matrix (removed by Krylov solvers)
+	PetscCall(MatGetNullSpace(ms->A, &nullsp));
+	PetscCall(MatSetNullSpace(S, nullsp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatSingleMult(Mat S, Vec x, Vec y)
+{
+	MatSingle         *ms;
+	const PetscScalar *xa, *ga;
+	PetscScalar       *ya, s;
+	PetscInt           i, k, m, *ai, *aj;
+	float             *av;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(MatShellGetContext(S, (void**)&ms));
+
+	m = ms->m;
+
+	// start ghost exchange
+	if(ms->ng)
+	{
+		PetscCall(VecScatterBegin(ms->sct, x, ms->g, INSERT_VALUES, SCATTER_FORWARD));
+	}
+
+	PetscCall(VecGetArrayRead(x, &xa));
+	PetscCall(VecGetArray    (y, &ya));
+
+	// diagonal block (overlaps with communication)
+	ai = ms->di;
+	aj = ms->dj;
+	av = ms->dv;
+
+	for(i = 0; i < m; i++)
+	{
+		s = 0.0;
+
+		OMP_SIMD(reduction(+:s))
+		for(k = ai[i]; k < ai[i+1]; k++) s += (PetscScalar)av[k]*xa[aj[k]];
+
+		ya[i] = s;
+	}
+
+	PetscCall(VecRestoreArrayRead(x, &xa));
+
+	// off-diagonal block
+	if(ms->ng)
+	{
+		PetscCall(VecScatterEnd(ms->sct, x, ms->g, INSERT_VALUES, SCATTER_FORWARD));
+
+		PetscCall(VecGetArrayRead(ms->g, &ga));
+
+		ai = ms->oi;
+		aj = ms->oj;
+		av = ms->ov;
+
+		for(i = 0; i < m; i++)
+		{
+			s = 0.0;
+
+			OMP_SIMD(reduction(+:s))
+			for(k = ai[i]; k < ai[i+1]; k++) s += (PetscScalar)av[k]*ga[aj[k]];
+
+			ya[i] += s;
+		}
+
+		PetscCall(VecRestoreArrayRead(ms->g, &ga));
+	}
+
+	PetscCall(VecRestoreArray(y, &ya));
+
+	PetscCall(PetscLogFlops(2.0*(PetscLogDouble)(ms->nd + ms->no)));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatSingleGetDiagonal(Mat S, Vec d)
+{
+	MatSingle *ms;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(MatShellGetContext(S, (void**)&ms));
+
+	// diagonal is taken from the source matrix
+	PetscCall(MatGetDiagonal(ms->A, d));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -21,11 +21,19 @@
 //---------------------------------------------------------------------------
 PetscErrorCode MatDataCreate(MatData *md, JacRes *jr, idxtype idxmod)
 {
-	
+	PetscBool flg;
+
 	PetscFunctionBeginUser;
 
-	// set coarse grid flag
+	// set coarse grid & tangent operator flags
 	md->coarsened = 0;
+	md->newton    = 0;
+	md->tangent   = 0;
+
+	// check branch-free row kernels of matrix-free operator
+	PetscCall(PetscOptionsHasName(NULL, NULL, "-mat_free_row_kernels", &flg));
+
+	md->rowkern = (flg == PETSC_TRUE);
 
 	// copy data
 	md->fs       = jr->fs;
@@ -78,6 +86,12 @@ PetscErrorCode MatDataCreateData(MatData *md)
 	PetscCall(makeIntArray(&md->SPCListMat, NULL, dof->ln));
 	PetscCall(makeIntArray(&md->SPCListVec, NULL, dof->ln));
 
+	// row buffer of matrix-free operator
+	if(md->rowkern)
+	{
+		PetscCall(makeScalArray(&md->work, NULL, fs->dsx.nnods));
+	}
+
 	if(md->coarsened)
 	{
 		// create boundary condition vectors
@@ -90,6 +104,69 @@ PetscErrorCode MatDataCreateData(MatData *md)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MatDataCreateNewton(MatData *md, JacRes *jr)
+{
+	// create storage for tangent (Newton) operator on fine grid
+
+	FDSTAG *fs;
+
+	PetscFunctionBeginUser;
+
+	fs = md->fs;
+
+	// set tangent operator flags
+	md->newton  = 1;
+	md->tangent = 1;
+
+	// create viscosity derivative vectors
+	PetscCall(DMCreateGlobalVector(fs->DA_CEN, &md->deta));
+	PetscCall(DMCreateGlobalVector(fs->DA_XY,  &md->detaxy));
+	PetscCall(DMCreateGlobalVector(fs->DA_XZ,  &md->detaxz));
+	PetscCall(DMCreateGlobalVector(fs->DA_YZ,  &md->detayz));
+
+	// access effective strain rates of the residual evaluation
+	md->dxx = jr->ldxx;
+	md->dyy = jr->ldyy;
+	md->dzz = jr->ldzz;
+	md->dxy = jr->ldxy;
+	md->dxz = jr->ldxz;
+	md->dyz = jr->ldyz;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatDataCoarsenNewton(MatData *coarse, MatData *fine)
+{
+	// create storage for tangent (Newton) operator on coarse grid
+	// (parameters are restricted from fine grid)
+
+	FDSTAG *fs;
+
+	PetscFunctionBeginUser;
+
+	fs = coarse->fs;
+
+	// set tangent operator flags
+	coarse->newton  = 1;
+	coarse->tangent = fine->tangent;
+
+	// create viscosity derivative vectors
+	PetscCall(DMCreateGlobalVector(fs->DA_CEN, &coarse->deta));
+	PetscCall(DMCreateGlobalVector(fs->DA_XY,  &coarse->detaxy));
+	PetscCall(DMCreateGlobalVector(fs->DA_XZ,  &coarse->detaxz));
+	PetscCall(DMCreateGlobalVector(fs->DA_YZ,  &coarse->detayz));
+
+	// create effective strain rate vectors
+	PetscCall(DMCreateLocalVector(fs->DA_CEN, &coarse->dxx));
+	PetscCall(DMCreateLocalVector(fs->DA_CEN, &coarse->dyy));
+	PetscCall(DMCreateLocalVector(fs->DA_CEN, &coarse->dzz));
+	PetscCall(DMCreateLocalVector(fs->DA_XY,  &coarse->dxy));
+	PetscCall(DMCreateLocalVector(fs->DA_XZ,  &coarse->dxz));
+	PetscCall(DMCreateLocalVector(fs->DA_YZ,  &coarse->dyz));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatDataDestroy(MatData *md)
 {
 	
@@ -110,6 +187,26 @@ PetscErrorCode MatDataDestroy(MatData *md)
 	PetscCall(PetscFree(md->SPCListMat));
 	PetscCall(PetscFree(md->SPCListVec));
 
+	PetscCall(PetscFree(md->work));
+
+	if(md->newton)
+	{
+		PetscCall(VecDestroy(&md->deta));
+		PetscCall(VecDestroy(&md->detaxy));
+		PetscCall(VecDestroy(&md->detaxz));
+		PetscCall(VecDestroy(&md->detayz));
+	}
+
+	if(md->newton && md->coarsened)
+	{
+		PetscCall(VecDestroy(&md->dxx));
+		PetscCall(VecDestroy(&md->dyy));
+		PetscCall(VecDestroy(&md->dzz));
+		PetscCall(VecDestroy(&md->dxy));
+		PetscCall(VecDestroy(&md->dxz));
+		PetscCall(VecDestroy(&md->dyz));
+	}
+
 	if(md->coarsened)
 	{
 		PetscCall(FDSTAGDestroy(md->fs));
@@ -129,11 +226,14 @@ PetscErrorCode MatDataCoarsen(MatData *coarse, MatData *fine)
 	
 	PetscFunctionBeginUser;
 
-	// set coarse grid flag
+	// set coarse grid & tangent operator flags
 	coarse->coarsened = 1;
+	coarse->newton    = 0;
+	coarse->tangent   = 0;
 
 	// copy data
 	coarse->idxmod  = fine->idxmod;
+	coarse->rowkern = fine->rowkern;
 	coarse->fssa    = fine->fssa;
 	coarse->grav[0] = fine->grav[0];
 	coarse->grav[1] = fine->grav[1];
@@ -154,6 +254,41 @@ PetscErrorCode MatDataCoarsen(MatData *coarse, MatData *fine)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MatDataAgglomerate(MatData *agg, MatData *md, MPI_Comm comm, PetscInt f[])
+{
+	// create evaluation context on agglomerated processor grid
+	// (only boundary conditions & indexing are used by Galerkin coarsening)
+
+	PetscFunctionBeginUser;
+
+	// set coarse grid & tangent operator flags
+	agg->coarsened = 1;
+	agg->newton    = 0;
+	agg->tangent   = 0;
+
+	// copy data
+	agg->idxmod  = md->idxmod;
+	agg->rowkern = md->rowkern;
+	agg->fssa    = md->fssa;
+	agg->grav[0] = md->grav[0];
+	agg->grav[1] = md->grav[1];
+	agg->grav[2] = md->grav[2];
+
+	// allocate staggered grid context
+	PetscCall(PetscMalloc(sizeof(FDSTAG), &agg->fs));
+
+	// create agglomerated staggered grid
+	PetscCall(FDSTAGAgglomerate(agg->fs, md->fs, comm, f));
+
+	// allocate storage
+	PetscCall(MatDataCreateData(agg));
+
+	// compute index vectors
+	PetscCall(MatDataComputeIndex(agg));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatDataComputeIndex(MatData *md)
 {
 	// compute & set global indices of local & ghost nodes
@@ -264,6 +399,12 @@ PetscErrorCode MatDataSetup(MatData *md, JacRes *jr)
 	// update material parameters
 	PetscCall(MatDataInitParam(md, jr));
 
+	// update viscosity derivatives
+	if(md->newton && md->tangent)
+	{
+		PetscCall(MatDataInitNewton(md, jr));
+	}
+
 	// update SPC constraints
 	PetscCall(MatDataListSPC(md));
 
@@ -298,6 +439,18 @@ PetscErrorCode MatDataRestrict(MatData *coarse, MatData *fine, PetscInt MG2D)
 		PetscCall(MatDataRestrictBC3D(coarse, fine));
 	}
 
+	// coarsen viscosity derivatives
+	// (coarse grid operators are only rediscretized in 3D)
+	if(coarse->newton)
+	{
+		coarse->tangent = fine->tangent;
+
+		if(coarse->tangent && !MG2D)
+		{
+			PetscCall(MatDataRestrictNewton3D(coarse, fine));
+		}
+	}
+
 	// update SPC constraints on coarse grid
 	PetscCall(MatDataListSPC(coarse));
 
@@ -402,6 +555,43 @@ PetscErrorCode MatDataInitParam(MatData *md, JacRes *jr)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MatDataInitNewton(MatData *md, JacRes *jr)
+{
+	// initialize viscosity derivatives on fine grid
+	// (vectors are stored in the same order as solution variables)
+
+	PetscInt     i, n;
+	PetscScalar *deta;
+
+	PetscFunctionBeginUser;
+
+	// cell centers
+	PetscCall(VecGetLocalSize(md->deta, &n));
+	PetscCall(VecGetArray(md->deta, &deta));
+	for(i = 0; i < n; i++) deta[i] = jr->svCell[i].svDev.deta;
+	PetscCall(VecRestoreArray(md->deta, &deta));
+
+	// xy edge points
+	PetscCall(VecGetLocalSize(md->detaxy, &n));
+	PetscCall(VecGetArray(md->detaxy, &deta));
+	for(i = 0; i < n; i++) deta[i] = jr->svXYEdge[i].svDev.deta;
+	PetscCall(VecRestoreArray(md->detaxy, &deta));
+
+	// xz edge points
+	PetscCall(VecGetLocalSize(md->detaxz, &n));
+	PetscCall(VecGetArray(md->detaxz, &deta));
+	for(i = 0; i < n; i++) deta[i] = jr->svXZEdge[i].svDev.deta;
+	PetscCall(VecRestoreArray(md->detaxz, &deta));
+
+	// yz edge points
+	PetscCall(VecGetLocalSize(md->detayz, &n));
+	PetscCall(VecGetArray(md->detayz, &deta));
+	for(i = 0; i < n; i++) deta[i] = jr->svYZEdge[i].svDev.deta;
+	PetscCall(VecRestoreArray(md->detayz, &deta));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatDataRestrictParam3D(MatData *coarse, MatData *fine)
 {
 	// restrict parameters from fine to coarse grid
@@ -631,6 +821,166 @@ PetscErrorCode MatDataRestrictParam2D(MatData *coarse, MatData *fine)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MatDataRestrictNewton3D(MatData *coarse, MatData *fine)
+{
+	// restrict viscosity derivatives & effective strain rates
+	// from fine to coarse grid (cell and edge averages)
+
+	PetscInt    I, J, K;
+	PetscInt    i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar ***fdeta, ***fdxx, ***fdyy, ***fdzz, ***fdxy, ***fdxz, ***fdyz;
+	PetscScalar ***deta,  ***dxx,  ***dyy,  ***dzz,  ***dxy,  ***dxz,  ***dyz;
+
+	PetscFunctionBeginUser;
+
+	// initialize ghost points in coarse grid
+	PetscCall(VecZeroEntries(coarse->dxx));
+	PetscCall(VecZeroEntries(coarse->dyy));
+	PetscCall(VecZeroEntries(coarse->dzz));
+	PetscCall(VecZeroEntries(coarse->dxy));
+	PetscCall(VecZeroEntries(coarse->dxz));
+	PetscCall(VecZeroEntries(coarse->dyz));
+
+	// access effective strain rates
+	PetscCall(DMDAVecGetArray(fine->fs->DA_CEN,   fine->dxx,   &fdxx));
+	PetscCall(DMDAVecGetArray(fine->fs->DA_CEN,   fine->dyy,   &fdyy));
+	PetscCall(DMDAVecGetArray(fine->fs->DA_CEN,   fine->dzz,   &fdzz));
+	PetscCall(DMDAVecGetArray(fine->fs->DA_XY,    fine->dxy,   &fdxy));
+	PetscCall(DMDAVecGetArray(fine->fs->DA_XZ,    fine->dxz,   &fdxz));
+	PetscCall(DMDAVecGetArray(fine->fs->DA_YZ,    fine->dyz,   &fdyz));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_CEN, coarse->dxx, &dxx));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_CEN, coarse->dyy, &dyy));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_CEN, coarse->dzz, &dzz));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_XY,  coarse->dxy, &dxy));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_XZ,  coarse->dxz, &dxz));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_YZ,  coarse->dyz, &dyz));
+
+	//---------------------------
+	// cell centers (coarse grid)
+	//---------------------------
+	PetscCall(DMDAVecGetArray(fine->fs->DA_CEN,   fine->deta,   &fdeta));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_CEN, coarse->deta, &deta));
+
+	PetscCall(DMDAGetCorners(coarse->fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// get fine grid indices
+		I = 2*i;
+		J = 2*j;
+		K = 2*k;
+
+		deta[k][j][i] = (fdeta[K  ][J  ][I] + fdeta[K  ][J  ][I+1] + fdeta[K  ][J+1][I] + fdeta[K  ][J+1][I+1]
+		               +  fdeta[K+1][J  ][I] + fdeta[K+1][J  ][I+1] + fdeta[K+1][J+1][I] + fdeta[K+1][J+1][I+1])/8.0;
+
+		dxx[k][j][i] = (fdxx[K  ][J  ][I] + fdxx[K  ][J  ][I+1] + fdxx[K  ][J+1][I] + fdxx[K  ][J+1][I+1]
+		              +  fdxx[K+1][J  ][I] + fdxx[K+1][J  ][I+1] + fdxx[K+1][J+1][I] + fdxx[K+1][J+1][I+1])/8.0;
+
+		dyy[k][j][i] = (fdyy[K  ][J  ][I] + fdyy[K  ][J  ][I+1] + fdyy[K  ][J+1][I] + fdyy[K  ][J+1][I+1]
+		              +  fdyy[K+1][J  ][I] + fdyy[K+1][J  ][I+1] + fdyy[K+1][J+1][I] + fdyy[K+1][J+1][I+1])/8.0;
+
+		dzz[k][j][i] = (fdzz[K  ][J  ][I] + fdzz[K  ][J  ][I+1] + fdzz[K  ][J+1][I] + fdzz[K  ][J+1][I+1]
+		              +  fdzz[K+1][J  ][I] + fdzz[K+1][J  ][I+1] + fdzz[K+1][J+1][I] + fdzz[K+1][J+1][I+1])/8.0;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_CEN,   fine->deta,   &fdeta));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_CEN, coarse->deta, &deta));
+
+	//-----------------------------
+	// xy edge points (coarse grid)
+	//-----------------------------
+	PetscCall(DMDAVecGetArray(fine->fs->DA_XY,   fine->detaxy,   &fdeta));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_XY, coarse->detaxy, &deta));
+
+	PetscCall(DMDAGetCorners(coarse->fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// get fine grid indices (coincident edges)
+		I = 2*i;
+		J = 2*j;
+		K = 2*k;
+
+		deta[k][j][i] = (fdeta[K][J][I] + fdeta[K+1][J][I])/2.0;
+		dxy [k][j][i] = (fdxy [K][J][I] + fdxy [K+1][J][I])/2.0;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_XY,   fine->detaxy,   &fdeta));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_XY, coarse->detaxy, &deta));
+
+	//-----------------------------
+	// xz edge points (coarse grid)
+	//-----------------------------
+	PetscCall(DMDAVecGetArray(fine->fs->DA_XZ,   fine->detaxz,   &fdeta));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_XZ, coarse->detaxz, &deta));
+
+	PetscCall(DMDAGetCorners(coarse->fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// get fine grid indices (coincident edges)
+		I = 2*i;
+		J = 2*j;
+		K = 2*k;
+
+		deta[k][j][i] = (fdeta[K][J][I] + fdeta[K][J+1][I])/2.0;
+		dxz [k][j][i] = (fdxz [K][J][I] + fdxz [K][J+1][I])/2.0;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_XZ,   fine->detaxz,   &fdeta));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_XZ, coarse->detaxz, &deta));
+
+	//-----------------------------
+	// yz edge points (coarse grid)
+	//-----------------------------
+	PetscCall(DMDAVecGetArray(fine->fs->DA_YZ,   fine->detayz,   &fdeta));
+	PetscCall(DMDAVecGetArray(coarse->fs->DA_YZ, coarse->detayz, &deta));
+
+	PetscCall(DMDAGetCorners(coarse->fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// get fine grid indices (coincident edges)
+		I = 2*i;
+		J = 2*j;
+		K = 2*k;
+
+		deta[k][j][i] = (fdeta[K][J][I] + fdeta[K][J][I+1])/2.0;
+		dyz [k][j][i] = (fdyz [K][J][I] + fdyz [K][J][I+1])/2.0;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_YZ,   fine->detayz,   &fdeta));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_YZ, coarse->detayz, &deta));
+
+	// restore access
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_CEN,   fine->dxx,   &fdxx));
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_CEN,   fine->dyy,   &fdyy));
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_CEN,   fine->dzz,   &fdzz));
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_XY,    fine->dxy,   &fdxy));
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_XZ,    fine->dxz,   &fdxz));
+	PetscCall(DMDAVecRestoreArray(fine->fs->DA_YZ,    fine->dyz,   &fdyz));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_CEN, coarse->dxx, &dxx));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_CEN, coarse->dyy, &dyy));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_CEN, coarse->dzz, &dzz));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_XY,  coarse->dxy, &dxy));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_XZ,  coarse->dxz, &dxz));
+	PetscCall(DMDAVecRestoreArray(coarse->fs->DA_YZ,  coarse->dyz, &dyz));
+
+	// exchange ghost points in coarse grid
+	LOCAL_TO_LOCAL(coarse->fs->DA_CEN, coarse->dxx)
+	LOCAL_TO_LOCAL(coarse->fs->DA_CEN, coarse->dyy)
+	LOCAL_TO_LOCAL(coarse->fs->DA_CEN, coarse->dzz)
+	LOCAL_TO_LOCAL(coarse->fs->DA_XY,  coarse->dxy)
+	LOCAL_TO_LOCAL(coarse->fs->DA_XZ,  coarse->dxz)
+	LOCAL_TO_LOCAL(coarse->fs->DA_YZ,  coarse->dyz)
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatDataRestrictBC3D(MatData *coarse, MatData *fine)
 {
 	// restrict boundary condition vectors from fine grid to coarse grid
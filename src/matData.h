@@ -36,6 +36,8 @@ struct MatData
 	PetscInt    numSPC,  *SPCListMat,  *SPCListVec;  // single points constraints (SPC)
 	PetscInt    vNumSPC, *vSPCListMat, *vSPCListVec; // velocity SPC
 	PetscInt    pNumSPC, *pSPCListMat, *pSPCListVec; // pressure SPC
+	PetscInt    rowkern;                             // branch-free row kernels flag (matrix-free operator)
+	PetscScalar *work;                               // row buffer of matrix-free operator
 	Vec         Kb, rho, eta, etaxy, etaxz, etayz;   // parameter vectors
 	PetscScalar dt;                                  // time step
 	PetscScalar fssa;                                // density gradient penalty parameter
@@ -43,6 +45,10 @@ struct MatData
 	PetscScalar grav[3];                             // global gravity components
 	PetscInt    coarsened;                           // coarsening flag
 	idxtype     idxmod;                              // indexing mode
+	PetscInt    newton;                              // tangent (Newton) operator storage flag
+	PetscInt    tangent;                             // tangent (Newton) operator activation flag
+	Vec         deta, detaxy, detaxz, detayz;        // viscosity derivatives w.r.t. J2 (tangent)
+	Vec         dxx, dyy, dzz, dxy, dxz, dyz;        // effective strain rates (tangent, owned by JacRes on fine grid)
 };
 
 //---------------------------------------------------------------------------
@@ -51,10 +57,16 @@ PetscErrorCode MatDataCreate(MatData *md, JacRes *jr, idxtype idxmod);
 
 PetscErrorCode MatDataCreateData(MatData *md);
 
+PetscErrorCode MatDataCreateNewton(MatData *md, JacRes *jr);
+
+PetscErrorCode MatDataCoarsenNewton(MatData *coarse, MatData *fine);
+
 PetscErrorCode MatDataDestroy(MatData *md);
 
 PetscErrorCode MatDataCoarsen(MatData *coarse, MatData *fine);
 
+PetscErrorCode MatDataAgglomerate(MatData *agg, MatData *md, MPI_Comm comm, PetscInt f[]);
+
 PetscErrorCode MatDataComputeIndex(MatData *md);
 
 PetscErrorCode MatDataSetup(MatData *md, JacRes *jr);
@@ -63,10 +75,14 @@ PetscErrorCode MatDataRestrict(MatData *coarse, MatData *fine, PetscInt MG2D);
 
 PetscErrorCode MatDataInitParam(MatData *md, JacRes *jr);
 
+PetscErrorCode MatDataInitNewton(MatData *md, JacRes *jr);
+
 PetscErrorCode MatDataRestrictParam3D(MatData *coarse, MatData *fine);
 
 PetscErrorCode MatDataRestrictParam2D(MatData *coarse, MatData *fine);
 
+PetscErrorCode MatDataRestrictNewton3D(MatData *coarse, MatData *fine);
+
 PetscErrorCode MatDataRestrictBC3D(MatData *coarse, MatData *fine);
 
 PetscErrorCode MatDataRestrictBC2D(MatData *coarse, MatData *fine);
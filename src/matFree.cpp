@@ -17,6 +17,7 @@
 #include "matData.h"
 #include "matrix.h"
 #include "multigrid.h"
+#include "perfLog.h"
 
 //---------------------------------------------------------------------------
 // interface functions
@@ -43,6 +44,28 @@ PetscErrorCode MatFreeApplyPicard(Mat A, Vec x, Vec f)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode MatFreeApplyNewton(Mat A, Vec x, Vec f)
+{
+	// this function corresponds to MATOP_MULT operation (f = A*x)
+
+	MatData     *md;
+	PetscScalar  cfInvEta;
+
+	
+	PetscFunctionBeginUser;
+
+	// access context
+	PetscCall(MatShellGetContext(A, (void**)&md));
+
+	// do not add inverse viscosity term to pressure diagonal matrix (Newton operator)
+	cfInvEta = 0.0;
+
+	// Picard operator with viscosity derivative contribution (md->tangent is set)
+	PetscCall(MatFreeComputeLinearOperator(md, x, f, cfInvEta));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatFreeApplyPreconditioner(Mat A, Vec x, Vec f)
 {
 	// this function corresponds to MATOP_MULT operation (f = A*x)
@@ -59,7 +82,7 @@ PetscErrorCode MatFreeApplyPreconditioner(Mat A, Vec x, Vec f)
 	// add inverse viscosity term to pressure diagonal matrix (preconditioner operator)
 	cfInvEta = 1.0;
 
-	PetscCall(MatFreeComputeLinearOperator(mdpc->md, x, f, cfInvEta));
+	PetscCall(MatFreeComputeLinearOperator(mdpc->md, x, f, cfInvEta, mdpc));
 
 	PetscFunctionReturn(0);
 }
@@ -170,15 +193,18 @@ PetscErrorCode MatFreeUpdateProlong(Mat P, Vec vc, Vec vfb, Vec vf)
 //---------------------------------------------------------------------------
 // main computation functions
 //---------------------------------------------------------------------------
-PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScalar cfInvEta)
+PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScalar cfInvEta, MatDataPC *mdpc)
 {
-	FDSTAG  *fs;
-	Vec      vx, vy, vz, p;
-	Vec      fx, fy, fz, c;
+	FDSTAG        *fs;
+	Vec            vx, vy, vz, p;
+	Vec            fx, fy, fz, c;
+	PetscLogDouble nc, words, flops;
 
 	
 	PetscFunctionBeginUser;
 
+	PetscCall(PerfBegin(_PERF_MATVEC_));
+
 	// access context
 	fs = md->fs;
 
@@ -198,7 +224,13 @@ PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScal
 	PetscCall(MatFreeSplitVec(md, x, vx, vy, vz, p));
 
 	// compute matrix-vector product
-	PetscCall(MatFreeEvaluateLinearOperator(md, vx, vy, vz, p, fx, fy, fz, c, cfInvEta));
+	PetscCall(MatFreeEvaluateLinearOperator(md, vx, vy, vz, p, fx, fy, fz, c, cfInvEta, mdpc));
+
+	// add viscosity derivative contribution (tangent operator)
+	if(md->newton && md->tangent)
+	{
+		PetscCall(MatFreeEvaluateTangent(md, vx, vy, vz, fx, fy, fz));
+	}
 
 	// assemble residual
 	PetscCall(MatFreeAssembleVec(md, f, fx, fy, fz, c));
@@ -213,6 +245,26 @@ PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScal
 	PetscCall(DMRestoreLocalVector (fs->DA_Z,   &fz));
 	PetscCall(DMRestoreGlobalVector(fs->DA_CEN, &c));
 
+	// estimated work of the operator kernels
+	nc    = (PetscLogDouble)fs->nCells;
+	words = _perf_mf_words_;
+	flops = _perf_mf_flops_;
+
+	if(mdpc && mdpc->sprec)
+	{
+		words -= _perf_mf_coef_words_/2;
+	}
+
+	if(md->newton && md->tangent)
+	{
+		words += _perf_mf_tan_words_;
+		flops += _perf_mf_tan_flops_;
+	}
+
+	PetscCall(PerfAddWork(_PERF_MATVEC_, nc*words*sizeof(PetscScalar), nc*flops));
+
+	PetscCall(PerfEnd(_PERF_MATVEC_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -499,14 +551,13 @@ PetscErrorCode MatFreeCombineVec(MatData *md, Vec v, Vec gvx, Vec gvy, Vec gvz,
 //---------------------------------------------------------------------------
 // low-level functions
 //---------------------------------------------------------------------------
-PetscErrorCode MatFreeEvaluateLinearOperator(MatData *md,
+
+static PetscErrorCode MatFreeStokesStencil(MatData *md,
 		Vec lvx, Vec lvy, Vec lvz, Vec gp,
 		Vec lfx, Vec lfy, Vec lfz, Vec gc,
 		PetscScalar cfInvEta)
 {
-	// cfInvEta - inverse viscosity term prefactor
-	// 0.0      - Picard operator
-	// 1.0      - preconditioner operator
+	// reference point-wise stencils with two-point constraints (default)
 
 	FDSTAG     *fs;
 	PetscInt    mcx, mcy, mcz;
@@ -788,6 +839,969 @@ PetscErrorCode MatFreeEvaluateLinearOperator(MatData *md,
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+
+// solution, residual & constraint arrays of the operator evaluation
+struct MatFreeArrays
+{
+	PetscScalar ***vx, ***vy, ***vz, ***p;         // solution
+	PetscScalar ***fx, ***fy, ***fz, ***c;         // residual
+	PetscScalar ***bcvx, ***bcvy, ***bcvz, ***bcp; // boundary constraints
+	PetscScalar  *w;                               // row buffer (deferred updates)
+};
+
+// parameter arrays (double or single precision)
+template <class T>
+struct MatFreeCoeff
+{
+	T ***Kb, ***rho, ***eta, ***etaxy, ***etaxz, ***etayz;
+};
+
+//---------------------------------------------------------------------------
+template <class T>
+static PetscErrorCode MatFreeStokesCells(MatData *md, MatFreeArrays *a, MatFreeCoeff<T> *coef, PetscScalar cfInvEta)
+{
+	// unconstrained cell stencils, processed row by row
+
+	FDSTAG      *fs;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar  dx, dy, dz, bdx, fdx, bdy, fdy, bdz, fdz;
+	PetscScalar  dxx, dyy, dzz, theta, tr, pc, sxx, syy, szz;
+	PetscScalar  eta, rho, IKdt, tx, ty, tz, dt, fssa, *grav, *w;
+	PetscScalar *vx, *vy, *vyf, *vz, *vzf, *p, *fx, *fy, *fyf, *fz, *fzf, *c;
+	T           *Kb, *rh, *et;
+
+	PetscFunctionBeginUser;
+
+	fs   = md->fs;
+	dt   = md->dt;
+	fssa = md->fssa;
+	grav = md->grav;
+	w    = a->w;
+
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	{
+		dz  = SIZE_CELL(k, sz, fs->dsz);
+		bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+		for(j = sy; j < sy+ny; j++)
+		{
+			dy  = SIZE_CELL(j, sy, fs->dsy);
+			bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+
+			// access rows
+			vx  = a->vx[k][j];   fx  = a->fx[k][j];
+			vy  = a->vy[k][j];   fy  = a->fy[k][j];
+			vyf = a->vy[k][j+1]; fyf = a->fy[k][j+1];
+			vz  = a->vz[k][j];   fz  = a->fz[k][j];
+			vzf = a->vz[k+1][j]; fzf = a->fz[k+1][j];
+			p   = a->p [k][j];   c   = a->c [k][j];
+			Kb  = coef->Kb [k][j];
+			rh  = coef->rho[k][j];
+			et  = coef->eta[k][j];
+
+			OMP_SIMD(private(dx, bdx, fdx, dxx, dyy, dzz, theta, tr, pc, sxx, syy, szz, eta, rho, IKdt, tx, ty, tz))
+			for(i = sx; i < sx+nx; i++)
+			{
+				// get density, shear & inverse bulk viscosities
+				eta  = (PetscScalar)et[i];
+				rho  = (PetscScalar)rh[i];
+				IKdt = 1.0/(PetscScalar)Kb[i]/dt;
+
+				// get mesh steps
+				dx  = SIZE_CELL(i, sx, fs->dsx);
+				bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+
+				// compute velocity gradients
+				dxx = (vx [i+1] - vx[i])/dx;
+				dyy = (vyf[i]   - vy[i])/dy;
+				dzz = (vzf[i]   - vz[i])/dz;
+
+				// compute volumetric & deviatoric strain rates
+				theta = dxx + dyy + dzz;
+				tr    = theta/3.0;
+				dxx  -= tr;
+				dyy  -= tr;
+				dzz  -= tr;
+
+				// access current pressure
+				pc = p[i];
+
+				// compute deviatoric stresses
+				sxx = 2.0*eta*dxx;
+				syy = 2.0*eta*dyy;
+				szz = 2.0*eta*dzz;
+
+				// compute stabilization terms (lumped approximation)
+				tx = -fssa*dt*(rho*grav[0]);
+				ty = -fssa*dt*(rho*grav[1]);
+				tz = -fssa*dt*(rho*grav[2]);
+
+				// momentum (forward x-face update is deferred)
+				fx[i] -= ((sxx - pc) + vx [i]*tx)/bdx;   w[i-sx] = ((sxx - pc) + vx [i+1]*tx)/fdx;
+				fy[i] -= ((syy - pc) + vy [i]*ty)/bdy;   fyf[i] += ((syy - pc) + vyf[i]*ty)/fdy;
+				fz[i] -= ((szz - pc) + vz [i]*tz)/bdz;   fzf[i] += ((szz - pc) + vzf[i]*tz)/fdz;
+
+				// mass
+				c[i] = -(IKdt + cfInvEta/eta)*pc - theta;
+			}
+
+			OMP_SIMD()
+			for(i = sx; i < sx+nx; i++) fx[i+1] += w[i-sx];
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+template <class T>
+static PetscErrorCode MatFreeStokesEdges(MatData *md, MatFreeArrays *a, MatFreeCoeff<T> *coef)
+{
+	// unconstrained edge stencils, processed row by row
+
+	FDSTAG      *fs;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz;
+	PetscScalar  dx, dy, dz, bdx, fdx, bdy, fdy, bdz, fdz, eta, s, *w;
+	PetscScalar *vx, *vxb, *vy, *vyb, *vz, *vzb, *fx, *fxb, *fy, *fyb, *fz, *fzb;
+	T           *et;
+
+	PetscFunctionBeginUser;
+
+	fs = md->fs;
+	w  = a->w;
+
+	//-------------------------------
+	// xy edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	{
+		for(j = sy; j < sy+ny; j++)
+		{
+			dy  = SIZE_NODE(j, sy, fs->dsy);
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+			vx = a->vx[k][j];   vxb = a->vx[k][j-1];   vy = a->vy[k][j];
+			fx = a->fx[k][j];   fxb = a->fx[k][j-1];   fy = a->fy[k][j];
+			et = coef->etaxy[k][j];
+
+			OMP_SIMD(private(dx, bdx, fdx, eta, s))
+			for(i = sx; i < sx+nx; i++)
+			{
+				eta = (PetscScalar)et[i];
+
+				dx  = SIZE_NODE(i, sx, fs->dsx);
+				bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+
+				// compute stress
+				s = eta*((vx[i] - vxb[i])/dy + (vy[i] - vy[i-1])/dx);
+
+				// momentum (backward y-face update is deferred)
+				fxb[i] -= s/bdy;   fx[i] += s/fdy;
+				w[i-sx] = s/bdx;   fy[i] += s/fdx;
+			}
+
+			OMP_SIMD()
+			for(i = sx; i < sx+nx; i++) fy[i-1] -= w[i-sx];
+		}
+	}
+
+	//-------------------------------
+	// xz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	{
+		dz  = SIZE_NODE(k, sz, fs->dsz);
+		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+		for(j = sy; j < sy+ny; j++)
+		{
+			vx = a->vx[k][j];   vxb = a->vx[k-1][j];   vz = a->vz[k][j];
+			fx = a->fx[k][j];   fxb = a->fx[k-1][j];   fz = a->fz[k][j];
+			et = coef->etaxz[k][j];
+
+			OMP_SIMD(private(dx, bdx, fdx, eta, s))
+			for(i = sx; i < sx+nx; i++)
+			{
+				eta = (PetscScalar)et[i];
+
+				dx  = SIZE_NODE(i, sx, fs->dsx);
+				bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+
+				// compute stress
+				s = eta*((vx[i] - vxb[i])/dz + (vz[i] - vz[i-1])/dx);
+
+				// momentum (backward z-face update is deferred)
+				fxb[i] -= s/bdz;   fx[i] += s/fdz;
+				w[i-sx] = s/bdx;   fz[i] += s/fdx;
+			}
+
+			OMP_SIMD()
+			for(i = sx; i < sx+nx; i++) fz[i-1] -= w[i-sx];
+		}
+	}
+
+	//-------------------------------
+	// yz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	{
+		dz  = SIZE_NODE(k, sz, fs->dsz);
+		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+		for(j = sy; j < sy+ny; j++)
+		{
+			dy  = SIZE_NODE(j, sy, fs->dsy);
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+			vy = a->vy[k][j];   vyb = a->vy[k-1][j];
+			vz = a->vz[k][j];   vzb = a->vz[k][j-1];
+			fy = a->fy[k][j];   fyb = a->fy[k-1][j];
+			fz = a->fz[k][j];   fzb = a->fz[k][j-1];
+			et = coef->etayz[k][j];
+
+			OMP_SIMD(private(eta, s))
+			for(i = sx; i < sx+nx; i++)
+			{
+				eta = (PetscScalar)et[i];
+
+				// compute stress
+				s = eta*((vy[i] - vyb[i])/dz + (vz[i] - vzb[i])/dy);
+
+				// momentum
+				fyb[i] -= s/bdz;   fy[i] += s/fdz;
+				fzb[i] -= s/bdy;   fz[i] += s/fdy;
+			}
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+template <class T>
+static PetscErrorCode MatFreeStokesBound(MatData *md, MatFreeArrays *a, MatFreeCoeff<T> *coef)
+{
+	// apply two-point constraints on the domain boundary
+	// (difference between constrained and unconstrained stencils)
+	// only boundary rows, and end points of the remaining rows are processed
+
+	FDSTAG       *fs;
+	PetscInt      mcx, mcy, mcz, mnx, mny, mnz;
+	PetscInt      i, j, k, nx, ny, nz, sx, sy, sz, ib, di;
+	PetscScalar   dx, dy, dz, bdx, fdx, bdy, fdy, bdz, fdz, eta, pc, s;
+	PetscScalar   ***vx, ***vy, ***vz, ***fx, ***fy, ***fz;
+	PetscScalar   ***bcvx, ***bcvy, ***bcvz, ***bcp;
+	PetscScalar   cf[6];
+
+	PetscFunctionBeginUser;
+
+	fs   = md->fs;
+	vx   = a->vx;   fx   = a->fx;   bcvx = a->bcvx;
+	vy   = a->vy;   fy   = a->fy;   bcvy = a->bcvy;
+	vz   = a->vz;   fz   = a->fz;   bcvz = a->bcvz;
+	bcp  = a->bcp;
+
+	// initialize index bounds
+	mcx = fs->dsx.tcels - 1;
+	mcy = fs->dsy.tcels - 1;
+	mcz = fs->dsz.tcels - 1;
+	mnx = fs->dsx.tnods - 1;
+	mny = fs->dsy.tnods - 1;
+	mnz = fs->dsz.tnods - 1;
+
+	//-------------------------------
+	// central points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	for(j = sy; j < sy+ny; j++)
+	{
+		if(k == 0 || k == mcz || j == 0 || j == mcy) { ib = sx; di = 1; }
+		else { ib = sx ? mcx : 0; di = PetscMax(mcx, 1); }
+
+		for(i = ib; i < sx+nx; i += di)
+		{
+			// set pressure two-point constraints
+			SET_PRES_TPC(bcp, i-1, j,   k,   i, 0,   cf[0])
+			SET_PRES_TPC(bcp, i+1, j,   k,   i, mcx, cf[1])
+			SET_PRES_TPC(bcp, i,   j-1, k,   j, 0,   cf[2])
+			SET_PRES_TPC(bcp, i,   j+1, k,   j, mcy, cf[3])
+			SET_PRES_TPC(bcp, i,   j,   k-1, k, 0,   cf[4])
+			SET_PRES_TPC(bcp, i,   j,   k+1, k, mcz, cf[5])
+
+			pc = a->p[k][j][i];
+
+			// get mesh steps for the backward and forward derivatives
+			bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+			bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+			bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+			// momentum
+			fx[k][j][i] += (cf[0] - 1.0)*pc/bdx;   fx[k][j][i+1] -= (cf[1] - 1.0)*pc/fdx;
+			fy[k][j][i] += (cf[2] - 1.0)*pc/bdy;   fy[k][j+1][i] -= (cf[3] - 1.0)*pc/fdy;
+			fz[k][j][i] += (cf[4] - 1.0)*pc/bdz;   fz[k+1][j][i] -= (cf[5] - 1.0)*pc/fdz;
+		}
+	}
+
+	//-------------------------------
+	// xy edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	for(j = sy; j < sy+ny; j++)
+	{
+		if(j == 0 || j == mny) { ib = sx; di = 1; }
+		else { ib = sx ? mnx : 0; di = mnx; }
+
+		for(i = ib; i < sx+nx; i += di)
+		{
+			// initialize scaling factors
+			cf[0] = 1.0;
+			cf[1] = 1.0;
+			cf[2] = 1.0;
+			cf[3] = 1.0;
+
+			// set velocity two-point constraints
+			SET_VEL_TPC(bcvx, i,   j-1, k, j, 0,   cf[1], cf[0])
+			SET_VEL_TPC(bcvx, i,   j,   k, j, mny, cf[0], cf[1])
+			SET_VEL_TPC(bcvy, i-1, j,   k, i, 0,   cf[3], cf[2])
+			SET_VEL_TPC(bcvy, i,   j,   k, i, mnx, cf[2], cf[3])
+
+			eta = (PetscScalar)coef->etaxy[k][j][i];
+
+			dx = SIZE_NODE(i, sx, fs->dsx);
+			dy = SIZE_NODE(j, sy, fs->dsy);
+
+			// compute stress correction
+			s = eta*(((cf[1] - 1.0)*vx[k][j][i] - (cf[0] - 1.0)*vx[k][j-1][i])/dy
+			+        ((cf[3] - 1.0)*vy[k][j][i] - (cf[2] - 1.0)*vy[k][j][i-1])/dx);
+
+			bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+			// momentum
+			fx[k][j-1][i] -= s/bdy;   fx[k][j][i] += s/fdy;
+			fy[k][j][i-1] -= s/bdx;   fy[k][j][i] += s/fdx;
+		}
+	}
+
+	//-------------------------------
+	// xz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	for(j = sy; j < sy+ny; j++)
+	{
+		if(k == 0 || k == mnz) { ib = sx; di = 1; }
+		else { ib = sx ? mnx : 0; di = mnx; }
+
+		for(i = ib; i < sx+nx; i += di)
+		{
+			// initialize scaling factors
+			cf[0] = 1.0;
+			cf[1] = 1.0;
+			cf[2] = 1.0;
+			cf[3] = 1.0;
+
+			// set velocity two-point constraints
+			SET_VEL_TPC(bcvx, i,   j,   k-1, k, 0,   cf[1], cf[0])
+			SET_VEL_TPC(bcvx, i,   j,   k,   k, mnz, cf[0], cf[1])
+			SET_VEL_TPC(bcvz, i-1, j,   k,   i, 0,   cf[3], cf[2])
+			SET_VEL_TPC(bcvz, i,   j,   k,   i, mnx, cf[2], cf[3])
+
+			eta = (PetscScalar)coef->etaxz[k][j][i];
+
+			dx = SIZE_NODE(i, sx, fs->dsx);
+			dz = SIZE_NODE(k, sz, fs->dsz);
+
+			// compute stress correction
+			s = eta*(((cf[1] - 1.0)*vx[k][j][i] - (cf[0] - 1.0)*vx[k-1][j][i])/dz
+			+        ((cf[3] - 1.0)*vz[k][j][i] - (cf[2] - 1.0)*vz[k][j][i-1])/dx);
+
+			bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+			bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+			// momentum
+			fx[k-1][j][i] -= s/bdz;   fx[k][j][i] += s/fdz;
+			fz[k][j][i-1] -= s/bdx;   fz[k][j][i] += s/fdx;
+		}
+	}
+
+	//-------------------------------
+	// yz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	for(k = sz; k < sz+nz; k++)
+	for(j = sy; j < sy+ny; j++)
+	{
+		// constraints do not depend on i
+		if(k != 0 && k != mnz && j != 0 && j != mny) continue;
+
+		for(i = sx; i < sx+nx; i++)
+		{
+			// initialize scaling factors
+			cf[0] = 1.0;
+			cf[1] = 1.0;
+			cf[2] = 1.0;
+			cf[3] = 1.0;
+
+			// set velocity two-point constraints
+			SET_VEL_TPC(bcvy, i,   j,   k-1, k, 0,   cf[1], cf[0])
+			SET_VEL_TPC(bcvy, i,   j,   k,   k, mnz, cf[0], cf[1])
+			SET_VEL_TPC(bcvz, i,   j-1, k,   j, 0,   cf[3], cf[2])
+			SET_VEL_TPC(bcvz, i,   j,   k,   j, mny, cf[2], cf[3])
+
+			eta = (PetscScalar)coef->etayz[k][j][i];
+
+			dy = SIZE_NODE(j, sy, fs->dsy);
+			dz = SIZE_NODE(k, sz, fs->dsz);
+
+			// compute stress correction
+			s = eta*(((cf[1] - 1.0)*vy[k][j][i] - (cf[0] - 1.0)*vy[k-1][j][i])/dz
+			+        ((cf[3] - 1.0)*vz[k][j][i] - (cf[2] - 1.0)*vz[k][j-1][i])/dy);
+
+			bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+			bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+			// momentum
+			fy[k-1][j][i] -= s/bdz;   fy[k][j][i] += s/fdz;
+			fz[k][j-1][i] -= s/bdy;   fz[k][j][i] += s/fdy;
+		}
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFreeEvaluateLinearOperator(MatData *md,
+		Vec lvx, Vec lvy, Vec lvz, Vec gp,
+		Vec lfx, Vec lfy, Vec lfz, Vec gc,
+		PetscScalar cfInvEta, MatDataPC *mdpc)
+{
+	// cfInvEta - inverse viscosity term prefactor
+	// 0.0      - Picard operator
+	// 1.0      - preconditioner operator
+
+	// With -mat_free_row_kernels stencils are first evaluated without
+	// two-point constraints by the branch-free row kernels, and then
+	// corrected on the domain boundary. Single precision parameters are
+	// used if available (preconditioner).
+
+	FDSTAG                    *fs;
+	MatFreeArrays              a;
+	MatFreeCoeff <PetscScalar> cd;
+	MatFreeCoeff <float>       cs;
+
+	
+	PetscFunctionBeginUser;
+
+	if(!md->rowkern)
+	{
+		PetscCall(MatFreeStokesStencil(md, lvx, lvy, lvz, gp, lfx, lfy, lfz, gc, cfInvEta));
+
+		PetscFunctionReturn(0);
+	}
+
+	fs = md->fs;
+
+    // clear residual components
+	PetscCall(VecZeroEntries(lfx));
+	PetscCall(VecZeroEntries(lfy));
+	PetscCall(VecZeroEntries(lfz));
+
+	// access work vectors
+	PetscCall(DMDAVecGetArray(fs->DA_X,   lvx,  &a.vx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   lvy,  &a.vy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   lvz,  &a.vz));
+	PetscCall(DMDAVecGetArray(fs->DA_X,   lfx,  &a.fx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   lfy,  &a.fy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   lfz,  &a.fz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, gc,   &a.c));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, gp,   &a.p));
+
+	// access boundary constraint vectors
+	PetscCall(DMDAVecGetArray(fs->DA_X,   md->bcvx,  &a.bcvx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   md->bcvy,  &a.bcvy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   md->bcvz,  &a.bcvz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->bcp,   &a.bcp));
+
+	// access row buffer
+	a.w = md->work;
+
+	if(mdpc && mdpc->sprec)
+	{
+		// access single precision parameters
+		cs.Kb    = mdpc->Kb;
+		cs.rho   = mdpc->rho;
+		cs.eta   = mdpc->eta;
+		cs.etaxy = mdpc->etaxy;
+		cs.etaxz = mdpc->etaxz;
+		cs.etayz = mdpc->etayz;
+
+		PetscCall(MatFreeStokesCells(md, &a, &cs, cfInvEta));
+		PetscCall(MatFreeStokesEdges(md, &a, &cs));
+		PetscCall(MatFreeStokesBound(md, &a, &cs));
+	}
+	else
+	{
+		// access parameter vectors
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->Kb,    &cd.Kb));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->rho,   &cd.rho));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->eta,   &cd.eta));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->etaxy, &cd.etaxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->etaxz, &cd.etaxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->etayz, &cd.etayz));
+
+		PetscCall(MatFreeStokesCells(md, &a, &cd, cfInvEta));
+		PetscCall(MatFreeStokesEdges(md, &a, &cd));
+		PetscCall(MatFreeStokesBound(md, &a, &cd));
+
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->Kb,    &cd.Kb));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->rho,   &cd.rho));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->eta,   &cd.eta));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->etaxy, &cd.etaxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->etaxz, &cd.etaxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->etayz, &cd.etayz));
+	}
+
+	// restore access
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   lvx,       &a.vx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   lvy,       &a.vy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   lvz,       &a.vz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   lfx,       &a.fx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   lfy,       &a.fy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   lfz,       &a.fz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, gc,        &a.c));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, gp,        &a.p));
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   md->bcvx,  &a.bcvx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   md->bcvy,  &a.bcvy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   md->bcvz,  &a.bcvz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->bcp,   &a.bcp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatFreeEvaluateTangent(MatData *md,
+		Vec lvx, Vec lvy, Vec lvz,
+		Vec lfx, Vec lfy, Vec lfz)
+{
+	// add viscosity derivative contribution of the tangent operator
+	//
+	// ds_ij = 2*eta*dd_ij + 2*d_ij*(d eta / d J2)*dJ2
+	//
+	// The first term is the Picard operator. In the second term d_ij are
+	// the effective strain rates of the last residual evaluation, and dJ2
+	// is the linearization of the second invariant, which is interpolated
+	// from the neighboring points exactly as in JacResGetResidual.
+
+	FDSTAG      *fs;
+	PetscInt     I1, I2, J1, J2, K1, K2, periodic;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz, mnx, mny, mnz;
+	PetscScalar  dx, dy, dz, bdx, fdx, bdy, fdy, bdz, fdz;
+	PetscScalar  xx, yy, zz, tr, dJ2, sxx, syy, szz, sxy, sxz, syz;
+	PetscScalar  cf[4];
+	PetscScalar ***fx,  ***fy,  ***fz, ***vx,  ***vy,  ***vz;
+	PetscScalar ***bcvx, ***bcvy, ***bcvz, ***deta;
+	PetscScalar ***dxx, ***dyy, ***dzz, ***dxy, ***dxz, ***dyz;
+	PetscScalar ***exx, ***eyy, ***ezz, ***exy, ***exz, ***eyz;
+	Vec          lexx, leyy, lezz, lexy, lexz, leyz;
+
+	PetscFunctionBeginUser;
+
+	fs       = md->fs;       // grid context
+	periodic = fs->periodic; // periodic flag
+
+	// initialize index bounds
+	mnx = fs->dsx.tnods - 1;
+	mny = fs->dsy.tnods - 1;
+	mnz = fs->dsz.tnods - 1;
+
+	// get temporary strain-rate increment vectors
+	PetscCall(DMGetLocalVector(fs->DA_CEN, &lexx));
+	PetscCall(DMGetLocalVector(fs->DA_CEN, &leyy));
+	PetscCall(DMGetLocalVector(fs->DA_CEN, &lezz));
+	PetscCall(DMGetLocalVector(fs->DA_XY,  &lexy));
+	PetscCall(DMGetLocalVector(fs->DA_XZ,  &lexz));
+	PetscCall(DMGetLocalVector(fs->DA_YZ,  &leyz));
+
+	PetscCall(VecZeroEntries(lexx));
+	PetscCall(VecZeroEntries(leyy));
+	PetscCall(VecZeroEntries(lezz));
+	PetscCall(VecZeroEntries(lexy));
+	PetscCall(VecZeroEntries(lexz));
+	PetscCall(VecZeroEntries(leyz));
+
+	// access work vectors
+	PetscCall(DMDAVecGetArray(fs->DA_X,   lvx,      &vx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   lvy,      &vy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   lvz,      &vz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, lexx,     &exx));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, leyy,     &eyy));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, lezz,     &ezz));
+	PetscCall(DMDAVecGetArray(fs->DA_XY,  lexy,     &exy));
+	PetscCall(DMDAVecGetArray(fs->DA_XZ,  lexz,     &exz));
+	PetscCall(DMDAVecGetArray(fs->DA_YZ,  leyz,     &eyz));
+	PetscCall(DMDAVecGetArray(fs->DA_X,   md->bcvx, &bcvx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   md->bcvy, &bcvy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   md->bcvz, &bcvz));
+
+	//=====================================
+	// STRAIN-RATE INCREMENTS
+	//=====================================
+
+	//-------------------------------
+	// central points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// get mesh steps
+		dx = SIZE_CELL(i, sx, fs->dsx);
+		dy = SIZE_CELL(j, sy, fs->dsy);
+		dz = SIZE_CELL(k, sz, fs->dsz);
+
+		// compute velocity gradients
+		xx = (vx[k][j][i+1] - vx[k][j][i])/dx;
+		yy = (vy[k][j+1][i] - vy[k][j][i])/dy;
+		zz = (vz[k+1][j][i] - vz[k][j][i])/dz;
+
+		// compute deviatoric strain rates
+		tr = (xx + yy + zz)/3.0;
+
+		exx[k][j][i] = xx - tr;
+		eyy[k][j][i] = yy - tr;
+		ezz[k][j][i] = zz - tr;
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// xy edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// initialize scaling factors
+		cf[0] = 1.0;
+		cf[1] = 1.0;
+		cf[2] = 1.0;
+		cf[3] = 1.0;
+
+		// set velocity two-point constraints
+		SET_VEL_TPC(bcvx, i,   j-1, k, j, 0,   cf[1], cf[0])
+		SET_VEL_TPC(bcvx, i,   j,   k, j, mny, cf[0], cf[1])
+		SET_VEL_TPC(bcvy, i-1, j,   k, i, 0,   cf[3], cf[2])
+		SET_VEL_TPC(bcvy, i,   j,   k, i, mnx, cf[2], cf[3])
+
+		// get mesh steps
+		dx = SIZE_NODE(i, sx, fs->dsx);
+		dy = SIZE_NODE(j, sy, fs->dsy);
+
+		// compute shear strain rate
+		exy[k][j][i] = 0.5*((cf[1]*vx[k][j][i] - cf[0]*vx[k][j-1][i])/dy
+		             +      (cf[3]*vy[k][j][i] - cf[2]*vy[k][j][i-1])/dx);
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// xz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// initialize scaling factors
+		cf[0] = 1.0;
+		cf[1] = 1.0;
+		cf[2] = 1.0;
+		cf[3] = 1.0;
+
+		// set velocity two-point constraints
+		SET_VEL_TPC(bcvx, i,   j,   k-1, k, 0,   cf[1], cf[0])
+		SET_VEL_TPC(bcvx, i,   j,   k,   k, mnz, cf[0], cf[1])
+		SET_VEL_TPC(bcvz, i-1, j,   k,   i, 0,   cf[3], cf[2])
+		SET_VEL_TPC(bcvz, i,   j,   k,   i, mnx, cf[2], cf[3])
+
+		// get mesh steps
+		dx = SIZE_NODE(i, sx, fs->dsx);
+		dz = SIZE_NODE(k, sz, fs->dsz);
+
+		// compute shear strain rate
+		exz[k][j][i] = 0.5*((cf[1]*vx[k][j][i] - cf[0]*vx[k-1][j][i])/dz
+		             +      (cf[3]*vz[k][j][i] - cf[2]*vz[k][j][i-1])/dx);
+	}
+	END_STD_LOOP
+
+	//-------------------------------
+	// yz edge points
+	//-------------------------------
+	PetscCall(DMDAGetCorners(fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// initialize scaling factors
+		cf[0] = 1.0;
+		cf[1] = 1.0;
+		cf[2] = 1.0;
+		cf[3] = 1.0;
+
+		// set velocity two-point constraints
+		SET_VEL_TPC(bcvy, i,   j,   k-1, k, 0,   cf[1], cf[0])
+		SET_VEL_TPC(bcvy, i,   j,   k,   k, mnz, cf[0], cf[1])
+		SET_VEL_TPC(bcvz, i,   j-1, k,   j, 0,   cf[3], cf[2])
+		SET_VEL_TPC(bcvz, i,   j,   k,   j, mny, cf[2], cf[3])
+
+		// get mesh steps
+		dy = SIZE_NODE(j, sy, fs->dsy);
+		dz = SIZE_NODE(k, sz, fs->dsz);
+
+		// compute shear strain rate
+		eyz[k][j][i] = 0.5*((cf[1]*vy[k][j][i] - cf[0]*vy[k-1][j][i])/dz
+		             +      (cf[3]*vz[k][j][i] - cf[2]*vz[k][j-1][i])/dy);
+	}
+	END_STD_LOOP
+
+	// restore access
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   lvx,      &vx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   lvy,      &vy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   lvz,      &vz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, lexx,     &exx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, leyy,     &eyy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, lezz,     &ezz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XY,  lexy,     &exy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  lexz,     &exz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  leyz,     &eyz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   md->bcvx, &bcvx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   md->bcvy, &bcvy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   md->bcvz, &bcvz));
+
+	// communicate boundary strain-rate increments
+	LOCAL_TO_LOCAL(fs->DA_CEN, lexx);
+	LOCAL_TO_LOCAL(fs->DA_CEN, leyy);
+	LOCAL_TO_LOCAL(fs->DA_CEN, lezz);
+	LOCAL_TO_LOCAL(fs->DA_XY,  lexy);
+	LOCAL_TO_LOCAL(fs->DA_XZ,  lexz);
+	LOCAL_TO_LOCAL(fs->DA_YZ,  leyz);
+
+	//=====================================
+	// TANGENT STRESSES
+	//=====================================
+
+	// access work vectors
+	PetscCall(DMDAVecGetArray(fs->DA_X,   lfx,     &fx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   lfy,     &fy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   lfz,     &fz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, lexx,    &exx));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, leyy,    &eyy));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, lezz,    &ezz));
+	PetscCall(DMDAVecGetArray(fs->DA_XY,  lexy,    &exy));
+	PetscCall(DMDAVecGetArray(fs->DA_XZ,  lexz,    &exz));
+	PetscCall(DMDAVecGetArray(fs->DA_YZ,  leyz,    &eyz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dxx, &dxx));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dyy, &dyy));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dzz, &dzz));
+	PetscCall(DMDAVecGetArray(fs->DA_XY,  md->dxy, &dxy));
+	PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->dxz, &dxz));
+	PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->dyz, &dyz));
+
+	//-------------------------------
+	// central points
+	//-------------------------------
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->deta, &deta));
+
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// skip points with constant viscosity
+		if(!deta[k][j][i]) continue;
+
+		// linearize second invariant
+		dJ2 = dxx[k][j][i]*exx[k][j][i] + dyy[k][j][i]*eyy[k][j][i] + dzz[k][j][i]*ezz[k][j][i] +
+		0.5*(dxy[k][j][i]*exy[k][j][i] + dxy[k][j+1][i]*exy[k][j+1][i] + dxy[k][j][i+1]*exy[k][j][i+1] + dxy[k][j+1][i+1]*exy[k][j+1][i+1]) +
+		0.5*(dxz[k][j][i]*exz[k][j][i] + dxz[k+1][j][i]*exz[k+1][j][i] + dxz[k][j][i+1]*exz[k][j][i+1] + dxz[k+1][j][i+1]*exz[k+1][j][i+1]) +
+		0.5*(dyz[k][j][i]*eyz[k][j][i] + dyz[k+1][j][i]*eyz[k+1][j][i] + dyz[k][j+1][i]*eyz[k][j+1][i] + dyz[k+1][j+1][i]*eyz[k+1][j+1][i]);
+
+		// compute tangent stresses
+		sxx = 2.0*deta[k][j][i]*dxx[k][j][i]*dJ2;
+		syy = 2.0*deta[k][j][i]*dyy[k][j][i]*dJ2;
+		szz = 2.0*deta[k][j][i]*dzz[k][j][i]*dJ2;
+
+		// get mesh steps for the backward and forward derivatives
+		bdx = SIZE_NODE(i, sx, fs->dsx);   fdx = SIZE_NODE(i+1, sx, fs->dsx);
+		bdy = SIZE_NODE(j, sy, fs->dsy);   fdy = SIZE_NODE(j+1, sy, fs->dsy);
+		bdz = SIZE_NODE(k, sz, fs->dsz);   fdz = SIZE_NODE(k+1, sz, fs->dsz);
+
+		// momentum
+		fx[k][j][i] -= sxx/bdx;   fx[k][j][i+1] += sxx/fdx;
+		fy[k][j][i] -= syy/bdy;   fy[k][j+1][i] += syy/fdy;
+		fz[k][j][i] -= szz/bdz;   fz[k+1][j][i] += szz/fdz;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->deta, &deta));
+
+	//-------------------------------
+	// xy edge points
+	//-------------------------------
+	PetscCall(DMDAVecGetArray(fs->DA_XY, md->detaxy, &deta));
+
+	PetscCall(DMDAGetCorners(fs->DA_XY, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// skip points with constant viscosity
+		if(!deta[k][j][i]) continue;
+
+		// check index bounds
+		I1 = i;   if(!periodic && I1 == mnx) I1--;
+		I2 = i-1; if(!periodic && I2 == -1)  I2++;
+		J1 = j;   if(             J1 == mny) J1--;
+		J2 = j-1; if(             J2 == -1)  J2++;
+
+		// linearize second invariant
+		dJ2 = 2.0*dxy[k][j][i]*exy[k][j][i] +
+		0.25*(dxx[k][J1][I1]*exx[k][J1][I1] + dxx[k][J1][I2]*exx[k][J1][I2] + dxx[k][J2][I1]*exx[k][J2][I1] + dxx[k][J2][I2]*exx[k][J2][I2]) +
+		0.25*(dyy[k][J1][I1]*eyy[k][J1][I1] + dyy[k][J1][I2]*eyy[k][J1][I2] + dyy[k][J2][I1]*eyy[k][J2][I1] + dyy[k][J2][I2]*eyy[k][J2][I2]) +
+		0.25*(dzz[k][J1][I1]*ezz[k][J1][I1] + dzz[k][J1][I2]*ezz[k][J1][I2] + dzz[k][J2][I1]*ezz[k][J2][I1] + dzz[k][J2][I2]*ezz[k][J2][I2]) +
+		0.5 *(dxz[k][J1][i]*exz[k][J1][i] + dxz[k+1][J1][i]*exz[k+1][J1][i] + dxz[k][J2][i]*exz[k][J2][i] + dxz[k+1][J2][i]*exz[k+1][J2][i]) +
+		0.5 *(dyz[k][j][I1]*eyz[k][j][I1] + dyz[k+1][j][I1]*eyz[k+1][j][I1] + dyz[k][j][I2]*eyz[k][j][I2] + dyz[k+1][j][I2]*eyz[k+1][j][I2]);
+
+		// compute tangent stress
+		sxy = 2.0*deta[k][j][i]*dxy[k][j][i]*dJ2;
+
+		// get mesh steps for the backward and forward derivatives
+		bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+		bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+
+		// momentum
+		fx[k][j-1][i] -= sxy/bdy;   fx[k][j][i] += sxy/fdy;
+		fy[k][j][i-1] -= sxy/bdx;   fy[k][j][i] += sxy/fdx;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_XY, md->detaxy, &deta));
+
+	//-------------------------------
+	// xz edge points
+	//-------------------------------
+	PetscCall(DMDAVecGetArray(fs->DA_XZ, md->detaxz, &deta));
+
+	PetscCall(DMDAGetCorners(fs->DA_XZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// skip points with constant viscosity
+		if(!deta[k][j][i]) continue;
+
+		// check index bounds
+		I1 = i;   if(!periodic && I1 == mnx) I1--;
+		I2 = i-1; if(!periodic && I2 == -1)  I2++;
+		K1 = k;   if(             K1 == mnz) K1--;
+		K2 = k-1; if(             K2 == -1)  K2++;
+
+		// linearize second invariant
+		dJ2 = 2.0*dxz[k][j][i]*exz[k][j][i] +
+		0.25*(dxx[K1][j][I1]*exx[K1][j][I1] + dxx[K1][j][I2]*exx[K1][j][I2] + dxx[K2][j][I1]*exx[K2][j][I1] + dxx[K2][j][I2]*exx[K2][j][I2]) +
+		0.25*(dyy[K1][j][I1]*eyy[K1][j][I1] + dyy[K1][j][I2]*eyy[K1][j][I2] + dyy[K2][j][I1]*eyy[K2][j][I1] + dyy[K2][j][I2]*eyy[K2][j][I2]) +
+		0.25*(dzz[K1][j][I1]*ezz[K1][j][I1] + dzz[K1][j][I2]*ezz[K1][j][I2] + dzz[K2][j][I1]*ezz[K2][j][I1] + dzz[K2][j][I2]*ezz[K2][j][I2]) +
+		0.5 *(dxy[K1][j][i]*exy[K1][j][i] + dxy[K1][j+1][i]*exy[K1][j+1][i] + dxy[K2][j][i]*exy[K2][j][i] + dxy[K2][j+1][i]*exy[K2][j+1][i]) +
+		0.5 *(dyz[k][j][I1]*eyz[k][j][I1] + dyz[k][j+1][I1]*eyz[k][j+1][I1] + dyz[k][j][I2]*eyz[k][j][I2] + dyz[k][j+1][I2]*eyz[k][j+1][I2]);
+
+		// compute tangent stress
+		sxz = 2.0*deta[k][j][i]*dxz[k][j][i]*dJ2;
+
+		// get mesh steps for the backward and forward derivatives
+		bdx = SIZE_CELL(i-1, sx, fs->dsx);   fdx = SIZE_CELL(i, sx, fs->dsx);
+		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+		// momentum
+		fx[k-1][j][i] -= sxz/bdz;   fx[k][j][i] += sxz/fdz;
+		fz[k][j][i-1] -= sxz/bdx;   fz[k][j][i] += sxz/fdx;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_XZ, md->detaxz, &deta));
+
+	//-------------------------------
+	// yz edge points
+	//-------------------------------
+	PetscCall(DMDAVecGetArray(fs->DA_YZ, md->detayz, &deta));
+
+	PetscCall(DMDAGetCorners(fs->DA_YZ, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		// skip points with constant viscosity
+		if(!deta[k][j][i]) continue;
+
+		// check index bounds
+		J1 = j;   if(J1 == mny) J1--;
+		J2 = j-1; if(J2 == -1)  J2++;
+		K1 = k;   if(K1 == mnz) K1--;
+		K2 = k-1; if(K2 == -1)  K2++;
+
+		// linearize second invariant
+		dJ2 = 2.0*dyz[k][j][i]*eyz[k][j][i] +
+		0.25*(dxx[K1][J1][i]*exx[K1][J1][i] + dxx[K1][J2][i]*exx[K1][J2][i] + dxx[K2][J1][i]*exx[K2][J1][i] + dxx[K2][J2][i]*exx[K2][J2][i]) +
+		0.25*(dyy[K1][J1][i]*eyy[K1][J1][i] + dyy[K1][J2][i]*eyy[K1][J2][i] + dyy[K2][J1][i]*eyy[K2][J1][i] + dyy[K2][J2][i]*eyy[K2][J2][i]) +
+		0.25*(dzz[K1][J1][i]*ezz[K1][J1][i] + dzz[K1][J2][i]*ezz[K1][J2][i] + dzz[K2][J1][i]*ezz[K2][J1][i] + dzz[K2][J2][i]*ezz[K2][J2][i]) +
+		0.5 *(dxy[K1][j][i]*exy[K1][j][i] + dxy[K1][j][i+1]*exy[K1][j][i+1] + dxy[K2][j][i]*exy[K2][j][i] + dxy[K2][j][i+1]*exy[K2][j][i+1]) +
+		0.5 *(dxz[k][J1][i]*exz[k][J1][i] + dxz[k][J1][i+1]*exz[k][J1][i+1] + dxz[k][J2][i]*exz[k][J2][i] + dxz[k][J2][i+1]*exz[k][J2][i+1]);
+
+		// compute tangent stress
+		syz = 2.0*deta[k][j][i]*dyz[k][j][i]*dJ2;
+
+		// get mesh steps for the backward and forward derivatives
+		bdy = SIZE_CELL(j-1, sy, fs->dsy);   fdy = SIZE_CELL(j, sy, fs->dsy);
+		bdz = SIZE_CELL(k-1, sz, fs->dsz);   fdz = SIZE_CELL(k, sz, fs->dsz);
+
+		// momentum
+		fy[k-1][j][i] -= syz/bdz;   fy[k][j][i] += syz/fdz;
+		fz[k][j-1][i] -= syz/bdy;   fz[k][j][i] += syz/fdy;
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_YZ, md->detayz, &deta));
+
+	// restore access
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   lfx,     &fx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   lfy,     &fy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   lfz,     &fz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, lexx,    &exx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, leyy,    &eyy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, lezz,    &ezz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XY,  lexy,    &exy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  lexz,    &exz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  leyz,    &eyz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dxx, &dxx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dyy, &dyy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dzz, &dzz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->dxy, &dxy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->dxz, &dxz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->dyz, &dyz));
+
+	// restore temporary vectors
+	PetscCall(DMRestoreLocalVector(fs->DA_CEN, &lexx));
+	PetscCall(DMRestoreLocalVector(fs->DA_CEN, &leyy));
+	PetscCall(DMRestoreLocalVector(fs->DA_CEN, &lezz));
+	PetscCall(DMRestoreLocalVector(fs->DA_XY,  &lexy));
+	PetscCall(DMRestoreLocalVector(fs->DA_XZ,  &lexz));
+	PetscCall(DMRestoreLocalVector(fs->DA_YZ,  &leyz));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode MatFreeEvaluateRestrict(
 		MatData *coarse, MatData *fine,
 		Vec fx, Vec fy, Vec fz, Vec fp,
@@ -1178,6 +2192,7 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 		Vec ldx, Vec ldy, Vec ldz, Vec gdp)
 {
 	// get diagonal of the preconditioner matrix
+	// (diagonal of the partial Newton tangent is added if active)
 
 	FDSTAG      *fs;
 	PetscInt    idx[7];
@@ -1190,6 +2205,10 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 	PetscScalar ***vdx,  ***vdy,  ***vdz,  ***vdp;
 	PetscScalar ***bcvx, ***bcvy, ***bcvz, ***bcp;
 	PetscScalar ***vKb,  ***vrho,  ***veta, ***vetaxy, ***vetaxz, ***vetayz;
+	PetscScalar ***vdeta=NULL, ***vdetaxy=NULL, ***vdetaxz=NULL, ***vdetayz=NULL;
+	PetscScalar ***vdxx=NULL,  ***vdyy=NULL,    ***vdzz=NULL,    ***vdxy=NULL, ***vdxz=NULL, ***vdyz=NULL;
+	PetscScalar dn[3];
+	PetscInt    tangent;
 	PetscInt    pdofidx[7];
 	PetscScalar cf[7];
 
@@ -1199,6 +2218,9 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 	// access context
 	fs = md->fs;
 
+	// set tangent flag
+	tangent = md->newton && md->tangent;
+
 	// get density gradient stabilization parameters
 	dt     = md->dt;     // time step
 	fssa   = md->fssa;   // density gradient penalty parameter
@@ -1237,6 +2259,21 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 	PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->etaxz, &vetaxz));
 	PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->etayz, &vetayz));
 
+	// access viscosity derivative vectors (partial Newton tangent)
+	if(tangent)
+	{
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	//---------------
 	// central points
 	//---------------
@@ -1277,6 +2314,16 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 		// compute density gradient stabilization terms
 		addDensGradStabil(fssa, v, rho, dt, grav, fdx, fdy, fdz, bdx, bdy, bdz);
 
+		// add viscosity derivative term (partial Newton tangent)
+		if(tangent)
+		{
+			dn[0] = vdxx[k][j][i];
+			dn[1] = vdyy[k][j][i];
+			dn[2] = vdzz[k][j][i];
+
+			addViscPartialTangent(eta, vdeta[k][j][i], dn, v, dx, dy, dz, fdx, fdy, fdz, bdx, bdy, bdz);
+		}
+
 		// update diagonal entries
 		vdx[k  ][j  ][i  ] += v[0 ];
 		vdx[k  ][j  ][i+1] += v[8 ];
@@ -1298,6 +2345,9 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 		// get effective viscosity
 		eta = vetaxy[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(tangent) eta = getViscPartialTangent(eta, vdetaxy[k][j][i], vdxy[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dy = SIZE_NODE(j, sy, fs->dsy);
@@ -1349,6 +2399,9 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 		// get effective viscosity
 		eta = vetaxz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(tangent) eta = getViscPartialTangent(eta, vdetaxz[k][j][i], vdxz[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -1400,6 +2453,9 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 		// get effective viscosity
 		eta = vetayz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(tangent) eta = getViscPartialTangent(eta, vdetayz[k][j][i], vdyz[k][j][i]);
+
 		// get mesh steps
 		dy = SIZE_NODE(j, sy, fs->dsy);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -1459,6 +2515,20 @@ PetscErrorCode MatFreeEvaluateDiagonal(MatData *md,
 	PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->etaxz, &vetaxz));
 	PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->etayz, &vetayz));
 
+	if(tangent)
+	{
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
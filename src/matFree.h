@@ -17,6 +17,7 @@
 
 struct MatData;
 struct MGInterp;
+struct MatDataPC;
 
 //---------------------------------------------------------------------------
 // interface functions
@@ -24,6 +25,8 @@ struct MGInterp;
 
 PetscErrorCode MatFreeApplyPicard(Mat A, Vec x, Vec f);
 
+PetscErrorCode MatFreeApplyNewton(Mat A, Vec x, Vec f);
+
 PetscErrorCode MatFreeApplyPreconditioner(Mat A, Vec x, Vec f);
 
 PetscErrorCode MatFreeGetDiagonal(Mat mat, Vec v);
@@ -40,7 +43,7 @@ PetscErrorCode MatFreeUpdateProlong(Mat P, Vec vc, Vec vfb, Vec vf);
 // main computation functions
 //---------------------------------------------------------------------------
 
-PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScalar cfInvEta);
+PetscErrorCode MatFreeComputeLinearOperator(MatData *md, Vec x, Vec f, PetscScalar cfInvEta, MatDataPC *mdpc = NULL);
 
 PetscErrorCode MatFreeComputeRestrict(MGInterp *mgi, Vec vf, Vec vc);
 
@@ -68,11 +71,16 @@ PetscErrorCode MatFreeCombineVec(MatData *md, Vec v, Vec gvx, Vec gvy, Vec gvz,
 PetscErrorCode MatFreeEvaluateLinearOperator(MatData *md,
 		Vec lvx, Vec lvy, Vec lvz, Vec gp,
 		Vec lfx, Vec lfy, Vec lfz, Vec gc,
-		PetscScalar cfInvEta);
+		PetscScalar cfInvEta, MatDataPC *mdpc = NULL);
 
 // cfInvEta - inverse viscosity term prefactor
 // 0.0      - Picard operator
 // 1.0      - preconditioner operator
+// mdpc     - preconditioner context (single precision parameters, optional)
+
+PetscErrorCode MatFreeEvaluateTangent(MatData *md,
+		Vec lvx, Vec lvy, Vec lvz,
+		Vec lfx, Vec lfy, Vec lfz);
 
 PetscErrorCode MatFreeEvaluateRestrict(
 		MatData *coarse, MatData *fine,
@@ -16,6 +16,7 @@
 #include "tssolve.h"
 #include "fdstag.h"
 #include "tools.h"
+#include "perfLog.h"
 
 //---------------------------------------------------------------------------
 PetscErrorCode PMatCreate(MatData *md, Mat *A, PetscInt set_null_space)
@@ -231,6 +232,7 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 {
 	//======================================================================
 	// Assemble effective viscosity preconditioning matrix
+	// (partial Newton tangent is added if active, see addViscPartialTangent)
 	//
 	// Global ordering of the variables is interlaced:
 	// all X-Y-Z-P DOF of the first processor
@@ -248,6 +250,9 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 	PetscScalar ***ivx, ***ivy, ***ivz, ***ip;
 	PetscScalar ***bcvx, ***bcvy, ***bcvz, ***bcp;
 	PetscScalar ***vKb,  ***vrho,  ***veta, ***vetaxy, ***vetaxz, ***vetayz;
+	PetscScalar ***vdeta=NULL, ***vdetaxy=NULL, ***vdetaxz=NULL, ***vdetayz=NULL;
+	PetscScalar ***vdxx=NULL,  ***vdyy=NULL,    ***vdzz=NULL,    ***vdxy=NULL, ***vdxz=NULL, ***vdyz=NULL;
+	PetscScalar dn[3];
 	PetscInt    pdofidx[7];
 	PetscScalar cf[7];
 
@@ -291,6 +296,21 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 	PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->etaxz, &vetaxz));
 	PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->etayz, &vetayz));
 
+	// access viscosity derivative vectors (Newton tangent)
+	if(md->tangent)
+	{
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	//---------------
 	// central points
 	//---------------
@@ -334,6 +354,16 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 		// compute density gradient stabilization terms
 		addDensGradStabil(fssa, v, rho, dt, grav, fdx, fdy, fdz, bdx, bdy, bdz);
 
+		// add viscosity derivative term (partial Newton tangent)
+		if(md->tangent)
+		{
+			dn[0] = vdxx[k][j][i];
+			dn[1] = vdyy[k][j][i];
+			dn[2] = vdzz[k][j][i];
+
+			addViscPartialTangent(eta, vdeta[k][j][i], dn, v, dx, dy, dz, fdx, fdy, fdz, bdx, bdy, bdz);
+		}
+
 		// get global indices of the points:
 		// vx_(i), vx_(i+1), vy_(j), vy_(j+1), vz_(k), vz_(k+1), p
 		idx[0] = (PetscInt) ivx[k][j][i];
@@ -371,6 +401,9 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 		// get effective viscosity
 		eta = vetaxy[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetaxy[k][j][i], vdxy[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dy = SIZE_NODE(j, sy, fs->dsy);
@@ -423,6 +456,9 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 		// get effective viscosity
 		eta = vetaxz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetaxz[k][j][i], vdxz[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -475,6 +511,9 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 		// get effective viscosity
 		eta = vetayz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetayz[k][j][i], vdyz[k][j][i]);
+
 		// get mesh steps
 		dy = SIZE_NODE(j, sy, fs->dsy);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -535,6 +574,20 @@ PetscErrorCode PMatAssemble(MatData *md, PetscScalar pgamma, Mat A)
 	PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->etaxz, &vetaxz));
 	PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->etayz, &vetayz));
 
+	if(md->tangent)
+	{
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	// assemble velocity-pressure matrix, remove constrained rows
 	PetscCall(MatAIJAssemble(A, md->numSPC, md->SPCListMat, 1.0));
 
@@ -667,6 +720,8 @@ PetscErrorCode PMatMonoPicard(Mat J, Vec x, Vec r)
 
 	PetscCall(MatShellGetContext(J, (void**)&P));
 
+	PetscCall(PerfBegin(_PERF_PICARD_));
+
 	// compute action of preconditioner matrix
 	PetscCall(MatMult(P->A, x, r));
 
@@ -676,6 +731,8 @@ PetscErrorCode PMatMonoPicard(Mat J, Vec x, Vec r)
 	// update result
 	PetscCall(VecAXPY(r, -1.0, P->w));
 
+	PetscCall(PerfEnd(_PERF_PICARD_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -1009,6 +1066,9 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 	PetscScalar ***ivx, ***ivy, ***ivz, ***ip;
 	PetscScalar ***bcvx, ***bcvy, ***bcvz, ***bcp;
 	PetscScalar ***vKb,  ***vrho,  ***veta, ***vetaxy, ***vetaxz, ***vetayz;
+	PetscScalar ***vdeta=NULL, ***vdetaxy=NULL, ***vdetaxz=NULL, ***vdetayz=NULL;
+	PetscScalar ***vdxx=NULL,  ***vdyy=NULL,    ***vdzz=NULL,    ***vdxy=NULL, ***vdxz=NULL, ***vdyz=NULL;
+	PetscScalar dn[3];
 	PetscInt    pdofidx[7];
 	PetscScalar cf[7];
 
@@ -1062,6 +1122,21 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 	PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->etaxz, &vetaxz));
 	PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->etayz, &vetayz));
 
+	// access viscosity derivative vectors (Newton tangent)
+	if(md->tangent)
+	{
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecGetArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecGetArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecGetArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecGetArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	//---------------
 	// central points
 	//---------------
@@ -1103,6 +1178,16 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 		// compute density gradient stabilization terms
 		addDensGradStabil(fssa, v, rho, dt, grav, fdx, fdy, fdz, bdx, bdy, bdz);
 
+		// add viscosity derivative term (partial Newton tangent)
+		if(md->tangent)
+		{
+			dn[0] = vdxx[k][j][i];
+			dn[1] = vdyy[k][j][i];
+			dn[2] = vdzz[k][j][i];
+
+			addViscPartialTangent(eta, vdeta[k][j][i], dn, v, dx, dy, dz, fdx, fdy, fdz, bdx, bdy, bdz);
+		}
+
 		// get global indices of the points:
 		// vx_(i), vx_(i+1), vy_(j), vy_(j+1), vz_(k), vz_(k+1), p
 		idx[0] = (PetscInt) ivx[k][j][i];
@@ -1169,6 +1254,9 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 		// get effective viscosity
 		eta = vetaxy[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetaxy[k][j][i], vdxy[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dy = SIZE_NODE(j, sy, fs->dsy);
@@ -1222,6 +1310,9 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 		// get effective viscosity
 		eta = vetaxz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetaxz[k][j][i], vdxz[k][j][i]);
+
 		// get mesh steps
 		dx = SIZE_NODE(i, sx, fs->dsx);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -1275,6 +1366,9 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 		// get effective viscosity
 		eta = vetayz[k][j][i];
 
+		// get tangent viscosity (partial Newton tangent)
+		if(md->tangent) eta = getViscPartialTangent(eta, vdetayz[k][j][i], vdyz[k][j][i]);
+
 		// get mesh steps
 		dy = SIZE_NODE(j, sy, fs->dsy);
 		dz = SIZE_NODE(k, sz, fs->dsz);
@@ -1329,6 +1423,20 @@ PetscErrorCode PMatBlockAssemble(PMatBlock *P)
 	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   md->bcvz,  &bcvz));
 	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->bcp,   &bcp));
 
+	if(md->tangent)
+	{
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->deta,   &vdeta));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->detaxy, &vdetaxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->detaxz, &vdetaxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->detayz, &vdetayz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dxx,    &vdxx));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dyy,    &vdyy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->dzz,    &vdzz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XY,  md->dxy,    &vdxy));
+		PetscCall(DMDAVecRestoreArray(fs->DA_XZ,  md->dxz,    &vdxz));
+		PetscCall(DMDAVecRestoreArray(fs->DA_YZ,  md->dyz,    &vdyz));
+	}
+
 	// assemble velocity-pressure matrix blocks, remove constrained rows
 	PetscCall(MatAIJAssemble(P->Avv, md->vNumSPC, md->vSPCListMat, 1.0));
 	PetscCall(MatAIJAssemble(P->Avp, md->vNumSPC, md->vSPCListMat, 0.0));
@@ -1370,6 +1478,8 @@ PetscErrorCode PMatBlockPicard(Mat J, Vec x, Vec r)
 
 	PetscCall(MatShellGetContext(J, (void**)&P));
 
+	PetscCall(PerfBegin(_PERF_PICARD_));
+
 	// extract solution blocks
 	PetscCall(VecScatterBlockToMonolithic(P->xv, P->xp, x, SCATTER_REVERSE));
 
@@ -1395,6 +1505,8 @@ PetscErrorCode PMatBlockPicard(Mat J, Vec x, Vec r)
 	// compose coupled residual
 	PetscCall(VecScatterBlockToMonolithic(P->rv, P->rp, r, SCATTER_FORWARD));
 
+	PetscCall(PerfEnd(_PERF_PICARD_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -103,12 +103,52 @@ PetscErrorCode PMatBlockDestroy(PMatBlock *P);
 
 PetscErrorCode PMatBlockPicard(Mat J, Vec x, Vec r);
 
+//---------------------------------------------------------------------------
+//....................   SINGLE PRECISION MATRIX COPY   .....................
+//---------------------------------------------------------------------------
+
+// Shell matrix that stores coefficients of an assembled AIJ matrix in
+// single precision (diagonal & off-diagonal blocks in CSR format).
+// Input and output vectors, as well as row accumulation, stay in double
+// precision. Used as a linear operator inside preconditioners (smoothers,
+// residuals, Schur complement products) to halve the coefficient traffic
+// of bandwidth-bound matrix-vector products. The source matrix remains
+// the preconditioning matrix (factorizations, diagonals, Galerkin products).
+
+struct MatSingle
+{
+	Mat         A;       // source matrix (double precision)
+	PetscInt    m;       // number of local rows
+	PetscInt    nd, no;  // number of nonzeros in diagonal & off-diagonal blocks
+	PetscInt   *di, *dj; // diagonal block row pointers & column indices
+	PetscInt   *oi, *oj; // off-diagonal block row pointers & column indices
+	float      *dv, *ov; // diagonal & off-diagonal block coefficients
+	PetscInt    ng;      // number of ghost columns
+	PetscInt   *gidx;    // global indices of ghost columns
+	Vec         g;       // ghost values of input vector
+	VecScatter  sct;     // ghost values scatter context
+};
+
+//---------------------------------------------------------------------------
+
+PetscErrorCode MatSingleCreate(Mat A, Mat *S);
+
+PetscErrorCode MatSingleDestroy(Mat *S);
+
+// copy coefficients of source matrix (call after every assembly)
+PetscErrorCode MatSingleUpdate(Mat S);
+
+PetscErrorCode MatSingleMult(Mat S, Vec x, Vec y);
+
+PetscErrorCode MatSingleGetDiagonal(Mat S, Vec d);
+
 //---------------------------------------------------------------------------
 // SERVICE FUNCTIONS
 //---------------------------------------------------------------------------
 
 PetscErrorCode MatAIJCreate(PetscInt m, PetscInt n, PetscInt d_nz,
-	const PetscInt d_nnz[], PetscInt o_nz, const PetscInt o_nnz[], Mat *P);
+	const PetscInt d_nnz[], PetscInt o_nz, const PetscInt o_nnz[], Mat *P,
+	MPI_Comm comm = PETSC_COMM_WORLD);
 
 PetscErrorCode MatAIJCreateDiag(PetscInt m, PetscInt istart, Mat *P);
 
@@ -130,6 +170,16 @@ void addDensGradStabil(
 	PetscScalar fdx,  PetscScalar fdy,  PetscScalar fdz,
 	PetscScalar bdx,  PetscScalar bdy,  PetscScalar bdz);
 
+// add partial Newton tangent to cell stiffness matrix (normal stresses only)
+void addViscPartialTangent(
+	PetscScalar eta, PetscScalar deta, PetscScalar *d, PetscScalar *v,
+	PetscScalar dx,  PetscScalar dy,   PetscScalar dz,
+	PetscScalar fdx, PetscScalar fdy,  PetscScalar fdz,
+	PetscScalar bdx, PetscScalar bdy,  PetscScalar bdz);
+
+// get partial tangent viscosity of edge point (shear stress component only)
+PetscScalar getViscPartialTangent(PetscScalar eta, PetscScalar deta, PetscScalar d);
+
 // compute velocity Schur complement
 void getVelSchur(PetscScalar v[], PetscScalar d[], PetscScalar g[]);
 
@@ -157,6 +207,9 @@ PetscErrorCode VecScatterBlockToMonolithic(Vec f, Vec g, Vec b, ScatterMode mode
 // set pressure two-point constraint
 #define SET_PRES_TPC(bc, i, j, k, ind, lim, cf) { cf = 1.0; if(ind == lim && bc[k][j][i] != DBL_MAX) cf = 2.0; }
 
+// minimum ratio of tangent to effective viscosity (partial tangent preconditioner)
+#define _tangent_min_ 1e-2
+
 // compute scaled shear stress stencil for constrained internal velocity case
 #define RESCALE_STENCIL(rescal, d, df, db, cf, cb, dr) { dr = 0.0; if(rescal) { if(cf == DBL_MAX) { dr += df; } if(cb == DBL_MAX) { dr += db; } } if(dr) { d = dr/2.0; } }
 
@@ -17,12 +17,14 @@
 #include "matrix.h"
 #include "matFree.h"
 #include "tools.h"
+#include "perfLog.h"
 //---------------------------------------------------------------------------
 // MGLevel functions
 //---------------------------------------------------------------------------
 PetscErrorCode MGLevelCreate(MGLevel *lvl, MGLevel *fine, MatData *md, Mat A)
 {
 	PetscInt ln=0, lnfine=0;
+	MPI_Comm comm;
 
 	
 	PetscFunctionBeginUser;
@@ -140,9 +142,12 @@ PetscErrorCode MGLevelCreate(MGLevel *lvl, MGLevel *fine, MatData *md, Mat A)
 		{
 			// WARNING! CONSTANT SIZE PREALLOCATION (ADD VARIABLE PREALLOCATION)
 
+			// get communicator of the level (sub-communicator on agglomerated grid)
+			PetscCall(PetscObjectGetComm((PetscObject)lvl->md->fs->DA_CEN, &comm));
+
 			// preallocate restriction & prolongation matrices
-			PetscCall(MatAIJCreate(ln,     lnfine, 12, NULL, 4, NULL, &lvl->R));
-			PetscCall(MatAIJCreate(lnfine, ln,     8,  NULL, 7, NULL, &lvl->P));
+			PetscCall(MatAIJCreate(ln,     lnfine, 12, NULL, 4, NULL, &lvl->R, comm));
+			PetscCall(MatAIJCreate(lnfine, ln,     8,  NULL, 7, NULL, &lvl->P, comm));
 		}
 	}
 
@@ -182,6 +187,10 @@ PetscErrorCode MGLevelDestroy(MGLevel *lvl)
 	{
 		PetscCall(MatDestroy(&lvl->A));
 	}
+	if(lvl->S)
+	{
+		PetscCall(MatSingleDestroy(&lvl->S));
+	}
 
 	PetscFunctionReturn(0);
 }
@@ -222,35 +231,180 @@ PetscErrorCode MGInterpDestroy(MGInterp *mgi)
 //---------------------------------------------------------------------------
 PetscErrorCode MatDataPCCreate(MatDataPC *mdpc, MatData *md)
 {
+	FDSTAG    *fs;
+	PetscBool  flg;
+
 	
 	PetscFunctionBeginUser;
 
+	fs = md->fs;
+
 	// set evaluation context
 	mdpc->md = md;
 
 	// reserve storage for matrix diagonal
-	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, md->fs->dof.ln, PETSC_DETERMINE, &mdpc->D));
+	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, fs->dof.ln, PETSC_DETERMINE, &mdpc->D));
 	PetscCall(VecSetFromOptions(mdpc->D));
 
+	// single precision parameters halve the parameter memory traffic of the preconditioner operator
+	PetscCall(PetscOptionsHasName(NULL, NULL, "-gmg_mat_free_single", &flg));
+
+	if(flg == PETSC_TRUE)
+	{
+		mdpc->sprec = 1;
+
+		PetscCall(MatDataPCArrayCreate(fs->DA_CEN, &mdpc->Kb));
+		PetscCall(MatDataPCArrayCreate(fs->DA_CEN, &mdpc->rho));
+		PetscCall(MatDataPCArrayCreate(fs->DA_CEN, &mdpc->eta));
+		PetscCall(MatDataPCArrayCreate(fs->DA_XY,  &mdpc->etaxy));
+		PetscCall(MatDataPCArrayCreate(fs->DA_XZ,  &mdpc->etaxz));
+		PetscCall(MatDataPCArrayCreate(fs->DA_YZ,  &mdpc->etayz));
+	}
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 PetscErrorCode MatDataPCDestroy(MatDataPC *mdpc)
 {
+	FDSTAG *fs;
+
 	
 	PetscFunctionBeginUser;
 
+	fs = mdpc->md->fs;
+
 	PetscCall(VecDestroy(&mdpc->D));
 
+	if(mdpc->sprec)
+	{
+		PetscCall(MatDataPCArrayDestroy(fs->DA_CEN, &mdpc->Kb));
+		PetscCall(MatDataPCArrayDestroy(fs->DA_CEN, &mdpc->rho));
+		PetscCall(MatDataPCArrayDestroy(fs->DA_CEN, &mdpc->eta));
+		PetscCall(MatDataPCArrayDestroy(fs->DA_XY,  &mdpc->etaxy));
+		PetscCall(MatDataPCArrayDestroy(fs->DA_XZ,  &mdpc->etaxz));
+		PetscCall(MatDataPCArrayDestroy(fs->DA_YZ,  &mdpc->etayz));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatDataPCUpdate(MatDataPC *mdpc)
+{
+	MatData *md;
+	FDSTAG  *fs;
+
+	
+	PetscFunctionBeginUser;
+
+	if(!mdpc->sprec) PetscFunctionReturn(0);
+
+	md = mdpc->md;
+	fs = md->fs;
+
+	PetscCall(MatDataPCArrayCopy(fs->DA_CEN, md->Kb,    mdpc->Kb));
+	PetscCall(MatDataPCArrayCopy(fs->DA_CEN, md->rho,   mdpc->rho));
+	PetscCall(MatDataPCArrayCopy(fs->DA_CEN, md->eta,   mdpc->eta));
+	PetscCall(MatDataPCArrayCopy(fs->DA_XY,  md->etaxy, mdpc->etaxy));
+	PetscCall(MatDataPCArrayCopy(fs->DA_XZ,  md->etaxz, mdpc->etaxz));
+	PetscCall(MatDataPCArrayCopy(fs->DA_YZ,  md->etayz, mdpc->etayz));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatDataPCArrayCreate(DM da, float ****a)
+{
+	// allocate array of owned points, accessed as a[k][j][i] with global indices
+	// (plane & row pointers are stored in front of the data)
+
+	PetscInt   j, k, sx, sy, sz, nx, ny, nz;
+	size_t     sz_planes, sz_rows;
+	char      *buff;
+	float   ***planes, **rows, *data;
+
+	
+	PetscFunctionBeginUser;
+
+	PetscCall(DMDAGetCorners(da, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	sz_planes = sizeof(float**)*(size_t)nz;
+	sz_rows   = sizeof(float*) *(size_t)(nz*ny);
+
+	PetscCall(PetscMalloc(sz_planes + sz_rows + sizeof(float)*(size_t)(nz*ny*nx), &buff));
+
+	planes = (float***)buff;
+	rows   = (float**) (buff + sz_planes);
+	data   = (float*)  (buff + sz_planes + sz_rows);
+
+	for(k = 0; k < nz; k++)
+	{
+		for(j = 0; j < ny; j++)
+		{
+			rows[k*ny + j] = data + (k*ny + j)*nx - sx;
+		}
+
+		planes[k] = rows + k*ny - sy;
+	}
+
+	(*a) = planes - sz;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatDataPCArrayDestroy(DM da, float ****a)
+{
+	PetscInt  sz;
+	char     *buff;
+
+	
+	PetscFunctionBeginUser;
+
+	if(!(*a)) PetscFunctionReturn(0);
+
+	PetscCall(DMDAGetCorners(da, NULL, NULL, &sz, NULL, NULL, NULL));
+
+	buff = (char*)((*a) + sz);
+
+	PetscCall(PetscFree(buff));
+
+	(*a) = NULL;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MatDataPCArrayCopy(DM da, Vec v, float ***a)
+{
+	// copy owned points of DMDA vector (global or local)
+
+	PetscInt      i, j, k, sx, sy, sz, nx, ny, nz;
+	PetscScalar ***va;
+
+	
+	PetscFunctionBeginUser;
+
+	PetscCall(DMDAGetCorners(da, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	PetscCall(DMDAVecGetArray(da, v, &va));
+
+	START_STD_LOOP
+	{
+		a[k][j][i] = (float)va[k][j][i];
+	}
+	END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(da, v, &va));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
 // MG -functions
 //---------------------------------------------------------------------------
-PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A)
+PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A, PetscInt ptan, PetscInt sprec, PetscInt aggmg)
 {
+	KSP      ksp;
+	PC       pc;
 	PetscInt i;
 	MGLevel  *fine;
+	MPI_Comm comm;
 
 	
 	PetscFunctionBeginUser;
@@ -258,6 +412,12 @@ PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A)
 	// clear object
 	PetscCall(PetscMemzero(mg, sizeof(MG)));
 
+	// set single precision operators flag
+	mg->sprec = sprec;
+
+	// set agglomerated hierarchy flag
+	mg->aggmg = aggmg;
+
 	// check multigrid mesh restrictions & get actual number of levels
 	PetscCall(MGGetNumLevels(mg, md));
 
@@ -277,19 +437,68 @@ PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A)
 	{
 		PetscCall(MGLevelCreate(&mg->lvls[i], fine, md, A));
 
+		// create tangent storage on rediscretized coarse levels
+		if(fine && i < ptan && fine->md->newton && mg->lvls[i].type != _LVL_GALERKIN_)
+		{
+			PetscCall(MatDataCoarsenNewton(mg->lvls[i].md, fine->md));
+		}
+
 		fine = &mg->lvls[i];
 	}
 
 	// create Galerkin multigrid preconditioner
-	PetscCall(PCCreate(PETSC_COMM_WORLD, &mg->pc));
-	PetscCall(PCSetOptionsPrefix(mg->pc, "gmg_"));
+	PetscCall(PetscObjectGetComm((PetscObject)md->fs->DA_CEN, &comm));
+
+	PetscCall(PCCreate(comm, &mg->pc));
+
+	if(mg->aggmg) { PetscCall(PCSetOptionsPrefix(mg->pc, "gmg_agg_")); }
+	else          { PetscCall(PCSetOptionsPrefix(mg->pc, "gmg_"));     }
 	PetscCall(PCSetType(mg->pc, PCMG));
 	PetscCall(PCMGSetLevels(mg->pc, mg->nlvl, NULL));
 	PetscCall(PCMGSetType(mg->pc, PC_MG_MULTIPLICATIVE));
 	PetscCall(PCMGSetCycleType(mg->pc, PC_MG_CYCLE_V));
+
+	// set default smoothers on matrix-free levels (Chebyshev with Jacobi)
+	for(i = 0; i < mg->nlmf; i++)
+	{
+		PetscCall(PCMGGetSmoother(mg->pc, mg->nlvl-1-i, &ksp));
+		PetscCall(KSPSetType(ksp, KSPCHEBYSHEV));
+		PetscCall(KSPGetPC(ksp, &pc));
+		PetscCall(PCSetType(pc, PCJACOBI));
+	}
+
 	PetscCall(PCSetFromOptions(mg->pc));
 	PetscCall(PCMGSetGalerkin(mg->pc, PC_MG_GALERKIN_NONE));
 
+	// pass single precision operator to fine level smoother
+	if(mg->sprec)
+	{
+		PetscCall(PCSetUseAmat(mg->pc, PETSC_TRUE));
+	}
+
+	// time level solves (agglomerated levels are included in coarse level time)
+	if(!mg->aggmg)
+	{
+		PetscCall(PerfAttachMG(mg->pc, mg->nlvl));
+	}
+
+	// replace coarse solver with agglomerated multigrid
+	if(mg->aggf[0]*mg->aggf[1]*mg->aggf[2] > 1)
+	{
+		PetscCall(PetscMalloc(sizeof(MGAgg), &mg->agg));
+		PetscCall(PetscMemzero(mg->agg, sizeof(MGAgg)));
+
+		PetscCall(MGAggCreate(mg->agg, &mg->lvls[mg->nlvl-1], mg->aggf));
+
+		PetscCall(PCMGGetCoarseSolve(mg->pc, &ksp));
+		PetscCall(KSPSetType(ksp, KSPPREONLY));
+		PetscCall(KSPGetPC(ksp, &pc));
+		PetscCall(PCSetType(pc, PCSHELL));
+		PetscCall(PCShellSetContext(pc, (void*)mg->agg));
+		PetscCall(PCShellSetApply(pc, MGAggApply));
+		PetscCall(PCShellSetName(pc, "agglomerated multigrid"));
+	}
+
 	// set coarse solver setup flag
 	mg->crs_setup = 0;
 
@@ -300,6 +509,7 @@ PetscErrorCode MGDestroy(MG *mg)
 {
 	PetscInt  i;
 	PetscBool flg;
+	MPI_Comm  comm;
 
 	
 	PetscFunctionBeginUser;
@@ -309,7 +519,15 @@ PetscErrorCode MGDestroy(MG *mg)
 
 	if(flg == PETSC_TRUE)
 	{
-		PetscCall(PCView(mg->pc, PETSC_VIEWER_STDOUT_WORLD));
+		PetscCall(PetscObjectGetComm((PetscObject)mg->pc, &comm));
+
+		PetscCall(PCView(mg->pc, PETSC_VIEWER_STDOUT_(comm)));
+	}
+
+	if(mg->agg)
+	{
+		PetscCall(MGAggDestroy(mg->agg));
+		PetscCall(PetscFree   (mg->agg));
 	}
 
 	for(i = 0; i < mg->nlvl; i++)
@@ -319,6 +537,8 @@ PetscErrorCode MGDestroy(MG *mg)
 
 	PetscCall(PetscFree(mg->lvls));
 
+	PetscCall(PetscBTDestroy(&mg->bcmask));
+
 	PetscCall(PCDestroy(&mg->pc));
 
 	PetscFunctionReturn(0);
@@ -328,35 +548,63 @@ PetscErrorCode MGSetup(MG *mg)
 {
 	KSP      ksp;
 	MGLevel *lvl, *fine;
-	PetscInt i, petsc_mg_level;
+	PetscInt i, petsc_mg_level, bc_changed, rebuild;
 
 	
 	PetscFunctionBeginUser;
 
+	// agglomerated hierarchy is set up within the setup of parent hierarchy
+	if(!mg->aggmg) { PetscCall(PerfBegin(_PERF_MG_SETUP_)); }
+
+	// check whether restriction & prolongation stencils are still valid
+	PetscCall(MGCheckBCMask(mg, &bc_changed));
+
+	// check whether coarse operators can be reused (lagged)
+	if(bc_changed || mg->tangent != mg->lvls[0].md->tangent || mg->lagcnt >= mg->lag)
+	{
+		rebuild     = 1;
+		mg->lagcnt  = 0;
+		mg->tangent = mg->lvls[0].md->tangent;
+	}
+	else
+	{
+		rebuild = 0;
+		mg->lagcnt++;
+	}
+
 	for(i = 0, petsc_mg_level = mg->nlvl-1; i < mg->nlvl; i++, petsc_mg_level--)
 	{
 		lvl = &mg->lvls[i];
 
+		// coarse operators are lagged (matrix-free levels and external operator are always updated)
+		if(!rebuild && lvl->type != _LVL_MAT_FREE_ && !lvl->ext_op) break;
+
 		// setup interpolation operators
 		if(i > 0)
 		{
 			fine = &mg->lvls[i-1];
 
-			// restrict evaluation context
-			PetscCall(MatDataRestrict(lvl->md, fine->md, mg->MG2D));
+			if(lvl->type != _LVL_GALERKIN_ || bc_changed)
+			{
+				// restrict evaluation context
+				PetscCall(MatDataRestrict(lvl->md, fine->md, mg->MG2D));
+			}
 
 			if(lvl->type == _LVL_GALERKIN_)
 			{
-				// assemble restriction and prolongation matrices
-				if(mg->MG2D)
-				{
-					PetscCall(MGLevelSetupRestrict2D(lvl, fine));
-					PetscCall(MGLevelSetupProlong2D (lvl, fine));
-				}
-				else
+				// assemble restriction and prolongation matrices (depend on boundary condition mask only)
+				if(bc_changed)
 				{
-					PetscCall(MGLevelSetupRestrict3D(lvl, fine));
-					PetscCall(MGLevelSetupProlong3D (lvl, fine));
+					if(mg->MG2D)
+					{
+						PetscCall(MGLevelSetupRestrict2D(lvl, fine));
+						PetscCall(MGLevelSetupProlong2D (lvl, fine));
+					}
+					else
+					{
+						PetscCall(MGLevelSetupRestrict3D(lvl, fine));
+						PetscCall(MGLevelSetupProlong3D (lvl, fine));
+					}
 				}
 
 				// compute coarse grid operator
@@ -379,6 +627,9 @@ PetscErrorCode MGSetup(MG *mg)
 		{
 			// compute matrix diagonal on matrix-free levels
 			PetscCall(MatFreeComputeDiagonal(lvl->md, lvl->mdpc->D));
+
+			// update single precision parameters
+			PetscCall(MatDataPCUpdate(lvl->mdpc));
 		}
 		else if(lvl->type == _LVL_ASSEMBLED_ && !lvl->ext_op)
 		{
@@ -395,13 +646,35 @@ PetscErrorCode MGSetup(MG *mg)
 			mg->crs_setup = PETSC_TRUE;
 		}
 
-		// set operators in PCMG
+		// update single precision copy of assembled operator (except coarsest level)
+		if(mg->sprec && lvl->type != _LVL_MAT_FREE_ && i != mg->nlvl-1)
+		{
+			if(!lvl->S)
+			{
+				PetscCall(MatSingleCreate(lvl->A, &lvl->S));
+			}
+
+			PetscCall(MatSingleUpdate(lvl->S));
+		}
+
+		// set operators in PCMG (single precision copy is used by smoother & residual)
 		PetscCall(PCMGGetSmoother(mg->pc, petsc_mg_level, &ksp));
-		PetscCall(KSPSetOperators(ksp,lvl->A, lvl->A));
+
+		if(lvl->S) { PetscCall(KSPSetOperators(ksp, lvl->S, lvl->A)); }
+		else       { PetscCall(KSPSetOperators(ksp, lvl->A, lvl->A)); }
+	}
+
+	// redistribute coarse operator & setup agglomerated multigrid
+	if(mg->agg && rebuild)
+	{
+		PetscCall(MGAggSetup(mg->agg, &mg->lvls[mg->nlvl-1], bc_changed));
 	}
 
-	// set top-level operators
-	PetscCall(PCSetOperators(mg->pc, mg->lvls[0].A, mg->lvls[0].A));
+	// set top-level operators (otherwise PCMG resets fine level smoother operators)
+	if(mg->lvls[0].S) { PetscCall(PCSetOperators(mg->pc, mg->lvls[0].S, mg->lvls[0].A)); }
+	else              { PetscCall(PCSetOperators(mg->pc, mg->lvls[0].A, mg->lvls[0].A)); }
+
+	if(!mg->aggmg) { PetscCall(PerfEnd(_PERF_MG_SETUP_)); }
 
 	PetscFunctionReturn(0);
 }
@@ -415,9 +688,13 @@ PetscErrorCode MGApply(PC pc, Vec x, Vec y)
 
 	PetscCall(PCShellGetContext(pc, (void**)&mg));
 
+	PetscCall(PerfBegin(_PERF_MG_APPLY_));
+
 	// apply multigrid preconditioner
 	PetscCall(PCApply(mg->pc, x, y));
 
+	PetscCall(PerfEnd(_PERF_MG_APPLY_));
+
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -426,8 +703,9 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 	// check multigrid mesh restrictions, get actual number of coarsening steps
 
 	FDSTAG   *fs;
-	PetscBool opt_set;
-	PetscInt  nx, ny, nz, Nx, Ny, Nz, ncors, nlevels, nlmf;
+	PetscBool opt_set, mf_set, redisc, sprec;
+	PetscInt  nx, ny, nz, Nx, Ny, Nz, ncors, nlevels, nlmf, lag, ncells, nagg, nalvl, f[3];
+	MPI_Comm  comm;
 
 	
 	PetscFunctionBeginUser;
@@ -440,6 +718,34 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 	// set 2D coarsening flag
 	PetscCall(FDSTAGCheckMG2D(fs, mg->MG2D));
 
+	if(mg->aggmg)
+	{
+		// hierarchy on agglomerated grid (top level is redistributed coarse operator)
+		// number of levels is checked by parent hierarchy
+		nlevels = ncors + 1;
+
+		PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_agg_pc_mg_levels", &nlevels, NULL));
+
+		// get coarse grid size
+		PetscCall(FDSTAGGetCoarseGridSize(fs, nlevels, nx, ny, nz, Nx, Ny, Nz));
+
+		// print grid statistics
+		PetscCall(PetscObjectGetComm((PetscObject)fs->DA_CEN, &comm));
+
+		PetscPrintf(comm, "Agglomerated multigrid: \n");
+		PetscPrintf(comm, "   Number of cpu                 :  %lld\n", (LLD)(fs->dsx.nproc*fs->dsy.nproc*fs->dsz.nproc));
+		PetscPrintf(comm, "   Global coarse grid [Nx,Ny,Nz] : [%lld, %lld, %lld]\n", (LLD)Nx, (LLD)Ny, (LLD)Nz);
+		PetscPrintf(comm, "   Local coarse grid  [nx,ny,nz] : [%lld, %lld, %lld]\n", (LLD)nx, (LLD)ny, (LLD)nz);
+		PetscPrintf(comm, "   Number of multigrid levels    :  %lld\n", (LLD)nlevels);
+		PetscPrintf(comm, "--------------------------------------------------------------------------\n");
+
+		mg->nlvl = nlevels;
+		mg->nlmf = 0;
+		mg->lag  = 0;
+
+		PetscFunctionReturn(0);
+	}
+
 	// check number of levels requested on the command line
 	PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_pc_mg_levels", &nlevels, &opt_set));
 
@@ -453,13 +759,13 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 	}
 
 	// check number of matrix-free levels requested on the command line
-	PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_mat_free_levels", &nlmf, &opt_set));
+	PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_mat_free_levels", &nlmf, &mf_set));
 
-	if(opt_set == PETSC_TRUE)
+	if(mf_set == PETSC_TRUE)
 	{
-		if(nlmf > nlevels-2)
+		if(nlmf > nlevels-1)
 		{
-			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect # of matrix-free levels specified. Requested: %lld. Max. possible: %lld", (LLD)nlmf, (LLD)(nlevels-2));
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect # of matrix-free levels specified. Requested: %lld. Max. possible: %lld", (LLD)nlmf, (LLD)(nlevels-1));
 		}
 	}
 	else
@@ -467,6 +773,29 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 		nlmf = 0;
 	}
 
+	// check number of setups that reuse coarse operators
+	lag = 0;
+
+	PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_coarse_lag", &lag, NULL));
+
+	if(lag < 0)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect coarse operator lag specified: %lld", (LLD)lag);
+	}
+
+	// check rediscretized coarse operators (all levels except coarsest are matrix-free)
+	PetscCall(PetscOptionsHasName(NULL, NULL, "-gmg_rediscretize", &redisc));
+
+	if(redisc == PETSC_TRUE)
+	{
+		if(mf_set == PETSC_TRUE && nlmf != nlevels-1)
+		{
+			SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Option -gmg_rediscretize requires all levels except coarsest to be matrix-free, remove -gmg_mat_free_levels or set it to %lld", (LLD)(nlevels-1));
+		}
+
+		nlmf = nlevels-1;
+	}
+
 	if(nlmf && md->idxmod == _IDX_BLOCK_)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Matrix-free multigrid is not supported for block matrices (-gmg_mat_free_levels -jp_type)");
@@ -477,6 +806,14 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Matrix-free multigrid is not supported for 2D grids (-gmg_mat_free_levels)");
 	}
 
+	// check single precision parameters of matrix-free levels
+	PetscCall(PetscOptionsHasName(NULL, NULL, "-gmg_mat_free_single", &sprec));
+
+	if(nlmf && sprec && !md->rowkern)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Single precision matrix-free parameters require branch-free row kernels (-gmg_mat_free_single -mat_free_row_kernels)");
+	}
+
 	// get coarse grid size
 	PetscCall(FDSTAGGetCoarseGridSize(fs, nlevels, nx, ny, nz, Nx, Ny, Nz));
 
@@ -485,12 +822,610 @@ PetscErrorCode MGGetNumLevels(MG *mg, MatData *md)
 	PetscPrintf(PETSC_COMM_WORLD, "   Local coarse grid  [nx,ny,nz] : [%lld, %lld, %lld]\n", (LLD)nx, (LLD)ny, (LLD)nz);
 	PetscPrintf(PETSC_COMM_WORLD, "   Number of multigrid levels    :  %lld\n", (LLD)nlevels);
 	PetscPrintf(PETSC_COMM_WORLD, "   Number of matrix-free levels  :  %lld\n", (LLD)nlmf);
+	if(nlmf == nlevels-1)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Coarse grid operators         :  rediscretized\n");
+	}
+	if(lag)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Coarse operator lag           :  %lld\n", (LLD)lag);
+	}
+	if(nlmf && sprec)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Matrix-free parameters        :  single precision\n");
+	}
+	if(mg->sprec)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Assembled level operators     :  single precision\n");
+	}
+
+	// check agglomeration of coarse grid on fewer processors
+	ncells = 0;
+
+	PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_agg_cells_per_cpu", &ncells, NULL));
+
+	if(ncells > 0)
+	{
+		// get processor reduction factors & number of coarsening steps on agglomerated grid
+		PetscCall(FDSTAGGetAggGrid(fs, nlevels, ncells, f, nagg));
+
+		if(nagg)
+		{
+			// check number of agglomerated levels requested on the command line
+			PetscCall(PetscOptionsGetInt(NULL, NULL, "-gmg_agg_pc_mg_levels", &nalvl, &opt_set));
+
+			if(opt_set == PETSC_TRUE && (nalvl < 2 || nalvl > nagg + 1))
+			{
+				SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect # of agglomerated multigrid levels specified. Requested: %lld. Max. possible: %lld", (LLD)nalvl, (LLD)(nagg+1));
+			}
+
+			mg->aggf[0] = f[0];
+			mg->aggf[1] = f[1];
+			mg->aggf[2] = f[2];
+
+			PetscPrintf(PETSC_COMM_WORLD, "   Coarse grid agglomeration     : [%lld, %lld, %lld] (%lld cpu)\n",
+				(LLD)f[0], (LLD)f[1], (LLD)f[2], (LLD)(fs->dsx.nproc*fs->dsy.nproc*fs->dsz.nproc/(f[0]*f[1]*f[2])));
+		}
+		else
+		{
+			PetscPrintf(PETSC_COMM_WORLD, "   Coarse grid agglomeration     :  not possible\n");
+		}
+	}
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
 	// store number of levels
 	mg->nlvl = nlevels;
 	mg->nlmf = nlmf;
+	mg->lag  = lag;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGCheckBCMask(MG *mg, PetscInt *changed)
+{
+	// check whether boundary condition mask of the fine grid has changed
+	// (restriction & prolongation stencils depend on constrained DOF only)
+
+	MatData     *md;
+	Vec          bc[4];
+	PetscScalar *a;
+	PetscInt     i, j, k, n, ntot, flag;
+	PetscBool    cur;
+	MPI_Comm     comm;
+
+	PetscFunctionBeginUser;
+
+	md = mg->lvls[0].md;
+
+	bc[0] = md->bcvx;
+	bc[1] = md->bcvy;
+	bc[2] = md->bcvz;
+	bc[3] = md->bcp;
+
+	// allocate mask storage on first call
+	if(!mg->bcset)
+	{
+		ntot = 0;
+
+		for(i = 0; i < 4; i++)
+		{
+			PetscCall(VecGetLocalSize(bc[i], &n));
+
+			ntot += n;
+		}
+
+		PetscCall(PetscBTCreate(ntot, &mg->bcmask));
+	}
+
+	// compare positions of constrained DOF with stored mask, update mask
+	flag = !mg->bcset;
+
+	for(i = 0, k = 0; i < 4; i++)
+	{
+		PetscCall(VecGetLocalSize(bc[i], &n));
+		PetscCall(VecGetArray(bc[i], &a));
+
+		for(j = 0; j < n; j++, k++)
+		{
+			cur = (a[j] != DBL_MAX) ? PETSC_TRUE : PETSC_FALSE;
+
+			if(cur != (PetscBTLookup(mg->bcmask, k) ? PETSC_TRUE : PETSC_FALSE))
+			{
+				flag = 1;
+
+				if(cur) PetscCall(PetscBTSet  (mg->bcmask, k));
+				else    PetscCall(PetscBTClear(mg->bcmask, k));
+			}
+		}
+
+		PetscCall(VecRestoreArray(bc[i], &a));
+	}
+
+	PetscCall(PetscObjectGetComm((PetscObject)mg->pc, &comm));
+
+	PetscCallMPI(MPI_Allreduce(MPI_IN_PLACE, &flag, 1, MPIU_INT, MPI_MAX, comm));
+
+	mg->bcset = 1;
+
+	(*changed) = flag;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+// MGAgg functions
+//---------------------------------------------------------------------------
+static void getAggNumPoints(PetscInt r, PetscInt P[], PetscInt n[], PetscInt periodic, PetscInt e[], PetscInt nd[])
+{
+	// get number of X, Y, Z & P points owned by agglomerated processor
+	// (boundary nodes are owned by the last processor in the direction)
+
+	PetscInt rx, ry, rz;
+
+	getLocalRank(&rx, &ry, &rz, (PetscMPIInt)r, P[0], P[1]);
+
+	e[0] = (rx == P[0]-1 && !periodic);
+	e[1] = (ry == P[1]-1);
+	e[2] = (rz == P[2]-1);
+
+	nd[0] = (n[0]+e[0])*n[1]*n[2];
+	nd[1] = n[0]*(n[1]+e[1])*n[2];
+	nd[2] = n[0]*n[1]*(n[2]+e[2]);
+	nd[3] = n[0]*n[1]*n[2];
+}
+//---------------------------------------------------------------------------
+static PetscInt getAggPointIndex(
+	PetscInt i, PetscInt j, PetscInt k, PetscInt t,
+	PetscInt P[], PetscInt n[], PetscInt periodic, PetscInt *r)
+{
+	// get agglomerated processor & local index of a grid point
+	// t - point type (0-2 - X, Y, Z faces, 3 - cells)
+
+	PetscInt l, b[3], e[3], m[3], nd[4], pos;
+
+	b[0] = i/n[0];
+	b[1] = j/n[1];
+	b[2] = k/n[2];
+
+	// last face node belongs to the last processor
+	if(t < 3 && b[t] == P[t]) b[t]--;
+
+	(*r) = b[0] + P[0]*(b[1] + P[1]*b[2]);
+
+	getAggNumPoints((*r), P, n, periodic, e, nd);
+
+	m[0] = n[0];
+	m[1] = n[1];
+
+	if(t < 2) m[t] += e[t];
+
+	pos = (i - b[0]*n[0]) + m[0]*((j - b[1]*n[1]) + m[1]*(k - b[2]*n[2]));
+
+	for(l = 0; l < t; l++) pos += nd[l];
+
+	return pos;
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGAggCreate(MGAgg *agg, MGLevel *lvl, PetscInt f[])
+{
+	// create agglomerated coarse grid solver for the coarsest level
+
+	MatData     *md;
+	FDSTAG      *fs;
+	DOFIndex    *dof;
+	Vec          v;
+	IS           is;
+	PetscMPIInt  color, key;
+	PetscInt     i, j, k, l, nx, ny, nz, sx, sy, sz, r, pos;
+	PetscInt     active, nagg, lnd, lnda, lna, start, cnt, vcnt;
+	PetscInt     P[3], n[3], e[3], nd[4];
+	PetscInt    *cst, *vst, *idx, *vidx, *didx;
+
+	PetscFunctionBeginUser;
+
+	md  = lvl->md;
+	fs  = md->fs;
+	dof = &fs->dof;
+
+	agg->comm = MPI_COMM_NULL;
+	agg->f[0] = f[0];
+	agg->f[1] = f[1];
+	agg->f[2] = f[2];
+
+	// agglomerated processor grid & local number of cells (uniform on all processors)
+	P[0] = fs->dsx.nproc/f[0];   n[0] = fs->dsx.ncels*f[0];
+	P[1] = fs->dsy.nproc/f[1];   n[1] = fs->dsy.ncels*f[1];
+	P[2] = fs->dsz.nproc/f[2];   n[2] = fs->dsz.ncels*f[2];
+
+	// create sub-communicator (rank ordering follows agglomerated processor grid)
+	active = !(fs->dsx.rank % f[0]) && !(fs->dsy.rank % f[1]) && !(fs->dsz.rank % f[2]);
+
+	if(active) color = 0;
+	else       color = MPI_UNDEFINED;
+
+	key = (PetscMPIInt)(fs->dsx.rank/f[0] + P[0]*(fs->dsy.rank/f[1] + P[1]*(fs->dsz.rank/f[2])));
+
+	PetscCallMPI(MPI_Comm_split(PETSC_COMM_WORLD, color, key, &agg->comm));
+
+	// create agglomerated evaluation context
+	lna  = 0;
+	lnda = 0;
+
+	if(active)
+	{
+		PetscCall(PetscMalloc(sizeof(MatData), &agg->md));
+		PetscCall(PetscMemzero(agg->md, sizeof(MatData)));
+
+		PetscCall(MatDataAgglomerate(agg->md, md, agg->comm, f));
+
+		lna = agg->md->fs->dof.ln;
+
+		if     (md->idxmod == _IDX_COUPLED_) { lnda = agg->md->fs->dof.ln;  }
+		else if(md->idxmod == _IDX_BLOCK_)   { lnda = agg->md->fs->dof.lnv; }
+	}
+
+	// compute starting indices of agglomerated processors (coupled & velocity layouts)
+	// global ordering of active processors coincides with agglomerated processor grid
+	nagg = P[0]*P[1]*P[2];
+
+	PetscCall(makeIntArray(&cst, NULL, nagg));
+	PetscCall(makeIntArray(&vst, NULL, nagg));
+
+	for(r = 0, cnt = 0, vcnt = 0; r < nagg; r++)
+	{
+		getAggNumPoints(r, P, n, fs->periodic, e, nd);
+
+		cst[r] = cnt;  cnt  += nd[0] + nd[1] + nd[2] + nd[3];
+		vst[r] = vcnt; vcnt += nd[0] + nd[1] + nd[2];
+	}
+
+	// compute agglomerated global indices of local points (parent ordering)
+	PetscCall(makeIntArray(&idx,  NULL, dof->ln));
+	PetscCall(makeIntArray(&vidx, NULL, dof->lnv));
+
+	l = 0;
+
+	//---------
+	// X-points
+	//---------
+	PetscCall(DMDAGetCorners(fs->DA_X, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		pos = getAggPointIndex(i, j, k, 0, P, n, fs->periodic, &r);
+
+		idx[l] = cst[r] + pos; vidx[l] = vst[r] + pos; l++;
+	}
+	END_STD_LOOP
+
+	//---------
+	// Y-points
+	//---------
+	PetscCall(DMDAGetCorners(fs->DA_Y, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		pos = getAggPointIndex(i, j, k, 1, P, n, fs->periodic, &r);
+
+		idx[l] = cst[r] + pos; vidx[l] = vst[r] + pos; l++;
+	}
+	END_STD_LOOP
+
+	//---------
+	// Z-points
+	//---------
+	PetscCall(DMDAGetCorners(fs->DA_Z, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		pos = getAggPointIndex(i, j, k, 2, P, n, fs->periodic, &r);
+
+		idx[l] = cst[r] + pos; vidx[l] = vst[r] + pos; l++;
+	}
+	END_STD_LOOP
+
+	//---------
+	// P-points
+	//---------
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP
+	{
+		pos = getAggPointIndex(i, j, k, 3, P, n, fs->periodic, &r);
+
+		idx[l] = cst[r] + pos; l++;
+	}
+	END_STD_LOOP
+
+	// select layout of the linear system
+	lnd   = 0;
+	start = 0;
+	didx  = NULL;
+
+	if     (md->idxmod == _IDX_COUPLED_) { lnd = dof->ln;  start = dof->st;  didx = idx;  }
+	else if(md->idxmod == _IDX_BLOCK_)   { lnd = dof->lnv; start = dof->stv; didx = vidx; }
+
+	// boundary condition scatter (all DOF)
+	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, dof->ln, PETSC_DETERMINE, &agg->dc));
+	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, lna,     PETSC_DETERMINE, &agg->da));
+
+	PetscCall(ISCreateGeneral(PETSC_COMM_WORLD, dof->ln, idx, PETSC_USE_POINTER, &is));
+	PetscCall(VecScatterCreate(agg->dc, NULL, agg->da, is, &agg->sbc));
+	PetscCall(ISDestroy(&is));
+
+	// linear system scatter
+	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, lnd,  PETSC_DETERMINE, &v));
+	PetscCall(VecCreateMPI(PETSC_COMM_WORLD, lnda, PETSC_DETERMINE, &agg->bp));
+	PetscCall(VecDuplicate(agg->bp, &agg->xp));
+
+	PetscCall(ISCreateGeneral(PETSC_COMM_WORLD, lnd, didx, PETSC_USE_POINTER, &is));
+	PetscCall(VecScatterCreate(v, NULL, agg->bp, is, &agg->sdof));
+	PetscCall(ISDestroy(&is));
+	PetscCall(VecDestroy(&v));
+
+	// permutation matrix (single unit entry per row)
+	PetscCall(MatAIJCreate(lnd, lnda, 1, NULL, 1, NULL, &agg->Pi));
+
+	for(i = 0; i < lnd; i++)
+	{
+		PetscCall(MatSetValue(agg->Pi, start + i, didx[i], 1.0, INSERT_VALUES));
+	}
+
+	PetscCall(MatAIJAssemble(agg->Pi, 0, NULL, 0.0));
+
+	// solution & right-hand side vectors on sub-communicator (arrays are placed during application)
+	if(active)
+	{
+		PetscCall(VecCreateMPIWithArray(agg->comm, 1, lnda, PETSC_DETERMINE, NULL, &agg->b));
+		PetscCall(VecCreateMPIWithArray(agg->comm, 1, lnda, PETSC_DETERMINE, NULL, &agg->x));
+	}
+
+	// clear temporary storage
+	PetscCall(PetscFree(cst));
+	PetscCall(PetscFree(vst));
+	PetscCall(PetscFree(idx));
+	PetscCall(PetscFree(vidx));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGAggDestroy(MGAgg *agg)
+{
+	PetscFunctionBeginUser;
+
+	// agglomerated hierarchy owns the evaluation context (top level is coarsened)
+	if(agg->mg)
+	{
+		PetscCall(MGDestroy(agg->mg));
+		PetscCall(PetscFree(agg->mg));
+	}
+	else if(agg->md)
+	{
+		PetscCall(MatDataDestroy(agg->md));
+		PetscCall(PetscFree     (agg->md));
+	}
+
+	PetscCall(MatDestroy(&agg->Pi));
+	PetscCall(MatDestroy(&agg->Ap));
+	PetscCall(MatDestroy(&agg->Al));
+	PetscCall(MatDestroy(&agg->A));
+
+	PetscCall(VecScatterDestroy(&agg->sdof));
+	PetscCall(VecScatterDestroy(&agg->sbc));
+
+	PetscCall(VecDestroy(&agg->dc));
+	PetscCall(VecDestroy(&agg->da));
+	PetscCall(VecDestroy(&agg->bp));
+	PetscCall(VecDestroy(&agg->xp));
+	PetscCall(VecDestroy(&agg->b));
+	PetscCall(VecDestroy(&agg->x));
+
+	if(agg->comm != MPI_COMM_NULL)
+	{
+		PetscCallMPI(MPI_Comm_free(&agg->comm));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGAggSetup(MGAgg *agg, MGLevel *lvl, PetscInt bc_changed)
+{
+	// redistribute coarse operator, boundary conditions & coordinates,
+	// setup agglomerated multigrid (collective on parent communicator)
+
+	MatReuse reuse;
+	PetscInt lnda;
+
+	PetscFunctionBeginUser;
+
+	if(agg->Ap) reuse = MAT_REUSE_MATRIX;
+	else        reuse = MAT_INITIAL_MATRIX;
+
+	// redistribute coarse operator (permutation Galerkin product)
+	PetscCall(MatPtAP(lvl->A, agg->Pi, reuse, PETSC_DETERMINE, &agg->Ap));
+
+	// redistribute boundary conditions & coordinates
+	if(bc_changed)
+	{
+		PetscCall(MGAggSetBC(agg, lvl->md));
+	}
+
+	PetscCall(FDSTAGAgglomerateCoord(agg->md ? agg->md->fs : NULL, lvl->md->fs));
+
+	// idle processors are done
+	if(!agg->md) PetscFunctionReturn(0);
+
+	// move local rows to sub-communicator
+	PetscCall(VecGetLocalSize(agg->bp, &lnda));
+
+	PetscCall(MatMPIAIJGetLocalMat(agg->Ap, reuse, &agg->Al));
+
+	PetscCall(MatCreateMPIMatConcatenateSeqMat(agg->comm, agg->Al, lnda, reuse, &agg->A));
+
+	agg->md->dt = lvl->md->dt;
+
+	// create agglomerated multigrid on first setup (requires operator)
+	if(!agg->mg)
+	{
+		PetscCall(PetscMalloc(sizeof(MG), &agg->mg));
+
+		PetscCall(MGCreate(agg->mg, agg->md, agg->A, 0, 0, 1));
+	}
+
+	PetscCall(MGSetup(agg->mg));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGAggSetBC(MGAgg *agg, MatData *md)
+{
+	// redistribute boundary condition vectors
+	// (restriction & prolongation on agglomerated grid only use constraint pattern)
+
+	FDSTAG      *fs;
+	PetscScalar *a, ***bcvx, ***bcvy, ***bcvz, ***bcp;
+	PetscInt     i, j, k, nx, ny, nz, sx, sy, sz, iter;
+	MatData     *mda;
+
+	PetscFunctionBeginUser;
+
+	//==========================================
+	// pack parent boundary conditions (DOF order)
+	//==========================================
+
+	fs = md->fs;
+
+	PetscCall(VecGetArray(agg->dc, &a));
+
+	PetscCall(DMDAVecGetArray(fs->DA_X,   md->bcvx, &bcvx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   md->bcvy, &bcvy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   md->bcvz, &bcvz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, md->bcp,  &bcp));
+
+	iter = 0;
+
+	PetscCall(DMDAGetCorners(fs->DA_X, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { a[iter++] = bcvx[k][j][i]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_Y, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { a[iter++] = bcvy[k][j][i]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_Z, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { a[iter++] = bcvz[k][j][i]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { a[iter++] = bcp[k][j][i]; } END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   md->bcvx, &bcvx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   md->bcvy, &bcvy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   md->bcvz, &bcvz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, md->bcp,  &bcp));
+
+	PetscCall(VecRestoreArray(agg->dc, &a));
+
+	//=============
+	// redistribute
+	//=============
+
+	PetscCall(VecScatterBegin(agg->sbc, agg->dc, agg->da, INSERT_VALUES, SCATTER_FORWARD));
+	PetscCall(VecScatterEnd  (agg->sbc, agg->dc, agg->da, INSERT_VALUES, SCATTER_FORWARD));
+
+	if(!agg->md) PetscFunctionReturn(0);
+
+	//==================================================
+	// unpack agglomerated boundary conditions (DOF order)
+	//==================================================
+
+	mda = agg->md;
+	fs  = mda->fs;
+
+	// boundary ghost points are unconstrained
+	PetscCall(VecSet(mda->bcvx, DBL_MAX));
+	PetscCall(VecSet(mda->bcvy, DBL_MAX));
+	PetscCall(VecSet(mda->bcvz, DBL_MAX));
+	PetscCall(VecSet(mda->bcp,  DBL_MAX));
+
+	PetscCall(VecGetArray(agg->da, &a));
+
+	PetscCall(DMDAVecGetArray(fs->DA_X,   mda->bcvx, &bcvx));
+	PetscCall(DMDAVecGetArray(fs->DA_Y,   mda->bcvy, &bcvy));
+	PetscCall(DMDAVecGetArray(fs->DA_Z,   mda->bcvz, &bcvz));
+	PetscCall(DMDAVecGetArray(fs->DA_CEN, mda->bcp,  &bcp));
+
+	iter = 0;
+
+	PetscCall(DMDAGetCorners(fs->DA_X, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { bcvx[k][j][i] = a[iter++]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_Y, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { bcvy[k][j][i] = a[iter++]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_Z, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { bcvz[k][j][i] = a[iter++]; } END_STD_LOOP
+
+	PetscCall(DMDAGetCorners(fs->DA_CEN, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	START_STD_LOOP { bcp[k][j][i] = a[iter++]; } END_STD_LOOP
+
+	PetscCall(DMDAVecRestoreArray(fs->DA_X,   mda->bcvx, &bcvx));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Y,   mda->bcvy, &bcvy));
+	PetscCall(DMDAVecRestoreArray(fs->DA_Z,   mda->bcvz, &bcvz));
+	PetscCall(DMDAVecRestoreArray(fs->DA_CEN, mda->bcp,  &bcp));
+
+	PetscCall(VecRestoreArray(agg->da, &a));
+
+	// exchange ghost point constraints
+	LOCAL_TO_LOCAL(fs->DA_X,   mda->bcvx)
+	LOCAL_TO_LOCAL(fs->DA_Y,   mda->bcvy)
+	LOCAL_TO_LOCAL(fs->DA_Z,   mda->bcvz)
+	LOCAL_TO_LOCAL(fs->DA_CEN, mda->bcp)
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode MGAggApply(PC pc, Vec b, Vec x)
+{
+	// apply agglomerated multigrid as a coarse solver
+
+	MGAgg             *agg;
+	const PetscScalar *ba;
+	PetscScalar       *xa;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(PCShellGetContext(pc, (void**)&agg));
+
+	// gather right-hand side on active processors
+	PetscCall(VecScatterBegin(agg->sdof, b, agg->bp, INSERT_VALUES, SCATTER_FORWARD));
+	PetscCall(VecScatterEnd  (agg->sdof, b, agg->bp, INSERT_VALUES, SCATTER_FORWARD));
+
+	if(agg->md)
+	{
+		PetscCall(VecGetArrayRead(agg->bp, &ba));
+		PetscCall(VecGetArray    (agg->xp, &xa));
+
+		PetscCall(VecPlaceArray(agg->b, ba));
+		PetscCall(VecPlaceArray(agg->x, xa));
+
+		PetscCall(PCApply(agg->mg->pc, agg->b, agg->x));
+
+		PetscCall(VecResetArray(agg->b));
+		PetscCall(VecResetArray(agg->x));
+
+		PetscCall(VecRestoreArrayRead(agg->bp, &ba));
+		PetscCall(VecRestoreArray    (agg->xp, &xa));
+	}
+
+	// scatter solution back to parent layout
+	PetscCall(VecScatterBegin(agg->sdof, agg->xp, x, INSERT_VALUES, SCATTER_REVERSE));
+	PetscCall(VecScatterEnd  (agg->sdof, agg->xp, x, INSERT_VALUES, SCATTER_REVERSE));
 
 	PetscFunctionReturn(0);
 }
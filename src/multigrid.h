@@ -49,8 +49,10 @@ PetscErrorCode MGInterpDestroy(MGInterp *mgi);
 
 struct MatDataPC
 {
-	MatData *md; // matrix evaluation context
-	Vec      D;  // diagonal of assembled preconditioner matrix
+	MatData  *md;    // matrix evaluation context
+	Vec       D;     // diagonal of assembled preconditioner matrix
+	PetscInt  sprec; // single precision parameters flag
+	float  ***Kb, ***rho, ***eta, ***etaxy, ***etaxz, ***etayz; // single precision parameters (owned points)
 };
 //---------------------------------------------------------------------------
 
@@ -58,6 +60,16 @@ PetscErrorCode MatDataPCCreate(MatDataPC *mdpc, MatData *md);
 
 PetscErrorCode MatDataPCDestroy(MatDataPC *mdpc);
 
+// convert parameters to single precision (if activated)
+PetscErrorCode MatDataPCUpdate(MatDataPC *mdpc);
+
+// allocate, free & fill single precision array with DMDA indexing
+PetscErrorCode MatDataPCArrayCreate(DM da, float ****a);
+
+PetscErrorCode MatDataPCArrayDestroy(DM da, float ****a);
+
+PetscErrorCode MatDataPCArrayCopy(DM da, Vec v, float ***a);
+
 //---------------------------------------------------------------------------
 
 // Galerkin multigrid level data structure
@@ -74,6 +86,7 @@ struct MGLevel
 	Mat         A;      // linear operator (matrix-free, assembled or generated by Galerkin coarsening)
 	//                     in any configuration there is only one assembled operator
 	//                     the rest is either matrix-free or Galerkin
+	Mat         S;      // single precision copy of assembled operator (smoothers & residuals)
 
 	// ******** fine level ************
 	//     |                   ^
@@ -119,6 +132,45 @@ void getRowProlong(
 
 //---------------------------------------------------------------------------
 
+struct MG;
+
+// Agglomerated coarse grid solver. The coarsest level operator is redistributed
+// onto a sub-communicator of processors with zero indices modulo reduction factors
+// (Galerkin product with permutation matrix), where geometric coarsening continues
+// with a separate multigrid hierarchy. Idle processors only take part in scatters
+// and in the redistribution product.
+
+struct MGAgg
+{
+	MPI_Comm    comm;     // sub-communicator (MPI_COMM_NULL on idle processors)
+	PetscInt    f[3];     // processor reduction factors
+	MatData    *md;       // agglomerated evaluation context (NULL on idle processors)
+	MG         *mg;       // agglomerated multigrid (NULL on idle processors)
+	Mat         Pi;       // permutation matrix (parent -> agglomerated layout)
+	Mat         Ap;       // redistributed operator (parent communicator)
+	Mat         Al;       // local rows of redistributed operator
+	Mat         A;        // agglomerated operator (sub-communicator)
+	VecScatter  sdof;     // DOF vector scatter (parent -> agglomerated layout)
+	VecScatter  sbc;      // boundary condition scatter (all DOF)
+	Vec         dc, da;   // packed boundary conditions (parent & agglomerated layout)
+	Vec         bp, xp;   // right-hand side & solution (agglomerated layout, parent communicator)
+	Vec         b,  x;    // right-hand side & solution (sub-communicator, arrays are placed)
+};
+
+//---------------------------------------------------------------------------
+
+PetscErrorCode MGAggCreate(MGAgg *agg, MGLevel *lvl, PetscInt f[]);
+
+PetscErrorCode MGAggDestroy(MGAgg *agg);
+
+PetscErrorCode MGAggSetup(MGAgg *agg, MGLevel *lvl, PetscInt bc_changed);
+
+PetscErrorCode MGAggSetBC(MGAgg *agg, MatData *md);
+
+PetscErrorCode MGAggApply(PC pc, Vec b, Vec x);
+
+//---------------------------------------------------------------------------
+
 struct MG
 {
 	// PETSc level numbering (inverse w.r.t. coarsening sequence):
@@ -139,11 +191,20 @@ struct MG
 	MGLevel  *lvls;      // multigrid levels
 	PetscInt  crs_setup; // coarse solver setup flag
 	PetscInt  MG2D;      // 2D multigrid flag
+	PetscInt  lag;       // number of setups that reuse coarse operators
+	PetscInt  lagcnt;    // number of setups since last coarse operator update
+	PetscInt  tangent;   // Newton tangent flag of last coarse operator update
+	PetscInt  bcset;     // boundary condition mask is set
+	PetscBT   bcmask;    // boundary condition mask of last setup (local)
+	PetscInt  sprec;     // single precision operators on assembled & Galerkin levels
+	PetscInt  aggf[3];   // processor reduction factors of agglomerated coarse grid
+	MGAgg    *agg;       // agglomerated coarse grid solver (NULL if not activated)
+	PetscInt  aggmg;     // hierarchy on agglomerated grid flag (no nested agglomeration)
 };
 
 //---------------------------------------------------------------------------
 
-PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A);
+PetscErrorCode MGCreate(MG *mg, MatData *md, Mat A, PetscInt ptan, PetscInt sprec = 0, PetscInt aggmg = 0);
 
 PetscErrorCode MGDestroy(MG *mg);
 
@@ -153,6 +214,8 @@ PetscErrorCode MGApply(PC pc, Vec x, Vec y);
 
 PetscErrorCode MGGetNumLevels(MG *mg, MatData *md);
 
+PetscErrorCode MGCheckBCMask(MG *mg, PetscInt *changed);
+
 //---------------------------------------------------------------------------
 
 // test codes
@@ -72,6 +72,14 @@ PetscErrorCode NLSolCreate(SNES *p_snes, JacRes *jr)
 	PetscCall(MatSetFromOptions(nl->MFFD));
 	PetscCall(MatSetUp(nl->MFFD));
 
+	// create matrix-free analytic Jacobian
+	PetscCall(MatDataCreate(&nl->md, jr, _IDX_COUPLED_));
+	PetscCall(MatDataCreateNewton(&nl->md, jr));
+	PetscCall(MatCreateShell(PETSC_COMM_WORLD, dof->ln, dof->ln,
+		PETSC_DETERMINE, PETSC_DETERMINE, (void*)&nl->md, &nl->NEWTON));
+	PetscCall(MatSetUp(nl->NEWTON));
+	PetscCall(MatShellSetOperation(nl->NEWTON, MATOP_MULT, (void(*)(void))MatFreeApplyNewton));
+
 	// setup nonlinear solver
 	PetscCall(SNESCreate(PETSC_COMM_WORLD, &snes));
 	PetscCall(SNESSetApplicationContext(snes, (void*)nl));
@@ -99,6 +107,7 @@ PetscErrorCode NLSolCreate(SNES *p_snes, JacRes *jr)
 	nl->minItPic = 5;
 	nl->rtolNwt  = 1.2;
 	nl->maxItNwt = 20;
+	nl->jnwt     = _MFFD_;
 
 	// override from command line
 	PetscCall(PetscOptionsGetScalar(NULL, NULL, "-snes_picard_rtol",  &nl->rtolPic,  NULL));
@@ -106,6 +115,10 @@ PetscErrorCode NLSolCreate(SNES *p_snes, JacRes *jr)
 	PetscCall(PetscOptionsGetScalar(NULL, NULL, "-snes_newton_rtol",  &nl->rtolNwt,  NULL));
 	PetscCall(PetscOptionsGetInt   (NULL, NULL, "-snes_newton_maxit", &nl->maxItNwt, NULL));
 
+	// use analytic Jacobian instead of finite difference
+	// (pressure dependence of the yield stress is not linearized)
+	PetscCall(PetscOptionsHasName(NULL, NULL, "-snes_newton_analytic", &flag)); if(flag) { nl->jnwt = _NEWTON_; }
+
 	// return solver
 	(*p_snes) = snes;
 
@@ -143,6 +156,8 @@ PetscErrorCode NLSolDestroy(SNES *p_snes)
 	PetscCall(MatDestroy(&P));
 	PetscCall(MatDestroy(&nl->MFFD));
 	PetscCall(MatDestroy(&nl->PICARD));
+	PetscCall(MatDestroy(&nl->NEWTON));
+	PetscCall(MatDataDestroy(&nl->md));
 	PetscCall(PCDataDestroy(&nl->pc));
 	PetscCall(PetscFree(nl));
 	PetscCall(SNESDestroy(p_snes));
@@ -173,7 +188,6 @@ PetscErrorCode FormResidual(SNES snes, Vec x, Vec f, void *ctx)
 //---------------------------------------------------------------------------
 PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 {
-	Vec         r;
 	NLSol       *nl;
 	JacRes      *jr;
 	PetscInt    it;
@@ -197,9 +211,9 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 	//========================
 
 	// get iteration counter and residual norm
+	// (reuse norm computed by SNES to avoid an extra global reduction)
 	PetscCall(SNESGetIterationNumber(snes, &it));
-	PetscCall(SNESGetFunction(snes, &r, NULL, NULL));
-	PetscCall(VecNorm(r, NORM_2, &nrm));
+	PetscCall(SNESGetFunctionNorm(snes, &nrm));
 
 	if(!nrm) nrm = 1.0;
 
@@ -216,11 +230,11 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 		// Picard case, check to switch to Newton (convergence)
 		if(nrm < nl->refRes*nl->rtolPic)
 		{
-			nl->jtype = _MFFD_;
+			nl->jtype = nl->jnwt;
 			nl->itNwt = 0;
 		}
 	}
-	else if(nl->jtype == _MFFD_)
+	else
 	{
 		// Newton case, check to switch to Picard (divergence)
 		if(nrm > nl->refRes*nl->rtolNwt || nl->itNwt > (nl->maxItNwt-1))
@@ -245,6 +259,11 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 		PetscPrintf(PETSC_COMM_WORLD,"%3lld MMFD   ||F||/||F0||=%e \n", (LLD)nl->it, nrm/nl->refRes);
 		nl->itNwt++;
 	}
+	else if(nl->jtype == _NEWTON_)
+	{
+		PetscPrintf(PETSC_COMM_WORLD,"%3lld NEWTON ||F||/||F0||=%e \n", (LLD)nl->it, nrm/nl->refRes);
+		nl->itNwt++;
+	}
 
 	// switch off pressure limit for plasticity after first iteration
 	if(!ctrl->initGuess && it > 1)
@@ -258,6 +277,10 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 	//=====================
 	// setup preconditioner
 	//=====================
+
+	// use partial Newton tangent in preconditioner together with Newton Jacobian
+	PetscCall(PCDataSetTangent(&nl->pc, nl->jtype != _PICARD_));
+
 	PetscCall(PCDataSetup(&nl->pc, jr));
 
 	// assembly preconditioner
@@ -290,6 +313,18 @@ PetscErrorCode FormJacobian(SNES snes, Vec x, Mat Amat, Mat Pmat, void *ctx)
 		// set MMFD operator
 		PetscCall(MatShellSetContext(Amat, (void*)&nl->MFFD));
 	}
+	else if(nl->jtype == _NEWTON_)
+	{
+		// update viscosities & derivatives of the last residual evaluation
+		PetscCall(MatDataSetup(&nl->md, jr));
+
+		// assembly analytic operator
+		PetscCall(MatAssemblyBegin(nl->NEWTON, MAT_FINAL_ASSEMBLY));
+		PetscCall(MatAssemblyEnd  (nl->NEWTON, MAT_FINAL_ASSEMBLY));
+
+		// set analytic operator
+		PetscCall(MatShellSetContext(Amat, (void*)&nl->NEWTON));
+	}
 
 	// assembly Jacobian
 	PetscCall(MatAssemblyBegin(Amat, MAT_FINAL_ASSEMBLY));
@@ -342,7 +377,7 @@ PetscErrorCode SNESCoupledTest(
 
 	PetscCall(SNESGetKSP(snes, &js_ksp));
 
-	// update absolute tolerances
+	// update absolute tolerances (use norm computed by SNES, no extra reduction)
 	PetscCall(SNESUpdateAbsTol(snes,    nl->snes_atol_auto,   nl->snes_ref_norm,   f, it));
 	PetscCall(KSPUpdateAbsTol (js_ksp,  nl->js_ksp_atol_auto, nl->js_ksp_ref_norm, f, it));
 
@@ -359,17 +394,18 @@ PetscErrorCode SNESCoupledTest(
 		PetscCall(JacResGetTempRes(jr, jr->ts->dt));
 		PetscCall(JacResGetTempMat(jr, jr->ts->dt));
 
-		// update absolute tolerance
-		PetscCall(VecNorm(jr->ge, NORM_2, &norm));
-		PetscCall(NLSolvePushNorm(nl->ts_ksp_ref_norm, jr->ts_ksp_ref_norm, norm));
-		PetscCall(KSPUpdateAbsTol(jr->tksp, nl->ts_ksp_atol_auto, nl->ts_ksp_ref_norm, norm, it));
+		// update absolute tolerance (norm is only required on first iteration)
+		if(nl->ts_ksp_atol_auto && !it)
+		{
+			PetscCall(VecNorm(jr->ge, NORM_2, &norm));
+			PetscCall(NLSolvePushNorm(nl->ts_ksp_ref_norm, jr->ts_ksp_ref_norm, norm));
+			PetscCall(KSPUpdateAbsTol(jr->tksp, nl->ts_ksp_atol_auto, nl->ts_ksp_ref_norm, norm, it));
+		}
 
 		// compute and apply temperature correction (not on first iteration)
 		if(it)
 		{
-			PetscCall(KSPSetOperators(jr->tksp, jr->Att, jr->Att));
-			PetscCall(KSPSetUp(jr->tksp));
-			PetscCall(KSPSolve(jr->tksp, jr->ge, jr->dT));
+			PetscCall(JacResSolveTemp(jr, jr->tksp, jr->ts->dt, it == 1));
 			PetscCall(JacResUpdateTemp(jr));
 		}
 	}
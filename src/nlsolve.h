@@ -17,7 +17,8 @@
 enum JacType
 {
 	_PICARD_, // constant effective coefficients approximation (viscosity, conductivity, stress)
-	_MFFD_    // built-in finite difference approximation
+	_MFFD_,   // built-in finite difference approximation
+	_NEWTON_  // matrix-free analytic Jacobian (viscosity derivatives)
 
 };
 //---------------------------------------------------------------------------
@@ -28,6 +29,9 @@ struct NLSol
 	PCData      pc;       // preconditioner context
 	Mat         MFFD;     // matrix-free finite difference Jacobian
 	Mat         PICARD;   // Picard Jacobian
+	Mat         NEWTON;   // matrix-free analytic Jacobian
+	MatData     md;       // analytic Jacobian evaluation context
+	JacType     jnwt;     // Jacobian type used in Newton iterations
 
 	PetscInt    it;       // iteration counter
 	PetscInt    itNwt;    // Newton iteration counter
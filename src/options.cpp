@@ -88,9 +88,15 @@ PetscErrorCode solverOptionsSetDefaults(FB *fb)
 	// LINEAR SOLVER
 	//==============
 
-	PetscCall(PetscOptionsInsertString(NULL, "-js_ksp_type fgmres"));
+	PetscCall(set_string_option("ksp_type", opt.krylov_type, "js"));
 	PetscCall(PetscOptionsInsertString(NULL, "-js_ksp_converged_reason"));
 
+	if(!strcmp(opt.krylov_type, "pipegcr"))
+	{
+		// store as many search directions as default fgmres restart
+		PetscCall(set_integer_option("ksp_pipegcr_mmax", 30, "js"));
+	}
+
 	if(opt.monitor_solvers)
 	{
 		PetscCall(PetscOptionsInsertString(NULL, "-js_ksp_monitor"));
@@ -149,6 +155,9 @@ PetscErrorCode solverOptionsSetDefaults(FB *fb)
 		PetscCall(FDSTAGGetLevelsLocalGridSize(fs, opt.num_mg_levels,
 				levels_num_local_cells, coarse_num_local_cells));
 
+		// select coarse grid agglomeration
+		PetscCall(get_agglomeration(opt, fs, coarse_num_local_cells));
+
 		// select coarse solve reduction factor
 		PetscCall(get_coarse_reduction_factor(opt, coarse_num_local_cells));
 
@@ -314,6 +323,7 @@ PetscErrorCode solverOptionsReadFromFile(FB *fb, SolOptDB &opt)
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "use_line_search",         &opt.use_line_search,         1, 1));
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "use_eisenstat_walker",    &opt.use_eisenstat_walker,    1, 1));
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "use_mat_free_jac",        &opt.use_mat_free_jac,        1, 1));
+		PetscCall(getStringParam(fb, _OPTIONAL_, "krylov_type",              opt.krylov_type,             "_none_"));
 		PetscCall(getStringParam(fb, _OPTIONAL_, "stokes_solver",            opt.stokes_solver,           "_none_"));
 		PetscCall(getStringParam(fb, _OPTIONAL_, "direct_solver_type",       opt.direct_solver_type,      "_none_"));
 		PetscCall(getScalarParam(fb, _OPTIONAL_, "block_tolerances",         opt.block_tolerances,        2, 1.0));
@@ -328,6 +338,7 @@ PetscErrorCode solverOptionsReadFromFile(FB *fb, SolOptDB &opt)
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "smoother_num_sweeps",     &opt.smoother_num_sweeps,     1, 1000));
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "coarse_num_cpu",          &opt.coarse_num_cpu,          1, 16384));
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "coarse_cells_per_cpu",    &opt.coarse_cells_per_cpu,    1, 131072));
+		PetscCall(getIntParam   (fb, _OPTIONAL_, "agglomerate_cells_per_cpu", &opt.agglomerate_cells_per_cpu, 1, 131072));
 		PetscCall(getStringParam(fb, _OPTIONAL_, "coarse_solver",            opt.coarse_solver,           "_none_"));
 		PetscCall(getScalarParam(fb, _OPTIONAL_, "coarse_tolerances",        opt.coarse_tolerances,       2, 1.0));
 		PetscCall(getIntParam   (fb, _OPTIONAL_, "subdomain_num_per_cpu",   &opt.subdomain_num_per_cpu,   1, 256));
@@ -358,6 +369,13 @@ PetscErrorCode solverOptionsCheck(SolOptDB &opt)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect Stokes solver type (stokes_solver): %s", opt.stokes_solver);
 	}
 
+	if(!(!strcmp(opt.krylov_type, "fgmres")
+	||   !strcmp(opt.krylov_type, "pipefgmres")
+	||   !strcmp(opt.krylov_type, "pipegcr")))
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect Krylov solver type (krylov_type): %s", opt.krylov_type);
+	}
+
 	if(!(!strcmp(opt.direct_solver_type, "superlu_dist")
 	||   !strcmp(opt.direct_solver_type, "mumps")
 	||   !strcmp(opt.direct_solver_type, "default")))
@@ -445,6 +463,58 @@ PetscErrorCode get_num_mg_levels(SolOptDB &opt, FDSTAG *fs)
 	PetscFunctionReturn(0);
 }
 //-----------------------------------------------------------------------------
+PetscErrorCode get_agglomeration(
+		SolOptDB &opt,
+		FDSTAG   *fs,
+		PetscInt &coarse_num_local_cells)
+{
+	// get coarse grid agglomeration factors & number of agglomerated levels
+
+	PetscMPIInt size;
+	PetscInt    i, ncors, nagg, MG2D, f[3];
+
+	PetscFunctionBeginUser;
+
+	if(!opt.agglomerate_cells_per_cpu) PetscFunctionReturn(0);
+
+	// get processor reduction factors
+	PetscCall(FDSTAGGetAggGrid(fs, opt.num_mg_levels, opt.agglomerate_cells_per_cpu, f, ncors));
+
+	if(!ncors)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "   Coarse grid agglomeration    : not possible\n");
+
+		PetscFunctionReturn(0);
+	}
+
+	PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &size));
+
+	PetscCall(FDSTAGCheckMG2D(fs, MG2D));
+
+	nagg = f[0]*f[1]*f[2];
+
+	// number of processors & local cells on top agglomerated level
+	opt.agg_num_mg_levels  = ncors + 1;
+	opt.agg_num_cpu        = (PetscInt)size/nagg;
+	coarse_num_local_cells = coarse_num_local_cells*nagg;
+
+	// number of smoother subdomains on agglomerated levels
+	if(opt.subdomain_num_per_cpu != -1) opt.agg_num_local_blocks = opt.subdomain_num_per_cpu;
+	else                                opt.agg_num_local_blocks = PetscCeilInt(coarse_num_local_cells, opt.subdomain_cells_per_cpu);
+
+	// get coarsest grid size of agglomerated hierarchy
+	for(i = 0; i < ncors; i++)
+	{
+		if(MG2D) coarse_num_local_cells /= 4;
+		else     coarse_num_local_cells /= 8;
+	}
+
+	PetscPrintf(PETSC_COMM_WORLD, "   Coarse grid agglomeration    : [%lld, %lld, %lld] (%lld cpu)\n", (LLD)f[0], (LLD)f[1], (LLD)f[2], (LLD)opt.agg_num_cpu);
+	PetscPrintf(PETSC_COMM_WORLD, "   Agglomerated levels          : %lld\n", (LLD)opt.agg_num_mg_levels);
+
+	PetscFunctionReturn(0);
+}
+//-----------------------------------------------------------------------------
 PetscErrorCode get_coarse_reduction_factor(
 		SolOptDB &opt,
 		PetscInt  coarse_num_local_cells)
@@ -461,6 +531,9 @@ PetscErrorCode get_coarse_reduction_factor(
 
 	total_num_cpu = (PetscInt)size;
 
+	// coarse solve runs on agglomerated processors
+	if(opt.agg_num_cpu) total_num_cpu = opt.agg_num_cpu;
+
 	if(total_num_cpu == 1 || !opt.coarse_num_cpu)
 	{
 		// use all processors
@@ -824,6 +897,8 @@ PetscErrorCode set_custom_mg_options(
 		SolOptDB   &opt,
 		const char *prefix)
 {
+	char *agg_prefix;
+
 	PetscFunctionBeginUser;
 
 	if(opt.view_solvers) { PetscCall(set_empty_option("pc_view", prefix)); }
@@ -831,8 +906,29 @@ PetscErrorCode set_custom_mg_options(
 	// number of multigrid levels
 	PetscCall(set_integer_option("pc_mg_levels", opt.num_mg_levels, prefix));
 
-	// setup coarse solver
-	PetscCall(set_coarse_options(opt, prefix));
+	if(opt.agg_num_mg_levels)
+	{
+		// agglomerated coarse grid multigrid (replaces coarse solver)
+		PetscCall(set_integer_option("agg_cells_per_cpu", opt.agglomerate_cells_per_cpu, prefix));
+		PetscCall(set_integer_option("agg_pc_mg_levels",  opt.agg_num_mg_levels,         prefix));
+
+		asprintf(&agg_prefix,"%s_agg", prefix);
+
+		PetscCall(set_coarse_options(opt, agg_prefix));
+
+		free(agg_prefix);
+
+		asprintf(&agg_prefix,"%s_agg_mg_levels", prefix);
+
+		PetscCall(set_smoother_options(opt, agg_prefix, opt.agg_num_local_blocks));
+
+		free(agg_prefix);
+	}
+	else
+	{
+		// setup coarse solver
+		PetscCall(set_coarse_options(opt, prefix));
+	}
 
 	// setup level smoothers
 	PetscCall(set_levels_options(opt, prefix));
@@ -34,6 +34,7 @@ struct SolOptDB
 	PetscInt    use_line_search                =  1;
 	PetscInt    use_eisenstat_walker           =  0;
 	PetscInt    use_mat_free_jac               =  0;
+	char        krylov_type[_str_len_]         = "fgmres";                   // [fgmres, pipefgmres, pipegcr] (outer Stokes solver, pipelined types overlap reductions with preconditioner)
 
 	char        stokes_solver[_str_len_]       = "coupled_direct";           // [coupled_direct, block_direct, coupled_mg, block_mg, wbfbt]
 	char        direct_solver_type[_str_len_]  = "mumps";                    // [mumps, superlu_dist, default (PETSc built-in, sequential only)]
@@ -52,6 +53,7 @@ struct SolOptDB
 
 	PetscInt    coarse_num_cpu                 =  0;                         // number of cpu for coarse solve (-1 = automatic setting) (0 = all cpus) (NOTE: can be assigned differently)
 	PetscInt    coarse_cells_per_cpu           =  4096;                      // (only for coarse_num_cpu = -1)
+	PetscInt    agglomerate_cells_per_cpu      =  0;                         // agglomerate coarse grid on fewer cpu to reach this number of local cells (0 = deactivated)
 	char        coarse_solver[_str_len_]       = "direct";                   // [direct, hypre, bjacobi, asm] (hypre, bjacobi and asm use fgmres)
 	PetscScalar coarse_tolerances[2]           = { 1e-2, 30 } ;              // rtol, maxit (fgmres settings for hypre, bjacobi and asm)
 
@@ -68,6 +70,9 @@ struct SolOptDB
 	PetscInt    levels_num_local_blocks[_max_num_mg_levels_] = {0};
 	PetscInt    levels_num_blocks_constant                   =  0;
 	PetscInt    coarse_reduction_factor                      =  0;
+	PetscInt    agg_num_mg_levels                            =  0;
+	PetscInt    agg_num_cpu                                  =  0;
+	PetscInt    agg_num_local_blocks                         =  0;
 
 };
 
@@ -81,6 +86,11 @@ PetscErrorCode solverOptionsCheck(SolOptDB &opt);
 
 PetscErrorCode get_num_mg_levels(SolOptDB &opt, FDSTAG *fs);
 
+PetscErrorCode get_agglomeration(
+		SolOptDB &opt,
+		FDSTAG   *fs,
+		PetscInt &coarse_num_local_cells);
+
 PetscErrorCode get_coarse_reduction_factor(
 		SolOptDB &opt,
 		PetscInt  coarse_num_local_cells);
@@ -40,6 +40,7 @@
 #include "advect.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "asyncWriter.h"
 //---------------------------------------------------------------------------
 #define __AVD_DEBUG_MODE
 //---------------------------------------------------------------------------
@@ -669,6 +670,7 @@ PetscErrorCode PVAVDCreate(PVAVD *pvavd, FB *fb)
 	PetscCall(getStringParam(fb, _OPTIONAL_, "out_file_name", filename,                  "output"));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_avd_pvd",   &pvavd->outpvd,                1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_avd_ref",   &pvavd->refine, 1, _max_avd_refine_));
+	PetscCall(VTKCompCreate(&pvavd->vtkcomp, fb));
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "AVD output parameters:\n");
@@ -726,7 +728,7 @@ PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	// open outfile.pvts file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvtr", dirName, pvavd->outfile);
-	fp = fopen(fname,"wb");
+	PetscCall(AsyncWriterOpen(fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -775,7 +777,7 @@ PetscErrorCode PVAVDWritePVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	fprintf(fp, "</VTKFile>\n");
 
-	fclose( fp );
+	PetscCall(AsyncWriterClose(fp));
 
 	PetscFunctionReturn(0);
 }
@@ -804,7 +806,7 @@ PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	// open outfile_p_XXXXXX.vtr file in the output directory (write mode)
 	asprintf(&fname, "%s/%s_p%1.6lld.vtr", dirName, pvavd->outfile, (LLD)rank);
-	fp = fopen(fname,"wb");
+	PetscCall(VTKCompOpen(&pvavd->vtkcomp, fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -899,7 +901,7 @@ PetscErrorCode PVAVDWriteVTR(PVAVD *pvavd, AVD3D A, const char *dirName)
 
 	fprintf(fp, "</VTKFile>\n");
 
-	fclose( fp );
+	PetscCall(VTKCompClose(&pvavd->vtkcomp, fp));
 
 	PetscFunctionReturn(0);
 }
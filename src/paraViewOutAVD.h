@@ -34,6 +34,8 @@
 #ifndef __paraViewOutAVD_h__
 #define __paraViewOutAVD_h__
 
+#include "paraViewOutComp.h"
+
 #define AVD_TRUE  'T'
 #define AVD_FALSE 'F'
 #define AVD_CELL_MASK -2
@@ -169,6 +171,7 @@ struct PVAVD
 	PetscInt  outavd;             // AVD output flag
 	PetscInt  refine;             // Voronoi Diagram refinement factor
 	PetscInt  outpvd;             // pvd file output flag
+	VTKComp   vtkcomp;            // output compression
 
 };
 
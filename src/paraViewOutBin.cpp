@@ -19,6 +19,7 @@
 #include "phase.h"
 #include "outFunct.h"
 #include "tools.h"
+#include "asyncWriter.h"
 //---------------------------------------------------------------------------
 // * phase-ratio output
 // * integrate AVD phase viewer
@@ -390,6 +391,9 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 
 	PetscCall(FBFreeBlocks(fb));
 
+	// output compression
+	PetscCall(VTKCompCreate(&pvout->vtkcomp, fb));
+
 	// check
 	if(!pvout->jr->ctrl.actTemp)             omask->energ_res = 0; // heat diffusion is deactivated
 	if( pvout->jr->ctrl.gwType == _GW_NONE_) omask->eff_press = 0; // pore pressure is deactivated
@@ -398,6 +402,7 @@ PetscErrorCode PVOutCreate(PVOut *pvout, FB *fb)
 	PetscPrintf(PETSC_COMM_WORLD, "Output parameters:\n");
 	PetscPrintf(PETSC_COMM_WORLD, "   Output file name                        : %s \n", pvout->outfile);
 	PetscPrintf(PETSC_COMM_WORLD, "   Write .pvd file                         : %s \n", pvout->outpvd ? "yes" : "no");
+	if(pvout->vtkcomp.type != _VTK_RAW_) PetscPrintf(PETSC_COMM_WORLD, "   Data compressor                         : %s \n", VTKCompName(&pvout->vtkcomp));
 
 	if(omask->phase)          PetscPrintf(PETSC_COMM_WORLD, "   Phase                                   @ \n");
 	if(omask->density)        PetscPrintf(PETSC_COMM_WORLD, "   Density                                 @ \n");
@@ -586,7 +591,7 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 
 	// open outfile.pvtr file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvtr", dirName, pvout->outfile);
-	fp = fopen(fname,"wb");
+	PetscCall(AsyncWriterOpen(fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -640,7 +645,7 @@ PetscErrorCode PVOutWritePVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	PetscCall(AsyncWriterClose(fp));
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
@@ -674,7 +679,7 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 
 	// open outfile_p_XXXXXX.vtr file in the output directory (write mode)
 	asprintf(&fname, "%s/%s_p%1.8lld.vtr", dirName, pvout->outfile, (LLD)rank);
-	fp = fopen(fname,"wb");
+	PetscCall(VTKCompOpen(&pvout->vtkcomp, fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -751,7 +756,7 @@ PetscErrorCode PVOutWriteVTR(PVOut *pvout, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	PetscCall(VTKCompClose(&pvout->vtkcomp, fp));
 
 	PetscFunctionReturn(0);
 }
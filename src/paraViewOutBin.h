@@ -37,6 +37,8 @@
 #ifndef __paraViewOutBin_h__
 #define __paraViewOutBin_h__
 
+#include "paraViewOutComp.h"
+
 //---------------------------------------------------------------------------
 
 struct FB;
@@ -160,6 +162,7 @@ struct PVOut
 	OutBuf    outbuf;             // output buffer
 	long int  offset;             // pvd file offset
 	PetscInt  outpvd;             // pvd file output flag
+	VTKComp   vtkcomp;            // output compression
 
 };
 //---------------------------------------------------------------------------
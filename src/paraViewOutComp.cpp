@@ -0,0 +1,378 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//.................... COMPRESSED PARAVIEW XML OUTPUT .......................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "paraViewOutComp.h"
+#include "parsing.h"
+#include "tools.h"
+#include "asyncWriter.h"
+
+#ifdef LAMEM_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef LAMEM_LZ4
+#include <lz4.h>
+#endif
+//---------------------------------------------------------------------------
+// appended data array
+struct VTKCompArray
+{
+	uint64_t offset; // offset in raw appended data section
+	uint64_t nbytes; // number of uncompressed bytes
+	uint64_t nblock; // number of compression blocks
+	uint64_t start;  // index of first compression block
+	uint64_t cbytes; // size of compressed array (including header)
+};
+
+// compression block
+struct VTKCompBlock
+{
+	const char *src; // uncompressed data
+	size_t      n;   // uncompressed size
+	char       *dst; // compressed data
+	size_t      dn;  // compressed size
+};
+//---------------------------------------------------------------------------
+PetscErrorCode VTKCompCreate(VTKComp *vc, FB *fb)
+{
+	char str[_str_len_];
+
+	PetscFunctionBeginUser;
+
+	// initialize
+	vc->type     = _VTK_RAW_;
+	vc->nthreads = 1;
+
+	// read
+	PetscCall(getStringParam(fb, _OPTIONAL_, "out_compress",    str,           "none"));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_num_threads", &vc->nthreads, 1, -1));
+
+	if     (!strcmp(str, "none")) vc->type = _VTK_RAW_;
+	else if(!strcmp(str, "zlib")) vc->type = _VTK_ZLIB_;
+	else if(!strcmp(str, "lz4"))  vc->type = _VTK_LZ4_;
+	else SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Incorrect output compression type: %s (none, zlib, lz4)", str);
+
+#ifndef LAMEM_ZLIB
+	if(vc->type == _VTK_ZLIB_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "zlib compression requires LaMEM compiled with zlib support (make zlib=1)");
+	}
+#endif
+
+#ifndef LAMEM_LZ4
+	if(vc->type == _VTK_LZ4_)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "LZ4 compression requires LaMEM compiled with LZ4 support (make lz4=1)");
+	}
+#endif
+
+#ifdef _WIN32
+	// memory streams are not available
+	vc->type = _VTK_RAW_;
+#endif
+
+	vc->nthreads = getNumThreads(vc->nthreads);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+const char * VTKCompName(VTKComp *vc)
+{
+	if(vc->type == _VTK_ZLIB_) return "vtkZLibDataCompressor";
+	if(vc->type == _VTK_LZ4_)  return "vtkLZ4DataCompressor";
+
+	return "none";
+}
+//---------------------------------------------------------------------------
+PetscErrorCode VTKCompOpen(VTKComp *vc, const char *name, FILE **fp)
+{
+	// WARNING! file pointer is NULL on failure (check as for fopen)
+
+	PetscFunctionBeginUser;
+
+	if(vc->type == _VTK_RAW_)
+	{
+		PetscCall(AsyncWriterOpen(name, fp));
+
+		PetscFunctionReturn(0);
+	}
+
+	// stage file in memory, compress in output writer thread
+	PetscCall(AsyncWriterOpenFilter(name, VTKCompAppended, vc, fp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode VTKCompClose(VTKComp *vc, FILE *fp)
+{
+	PetscFunctionBeginUser;
+
+	UNUSED(vc);
+
+	PetscCall(AsyncWriterClose(fp));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscInt VTKCompBlockData(VTKCompType type, VTKCompBlock *b)
+{
+	// compress single block, return nonzero on failure
+
+	b->dst = NULL;
+	b->dn  = 0;
+
+#ifdef LAMEM_ZLIB
+	if(type == _VTK_ZLIB_)
+	{
+		uLongf cap = compressBound((uLong)b->n);
+
+		b->dst = (char*)malloc(cap);
+
+		if(!b->dst) return 1;
+
+		if(compress2((Bytef*)b->dst, &cap, (const Bytef*)b->src, (uLong)b->n, Z_DEFAULT_COMPRESSION) != Z_OK) return 1;
+
+		b->dn = (size_t)cap;
+
+		return 0;
+	}
+#endif
+
+#ifdef LAMEM_LZ4
+	if(type == _VTK_LZ4_)
+	{
+		int cap = LZ4_compressBound((int)b->n);
+		int dn;
+
+		b->dst = (char*)malloc((size_t)cap);
+
+		if(!b->dst) return 1;
+
+		dn = LZ4_compress_default(b->src, b->dst, (int)b->n, cap);
+
+		if(dn <= 0) return 1;
+
+		b->dn = (size_t)dn;
+
+		return 0;
+	}
+#endif
+
+	UNUSED(type);
+
+	return 1;
+}
+//---------------------------------------------------------------------------
+int VTKCompAppended(
+		void       *ctx,
+		const char *src,
+		size_t      n,
+		char      **dst,
+		size_t     *dn)
+{
+	// replace raw appended data blocks with compressed blocks, return nonzero on failure
+	// WARNING! source buffer must be null-terminated (as from memory stream)
+	// WARNING! called from output writer thread, no PETSc or MPI calls are allowed
+
+	VTKComp               *vc;
+	FILE                  *fp;
+	const char            *app, *data, *p, *q, *vtk;
+	char                  *e;
+	vector <VTKCompArray>  arrays;
+	vector <VTKCompBlock>  blocks;
+	vector <uint64_t>      offsets;
+	vector <size_t>        attr;
+	uint64_t               hdr[3], nbytes, off, tail;
+	size_t                 pos, cur;
+	PetscInt               i, k, nblock, fail;
+
+	vc = (VTKComp*)ctx;
+
+	// locate appended data section
+	app  = strstr(src, "<AppendedData encoding=\"raw\">");
+	data = app ? (const char*)memchr(app, '_', n - (size_t)(app - src)) : NULL;
+	vtk  = strstr(src, "<VTKFile");
+
+	if(!app || !data || !vtk || vc->type == _VTK_RAW_)
+	{
+		// nothing to compress, copy as is
+		(*dst) = (char*)malloc(n + 1);
+
+		if(!(*dst)) return 1;
+
+		memcpy(*dst, src, n);
+		(*dn) = n;
+
+		return 0;
+	}
+
+	data++;
+
+	// collect offset attributes in the header
+	p = src;
+
+	while((p = strstr(p, "offset=\"")) && p < app)
+	{
+		p += 8;
+
+		off = (uint64_t)strtoull(p, &e, 10);
+
+		attr.push_back((size_t)(p - src));
+		attr.push_back((size_t)(e - src));
+		offsets.push_back(off);
+
+		p = e;
+	}
+
+	sort(offsets.begin(), offsets.end());
+	offsets.erase(unique(offsets.begin(), offsets.end()), offsets.end());
+
+	// parse raw data arrays & split into compression blocks
+	tail = 0;
+
+	for(auto o : offsets)
+	{
+		VTKCompArray a;
+
+		pos = (size_t)(data - src) + o;
+
+		// inconsistent appended data offset
+		if(pos + sizeof(uint64_t) > n) return 1;
+
+		memcpy(&nbytes, src + pos, sizeof(uint64_t));
+
+		// inconsistent appended data size
+		if(pos + sizeof(uint64_t) + nbytes > n) return 1;
+
+		a.offset = o;
+		a.nbytes = nbytes;
+		a.nblock = (nbytes + _vtk_comp_block_ - 1)/_vtk_comp_block_;
+		a.start  = (uint64_t)blocks.size();
+
+		for(off = 0; off < nbytes; off += _vtk_comp_block_)
+		{
+			VTKCompBlock b;
+
+			b.src = src + pos + sizeof(uint64_t) + off;
+			b.n   = (size_t)min((uint64_t)_vtk_comp_block_, nbytes - off);
+			b.dst = NULL;
+			b.dn  = 0;
+
+			blocks.push_back(b);
+		}
+
+		arrays.push_back(a);
+
+		tail = max(tail, (uint64_t)(pos + sizeof(uint64_t) + nbytes));
+	}
+
+	// compress blocks
+	nblock = (PetscInt)blocks.size();
+	fail   = 0;
+
+	OMP(parallel for num_threads(vc->nthreads) schedule(dynamic) reduction(max:fail))
+	for(k = 0; k < nblock; k++)
+	{
+		fail = max(fail, VTKCompBlockData(vc->type, &blocks[(size_t)k]));
+	}
+
+	if(fail)
+	{
+		for(auto &b : blocks) free(b.dst);
+
+		return 1;
+	}
+
+	// compute compressed array sizes
+	for(auto &a : arrays)
+	{
+		a.cbytes = (3 + a.nblock)*sizeof(uint64_t);
+
+		for(off = 0; off < a.nblock; off++) a.cbytes += blocks[a.start + off].dn;
+	}
+
+	// assemble compressed file
+	fp = open_memstream(dst, dn);
+
+	if(!fp)
+	{
+		for(auto &b : blocks) free(b.dst);
+
+		return 1;
+	}
+
+	// header with compressor attribute & updated offsets
+	cur = (size_t)(vtk - src) + strlen("<VTKFile");
+
+	fwrite(src, 1, cur, fp);
+
+	fprintf(fp, " compressor=\"%s\"", VTKCompName(vc));
+
+	for(i = 0; i < (PetscInt)attr.size(); i += 2)
+	{
+		q   = src + attr[(size_t)i];
+		off = (uint64_t)strtoull(q, &e, 10);
+
+		// sum compressed sizes of preceding arrays
+		nbytes = 0;
+
+		for(auto &a : arrays)
+		{
+			if(a.offset >= off) break;
+
+			nbytes += a.cbytes;
+		}
+
+		fwrite(src + cur, 1, attr[(size_t)i] - cur, fp);
+
+		fprintf(fp, "%llu", (unsigned long long)nbytes);
+
+		cur = attr[(size_t)i+1];
+	}
+
+	fwrite(src + cur, 1, (size_t)(data - src) - cur, fp);
+
+	// compressed arrays
+	for(auto &a : arrays)
+	{
+		hdr[0] = a.nblock;
+		hdr[1] = _vtk_comp_block_;
+		hdr[2] = a.nbytes % _vtk_comp_block_;
+
+		fwrite(hdr, sizeof(uint64_t), 3, fp);
+
+		for(off = 0; off < a.nblock; off++)
+		{
+			nbytes = (uint64_t)blocks[a.start + off].dn;
+
+			fwrite(&nbytes, sizeof(uint64_t), 1, fp);
+		}
+
+		for(off = 0; off < a.nblock; off++)
+		{
+			fwrite(blocks[a.start + off].dst, 1, blocks[a.start + off].dn, fp);
+		}
+	}
+
+	// closing tags
+	if(!arrays.size()) tail = (uint64_t)(data - src);
+
+	fwrite(src + tail, 1, n - (size_t)tail, fp);
+
+	fail = (fclose(fp) != 0);
+
+	for(auto &b : blocks) free(b.dst);
+
+	return (int)fail;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,67 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+//.................... COMPRESSED PARAVIEW XML OUTPUT .......................
+//---------------------------------------------------------------------------
+#ifndef __paraViewOutComp_h__
+#define __paraViewOutComp_h__
+//---------------------------------------------------------------------------
+
+struct FB;
+
+//---------------------------------------------------------------------------
+
+// Data files are staged in memory with raw appended data blocks
+// (UInt64 byte count followed by data). On close, the staged buffer is
+// passed to the output writer, which compresses it in the background
+// thread (or immediately without out_async). Every block is split into
+// fixed-size pieces that are compressed independently (in parallel),
+// offsets in the XML header are updated, and the compressor attribute is
+// added to the VTKFile element. Support for the compression libraries is
+// enabled at compile time (make zlib=1, make lz4=1).
+
+// uncompressed size of compression block
+#define _vtk_comp_block_ 65536
+
+enum VTKCompType
+{
+	_VTK_RAW_,  // no compression
+	_VTK_ZLIB_, // vtkZLibDataCompressor
+	_VTK_LZ4_   // vtkLZ4DataCompressor
+};
+
+struct VTKComp
+{
+	VTKCompType type;     // compressor type
+	PetscInt    nthreads; // number of compression threads
+};
+
+// read compression parameters
+PetscErrorCode VTKCompCreate(VTKComp *vc, FB *fb);
+
+// get compressor name
+const char * VTKCompName(VTKComp *vc);
+
+// open data file for writing (staged in memory if compression is active)
+PetscErrorCode VTKCompOpen(VTKComp *vc, const char *name, FILE **fp);
+
+// pass staged data file to output writer (compressed before writing)
+PetscErrorCode VTKCompClose(VTKComp *vc, FILE *fp);
+
+// compress appended data blocks of XML file (output writer filter, context is VTKComp)
+int VTKCompAppended(
+		void       *ctx,
+		const char *src,
+		size_t      n,
+		char      **dst,
+		size_t     *dn);
+
+//---------------------------------------------------------------------------
+#endif
@@ -19,6 +19,7 @@
 #include "advect.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "asyncWriter.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb)
 {
@@ -41,6 +42,7 @@ PetscErrorCode PVMarkCreate(PVMark *pvmark, FB *fb)
 	// read
 	PetscCall(getStringParam(fb, _OPTIONAL_, "out_file_name", filename,    "output"));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_mark_pvd",  &pvmark->outpvd, 1, 1));
+	PetscCall(VTKCompCreate(&pvmark->vtkcomp, fb));
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "Marker output parameters:\n");
@@ -94,7 +96,7 @@ PetscErrorCode PVMarkWriteVTU(PVMark *pvmark, const char *dirName)
 	asprintf(&fname, "%s/%s_p%1.8lld.vtu", dirName, pvmark->outfile, (LLD)actx->iproc);
 
 	// open file
-	fp = fopen( fname, "wb" );
+	PetscCall(VTKCompOpen(&pvmark->vtkcomp, fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -233,7 +235,7 @@ PetscErrorCode PVMarkWriteVTU(PVMark *pvmark, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	PetscCall(VTKCompClose(&pvmark->vtkcomp, fp));
 
 	PetscFunctionReturn(0);
 }
@@ -259,7 +261,7 @@ PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName)
 	asprintf(&fname, "%s/%s.pvtu", dirName, pvmark->outfile);
 
 	// open file
-	fp = fopen( fname, "wb" );
+	PetscCall(AsyncWriterOpen(fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -300,7 +302,7 @@ PetscErrorCode PVMarkWritePVTU(PVMark *pvmark, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file and free name
-	fclose(fp);
+	PetscCall(AsyncWriterClose(fp));
 
 	PetscFunctionReturn(0);
 }
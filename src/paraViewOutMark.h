@@ -12,6 +12,8 @@
 //---------------------------------------------------------------------------
 #ifndef __paraViewOutMark_h__
 #define __paraViewOutMark_h__
+
+#include "paraViewOutComp.h"
 //---------------------------------------------------------------------------
 //................ ParaView marker output driver object .....................
 //---------------------------------------------------------------------------
@@ -28,6 +30,7 @@ struct PVMark
 	long int  offset;             // pvd file offset
 	PetscInt  outmark;            // marker output flag
 	PetscInt  outpvd;             // pvd file output flag
+	VTKComp   vtkcomp;            // output compression
 
 };
 
@@ -20,6 +20,7 @@
 #include "paraViewOutPassiveTracers.h"
 #include "tools.h"
 #include "passive_tracer.h"
+#include "asyncWriter.h"
 
 //---------------------------------------------------------------------------
 PetscErrorCode PVPtrCreate(PVPtr *pvptr, FB *fb)
@@ -55,6 +56,7 @@ PetscErrorCode PVPtrCreate(PVPtr *pvptr, FB *fb)
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_ptr_Active",          &pvptr->Active   , 1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_ptr_Grid_Mf",         &pvptr->Grid_mf   , 1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_ptr_APS",             &pvptr->APS       , 1, 1));
+	PetscCall(VTKCompCreate(&pvptr->vtkcomp, fb));
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "Passive Tracers output parameters:\n");
@@ -111,7 +113,7 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 	asprintf(&fname, "%s/%s_p%1.8lld.vtu", dirName, pvptr->outfile, (LLD)pvptr->actx->iproc);
 
 	// open file
-	fp = fopen( fname, "wb" );
+	PetscCall(VTKCompOpen(&pvptr->vtkcomp, fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -423,7 +425,7 @@ PetscErrorCode PVPtrWriteVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp,"\n\t</AppendedData>\n");
 	fprintf( fp, "</VTKFile>\n");
 	// close file
-	fclose(fp);
+	PetscCall(VTKCompClose(&pvptr->vtkcomp, fp));
 
 	PetscFunctionReturn(0);
 }
@@ -447,7 +449,7 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 	asprintf(&fname, "%s/%s.pvtu", dirName, pvptr->outfile);
 
 	// open file
-	fp = fopen( fname, "wb" );
+	PetscCall(AsyncWriterOpen(fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -531,7 +533,7 @@ PetscErrorCode PVPtrWritePVTU(PVPtr *pvptr, const char *dirName)
 	fprintf( fp, "</VTKFile>\n");
 
 	// close file and free name
-	fclose(fp);
+	PetscCall(AsyncWriterClose(fp));
 
 	PetscFunctionReturn(0);
 }
@@ -12,6 +12,8 @@
 //---------------------------------------------------------------------------
 #ifndef __paraViewOutPassiveTracers_h__
 #define __paraViewOutPassiveTracers_h__
+
+#include "paraViewOutComp.h"
 //---------------------------------------------------------------------------
 //................ ParaView marker output driver object .....................
 //---------------------------------------------------------------------------
@@ -28,6 +30,7 @@ struct PVPtr
 	long int  offset;             // pvd file offset
 	PetscInt  outptr;             // marker output flag
 	PetscInt  outpvd;             // pvd file output flag
+	VTKComp   vtkcomp;            // output compression
 	PetscInt  Temperature;
 	PetscInt  Pressure;
 	PetscInt  Phase;
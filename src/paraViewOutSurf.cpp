@@ -19,6 +19,7 @@
 #include "surf.h"
 #include "JacRes.h"
 #include "tools.h"
+#include "asyncWriter.h"
 //---------------------------------------------------------------------------
 PetscErrorCode PVSurfCreate(PVSurf *pvsurf, FB *fb)
 {
@@ -48,6 +49,7 @@ PetscErrorCode PVSurfCreate(PVSurf *pvsurf, FB *fb)
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_surf_velocity",   &pvsurf->velocity,   1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_surf_topography", &pvsurf->topography, 1, 1));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "out_surf_amplitude",  &pvsurf->amplitude,  1, 1));
+	PetscCall(VTKCompCreate(&pvsurf->vtkcomp, fb));
 
 	// print summary
 	PetscPrintf(PETSC_COMM_WORLD, "Surface output parameters:\n");
@@ -149,7 +151,7 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 
 	// open outfile.pvts file in the output directory (write mode)
 	asprintf(&fname, "%s/%s.pvts", dirName, pvsurf->outfile);
-	fp = fopen(fname,"wb");
+	PetscCall(AsyncWriterOpen(fname, &fp));
 	if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 	free(fname);
 
@@ -213,7 +215,7 @@ PetscErrorCode PVSurfWritePVTS(PVSurf *pvsurf, const char *dirName)
 	fprintf(fp, "</VTKFile>\n");
 
 	// close file
-	fclose(fp);
+	PetscCall(AsyncWriterClose(fp));
 
 	PetscFunctionReturn(0);
 }
@@ -240,7 +242,7 @@ PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 	{
 		// open outfile_p_XXXXXX.vts file in the output directory (write mode)
 		asprintf(&fname, "%s/%s_p%1.8lld.vts", dirName, pvsurf->outfile, (LLD)fs->dsz.color);
-		fp = fopen(fname,"wb");
+		PetscCall(VTKCompOpen(&pvsurf->vtkcomp, fname, &fp));
 		if(fp == NULL) SETERRQ(PETSC_COMM_SELF, 1,"cannot open file %s", fname);
 		free(fname);
 
@@ -328,7 +330,7 @@ PetscErrorCode PVSurfWriteVTS(PVSurf *pvsurf, const char *dirName)
 		fprintf(fp, "</VTKFile>\n");
 
 		// close file
-		fclose(fp);
+		PetscCall(VTKCompClose(&pvsurf->vtkcomp, fp));
 	}
 
 	PetscFunctionReturn(0);
@@ -13,6 +13,8 @@
 #ifndef __paraViewOutSurf_h__
 #define __paraViewOutSurf_h__
 
+#include "paraViewOutComp.h"
+
 //---------------------------------------------------------------------------
 
 struct FB;
@@ -30,6 +32,7 @@ struct PVSurf
 	long int   offset;             // pvd file offset
 	PetscInt   outsurf;            // free surface output flag
 	PetscInt   outpvd;             // pvd file output flag
+	VTKComp    vtkcomp;            // output compression
 	PetscInt   velocity;           // velocity output flag
 	PetscInt   topography;         // surface topography output flag
 	PetscInt   amplitude;          // topography amplitude output flag
@@ -318,7 +318,7 @@ PetscErrorCode ADV_Assign_Phase(AdvCtx *actx)
 	spair d;
 	Marker   *IP;
 	PetscScalar  X[3],Xm[3],*Xp,*Yp,*Zp,*Pr,*T,*phase,*APS;
-	PetscInt     I, J, K,ii,numpassive,imark,ID,nx,ny,n,*markind,id_m;
+	PetscInt     I, J, K,ii,numpassive,imark,ID,nx,ny,n,mstart,id_m;
 	PetscScalar ex,bx,ey,by,ez,bz;
 
 
@@ -374,11 +374,11 @@ PetscErrorCode ADV_Assign_Phase(AdvCtx *actx)
 
 
 			n = actx->markstart[ID+1] - actx->markstart[ID];
-			markind = actx->markind + actx->markstart[ID];
+			mstart  = actx->markstart[ID];
 
 			for (ii = 0; ii < n; ii++)
 			{
-				id_m=markind[ii];
+				id_m=mstart + ii;
 				Xm[0] = actx->markers[id_m].X[0];
 				Xm[1] = actx->markers[id_m].X[1];
 				Xm[2] = actx->markers[id_m].X[2];
@@ -463,7 +463,7 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 	Material_t      *mat;
 	PData           *Pd;
 	PetscInt        sx, sy, sz, nx, ny,nz;
-	PetscInt        jj, I, J, K, II, JJ, KK, AirPhase, num_part,ID, n, ii, numActTracers,*markind,id_m ;
+	PetscInt        jj, I, J, K, II, JJ, KK, AirPhase, num_part,ID, n, ii, numActTracers,mstart,id_m ;
 	PetscScalar     ex,bx,ey,by,ez,bz;
 	PetscScalar     *ncx, *ncy, *ncz;
 	PetscScalar     *ccx, *ccy, *ccz;
@@ -619,12 +619,12 @@ PetscErrorCode ADVAdvectPassiveTracer(AdvCtx *actx)
 					// sort markers by distance
 					dist.clear();
 					n = actx->markstart[ID+1] - actx->markstart[ID];
-					markind = actx->markind + actx->markstart[ID];
+					mstart  = actx->markstart[ID];
 
 
 					for (ii = 0; ii < n; ii++)
 					{
-						id_m=markind[ii];
+						id_m=mstart + ii;
 						Xm[0] = actx->markers[id_m].X[0];
 						Xm[1] = actx->markers[id_m].X[1];
 						Xm[2] = actx->markers[id_m].X[2];
@@ -855,7 +855,7 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 	FreeSurf        *surf;
 	Vec             vphase;
 	PetscInt        sx, sy, sz;
-	PetscInt        ii, jj, ID, I, J, K, L, AirPhase, phaseID, nmark, *markind, markid;
+	PetscInt        ii, jj, ID, I, J, K, L, AirPhase, phaseID, nmark, mstart, markid;
 	PetscScalar     ***ltopo, ***phase, *ncx, *ncy, topo, xp, yp, zp, *IX,bz,ez,by,ey,bx,ex,Xm[3];
 	PetscScalar *Xp, *Yp,*Zp,*phaseptr;
 	spair           d;
@@ -950,7 +950,7 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 
 				// get marker list in containing cell
 					nmark   = actx->markstart[ID+1] - actx->markstart[ID];
-					markind = actx->markind + actx->markstart[ID];
+					mstart  = actx->markstart[ID];
 
 				// clear distance storage
 					dist.clear();
@@ -958,7 +958,7 @@ PetscErrorCode ADVMarkCrossFreeSurfPassive_Tracers(AdvCtx *actx)
 					for(ii = 0; ii < nmark; ii++)
 					{
 					// get current marker
-						markid = markind[ii];
+						markid = mstart + ii;
 						IP     = &actx->markers[markid];
 
 						// sort out air markers
@@ -1072,7 +1072,7 @@ PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID,
 	if(((actx->Ptr->Condition_pr ==_Pres_ptr_)||(actx->Ptr->Condition_pr ==_Temp_ptr_)||(actx->Ptr->Condition_pr ==_Time_ptr_)) && Active[jj] == 1.0)
 	{
 
-		PetscInt n, ii,id_m,*markind;
+		PetscInt n, ii,id_m,mstart;
 
 		PetscCall(VecGetArray(actx->Ptr->phase, &phase));
 
@@ -1083,12 +1083,12 @@ PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID,
 
 		dist.clear();
 		n = actx->markstart[ID+1] - actx->markstart[ID];
-		markind = actx->markind + actx->markstart[ID];
+		mstart  = actx->markstart[ID];
 
 
 		for (ii = 0; ii < n; ii++)
 		{
-			id_m=markind[ii];
+			id_m=mstart + ii;
 			Xm[0] =actx->markers[id_m].X[0];
 			Xm[1] =actx->markers[id_m].X[1];
 			Xm[2] =actx->markers[id_m].X[2];
@@ -1179,6 +1179,89 @@ PetscErrorCode Passive_Tracer_WriteRestart(AdvCtx *actx, FILE *fp)
 
 	PetscFunctionReturn(0);
 }
+//---------------------------------------------------------------------------
+PetscErrorCode Passive_Tracer_ViewRestart(AdvCtx *actx, PetscViewer viewer)
+{
+	// passive tracer vectors are replicated on all processors, write them from rank zero
+
+	P_Tr        *Ptr;
+	Vec          v[11];
+	PetscScalar *a;
+	PetscInt     i;
+
+	PetscFunctionBeginUser;
+
+	if(!actx->jr->ctrl.Passive_Tracer) PetscFunctionReturn(0);
+
+	Ptr = actx->Ptr;
+
+	// same order as in the per-processor restart database
+	v[0]  = Ptr->x;
+	v[1]  = Ptr->y;
+	v[2]  = Ptr->z;
+	v[3]  = Ptr->p;
+	v[4]  = Ptr->T;
+	v[5]  = Ptr->phase;
+	v[6]  = Ptr->Melt_fr;
+	v[7]  = Ptr->Melt_Grid;
+	v[8]  = Ptr->APS;
+	v[9]  = Ptr->C_advection;
+	v[10] = Ptr->ID;
+
+	PetscCall(PetscViewerBinaryWrite(viewer, &Ptr->nummark, 1, PETSC_INT));
+
+	for(i = 0; i < 11; i++)
+	{
+		PetscCall(VecGetArray(v[i], &a));
+		PetscCall(PetscViewerBinaryWrite(viewer, a, Ptr->nummark, PETSC_SCALAR));
+		PetscCall(VecRestoreArray(v[i], &a));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode Passive_Tracer_LoadRestart(AdvCtx *actx, PetscViewer viewer)
+{
+	P_Tr        *Ptr;
+	Vec          v[11];
+	PetscScalar *a;
+	PetscInt     i, nummark;
+
+	PetscFunctionBeginUser;
+
+	if(!actx->jr->ctrl.Passive_Tracer) PetscFunctionReturn(0);
+
+	Ptr = actx->Ptr;
+
+	PetscCall(PetscViewerBinaryRead(viewer, &nummark, 1, NULL, PETSC_INT));
+
+	if(nummark != Ptr->nummark)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Number of passive tracers in restart database (%lld) does not match input file (%lld)", (LLD)nummark, (LLD)Ptr->nummark);
+	}
+
+	// same order as in the per-processor restart database
+	v[0]  = Ptr->x;
+	v[1]  = Ptr->y;
+	v[2]  = Ptr->z;
+	v[3]  = Ptr->p;
+	v[4]  = Ptr->T;
+	v[5]  = Ptr->phase;
+	v[6]  = Ptr->Melt_fr;
+	v[7]  = Ptr->Melt_Grid;
+	v[8]  = Ptr->APS;
+	v[9]  = Ptr->C_advection;
+	v[10] = Ptr->ID;
+
+	for(i = 0; i < 11; i++)
+	{
+		PetscCall(VecGetArray(v[i], &a));
+		PetscCall(PetscViewerBinaryRead(viewer, a, nummark, NULL, PETSC_SCALAR));
+		PetscCall(VecRestoreArray(v[i], &a));
+	}
+
+	PetscFunctionReturn(0);
+}
 
 // --------------------------------------------------------------------------------------- //
 
@@ -105,6 +105,10 @@ PetscErrorCode ReadPassive_Tracers(AdvCtx *actx, FILE *fp);
 
 PetscErrorCode Passive_Tracer_WriteRestart(AdvCtx *actx, FILE *fp);
 
+PetscErrorCode Passive_Tracer_ViewRestart(AdvCtx *actx, PetscViewer viewer);
+
+PetscErrorCode Passive_Tracer_LoadRestart(AdvCtx *actx, PetscViewer viewer);
+
 PetscErrorCode Sync_Vector(Vec x,AdvCtx *actx ,PetscInt nummark);
 
 PetscErrorCode Check_advection_condition(AdvCtx *actx, PetscInt jj, PetscInt ID, PetscScalar xp, PetscScalar yp, PetscScalar zp, PetscScalar P,PetscScalar T,PetscScalar mf);
@@ -0,0 +1,444 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ..................... PERFORMANCE INSTRUMENTATION .........................
+//---------------------------------------------------------------------------
+#include "LaMEM.h"
+#include "perfLog.h"
+#include "parsing.h"
+#include "tools.h"
+//---------------------------------------------------------------------------
+// event names (PETSc log, JSON report)
+static const char *perfNames[_PERF_NUM_EVENTS_][2] =
+{
+	{ "LMSNESSolve",    "snes_solve"    },
+	{ "LMResidual",     "residual"      },
+	{ "LMConstEq",      "consteq"       },
+	{ "LMMatFreeMult",  "matfree_mult"  },
+	{ "LMPicardMult",   "picard_mult"   },
+	{ "LMGMGSetup",     "mg_setup"      },
+	{ "LMGMGApply",     "mg_apply"      },
+	{ "LMMarkProject",  "mark_project"  },
+	{ "LMMarkExchange", "mark_exchange" },
+	{ "LMAVDControl",   "avd_control"   },
+	{ "LMOutAVD",       "out_avd"       },
+	{ "LMOutGrid",      "out_grid"      },
+	{ "LMOutSurf",      "out_surf"      },
+	{ "LMOutMark",      "out_mark"      },
+	{ "LMOutTracers",   "out_tracers"   },
+	{ "LMRestart",      "restart"       }
+};
+//---------------------------------------------------------------------------
+struct PerfTimer
+{
+	PetscLogEvent  id;    // PETSc event
+	PetscLogDouble tbeg;  // start time of current call
+	PetscLogDouble time;  // accumulated wall time
+	PetscLogDouble bytes; // estimated memory traffic
+	PetscLogDouble flops; // estimated operation count
+	PetscInt       count; // number of calls
+	PetscInt       depth; // nesting depth
+};
+//---------------------------------------------------------------------------
+struct PerfStep
+{
+	PetscInt       step;    // time step number
+	PetscScalar    time;    // model time
+	PetscScalar    dt;      // time step
+	PetscInt       snesits; // nonlinear iterations
+	PetscInt       kspits;  // linear iterations
+	PetscLogDouble t[_PERF_NUM_EVENTS_+1]; // maximum event times & step wall time
+};
+//---------------------------------------------------------------------------
+struct PerfLogCtx
+{
+	PetscInt           registered;               // events registration flag
+	PetscClassId       classid;                  // class of registered events
+	PetscInt           active;                   // report activation flag
+	char               file[_str_len_];          // report file name
+	char               lbl_time[_str_len_];      // time unit label
+	PerfTimer          ev  [_PERF_NUM_EVENTS_];  // phase timers
+	PerfTimer          lvl [_perf_max_levels_];  // multigrid level timers
+	PetscInt           lid [_perf_max_levels_];  // level indices (callback contexts)
+	PetscInt           nlvl;                     // number of timed levels
+	PetscInt           nreg;                     // number of registered level events
+	PetscLogDouble     tstart;                   // start of run
+	PetscLogDouble     tstep;                    // start of current time step
+	PetscLogDouble     tprev[_PERF_NUM_EVENTS_]; // event times at previous step
+	vector <PerfStep>  steps;                    // time step records
+};
+
+static PerfLogCtx pl;
+//---------------------------------------------------------------------------
+static void PerfTimerBegin(PerfTimer *pt)
+{
+	if(!pt->depth) PetscTime(&pt->tbeg);
+
+	pt->depth++;
+}
+//---------------------------------------------------------------------------
+static void PerfTimerEnd(PerfTimer *pt)
+{
+	PetscLogDouble t;
+
+	pt->depth--;
+
+	if(pt->depth) return;
+
+	PetscTime(&t);
+
+	pt->time += t - pt->tbeg;
+	pt->count++;
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode PerfLevelBegin(KSP ksp, Vec b, Vec x, void *ctx)
+{
+	PetscInt i;
+
+	UNUSED(ksp);
+	UNUSED(b);
+	UNUSED(x);
+
+	PetscFunctionBeginUser;
+
+	i = *(PetscInt*)ctx;
+
+	PetscCall(PetscLogEventBegin(pl.lvl[i].id, 0, 0, 0, 0));
+
+	if(pl.active) PerfTimerBegin(&pl.lvl[i]);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode PerfLevelEnd(KSP ksp, Vec b, Vec x, void *ctx)
+{
+	PetscInt i;
+
+	UNUSED(ksp);
+	UNUSED(b);
+	UNUSED(x);
+
+	PetscFunctionBeginUser;
+
+	i = *(PetscInt*)ctx;
+
+	if(pl.active) PerfTimerEnd(&pl.lvl[i]);
+
+	PetscCall(PetscLogEventEnd(pl.lvl[i].id, 0, 0, 0, 0));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogCreate(FB *fb)
+{
+	PetscInt i;
+
+	PetscFunctionBeginUser;
+
+	// register events once per process
+	if(!pl.registered)
+	{
+		PetscCall(PetscClassIdRegister("LaMEM", &pl.classid));
+
+		for(i = 0; i < _PERF_NUM_EVENTS_; i++)
+		{
+			PetscCall(PetscLogEventRegister(perfNames[i][0], pl.classid, &pl.ev[i].id));
+		}
+
+		pl.registered = 1;
+	}
+
+	// clear accumulated data
+	PetscCall(PerfLogDestroy());
+
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "perf_report", &pl.active, 1, 1));
+	PetscCall(getStringParam(fb, _OPTIONAL_, "perf_file",    pl.file,   "perf_report.json"));
+
+	if(pl.active)
+	{
+		PetscPrintf(PETSC_COMM_WORLD, "Performance report file : %s \n", pl.file);
+		PetscPrintf(PETSC_COMM_WORLD, "--------------------------------------------------------------------------\n");
+	}
+
+	PetscTime(&pl.tstart);
+
+	pl.tstep = pl.tstart;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+static PetscErrorCode PerfWriteTimer(FILE *fp, PerfTimer *pt, const char *key, PetscInt last)
+{
+	// reduce timer over processes & write JSON entry (rank zero only)
+
+	PetscLogDouble lsum[3], gsum[3], lmax[2], gmax[2], gmin, tavg, imb;
+	PetscMPIInt    size;
+
+	PetscFunctionBeginUser;
+
+	PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &size));
+
+	lsum[0] = pt->time;
+	lsum[1] = pt->bytes;
+	lsum[2] = pt->flops;
+	lmax[0] = pt->time;
+	lmax[1] = (PetscLogDouble)pt->count;
+
+	PetscCallMPI(MPI_Reduce(lsum, gsum, 3, MPI_DOUBLE, MPI_SUM, 0, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Reduce(lmax, gmax, 2, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD));
+	PetscCallMPI(MPI_Reduce(&pt->time, &gmin, 1, MPI_DOUBLE, MPI_MIN, 0, PETSC_COMM_WORLD));
+
+	if(!fp) PetscFunctionReturn(0);
+
+	// load imbalance (max/avg)
+	tavg = gsum[0]/(PetscLogDouble)size;
+	imb  = (tavg > 0.0) ? gmax[0]/tavg : 1.0;
+
+	fprintf(fp, "    \"%s\": { \"calls\": %lld, \"time_max\": %.6e, \"time_min\": %.6e, \"time_avg\": %.6e, \"imbalance\": %.4f",
+		key, (LLD)gmax[1], gmax[0], gmin, tavg, imb);
+
+	// aggregate bandwidth & operation rate (estimated work over slowest process)
+	if(gsum[1] > 0.0 && gmax[0] > 0.0)
+	{
+		fprintf(fp, ", \"gbytes\": %.6e, \"gflops\": %.6e, \"bandwidth_gbs\": %.4f, \"gflop_rate\": %.4f",
+			gsum[1]*1e-9, gsum[2]*1e-9, gsum[1]*1e-9/gmax[0], gsum[2]*1e-9/gmax[0]);
+	}
+
+	fprintf(fp, " }%s\n", last ? "" : ",");
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfLogDestroy()
+{
+	FILE           *fp;
+	PerfStep       *ps;
+	char            lvlkey[_str_len_];
+	PetscMPIInt     size;
+	PetscLogDouble  t;
+	PetscInt        i, j, ns;
+
+	PetscFunctionBeginUser;
+
+	if(pl.active)
+	{
+		PetscTime(&t);
+
+		PetscCallMPI(MPI_Comm_size(PETSC_COMM_WORLD, &size));
+
+		fp = NULL;
+
+		if(ISRankZero(PETSC_COMM_WORLD))
+		{
+			fp = fopen(pl.file, "w");
+		}
+
+		// report is skipped on failure (timers are still reduced collectively)
+		if(fp)
+		{
+			fprintf(fp, "{\n");
+			fprintf(fp, "  \"processes\": %lld,\n", (LLD)size);
+			fprintf(fp, "  \"total_time\": %.6e,\n", t - pl.tstart);
+			fprintf(fp, "  \"time_unit\": \"%s\",\n", pl.lbl_time);
+			fprintf(fp, "  \"events\": {\n");
+		}
+
+		// phase timers
+		for(i = 0; i < _PERF_NUM_EVENTS_; i++)
+		{
+			PetscCall(PerfWriteTimer(fp, &pl.ev[i], perfNames[i][1], i == _PERF_NUM_EVENTS_-1));
+		}
+
+		if(fp) fprintf(fp, "  },\n  \"mg_levels\": {\n");
+
+		// multigrid level timers (smoothers & coarse solver)
+		for(i = 0; i < pl.nlvl; i++)
+		{
+			sprintf(lvlkey, "level_%lld", (LLD)i);
+
+			PetscCall(PerfWriteTimer(fp, &pl.lvl[i], lvlkey, i == pl.nlvl-1));
+		}
+
+		if(fp)
+		{
+			fprintf(fp, "  },\n  \"steps\": [\n");
+
+			ns = (PetscInt)pl.steps.size();
+
+			for(i = 0; i < ns; i++)
+			{
+				ps = &pl.steps[i];
+
+				fprintf(fp, "    { \"step\": %lld, \"time\": %.6e, \"dt\": %.6e, \"wall\": %.6e, \"snes_its\": %lld, \"ksp_its\": %lld, \"phases\": {",
+					(LLD)ps->step, ps->time, ps->dt, ps->t[_PERF_NUM_EVENTS_], (LLD)ps->snesits, (LLD)ps->kspits);
+
+				for(j = 0; j < _PERF_NUM_EVENTS_; j++)
+				{
+					fprintf(fp, " \"%s\": %.6e%s", perfNames[j][1], ps->t[j], j == _PERF_NUM_EVENTS_-1 ? "" : ",");
+				}
+
+				fprintf(fp, " } }%s\n", i == ns-1 ? "" : ",");
+			}
+
+			fprintf(fp, "  ]\n}\n");
+
+			fclose(fp);
+		}
+
+		if(ISRankZero(PETSC_COMM_WORLD))
+		{
+			if(fp) PetscPrintf(PETSC_COMM_SELF, "Performance report is written to %s \n", pl.file);
+			else   PetscPrintf(PETSC_COMM_SELF, "WARNING! Cannot open performance report file %s \n", pl.file);
+
+			PetscPrintf(PETSC_COMM_SELF, "--------------------------------------------------------------------------\n");
+		}
+	}
+
+	// clear accumulated data (keep registered events)
+	for(i = 0; i < _PERF_NUM_EVENTS_; i++)
+	{
+		pl.ev[i].time  = 0.0;
+		pl.ev[i].bytes = 0.0;
+		pl.ev[i].flops = 0.0;
+		pl.ev[i].count = 0;
+		pl.ev[i].depth = 0;
+		pl.tprev[i]    = 0.0;
+	}
+
+	for(i = 0; i < _perf_max_levels_; i++)
+	{
+		pl.lvl[i].time  = 0.0;
+		pl.lvl[i].count = 0;
+		pl.lvl[i].depth = 0;
+	}
+
+	pl.steps.clear();
+
+	pl.active = 0;
+	pl.nlvl   = 0;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfBegin(PerfEvent ev)
+{
+	PetscFunctionBeginUser;
+
+	if(!pl.registered) PetscFunctionReturn(0);
+
+	PetscCall(PetscLogEventBegin(pl.ev[ev].id, 0, 0, 0, 0));
+
+	if(pl.active) PerfTimerBegin(&pl.ev[ev]);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfEnd(PerfEvent ev)
+{
+	PetscFunctionBeginUser;
+
+	if(!pl.registered) PetscFunctionReturn(0);
+
+	if(pl.active) PerfTimerEnd(&pl.ev[ev]);
+
+	PetscCall(PetscLogEventEnd(pl.ev[ev].id, 0, 0, 0, 0));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfAddWork(PerfEvent ev, PetscLogDouble bytes, PetscLogDouble flops)
+{
+	PetscFunctionBeginUser;
+
+	// operation count is also reported by -log_view
+	PetscCall(PetscLogFlops(flops));
+
+	pl.ev[ev].bytes += bytes;
+	pl.ev[ev].flops += flops;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfAttachMG(PC pc, PetscInt nlvl)
+{
+	// time level solves of PCMG (LaMEM numbering, 0 - finest level)
+
+	KSP      ksp;
+	char     name[_str_len_];
+	PetscInt i;
+
+	PetscFunctionBeginUser;
+
+	if(!pl.registered) PetscFunctionReturn(0);
+
+	nlvl = PetscMin(nlvl, _perf_max_levels_);
+
+	// register missing level events
+	for(i = pl.nreg; i < nlvl; i++)
+	{
+		sprintf(name, "LMGMGLevel%lld", (LLD)i);
+
+		PetscCall(PetscLogEventRegister(name, pl.classid, &pl.lvl[i].id));
+	}
+
+	pl.nreg = PetscMax(pl.nreg, nlvl);
+	pl.nlvl = PetscMax(pl.nlvl, nlvl);
+
+	for(i = 0; i < nlvl; i++)
+	{
+		pl.lid[i] = i;
+
+		PetscCall(PCMGGetSmoother(pc, nlvl-1-i, &ksp));
+		PetscCall(KSPSetPreSolve (ksp, PerfLevelBegin, &pl.lid[i]));
+		PetscCall(KSPSetPostSolve(ksp, PerfLevelEnd,   &pl.lid[i]));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode PerfStepEnd(SNES snes, PetscInt step, PetscScalar time, PetscScalar dt, const char *lbl_time)
+{
+	PerfStep       ps;
+	PetscLogDouble t, lt[_PERF_NUM_EVENTS_+1];
+	PetscInt       i;
+
+	PetscFunctionBeginUser;
+
+	if(!pl.active) PetscFunctionReturn(0);
+
+	PetscTime(&t);
+
+	// time spent in every phase during this step
+	for(i = 0; i < _PERF_NUM_EVENTS_; i++)
+	{
+		lt[i]       = pl.ev[i].time - pl.tprev[i];
+		pl.tprev[i] = pl.ev[i].time;
+	}
+
+	lt[_PERF_NUM_EVENTS_] = t - pl.tstep;
+
+	pl.tstep = t;
+
+	PetscCallMPI(MPI_Reduce(lt, ps.t, _PERF_NUM_EVENTS_+1, MPI_DOUBLE, MPI_MAX, 0, PETSC_COMM_WORLD));
+
+	ps.step = step;
+	ps.time = time;
+	ps.dt   = dt;
+
+	PetscCall(SNESGetIterationNumber      (snes, &ps.snesits));
+	PetscCall(SNESGetLinearSolveIterations(snes, &ps.kspits));
+
+	strncpy(pl.lbl_time, lbl_time, _str_len_-1);
+
+	if(ISRankZero(PETSC_COMM_WORLD)) pl.steps.push_back(ps);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+/*@ ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ **
+ **   Project      : LaMEM
+ **   License      : MIT, see LICENSE file for details
+ **   Contributors : Anton Popov, Boris Kaus, see AUTHORS file for complete list
+ **   Organization : Institute of Geosciences, Johannes-Gutenberg University, Mainz
+ **   Contact      : kaus@uni-mainz.de, popov@uni-mainz.de
+ **
+ ** ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ @*/
+//---------------------------------------------------------------------------
+// ..................... PERFORMANCE INSTRUMENTATION .........................
+//---------------------------------------------------------------------------
+#ifndef __perfLog_h__
+#define __perfLog_h__
+//---------------------------------------------------------------------------
+
+struct FB;
+
+//---------------------------------------------------------------------------
+// Solver phases are wrapped in PETSc log events (visible with -log_view).
+// In addition, wall time, call counts and estimated memory traffic and
+// operation counts are accumulated by every process. If activated
+// (perf_report = 1), a JSON report is written at the end of the run with
+// per-step timings and iteration counts, achieved bandwidth of the
+// matrix-free kernels and load imbalance (max/avg time over processes).
+//
+// Memory traffic of the matrix-free operator is the compulsory traffic
+// (every input array read once, every output array written once), i.e.
+// the reported bandwidth is a lower bound of the actual bandwidth.
+//---------------------------------------------------------------------------
+
+enum PerfEvent
+{
+	_PERF_SNES_,      // nonlinear solve (SNESSolve)
+	_PERF_RESIDUAL_,  // residual evaluation (JacResFormResidual)
+	_PERF_CONSTEQ_,   // constitutive update & residual assembly loops
+	_PERF_MATVEC_,    // matrix-free operator application
+	_PERF_PICARD_,    // assembled Picard matrix-vector product
+	_PERF_MG_SETUP_,  // multigrid setup
+	_PERF_MG_APPLY_,  // multigrid application
+	_PERF_MARK_PROJ_, // marker-to-grid projection
+	_PERF_MARK_EXCH_, // marker exchange
+	_PERF_AVD_,       // AVD marker control
+	_PERF_OUT_AVD_,   // AVD phase output
+	_PERF_OUT_GRID_,  // grid output
+	_PERF_OUT_SURF_,  // free surface output
+	_PERF_OUT_MARK_,  // marker output
+	_PERF_OUT_PTR_,   // passive tracers output
+	_PERF_RESTART_,   // restart database
+	_PERF_NUM_EVENTS_
+
+};
+
+// maximum number of multigrid levels with separate timers
+#define _perf_max_levels_ 16
+
+// words moved & floating point operations per cell of matrix-free operator (estimates)
+#define _perf_mf_words_       22
+#define _perf_mf_coef_words_  6   // parameter arrays (halved in single precision)
+#define _perf_mf_flops_       150
+#define _perf_mf_tan_words_   13
+#define _perf_mf_tan_flops_   80
+
+//---------------------------------------------------------------------------
+
+// read activation flag, register events (call before objects are created)
+PetscErrorCode PerfLogCreate(FB *fb);
+
+// write JSON report (if activated), clear accumulated data
+PetscErrorCode PerfLogDestroy();
+
+// start & stop event timer
+PetscErrorCode PerfBegin(PerfEvent ev);
+
+PetscErrorCode PerfEnd(PerfEvent ev);
+
+// add estimated memory traffic (bytes) & operation count to the event
+PetscErrorCode PerfAddWork(PerfEvent ev, PetscLogDouble bytes, PetscLogDouble flops);
+
+// attach per-level smoother timers to multigrid preconditioner
+PetscErrorCode PerfAttachMG(PC pc, PetscInt nlvl);
+
+// record time step (scaled time & time step, nonlinear & linear iteration counts)
+PetscErrorCode PerfStepEnd(SNES snes, PetscInt step, PetscScalar time, PetscScalar dt, const char *lbl_time);
+
+//---------------------------------------------------------------------------
+#endif
@@ -1503,6 +1503,74 @@ PetscErrorCode DynamicPhTr_ReadRestart(JacRes *jr, FILE *fp)
 	}
 
 
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DynamicPhTr_ViewRestart(JacRes *jr, PetscViewer viewer)
+{
+	// store box boundaries for all cells in y-direction (independent of partitioning)
+
+	Discret1D   *dsy;
+	Ph_trans_t  *PhaseTrans;
+	PetscScalar *gbuff;
+	PetscInt     nPtr, numPhTrn;
+
+	PetscFunctionBeginUser;
+
+	numPhTrn = jr->dbm->numPhtr;
+	dsy      = &jr->fs->dsy;
+
+	for(nPtr = 0; nPtr < numPhTrn; nPtr++)
+	{
+		PhaseTrans = jr->dbm->matPhtr+nPtr;
+
+		if(PhaseTrans->Type != _NotInAirBox_) continue;
+
+		gbuff = NULL;
+		PetscCall(Discret1DGatherCellArray(dsy, PhaseTrans->cbuffL, &gbuff));
+		PetscCall(PetscViewerBinaryWrite(viewer, gbuff, dsy->tcels+2, PETSC_SCALAR));
+		PetscCall(PetscFree(gbuff));
+
+		gbuff = NULL;
+		PetscCall(Discret1DGatherCellArray(dsy, PhaseTrans->cbuffR, &gbuff));
+		PetscCall(PetscViewerBinaryWrite(viewer, gbuff, dsy->tcels+2, PETSC_SCALAR));
+		PetscCall(PetscFree(gbuff));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DynamicPhTr_LoadRestart(JacRes *jr, PetscViewer viewer)
+{
+	// arrays must be created by DynamicPhTr_Init
+
+	Discret1D   *dsy;
+	Ph_trans_t  *PhaseTrans;
+	PetscScalar *gbuff;
+	PetscInt     nPtr, numPhTrn;
+
+	PetscFunctionBeginUser;
+
+	numPhTrn = jr->dbm->numPhtr;
+	dsy      = &jr->fs->dsy;
+
+	PetscCall(makeScalArray(&gbuff, NULL, dsy->tcels+2));
+
+	for(nPtr = 0; nPtr < numPhTrn; nPtr++)
+	{
+		PhaseTrans = jr->dbm->matPhtr+nPtr;
+
+		if(PhaseTrans->Type != _NotInAirBox_) continue;
+
+		PetscCall(PetscViewerBinaryRead(viewer, gbuff, dsy->tcels+2, NULL, PETSC_SCALAR));
+		PetscCall(Discret1DSetCellArray(dsy, gbuff, PhaseTrans->cbuffL));
+
+		PetscCall(PetscViewerBinaryRead(viewer, gbuff, dsy->tcels+2, NULL, PETSC_SCALAR));
+		PetscCall(Discret1DSetCellArray(dsy, gbuff, PhaseTrans->cbuffR));
+	}
+
+	PetscCall(PetscFree(gbuff));
+
 	PetscFunctionReturn(0);
 }
 //------------------------------------------------------------------------------------------------------------
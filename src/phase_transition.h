@@ -49,6 +49,8 @@ PetscErrorCode DynamicPhTr_Init(JacRes *jr);
 PetscErrorCode DynamicPhTr_WriteRestart2(JacRes *jr, FILE *fp);
 PetscErrorCode DynamicPhTr_WriteRestart(JacRes *jr, FILE *fp);
 PetscErrorCode DynamicPhTr_ReadRestart(JacRes *jr, FILE *fp);
+PetscErrorCode DynamicPhTr_ViewRestart(JacRes *jr, PetscViewer viewer);
+PetscErrorCode DynamicPhTr_LoadRestart(JacRes *jr, PetscViewer viewer);
 PetscErrorCode DynamicPhTrDestroy(DBMat *dbm);
 
 //-----------------------------------------------------------------------------
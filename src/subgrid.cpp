@@ -51,7 +51,7 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 	FDSTAG           *fs;
 	PetscInt          icell, isubcell, imark, I, J, K, i, j, ib, ie;
 	PetscInt          ncx, ncy, npx, npy, npz, nmark, ncell, nclone, nmerge;
-	PetscInt         *markind;
+	PetscInt         mstart;
 	PetscScalar       s[3], h[3], *x;
 	PetscLogDouble    t0, t1;
 	ipair             t;
@@ -117,12 +117,12 @@ PetscErrorCode ADVMarkSubGrid(AdvCtx *actx)
 		cell.clear();
 
 		// map markers on subcells
-		markind = actx->markind + actx->markstart[icell];
+		mstart  = actx->markstart[icell];
 
 		for(j = 0; j < nmark; j++)
 		{
 			// get marker index & coordinates
-			imark = markind[j];
+			imark = mstart + j;
 			x      = actx->markers[imark].X;
 
 			// compute containing subcell index
@@ -210,7 +210,7 @@ PetscErrorCode ADVMarkClone(
 	spair             d;
 	Marker            P;
 	PetscScalar       xc[3], *x;
-	PetscInt          I, J, K, j, npx, npy, imark, nmark, *markind;
+	PetscInt          I, J, K, j, npx, npy, imark, nmark, mstart;
 
 	
 	PetscFunctionBeginUser;
@@ -220,7 +220,7 @@ PetscErrorCode ADVMarkClone(
 	npx     = actx->NumPartX;
 	npy     = actx->NumPartY;
 	nmark   = actx->markstart[icell+1] - actx->markstart[icell];
-	markind = actx->markind + actx->markstart[icell];
+	mstart  = actx->markstart[icell];
 
 	// expand I, J, K subcell indices
 	GET_CELL_IJK(isubcell, I, J, K, npx, npy)
@@ -237,7 +237,7 @@ PetscErrorCode ADVMarkClone(
 	for(j = 0; j < nmark; j++)
 	{
 		// get marker index & coordinates
-		imark = markind[j];
+		imark = mstart + j;
 		x     = actx->markers[imark].X;
 
 		// store marker and distance
@@ -487,7 +487,7 @@ PetscErrorCode ADVMarkCrossFreeSurf(AdvCtx *actx)
 	FreeSurf        *surf;
 	Vec             vphase;
 	PetscInt        sx, sy, sz, nx, ny;
-	PetscInt        ii, jj, ID, I, J, K, L, AirPhase, phaseID, nmark, *markind, markid;
+	PetscInt        ii, jj, ID, I, J, K, L, AirPhase, phaseID, nmark, mstart, markid;
 	PetscScalar     ***ltopo, ***phase, *ncx, *ncy, topo, xp, yp, zp, *X, *IX;
     spair           d;
 	vector <spair>  dist;
@@ -572,7 +572,7 @@ PetscErrorCode ADVMarkCrossFreeSurf(AdvCtx *actx)
 
 				// get marker list in containing cell
 				nmark   = actx->markstart[ID+1] - actx->markstart[ID];
-				markind = actx->markind + actx->markstart[ID];
+				mstart  = actx->markstart[ID];
 
 				// clear distance storage
 				dist.clear();
@@ -580,7 +580,7 @@ PetscErrorCode ADVMarkCrossFreeSurf(AdvCtx *actx)
 				for(ii = 0; ii < nmark; ii++)
 				{
 					// get current marker
-					markid = markind[ii];
+					markid = mstart + ii;
 					IP     = &actx->markers[markid];
 
 					// sort out air markers
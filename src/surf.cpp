@@ -248,6 +248,51 @@ PetscErrorCode FreeSurfWriteRestart(FreeSurf *surf, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode FreeSurfViewRestart(FreeSurf *surf, PetscViewer viewer)
+{
+	PetscScalar state[2];
+
+	PetscFunctionBeginUser;
+
+	// free surface cases only
+	if(!surf->UseFreeSurf) PetscFunctionReturn(0);
+
+	// store run-time parameters
+	state[0] = surf->avg_topo;
+	state[1] = (PetscScalar)surf->phase;
+
+	PetscCall(PetscViewerBinaryWrite(viewer, state, 2, PETSC_SCALAR));
+
+	// store topography vector (redundant in z-direction)
+	PetscCall(DMDAViewRedundant(surf->DA_SURF, surf->gtopo, 1, viewer));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode FreeSurfLoadRestart(FreeSurf *surf, PetscViewer viewer)
+{
+	PetscScalar state[2];
+
+	PetscFunctionBeginUser;
+
+	// free surface cases only
+	if(!surf->UseFreeSurf) PetscFunctionReturn(0);
+
+	// read run-time parameters
+	PetscCall(PetscViewerBinaryRead(viewer, state, 2, NULL, PETSC_SCALAR));
+
+	surf->avg_topo = state[0];
+	surf->phase    = (PetscInt)state[1];
+
+	// read topography vector
+	PetscCall(DMDALoadRedundant(surf->DA_SURF, surf->gtopo, 1, viewer));
+
+	// get ghosted topography vector
+	GLOBAL_TO_LOCAL(surf->DA_SURF, surf->gtopo, surf->ltopo);
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode FreeSurfDestroy(FreeSurf *surf)
 {
 	PetscFunctionBeginUser;
@@ -82,6 +82,10 @@ PetscErrorCode FreeSurfReadRestart(FreeSurf *surf, FILE *fp);
 
 PetscErrorCode FreeSurfWriteRestart(FreeSurf *surf, FILE *fp);
 
+PetscErrorCode FreeSurfViewRestart(FreeSurf *surf, PetscViewer viewer);
+
+PetscErrorCode FreeSurfLoadRestart(FreeSurf *surf, PetscViewer viewer);
+
 PetscErrorCode FreeSurfDestroy(FreeSurf *surf);
 
 // advect topography on the free surface mesh
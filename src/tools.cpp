@@ -106,6 +106,77 @@ PetscErrorCode VecWriteRestart(Vec x, FILE *fp)
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode DMDAViewRedundant(DM da, Vec gv, PetscInt nlay, PetscViewer viewer)
+{
+	// Planview data (free surface, dike history) is stored redundantly by all
+	// processor layers in z-direction, every layer owns nlay z-planes.
+	// Only the first layer is written, in natural ordering.
+
+	Vec          natural, seq;
+	VecScatter   ctx;
+	PetscInt     mx, my;
+	PetscScalar *a;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(DMDAGetInfo(da, 0, &mx, &my, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+
+	// get natural ordering on rank zero
+	PetscCall(DMDACreateNaturalVector(da, &natural));
+	PetscCall(DMDAGlobalToNaturalBegin(da, gv, INSERT_VALUES, natural));
+	PetscCall(DMDAGlobalToNaturalEnd  (da, gv, INSERT_VALUES, natural));
+
+	PetscCall(VecScatterCreateToZero(natural, &ctx, &seq));
+	PetscCall(VecScatterBegin(ctx, natural, seq, INSERT_VALUES, SCATTER_FORWARD));
+	PetscCall(VecScatterEnd  (ctx, natural, seq, INSERT_VALUES, SCATTER_FORWARD));
+
+	// write first layer
+	PetscCall(VecGetArray(seq, &a));
+
+	PetscCall(PetscViewerBinaryWrite(viewer, a, mx*my*nlay, PETSC_SCALAR));
+
+	PetscCall(VecRestoreArray(seq, &a));
+
+	PetscCall(VecScatterDestroy(&ctx));
+	PetscCall(VecDestroy(&seq));
+	PetscCall(VecDestroy(&natural));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode DMDALoadRedundant(DM da, Vec gv, PetscInt nlay, PetscViewer viewer)
+{
+	// read planview data written by DMDAViewRedundant, copy to all processor layers
+
+	PetscInt      i, j, k, sx, sy, sz, nx, ny, nz, mx, my;
+	PetscScalar  *buff, ***a;
+
+	PetscFunctionBeginUser;
+
+	PetscCall(DMDAGetInfo(da, 0, &mx, &my, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0));
+
+	PetscCall(PetscMalloc1((size_t)(mx*my*nlay), &buff));
+
+	PetscCall(PetscViewerBinaryRead(viewer, buff, mx*my*nlay, NULL, PETSC_SCALAR));
+
+	PetscCall(DMDAGetCorners(da, &sx, &sy, &sz, &nx, &ny, &nz));
+
+	PetscCall(DMDAVecGetArray(da, gv, &a));
+
+	for(k = sz; k < sz + nz; k++)
+	for(j = sy; j < sy + ny; j++)
+	for(i = sx; i < sx + nx; i++)
+	{
+		a[k][j][i] = buff[i + mx*(j + my*(k % nlay))];
+	}
+
+	PetscCall(DMDAVecRestoreArray(da, gv, &a));
+
+	PetscCall(PetscFree(buff));
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 //  basic statistic functions
 //---------------------------------------------------------------------------
 PetscScalar getArthMean(PetscScalar *data, PetscInt n)
@@ -254,6 +325,26 @@ void getLocalRank(PetscInt *i, PetscInt *j, PetscInt *k, PetscMPIInt rank, Petsc
 
 }
 //---------------------------------------------------------------------------
+PetscErrorCode checkThreadSafety(const char *key, PetscInt nthreads)
+{
+	// PETSc function stack & error handling are only thread-safe
+	// if PETSc is configured with --with-threadsafety
+
+	PetscFunctionBeginUser;
+
+#ifndef PETSC_HAVE_THREADSAFETY
+	if(nthreads > 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_SUP, "%s > 1 requires PETSc configured with --with-threadsafety\n", key);
+	}
+#else
+	UNUSED(key);
+	UNUSED(nthreads);
+#endif
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscErrorCode DirMake(const char *name)
 {
 	int status;
@@ -428,13 +519,16 @@ void in_polygon(
 	PetscScalar *vcoord, // coordinates of polygon vertices
 	PetscScalar *box,    // bounding box of a polygon (optimization)
 	PetscScalar  atol,   // absolute tolerance
-	PetscInt    *in)     // point location flags (1-inside, 0-outside)
+	PetscInt    *in,     // point location flags (1-inside, 0-outside)
+	PetscInt     nslab,  // number of slabs in edge table (optimization)
+	PetscInt    *sptr,   // slab pointers to edge lists
+	PetscInt    *sidx)   // edge indices
 {
-	PetscInt    ip, iv, ind;
+	PetscInt    ip, iv, ind, b, jj, jb, je;
 	PetscInt    point_on, point_in;
 	PetscScalar ax, bx, ay, by;
 	PetscScalar nIntersect, intersecty, tmp;
-	PetscScalar xmin, xmax, ymin, ymax, xp, yp, xvind;
+	PetscScalar xmin, xmax, ymin, ymax, xp, yp, xvind, w;
 
 	// get bounding box
 	xmin = box[0];
@@ -442,6 +536,11 @@ void in_polygon(
 	ymin = box[2];
 	ymax = box[3];
 
+	// get slab width
+	w = 0.0;
+
+	if(nslab) w = (xmax - xmin)/(PetscScalar)nslab;
+
 	// test whether each point is in polygon
 	for(ip = 0; ip < np; ip++)
 	{
@@ -462,8 +561,24 @@ void in_polygon(
 		nIntersect = 0.0;
 		point_on   = 0;
 
-		for(iv = 0; iv < nv; iv++)
+		// only edges spanning the slab of a point can be intersected
+		if(nslab)
+		{
+			GET_POLY_SLAB(b, xp, xmin, w, nslab);
+
+			jb = sptr[b];
+			je = sptr[b+1];
+		}
+		else
 		{
+			jb = 0;
+			je = nv;
+		}
+
+		for(jj = jb; jj < je; jj++)
+		{
+			iv = nslab ? sidx[jj] : jj;
+
 			// does the line PQ intersect the line AB?
 			if(iv == nv-1)
 			{
@@ -545,6 +660,108 @@ void in_polygon(
 	}
 }
 //---------------------------------------------------------------------------
+PetscErrorCode polygon_slabs(
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon
+	PetscInt    *nslab,  // number of slabs (0 - edge table is not used)
+	PetscInt    *sptr,   // slab pointers to edge lists (nv+1)
+	PetscInt   **sidx,   // edge indices (reallocated if necessary)
+	PetscInt    *sz)     // capacity of edge index array
+{
+	// Build scanline edge table of a polygon.
+	// Bounding box is divided into uniform slabs along the first axis,
+	// every slab stores indices of all edges overlapping it (in ascending order).
+	// Number of slabs is reduced if long edges make the table too large.
+
+	PetscInt    iv, b, bb, be, n, cnt;
+	PetscScalar xmin, w, ax, bx;
+
+	PetscFunctionBeginUser;
+
+	xmin = box[0];
+	w    = 0.0;
+	n    = nv;
+	cnt  = 0;
+
+	while(n > 1)
+	{
+		w   = (box[1] - xmin)/(PetscScalar)n;
+		cnt = 0;
+
+		if(w <= 0.0) { n = 0; break; }
+
+		// count table entries
+		for(iv = 0; iv < nv; iv++)
+		{
+			ax = vcoord[2*iv];
+			bx = vcoord[2*((iv+1) % nv)];
+
+			GET_POLY_SLAB(bb, PetscMin(ax, bx), xmin, w, n);
+			GET_POLY_SLAB(be, PetscMax(ax, bx), xmin, w, n);
+
+			cnt += be - bb + 1;
+		}
+
+		if(cnt <= _max_slab_edges_*nv) break;
+
+		n /= 2;
+	}
+
+	// table is not useful for polygons with few vertices
+	if(n < 2)
+	{
+		(*nslab) = 0;
+
+		PetscFunctionReturn(0);
+	}
+
+	// reallocate edge index array
+	if(cnt > (*sz))
+	{
+		PetscCall(PetscFree(*sidx));
+		PetscCall(makeIntArray(sidx, NULL, cnt));
+
+		(*sz) = cnt;
+	}
+
+	// count & store edge indices
+	PetscCall(PetscMemzero(sptr, (size_t)(n+1)*sizeof(PetscInt)));
+
+	for(iv = 0; iv < nv; iv++)
+	{
+		ax = vcoord[2*iv];
+		bx = vcoord[2*((iv+1) % nv)];
+
+		GET_POLY_SLAB(bb, PetscMin(ax, bx), xmin, w, n);
+		GET_POLY_SLAB(be, PetscMax(ax, bx), xmin, w, n);
+
+		for(b = bb; b <= be; b++) sptr[b+1]++;
+	}
+
+	for(b = 0; b < n; b++) sptr[b+1] += sptr[b];
+
+	for(iv = 0; iv < nv; iv++)
+	{
+		ax = vcoord[2*iv];
+		bx = vcoord[2*((iv+1) % nv)];
+
+		GET_POLY_SLAB(bb, PetscMin(ax, bx), xmin, w, n);
+		GET_POLY_SLAB(be, PetscMax(ax, bx), xmin, w, n);
+
+		for(b = bb; b <= be; b++) (*sidx)[sptr[b]++] = iv;
+	}
+
+	// restore slab pointers
+	for(b = n; b > 0; b--) sptr[b] = sptr[b-1];
+
+	sptr[0] = 0;
+
+	(*nslab) = n;
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 void linSpace(
 	PetscScalar  min,
 	PetscScalar  max,
@@ -31,6 +31,12 @@ PetscErrorCode VecReadRestart (Vec x, FILE *fp);
 
 PetscErrorCode VecWriteRestart(Vec x, FILE *fp);
 
+// write leading nlay z-layers of a DMDA vector replicated over processor layers in z-direction
+PetscErrorCode DMDAViewRedundant(DM da, Vec gv, PetscInt nlay, PetscViewer viewer);
+
+// read DMDA vector replicated over processor layers in z-direction (every layer gets a copy)
+PetscErrorCode DMDALoadRedundant(DM da, Vec gv, PetscInt nlay, PetscViewer viewer);
+
 //---------------------------------------------------------------------------
 // Basic statistic functions
 //---------------------------------------------------------------------------
@@ -71,6 +77,40 @@ PetscMPIInt getGlobalRankPeriodic(
 // get local ranks of processor in DMDA
 void getLocalRank(PetscInt *i, PetscInt *j, PetscInt *k, PetscMPIInt rank, PetscInt m, PetscInt n);
 
+//---------------------------------------------------------------------------
+// Thread management functions (single thread without OpenMP)
+//---------------------------------------------------------------------------
+
+// get number of threads available for a requested number
+static inline PetscInt getNumThreads(PetscInt nreq)
+{
+#ifdef _OPENMP
+	PetscInt nmax = (PetscInt)omp_get_max_threads();
+
+	if(nreq < 1)    nreq = 1;
+	if(nreq > nmax) nreq = nmax;
+
+	return nreq;
+#else
+	UNUSED(nreq);
+
+	return 1;
+#endif
+}
+
+// get index of calling thread
+static inline PetscInt getThreadID()
+{
+#ifdef _OPENMP
+	return (PetscInt)omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+// check that PETSc error handling can be called from threads (thread bodies use PetscCall)
+PetscErrorCode checkThreadSafety(const char *key, PetscInt nthreads);
+
 //---------------------------------------------------------------------------
 // Directory management functions
 //---------------------------------------------------------------------------
@@ -123,7 +163,26 @@ void in_polygon(
 	PetscScalar *vcoord, // coordinates of polygon vertices
 	PetscScalar *box,    // bounding box of a polygon (optimization)
 	PetscScalar  atol,   // absolute tolerance
-	PetscInt    *in);    // point location flags (1-inside, 0-outside)
+	PetscInt    *in,     // point location flags (1-inside, 0-outside)
+	PetscInt     nslab = 0,     // number of slabs in edge table (optimization)
+	PetscInt    *sptr  = NULL,  // slab pointers to edge lists
+	PetscInt    *sidx  = NULL); // edge indices
+
+// build scanline edge table of a polygon (call after polygon_box)
+PetscErrorCode polygon_slabs(
+	PetscInt     nv,     // number of polygon vertices
+	PetscScalar *vcoord, // coordinates of polygon vertices
+	PetscScalar *box,    // bounding box of a polygon
+	PetscInt    *nslab,  // number of slabs (0 - edge table is not used)
+	PetscInt    *sptr,   // slab pointers to edge lists (nv+1)
+	PetscInt   **sidx,   // edge indices (reallocated if necessary)
+	PetscInt    *sz);    // capacity of edge index array
+
+// maximum average number of slabs overlapped by polygon edge
+#define _max_slab_edges_ 8
+
+// get slab index of a point
+#define GET_POLY_SLAB(b, x, xmin, w, n) { b = (PetscInt)PetscFloorReal(((x) - (xmin))/(w)); if(b < 0) b = 0; if(b > n-1) b = n-1; }
 
 //---------------------------------------------------------------------------
 // Polygon stretching functions
@@ -33,6 +33,7 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 	ts->CFLMAX    = 0.8;
 	ts->nstep_out = 1;
 	ts->nstep_ini = 1;
+	ts->rdb_keep  = 1;
 	ts->tol       = 1e-8;
 
 	// read parameters
@@ -51,6 +52,8 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nstep_out",       &ts->nstep_out,  1,               -1  ));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nstep_ini",       &ts->nstep_ini,  1,               -1  ));
 	PetscCall(getIntParam   (fb, _OPTIONAL_, "nstep_rdb",       &ts->nstep_rdb,  1,               -1  ));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "rdb_portable",    &ts->rdb_portable, 1,             1   ));
+	PetscCall(getIntParam   (fb, _OPTIONAL_, "rdb_keep",        &ts->rdb_keep,   1,               -1  ));
 	PetscCall(getScalarParam(fb, _OPTIONAL_, "time_tol",        &ts->tol,        1,               1.0 ));
 
 	if(ts->CFL < 0.0 && ts->CFL > 1.0)
@@ -68,6 +71,11 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "CFL parameter should be smaller than CFLMAX");
 	}
 
+	if(ts->rdb_keep < 1)
+	{
+		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "rdb_keep parameter must be at least 1");
+	}
+
 	if(!ts->time_end && !ts->nstep_max)
 	{
 		SETERRQ(PETSC_COMM_WORLD, PETSC_ERR_USER, "Define at least one of the parameters: time_end, nstep_max");
@@ -109,12 +117,63 @@ PetscErrorCode TSSolCreate(TSSol *ts, FB *fb)
 	if(ts->nstep_out) PetscPrintf(PETSC_COMM_WORLD, "   Output every [n] steps       : %lld \n", (LLD)ts->nstep_out);
 	if(ts->nstep_ini) PetscPrintf(PETSC_COMM_WORLD, "   Output [n] initial steps     : %lld \n", (LLD)ts->nstep_ini);
 	if(ts->nstep_rdb) PetscPrintf(PETSC_COMM_WORLD, "   Save restart every [n] steps : %lld \n", (LLD)ts->nstep_rdb);
+	if(ts->nstep_rdb && ts->rdb_portable) PetscPrintf(PETSC_COMM_WORLD, "   Restart database format      : portable \n");
+	if(ts->nstep_rdb && ts->rdb_keep > 1) PetscPrintf(PETSC_COMM_WORLD, "   Restart generations to keep  : %lld \n", (LLD)ts->rdb_keep);
 
 	PetscPrintf(PETSC_COMM_WORLD,"--------------------------------------------------------------------------\n");
 
 	PetscFunctionReturn(0);
 }
 //---------------------------------------------------------------------------
+PetscErrorCode TSSolViewRestart(TSSol *ts, PetscViewer viewer)
+{
+	// write time stepping state to portable restart database
+
+	PetscScalar state[5];
+
+	PetscFunctionBeginUser;
+
+	state[0] = ts->dt;
+	state[1] = ts->dt_next;
+	state[2] = ts->time;
+	state[3] = ts->time_out;
+	state[4] = (PetscScalar)ts->istep;
+
+	PetscCall(PetscViewerBinaryWrite(viewer, state, 5, PETSC_SCALAR));
+
+	// time stepping schedule is adjusted during the run
+	if(ts->num_dtper)
+	{
+		PetscCall(PetscViewerBinaryWrite(viewer, ts->schedule, _max_num_steps_, PETSC_SCALAR));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
+PetscErrorCode TSSolLoadRestart(TSSol *ts, PetscViewer viewer)
+{
+	// read time stepping state from portable restart database
+
+	PetscScalar state[5];
+
+	PetscFunctionBeginUser;
+
+	PetscCall(PetscViewerBinaryRead(viewer, state, 5, NULL, PETSC_SCALAR));
+
+	ts->dt       = state[0];
+	ts->dt_next  = state[1];
+	ts->time     = state[2];
+	ts->time_out = state[3];
+	ts->istep    = (PetscInt)state[4];
+
+	if(ts->num_dtper)
+	{
+		PetscCall(PetscViewerBinaryRead(viewer, ts->schedule, _max_num_steps_, NULL, PETSC_SCALAR));
+	}
+
+	PetscFunctionReturn(0);
+}
+//---------------------------------------------------------------------------
 PetscInt TSSolIsDone(TSSol *ts)
 {
 	//=================================================
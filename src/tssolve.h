@@ -43,6 +43,8 @@ struct TSSol
 	PetscInt    nstep_out;                 // save output every n steps
 	PetscInt    nstep_ini;                 // save output for n initial steps
 	PetscInt    nstep_rdb;                 // save restart database every n steps
+	PetscInt    rdb_portable;              // save processor-count independent restart database
+	PetscInt    rdb_keep;                  // number of restart database generations to keep
 	PetscInt    fix_dt;                    // flag to keep time steps fixed for advection (elasticity, kinematic block BC)
 	PetscInt    istep;                     // time step counter
 };
@@ -51,6 +53,10 @@ struct TSSol
 
 PetscErrorCode TSSolCreate(TSSol *ts, FB *fb);
 
+PetscErrorCode TSSolViewRestart(TSSol *ts, PetscViewer viewer);
+
+PetscErrorCode TSSolLoadRestart(TSSol *ts, PetscViewer viewer);
+
 PetscInt TSSolIsDone(TSSol *ts);
 
 PetscErrorCode TSSolStepForward(TSSol *ts);
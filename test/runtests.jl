@@ -1402,6 +1402,43 @@ end
 	end
 end
 #---------------------------------------------------------------------------
+@testset "t36_MatFreeOperator" begin
+    cd(test_dir)
+    dir = "t36_MatFreeOperator";
+    include(joinpath(dir,"MatFree_compare.jl"))
+
+    ParamFile = "MatFree_FallingBlock.dat";
+
+    # matrix-free Jacobian & fine multigrid level vs. assembled operators (4 cores)
+    mf      = "-js_mat_free -gmg_mat_free_levels 1"
+    rows    = "$mf -mat_free_row_kernels"
+    single  = "$rows -gmg_mat_free_single"
+
+    # boundary conditions: free slip, open top & no-slip (two-point constraints)
+    bcs     = ("", "-open_top_bound 1 -noslip 1,1,1,1,1,0")
+
+    for bc in bcs
+        # reference stencils
+        success, err = compare_matfree(dir, ParamFile, mf, bc)
+        @test success
+        @test err < 1e-7
+
+        # branch-free row kernels
+        success, err = compare_matfree(dir, ParamFile, rows, bc)
+        @test success
+        @test err < 1e-7
+
+        # single precision parameters of preconditioner (different Krylov history)
+        success, err = compare_matfree(dir, ParamFile, single, bc, keywords=("|Div|_inf",), accuracy=((atol=1e-8,),))
+        @test success
+        @test err < 1e-6
+    end
+
+    if clean_files
+        clean_test_directory(dir)
+    end
+end
+#---------------------------------------------------------------------------
 end
 #---------------------------------------------------------------------------
 
@@ -0,0 +1,42 @@
+# Compares matrix-free Stokes operators with the assembled operator
+
+"""
+    success, err = compare_matfree(dir, ParamFile, args, args_ref; cores=4, keywords, accuracy)
+
+Runs `ParamFile` with assembled operators (`args_ref`) and with matrix-free operators (`args`),
+compares the logfiles (solver residuals) and returns the relative difference of the velocity fields.
+"""
+function compare_matfree(dir, ParamFile, args, args_ref; cores=4,
+                        keywords=("KSP Residual norm","|Div|_2","|mRes|_2"),
+                        accuracy=((rtol=1e-4,atol=1e-12), (rtol=1e-3,atol=1e-10), (rtol=1e-3,atol=1e-10)))
+    cur_dir = pwd();
+    cd(dir)
+
+    # reference run (assembled operators)
+    out_ref = run_lamem_local_test(ParamFile, cores, "$args_ref -out_file_name MatFree_ref", outfile="MatFree_ref.out", opt=true, mpiexec=mpiexec)
+    data_ref, _ = read_LaMEM_timestep("MatFree_ref", 0, pwd(), fields=("velocity [ ]",), last=true)
+
+    # matrix-free run
+    out_mf  = run_lamem_local_test(ParamFile, cores, "$args_ref $args -out_file_name MatFree_mf", outfile="MatFree_mf.out", opt=true, mpiexec=mpiexec)
+    data_mf, _  = read_LaMEM_timestep("MatFree_mf", 0, pwd(), fields=("velocity [ ]",), last=true)
+
+    # compare solver residuals
+    success = out_ref && out_mf
+    split   = ntuple(i -> keywords[i]=="KSP Residual norm" ? "" : "=", length(keywords))
+
+    if success
+        success = compare_logfiles("MatFree_mf.out", "MatFree_ref.out", keywords, accuracy, split_sign=split)
+    end
+
+    # compare velocity fields
+    err = 0.0
+    for i=1:3
+        v_ref = Float64.(data_ref.fields.velocity[i])
+        v_mf  = Float64.(data_mf.fields.velocity[i])
+        err   = max(err, norm(v_mf - v_ref)/norm(v_ref))
+    end
+
+    cd(cur_dir)
+
+    return success, err
+end